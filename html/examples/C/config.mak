@@ -40,6 +40,7 @@ SRC = list1.c
 #SRC = list2.c
 #SRC = listdialog.c
 #SRC = lua_init.c
+#SRC = lua_callbacks.c
 #SRC = mask.c
 #SRC = menu.c
 #SRC = message.c
@@ -139,3 +140,4 @@ endif
 #USE_LUA51=Yes
 #USE_IUPLUA=Yes
 #SRC = lua_init.c
+#SRC = lua_callbacks.c
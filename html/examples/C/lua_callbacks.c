@@ -0,0 +1,76 @@
+/* Measures the number of Lua callbacks that can be called per second.
+   Compares the cached callbacks with the callbacks called using iup.CallMethod,
+   that is used when the global attribute IUPLUA_CALLMETHOD is set.  */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+
+#include <iup.h>
+#include <iupcbs.h>
+
+#include <iuplua.h>
+
+#define CALL_COUNT 1000000
+
+static const char* setup_script =
+  "count = 0\n"
+  "canvas = iup.canvas{}\n"
+  "function canvas:motion_cb(x, y, status) count = count + 1 end\n"
+  "iup.SetHandle(\"bench_canvas\", canvas)\n";
+
+/* set the callback again, so it uses the current IUPLUA_CALLMETHOD */
+static const char* reset_script =
+  "canvas.motion_cb = canvas.motion_cb\n";
+
+static void bench(const char* title)
+{
+  Ihandle* canvas = IupGetHandle("bench_canvas");
+  IFniis cb = (IFniis)IupGetCallback(canvas, "MOTION_CB");
+  clock_t start;
+  double seconds;
+  int i;
+
+  start = clock();
+  for (i = 0; i < CALL_COUNT; i++)
+    cb(canvas, i, i, "         ");
+  seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  printf("%s: %d calls in %.3f s (%.0f calls/s)\n", title, CALL_COUNT, seconds, CALL_COUNT / seconds);
+}
+
+int main(int argc, char **argv)
+{
+  lua_State *L;
+
+  IupOpen(&argc, &argv);
+
+  L = lua_open();
+  luaL_openlibs(L);
+
+  iuplua_open(L);
+
+  if (luaL_dostring(L, setup_script))
+  {
+    printf("%s\n", lua_tostring(L, -1));
+    return EXIT_FAILURE;
+  }
+
+  bench("Cached callback");
+
+  IupSetGlobal("IUPLUA_CALLMETHOD", "YES");
+  luaL_dostring(L, reset_script);
+  bench("iup.CallMethod");
+
+  IupSetGlobal("IUPLUA_CALLMETHOD", NULL);
+
+  lua_close(L);
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
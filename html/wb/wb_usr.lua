@@ -649,6 +649,14 @@ wb_usr.tree =
               name= {nl= "IupFlush"},
               link= "func/iupflush.html"
             },
+            {
+              name= {nl= "IupPostMessage"},
+              link= "func/iuppostmessage.html"
+            },
+            {
+              name= {nl= "IupAddIdleTask"},
+              link= "func/iupaddidletask.html"
+            },
             { link= "", name= {en= "" } },
             {
               name= {nl= "IupGetCallback"},
@@ -697,6 +705,10 @@ wb_usr.tree =
               name= {nl= "IDLE_ACTION"},
               link= "call/iup_idle_action.html"
             },
+            {
+              name= {nl= "POSTMESSAGE_CB"},
+              link= "call/iup_postmessage_cb.html"
+            },
             { link= "", name= {en= "" } },
             {
               name= {nl= "MAP_CB"},
@@ -26,6 +26,7 @@ extern "C" {
 #define IUP_VERSION_DATE "2012/06/23"  /* does not include bug fix releases */
 
 typedef struct Ihandle_ Ihandle;
+typedef struct Iled_ Iled;
 typedef int (*Icallback)(Ihandle*);
 
 /************************************************************************/
@@ -42,6 +43,10 @@ int       IupLoopStepWait  (void);
 int       IupMainLoopLevel (void);
 void      IupFlush         (void);
 void      IupExitLoop      (void);
+void      IupPostMessage   (Ihandle* ih, const char* s, int i, double d, void* p);
+int       IupAddIdleTask   (Icallback func, void* user_data, int priority);
+void      IupRemoveIdleTask(int id);
+int       IupGetIdleTaskInfo(int id, int *calls, double *time, double *max_time);
 
 int       IupRecordInput(const char* filename, int mode);
 int       IupPlayInput(const char* filename);
@@ -57,6 +62,11 @@ char*     IupUnMapFont     (const char *driverfont);
 int       IupHelp          (const char* url);
 char*     IupLoad          (const char *filename);
 char*     IupLoadBuffer    (const char *buffer);
+Iled*     IupLedParse      (const char *filename);
+Iled*     IupLedParseBuffer(const char *buffer, int size);
+char*     IupLedGetError   (Iled* led);
+char*     IupLedBuild      (Iled* led);
+void      IupLedDestroy    (Iled* led);
 
 char*     IupVersion       (void);
 char*     IupVersionDate   (void);
@@ -90,6 +100,7 @@ void      IupStoreAttribute(Ihandle* ih, const char* name, const char* value);
 Ihandle*  IupSetAttributes (Ihandle* ih, const char *str);
 char*     IupGetAttribute  (Ihandle* ih, const char* name);
 char*     IupGetAttributes (Ihandle* ih);
+int       IupGetAttributeBuffer(Ihandle* ih, const char* name, char* buffer, int size);
 int       IupGetInt        (Ihandle* ih, const char* name);
 int       IupGetInt2       (Ihandle* ih, const char* name);
 int       IupGetIntInt     (Ihandle *ih, const char* name, int *i1, int *i2);
@@ -102,6 +113,7 @@ Ihandle*  IupSetAtt(const char* handle_name, Ihandle* ih, const char* name, ...)
 void  IupSetAttributeId(Ihandle *ih, const char* name, int id, const char *value);
 void  IupStoreAttributeId(Ihandle *ih, const char* name, int id, const char *value);
 char* IupGetAttributeId(Ihandle *ih, const char* name, int id);
+int   IupGetAttributeIdBuffer(Ihandle* ih, const char* name, int id, char* buffer, int size);
 float IupGetFloatId(Ihandle *ih, const char* name, int id);
 int   IupGetIntId(Ihandle *ih, const char* name, int id);
 void  IupSetfAttributeId(Ihandle *ih, const char* name, int id, const char* format, ...);
@@ -109,6 +121,7 @@ void  IupSetfAttributeId(Ihandle *ih, const char* name, int id, const char* form
 void  IupSetAttributeId2(Ihandle* ih, const char* name, int lin, int col, const char* value);
 void  IupStoreAttributeId2(Ihandle* ih, const char* name, int lin, int col, const char* value);
 char* IupGetAttributeId2(Ihandle* ih, const char* name, int lin, int col);
+int   IupGetAttributeId2Buffer(Ihandle* ih, const char* name, int lin, int col, char* buffer, int size);
 int   IupGetIntId2(Ihandle* ih, const char* name, int lin, int col);
 float IupGetFloatId2(Ihandle* ih, const char* name, int lin, int col);
 void  IupSetfAttributeId2(Ihandle* ih, const char* name, int lin, int col, const char* format, ...);
@@ -223,6 +236,7 @@ int   IupConvertXYToPos(Ihandle* ih, int x, int y);
 int   IupTreeSetUserId(Ihandle* ih, int id, void* userid);
 void* IupTreeGetUserId(Ihandle* ih, int id);
 int   IupTreeGetId(Ihandle* ih, void *userid);
+int   IupTreeAddNodeList(Ihandle* ih, const char* kind, int id, const char** titles, int count);
 
 /* Deprecated IupTree utilities, use Iup*AttributeId functions */
 void  IupTreeSetAttribute  (Ihandle* ih, const char* name, int id, const char* value);
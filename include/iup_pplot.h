@@ -20,6 +20,7 @@ Ihandle* IupPPlot(void);
 /***********************************************/
 /*           Additional API                    */
 void IupPPlotBegin(Ihandle *ih, int strXdata);
+void IupPPlotBeginRing(Ihandle *ih, int capacity);  /* IupPPlotAdd/IupPPlotAddPoints replace the oldest samples when full */
 void IupPPlotAdd(Ihandle *ih, float x, float y);
 void IupPPlotAddStr(Ihandle *ih, const char* x, float y);
 int  IupPPlotEnd(Ihandle *ih);
@@ -8,6 +8,7 @@
 #define __IUPCBS_H
 
 typedef int (*IFidle)(void);  /* idle */
+typedef int (*IFv)(void*);  /* idle task */
 
 typedef void (*IFii)(int, int); /* globalkeypress_cb */
 typedef void (*IFiis)(int, int, char*);  /* globalmotion_cb */
@@ -17,10 +18,11 @@ typedef void (*IFfiis)(float,int,int,char*);  /* globalwheel_cb */
 typedef int (*IFn)(Ihandle*);  /* default definition, same as Icallback (ncols_cb, nlines_cb)*/
 typedef int (*IFni)(Ihandle*, int);   /* k_any, show_cb, toggle_action, spin_cb, branchopen_cb, branchclose_cb, executeleaf_cb, showrename_cb, rightclick_cb, extended_cb, height_cb, width_cb */
 typedef int (*IFnii)(Ihandle*, int, int);  /* resize_cb, caret_cb, matrix_mousemove_cb, enteritem_cb, leaveitem_cb, scrolltop_cb, dropcheck_cb, selection_cb, select_cb, switch_cb, scrolling_cb, vspan_cb, hspan_cb */
-typedef int (*IFniii)(Ihandle*, int, int, int); /* trayclick_cb, edition_cb */
+typedef int (*IFniii)(Ihandle*, int, int, int); /* trayclick_cb, edition_cb, selectrange_cb */
 typedef int (*IFniiii)(Ihandle*, int, int, int, int); /* dragdrop_cb */
 typedef int (*IFniiiiiiC)(Ihandle*, int, int, int, int, int, int, void*);  /* draw_cb */
 typedef int (*IFniiiiii)(Ihandle*, int, int, int, int, int, int);  /* OLD draw_cb */
+typedef int (*IFniiiiv)(Ihandle*, int, int, int, int, void*);  /* valueblock_cb */
 
 typedef int (*IFnff)(Ihandle*, float, float);    /* canvas_action */
 typedef int (*IFniff)(Ihandle*,int,float,float);  /* scroll_cb */
@@ -29,6 +31,7 @@ typedef int (*IFnfiis)(Ihandle*,float,int,int,char*);  /* wheel_cb */
 typedef int (*IFnsCi)(Ihandle*, char*, void*, int);  /* dragdata_cb */
 typedef int (*IFnsCiii)(Ihandle*, char*, void*, int, int, int);  /* dropdata_cb */
 typedef int (*IFnsiii)(Ihandle*, char*, int, int, int);  /* dropfiles_cb */
+typedef int (*IFnsidv)(Ihandle*, char*, int, double, void*);  /* postmessage_cb */
 
 typedef int (*IFnnii)(Ihandle*, Ihandle*, int, int); /* drop_cb */
 typedef int (*IFnnn)(Ihandle*, Ihandle*, Ihandle*); /* tabchange_cb */
@@ -50,6 +53,6 @@ typedef int (*IFnccc)(Ihandle*, unsigned char, unsigned char, unsigned char); /*
 typedef int (*IFniIIII)(Ihandle*, int, int*, int*, int*, int*); /* multitouch_cb */
 
 typedef char* (*sIFnii)(Ihandle*, int, int);  /* value_cb */
-typedef char* (*sIFni)(Ihandle*, int);  /* cell_cb */
+typedef char* (*sIFni)(Ihandle*, int);  /* cell_cb, list value_cb, list image_cb */
 
 #endif
@@ -33,7 +33,7 @@ INCLUDES = ../include .
 WIN32VER = 0x0501
 
 SRC = iup_array.c iup_callback.c iup_dlglist.c iup_attrib.c iup_focus.c iup_font.c \
-      iup_globalattrib.c iup_object.c iup_key.c iup_layout.c iup_ledlex.c iup_names.c iup_open.c \
+      iup_globalattrib.c iup_object.c iup_key.c iup_layout.c iup_ledbin.c iup_ledlex.c iup_names.c iup_open.c \
       iup_ledparse.c iup_predialogs.c iup_register.c iup_scanf.c iup_show.c iup_str.c iup_table.c \
       iup_func.c iup_childtree.c iup.c iup_classattrib.c iup_dialog.c iup_assert.c iup_canvas.c \
       iup_messagedlg.c iup_timer.c iup_image.c iup_label.c iup_fill.c iup_zbox.c \
@@ -41,7 +41,7 @@ SRC = iup_array.c iup_callback.c iup_dlglist.c iup_attrib.c iup_focus.c iup_font
       iup_user.c iup_button.c iup_radio.c iup_toggle.c iup_progressbar.c iup_text.c iup_val.c \
       iup_box.c iup_hbox.c iup_vbox.c iup_cbox.c iup_class.c iup_classbase.c iup_maskmatch.c \
       iup_mask.c iup_maskparse.c iup_tabs.c iup_spin.c iup_list.c iup_getparam.c \
-      iup_sbox.c iup_scrollbox.c iup_normalizer.c iup_tree.c iup_split.c iup_layoutdlg.c iup_recplay.c
+      iup_sbox.c iup_scrollbox.c iup_normalizer.c iup_tree.c iup_split.c iup_layoutdlg.c iup_recplay.c iup_loop.c iup_draw.c
 
 ifdef USE_GTK
   CHECK_GTK = Yes
@@ -118,6 +118,11 @@ else
 endif
 endif
 
+ifeq ($(findstring Win, $(TEC_SYSNAME)), )
+  # the transient strings and the table key atoms use pthread
+  LIBS += pthread
+endif
+
 ifneq ($(findstring dll, $(TEC_UNAME)), )
   DEFINES += IUP_DLL
   INCLUDES += ../etc
@@ -19,11 +19,12 @@
 #include "iup_object.h"
 #include "iup_image.h"
 #include "iup_draw.h"
+#include "iup_drvdraw.h"
 
 #include "iupgtk_drv.h"
 
 
-struct _IdrawCanvas{
+struct _IdrvCanvas{
   Ihandle* ih;
   int w, h;
 
@@ -32,9 +33,9 @@ struct _IdrawCanvas{
   GdkGC *gc, *pixmap_gc;
 };
 
-IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih)
+IdrvCanvas* iupdrvDrawCreateCanvas(Ihandle* ih)
 {
-  IdrawCanvas* dc = calloc(1, sizeof(IdrawCanvas));
+  IdrvCanvas* dc = calloc(1, sizeof(IdrvCanvas));
 
   dc->ih = ih;
   dc->wnd = iupgtkGetWindow(ih->handle);
@@ -48,7 +49,7 @@ IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih)
   return dc;
 }
 
-void iupDrawKillCanvas(IdrawCanvas* dc)
+void iupdrvDrawKillCanvas(IdrvCanvas* dc)
 {
   g_object_unref(dc->pixmap_gc); 
   g_object_unref(dc->pixmap); 
@@ -57,7 +58,7 @@ void iupDrawKillCanvas(IdrawCanvas* dc)
   free(dc);
 }
 
-void iupDrawUpdateSize(IdrawCanvas* dc)
+void iupdrvDrawUpdateSize(IdrvCanvas* dc)
 {
   int w, h;
   gdk_drawable_get_size(dc->wnd, &w, &h);
@@ -75,26 +76,26 @@ void iupDrawUpdateSize(IdrawCanvas* dc)
   }
 }
 
-void iupDrawFlush(IdrawCanvas* dc)
+void iupdrvDrawFlush(IdrvCanvas* dc)
 {
   gdk_draw_drawable(dc->wnd, dc->gc, dc->pixmap, 0, 0, 0, 0, dc->w, dc->h);
 }
 
-void iupDrawGetSize(IdrawCanvas* dc, int *w, int *h)
+void iupdrvDrawGetSize(IdrvCanvas* dc, int *w, int *h)
 {
   if (w) *w = dc->w;
   if (h) *h = dc->h;
 }
 
-void iupDrawParentBackground(IdrawCanvas* dc)
+void iupdrvDrawParentBackground(IdrvCanvas* dc)
 {
   unsigned char r=0, g=0, b=0;
   char* color = iupBaseNativeParentGetBgColorAttrib(dc->ih);
   iupStrToRGB(color, &r, &g, &b);
-  iupDrawRectangle(dc, 0, 0, dc->w-1, dc->h-1, r, g, b, IUP_DRAW_FILL);
+  iupdrvDrawRectangle(dc, 0, 0, dc->w-1, dc->h-1, r, g, b, IUP_DRAW_FILL);
 }
 
-void iupDrawRectangle(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawRectangle(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   GdkColor color;
   iupgdkColorSet(&color, r, g, b);
@@ -115,7 +116,7 @@ void iupDrawRectangle(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned
   }
 }
 
-void iupDrawLine(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawLine(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   GdkGCValues gcval;
   GdkColor color;
@@ -131,7 +132,7 @@ void iupDrawLine(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char
   gdk_draw_line(dc->pixmap, dc->pixmap_gc, x1, y1, x2, y2);
 }
 
-void iupDrawArc(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawArc(IdrvCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   GdkColor color;
   iupgdkColorSet(&color, r, g, b);
@@ -150,7 +151,7 @@ void iupDrawArc(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, doub
   gdk_draw_arc(dc->pixmap, dc->pixmap_gc, style==IUP_DRAW_FILL, x1, y1, x2-x1+1, y2-y1+1, iupROUND(a1*64), iupROUND((a2 - a1)*64));
 }
 
-void iupDrawPolygon(IdrawCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawPolygon(IdrvCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   GdkColor color;
   iupgdkColorSet(&color, r, g, b);
@@ -169,7 +170,7 @@ void iupDrawPolygon(IdrawCanvas* dc, int* points, int count, unsigned char r, un
   gdk_draw_polygon(dc->pixmap, dc->pixmap_gc, style==IUP_DRAW_FILL, (GdkPoint*)points, count);
 }
 
-void iupDrawSetClipRect(IdrawCanvas* dc, int x1, int y1, int x2, int y2)
+void iupdrvDrawSetClipRect(IdrvCanvas* dc, int x1, int y1, int x2, int y2)
 {
   GdkRectangle rect;
   rect.x      = x1;
@@ -179,12 +180,12 @@ void iupDrawSetClipRect(IdrawCanvas* dc, int x1, int y1, int x2, int y2)
   gdk_gc_set_clip_rectangle(dc->pixmap_gc, &rect);
 }
 
-void iupDrawResetClip(IdrawCanvas* dc)
+void iupdrvDrawResetClip(IdrvCanvas* dc)
 {
   gdk_gc_set_clip_region(dc->pixmap_gc, NULL);
 }
 
-void iupDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font)
+void iupdrvDrawText(IdrvCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font)
 {
   PangoLayout* fontlayout = (PangoLayout*)iupgtkGetPangoLayout(font);
   GdkColor color;
@@ -194,7 +195,7 @@ void iupDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, unsig
   gdk_draw_layout(dc->pixmap, dc->pixmap_gc, x, y, fontlayout);
 }
 
-void iupDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
+void iupdrvDrawImage(IdrvCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
 {
   int bpp;
   GdkPixbuf* pixbuf = iupImageGetImage(name, dc->ih, make_inactive);
@@ -207,7 +208,7 @@ void iupDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, i
   gdk_draw_pixbuf(dc->pixmap, dc->pixmap_gc, pixbuf, 0, 0, x, y, *img_w, *img_h, GDK_RGB_DITHER_NORMAL, 0, 0);
 }
 
-void iupDrawSelectRect(IdrawCanvas* dc, int x, int y, int w, int h)
+void iupdrvDrawSelectRect(IdrvCanvas* dc, int x, int y, int w, int h)
 {
   GdkColor color;
   iupgdkColorSet(&color, 255, 255, 255);
@@ -217,7 +218,7 @@ void iupDrawSelectRect(IdrawCanvas* dc, int x, int y, int w, int h)
   gdk_gc_set_function(dc->pixmap_gc, GDK_COPY);
 }
 
-void iupDrawFocusRect(IdrawCanvas* dc, int x, int y, int w, int h)
+void iupdrvDrawCanvasFocusRect(IdrvCanvas* dc, int x, int y, int w, int h)
 {
   GtkStyle *style = gtk_widget_get_style(dc->ih->handle);
   gtk_paint_focus(style, dc->wnd, GTK_STATE_NORMAL, NULL, NULL, NULL, x, y, w, h);
@@ -19,12 +19,13 @@
 #include "iup_object.h"
 #include "iup_image.h"
 #include "iup_draw.h"
+#include "iup_drvdraw.h"
 
 #include "iupgtk_drv.h"
 
 /* This was build for GTK3, but works also for GTK2 */
 
-struct _IdrawCanvas{
+struct _IdrvCanvas{
   Ihandle* ih;
   int w, h;
 
@@ -32,9 +33,9 @@ struct _IdrawCanvas{
   cairo_t *cr, *image_cr;
 };
 
-IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih)
+IdrvCanvas* iupdrvDrawCreateCanvas(Ihandle* ih)
 {
-  IdrawCanvas* dc = calloc(1, sizeof(IdrawCanvas));
+  IdrvCanvas* dc = calloc(1, sizeof(IdrvCanvas));
   cairo_surface_t* surface;
 
   dc->ih = ih;
@@ -55,7 +56,7 @@ IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih)
   return dc;
 }
 
-void iupDrawKillCanvas(IdrawCanvas* dc)
+void iupdrvDrawKillCanvas(IdrvCanvas* dc)
 {
   cairo_destroy(dc->image_cr);
   cairo_destroy(dc->cr);
@@ -63,7 +64,7 @@ void iupDrawKillCanvas(IdrawCanvas* dc)
   free(dc);
 }
 
-void iupDrawUpdateSize(IdrawCanvas* dc)
+void iupdrvDrawUpdateSize(IdrvCanvas* dc)
 {
   int w, h;
 
@@ -89,7 +90,7 @@ void iupDrawUpdateSize(IdrawCanvas* dc)
   }
 }
 
-void iupDrawFlush(IdrawCanvas* dc)
+void iupdrvDrawFlush(IdrvCanvas* dc)
 {
   /* flush the writing in the image */
   cairo_show_page(dc->image_cr);
@@ -104,21 +105,21 @@ void iupDrawFlush(IdrawCanvas* dc)
   cairo_paint(dc->cr);  /* paints the current source everywhere within the current clip region. */
 }
 
-void iupDrawGetSize(IdrawCanvas* dc, int *w, int *h)
+void iupdrvDrawGetSize(IdrvCanvas* dc, int *w, int *h)
 {
   if (w) *w = dc->w;
   if (h) *h = dc->h;
 }
 
-void iupDrawParentBackground(IdrawCanvas* dc)
+void iupdrvDrawParentBackground(IdrvCanvas* dc)
 {
   unsigned char r=0, g=0, b=0;
   char* color = iupBaseNativeParentGetBgColorAttrib(dc->ih);
   iupStrToRGB(color, &r, &g, &b);
-  iupDrawRectangle(dc, 0, 0, dc->w-1, dc->h-1, r, g, b, IUP_DRAW_FILL);
+  iupdrvDrawRectangle(dc, 0, 0, dc->w-1, dc->h-1, r, g, b, IUP_DRAW_FILL);
 }
 
-void iupDrawRectangle(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawRectangle(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   cairo_set_source_rgba(dc->image_cr, iupCOLOR8ToDouble(r),
                                        iupCOLOR8ToDouble(g),
@@ -146,7 +147,7 @@ void iupDrawRectangle(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned
   }
 }
 
-void iupDrawLine(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawLine(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   cairo_set_source_rgba(dc->image_cr, iupCOLOR8ToDouble(r),
                                        iupCOLOR8ToDouble(g),
@@ -167,7 +168,7 @@ void iupDrawLine(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char
   cairo_stroke(dc->image_cr);
 }
 
-void iupDrawArc(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawArc(IdrvCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   int xc, yc, w, h;
 
@@ -221,7 +222,7 @@ void iupDrawArc(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, doub
   }
 }
 
-void iupDrawPolygon(IdrawCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawPolygon(IdrvCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   int i;
 
@@ -252,18 +253,18 @@ void iupDrawPolygon(IdrawCanvas* dc, int* points, int count, unsigned char r, un
     cairo_stroke(dc->image_cr);
 }
 
-void iupDrawSetClipRect(IdrawCanvas* dc, int x1, int y1, int x2, int y2)
+void iupdrvDrawSetClipRect(IdrvCanvas* dc, int x1, int y1, int x2, int y2)
 {
   cairo_rectangle(dc->image_cr, x1, y1, x2-x1+1, y2-y1+1);
   cairo_clip(dc->image_cr);
 }
 
-void iupDrawResetClip(IdrawCanvas* dc)
+void iupdrvDrawResetClip(IdrvCanvas* dc)
 {
   cairo_reset_clip(dc->image_cr);
 }
 
-void iupDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font)
+void iupdrvDrawText(IdrvCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font)
 {
   PangoLayout* fontlayout = (PangoLayout*)iupgtkGetPangoLayout(font);
 
@@ -280,7 +281,7 @@ void iupDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, unsig
   pango_cairo_show_layout(dc->image_cr, fontlayout);
 }
 
-void iupDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
+void iupdrvDrawImage(IdrvCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
 {
   int bpp;
   GdkPixbuf* pixbuf = iupImageGetImage(name, dc->ih, make_inactive);
@@ -302,14 +303,14 @@ void iupDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, i
   cairo_restore (dc->image_cr);
 }
 
-void iupDrawSelectRect(IdrawCanvas* dc, int x, int y, int w, int h)
+void iupdrvDrawSelectRect(IdrvCanvas* dc, int x, int y, int w, int h)
 {
   cairo_set_source_rgba(dc->image_cr, 0, 0, 1, 0.60);
   cairo_rectangle(dc->image_cr, x, y, w, h);
   cairo_fill(dc->image_cr);
 }
 
-void iupDrawFocusRect(IdrawCanvas* dc, int x, int y, int w, int h)
+void iupdrvDrawCanvasFocusRect(IdrvCanvas* dc, int x, int y, int w, int h)
 {
 #if GTK_CHECK_VERSION(3, 0, 0)
   GtkStyleContext* context = gtk_widget_get_style_context(dc->ih->handle);
@@ -30,6 +30,7 @@ int iupgtkSetMnemonicTitle(Ihandle* ih, GtkLabel* label, const char* value);
 char* iupgtkStrConvertToUTF8(const char* str);
 char* iupgtkStrConvertFromUTF8(const char* str);
 void iupgtkReleaseConvertUTF8(void);
+void iupgtkLoopRelease(void);
 char* iupgtkStrConvertFromFilename(const char* str);
 char* iupgtkStrConvertToFilename(const char* str);
 void iupgtkUpdateMnemonic(Ihandle* ih);
@@ -71,6 +72,9 @@ PangoLayout* iupgtkGetPangoLayout(const char* value);
 char* iupgtkFindPangoFontDesc(PangoFontDescription* fontdesc);
 void iupgtkFontUpdatePangoLayout(Ihandle* ih, PangoLayout* layout);
 void iupgtkFontUpdateObjectPangoLayout(Ihandle* ih, gpointer object);
+void iupgtkFontTextCacheClear(void);
+void iupgtkFontTextCacheSetSize(int size);
+void iupgtkFontTextCacheGetInfo(int *size, unsigned long *hits, unsigned long *misses);
 
 /* There are PANGO_SCALE Pango units in one device unit. 
   For an output backend where a device unit is a pixel, 
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
 
 #include <gtk/gtk.h>
 
@@ -33,9 +34,349 @@ typedef struct _IgtkFont
   int charwidth, charheight;
 } IgtkFont;
 
-static Iarray* gtk_fonts = NULL;
+/* Each font is registered with all the names used to find it,
+   the font strings as given in the FONT attribute and its canonical name.
+   So different strings that describe the same font share the same IgtkFont. */
+typedef struct _IgtkFontName
+{
+  char* name;
+  unsigned int hash;
+  IgtkFont* gtkfont;
+  struct _IgtkFontName* next;
+} IgtkFontName;
+
+static Iarray* gtk_fonts = NULL;   /* array of IgtkFont*, each font is allocated so its address does not change */
+static IgtkFontName** gtk_fonts_table = NULL;  /* hash table of names, size is a power of 2 */
+static int gtk_fonts_table_size = 0, 
+           gtk_fonts_name_count = 0;
 static PangoContext *gtk_fonts_context = NULL;
 
+
+/* Text Width Cache
+   Measuring a string runs a full Pango layout, 
+   and the same strings are measured many times during the layout computation.
+   So the last measured widths are stored in a hash table with an LRU list,
+   the key is the font, the markup flag and the string. */
+
+typedef struct _IgtkTextItem
+{
+  IgtkFont* gtkfont;
+  int markup, len, width;
+  unsigned int hash;
+  char* str;
+  struct _IgtkTextItem *hash_next, 
+                       *lru_prev, *lru_next;
+} IgtkTextItem;
+
+static IgtkTextItem* gtk_textcache_items = NULL;   /* all the items, allocated when first used */
+static IgtkTextItem** gtk_textcache_table = NULL;  /* hash table, size is a power of 2 */
+static IgtkTextItem* gtk_textcache_first = NULL;   /* most recently used */
+static IgtkTextItem* gtk_textcache_last = NULL;    /* least recently used, reused when full */
+static int gtk_textcache_size = 4096,
+           gtk_textcache_count = 0,
+           gtk_textcache_table_size = 0;
+static unsigned long gtk_textcache_hits = 0,
+                     gtk_textcache_misses = 0;
+
+static unsigned int gtkTextCacheHash(IgtkFont* gtkfont, int markup, const char* str, int len)
+{
+  /* FNV-1a */
+  unsigned int hash = 2166136261u;
+  int i;
+  for (i = 0; i < len; i++)
+  {
+    hash ^= (unsigned char)str[i];
+    hash *= 16777619u;
+  }
+  hash ^= (unsigned int)((size_t)gtkfont >> 4);
+  hash *= 16777619u;
+  if (markup)
+    hash = ~hash;
+  return hash;
+}
+
+static void gtkTextCacheFree(void)
+{
+  int i;
+  for (i = 0; i < gtk_textcache_count; i++)
+    free(gtk_textcache_items[i].str);
+
+  free(gtk_textcache_items);
+  free(gtk_textcache_table);
+
+  gtk_textcache_items = NULL;
+  gtk_textcache_table = NULL;
+  gtk_textcache_first = NULL;
+  gtk_textcache_last = NULL;
+  gtk_textcache_count = 0;
+  gtk_textcache_table_size = 0;
+}
+
+static void gtkTextCacheAlloc(void)
+{
+  gtk_textcache_table_size = 64;
+  while (gtk_textcache_table_size < gtk_textcache_size)
+    gtk_textcache_table_size *= 2;
+
+  gtk_textcache_items = (IgtkTextItem*)calloc(gtk_textcache_size, sizeof(IgtkTextItem));
+  gtk_textcache_table = (IgtkTextItem**)calloc(gtk_textcache_table_size, sizeof(IgtkTextItem*));
+}
+
+static void gtkTextCacheUnlink(IgtkTextItem* item)
+{
+  if (item->lru_prev)
+    item->lru_prev->lru_next = item->lru_next;
+  else
+    gtk_textcache_first = item->lru_next;
+
+  if (item->lru_next)
+    item->lru_next->lru_prev = item->lru_prev;
+  else
+    gtk_textcache_last = item->lru_prev;
+}
+
+static void gtkTextCachePushFirst(IgtkTextItem* item)
+{
+  item->lru_prev = NULL;
+  item->lru_next = gtk_textcache_first;
+  if (gtk_textcache_first)
+    gtk_textcache_first->lru_prev = item;
+  gtk_textcache_first = item;
+  if (!gtk_textcache_last)
+    gtk_textcache_last = item;
+}
+
+static IgtkTextItem* gtkTextCacheFind(IgtkFont* gtkfont, int markup, const char* str, int len, unsigned int hash)
+{
+  IgtkTextItem* item = gtk_textcache_table[hash & (gtk_textcache_table_size-1)];
+  while (item)
+  {
+    if (item->hash == hash && item->gtkfont == gtkfont && item->markup == markup && 
+        item->len == len && memcmp(item->str, str, len) == 0)
+      return item;
+    item = item->hash_next;
+  }
+  return NULL;
+}
+
+static void gtkTextCacheAdd(IgtkFont* gtkfont, int markup, const char* str, int len, unsigned int hash, int width)
+{
+  IgtkTextItem* item;
+  IgtkTextItem** bucket;
+
+  if (gtk_textcache_count < gtk_textcache_size)
+  {
+    item = gtk_textcache_items + gtk_textcache_count;
+    gtk_textcache_count++;
+  }
+  else
+  {
+    /* reuse the least recently used item */
+    item = gtk_textcache_last;
+    gtkTextCacheUnlink(item);
+
+    bucket = gtk_textcache_table + (item->hash & (gtk_textcache_table_size-1));
+    while (*bucket != item)
+      bucket = &((*bucket)->hash_next);
+    *bucket = item->hash_next;
+
+    free(item->str);
+  }
+
+  item->gtkfont = gtkfont;
+  item->markup = markup;
+  item->len = len;
+  item->width = width;
+  item->hash = hash;
+  item->str = (char*)malloc(len+1);
+  memcpy(item->str, str, len);
+  item->str[len] = 0;
+
+  bucket = gtk_textcache_table + (hash & (gtk_textcache_table_size-1));
+  item->hash_next = *bucket;
+  *bucket = item;
+
+  gtkTextCachePushFirst(item);
+}
+
+void iupgtkFontTextCacheClear(void)
+{
+  int i;
+  for (i = 0; i < gtk_textcache_count; i++)
+  {
+    free(gtk_textcache_items[i].str);
+    gtk_textcache_items[i].str = NULL;
+  }
+
+  if (gtk_textcache_table)
+    memset(gtk_textcache_table, 0, gtk_textcache_table_size*sizeof(IgtkTextItem*));
+
+  gtk_textcache_first = NULL;
+  gtk_textcache_last = NULL;
+  gtk_textcache_count = 0;
+}
+
+void iupgtkFontTextCacheSetSize(int size)
+{
+  gtkTextCacheFree();
+
+  if (size < 0) 
+    size = 0;
+  gtk_textcache_size = size;  /* 0 disables the cache */
+  gtk_textcache_hits = 0;
+  gtk_textcache_misses = 0;
+}
+
+void iupgtkFontTextCacheGetInfo(int *size, unsigned long *hits, unsigned long *misses)
+{
+  if (size) *size = gtk_textcache_size;
+  if (hits) *hits = gtk_textcache_hits;
+  if (misses) *misses = gtk_textcache_misses;
+}
+
+static int gtkFontMeasureText(IgtkFont* gtkfont, const char* utf8_str, int len, int markup)
+{
+  int w;
+
+  if (markup)
+    pango_layout_set_markup(gtkfont->layout, utf8_str, len);
+  else
+    pango_layout_set_text(gtkfont->layout, utf8_str, len);
+
+  pango_layout_get_pixel_size(gtkfont->layout, &w, NULL);
+  return w;
+}
+
+static int gtkFontGetTextWidth(Ihandle* ih, IgtkFont* gtkfont, const char* str, int first_line)
+{
+  int markup = iupAttribGetBoolean(ih, "MARKUP");
+  unsigned int hash;
+  IgtkTextItem* item;
+  int w, len;
+
+  /* the length and the cache key are of the converted string, 
+     its length can be different from the original */
+  str = iupgtkStrConvertToUTF8(str);
+  if (first_line)
+  {
+    const char* line_end = strchr(str, '\n');
+    if (line_end)
+      len = (int)(line_end-str);
+    else
+      len = (int)strlen(str);
+  }
+  else
+    len = (int)strlen(str);
+
+  if (gtk_textcache_size == 0)
+    return gtkFontMeasureText(gtkfont, str, len, markup);
+
+  if (!gtk_textcache_items)
+    gtkTextCacheAlloc();
+
+  hash = gtkTextCacheHash(gtkfont, markup, str, len);
+  item = gtkTextCacheFind(gtkfont, markup, str, len, hash);
+  if (item)
+  {
+    gtk_textcache_hits++;
+
+    if (item != gtk_textcache_first)
+    {
+      gtkTextCacheUnlink(item);
+      gtkTextCachePushFirst(item);
+    }
+    return item->width;
+  }
+
+  gtk_textcache_misses++;
+
+  w = gtkFontMeasureText(gtkfont, str, len, markup);
+  gtkTextCacheAdd(gtkfont, markup, str, len, hash, w);
+  return w;
+}
+
+
+static unsigned int gtkFontHashName(const char* name)
+{
+  /* FNV-1a, case insensitive */
+  unsigned int hash = 2166136261u;
+  while (*name)
+  {
+    hash ^= (unsigned char)tolower(*name);
+    hash *= 16777619u;
+    name++;
+  }
+  return hash;
+}
+
+static IgtkFont* gtkFontFindName(const char* name, unsigned int hash)
+{
+  IgtkFontName* fontname = gtk_fonts_table[hash & (gtk_fonts_table_size-1)];
+  while (fontname)
+  {
+    if (fontname->hash == hash && iupStrEqualNoCase(fontname->name, name))
+      return fontname->gtkfont;
+    fontname = fontname->next;
+  }
+  return NULL;
+}
+
+static void gtkFontAddName(const char* name, unsigned int hash, IgtkFont* gtkfont)
+{
+  IgtkFontName* fontname;
+  int index;
+
+  if (gtk_fonts_name_count >= gtk_fonts_table_size)
+  {
+    /* grow the table and rehash */
+    int i, new_size = 2*gtk_fonts_table_size;
+    IgtkFontName** new_table = (IgtkFontName**)calloc(new_size, sizeof(IgtkFontName*));
+    for (i = 0; i < gtk_fonts_table_size; i++)
+    {
+      IgtkFontName* next;
+      for (fontname = gtk_fonts_table[i]; fontname; fontname = next)
+      {
+        next = fontname->next;
+        index = fontname->hash & (new_size-1);
+        fontname->next = new_table[index];
+        new_table[index] = fontname;
+      }
+    }
+    free(gtk_fonts_table);
+    gtk_fonts_table = new_table;
+    gtk_fonts_table_size = new_size;
+  }
+
+  fontname = (IgtkFontName*)malloc(sizeof(IgtkFontName));
+  fontname->name = iupStrDup(name);
+  fontname->hash = hash;
+  fontname->gtkfont = gtkfont;
+
+  index = hash & (gtk_fonts_table_size-1);
+  fontname->next = gtk_fonts_table[index];
+  gtk_fonts_table[index] = fontname;
+  gtk_fonts_name_count++;
+}
+
+static int gtkFontParse(const char* standardfont, char* typeface, int *size, int *is_bold, int *is_italic, int *is_underline, int *is_strikeout, int *is_pango)
+{
+  /* parse only the format that matches the string */
+  *is_pango = 0;
+
+  if (standardfont[0] == '-')
+    return iupFontParseX(standardfont, typeface, size, is_bold, is_italic, is_underline, is_strikeout);
+
+  if (strchr(standardfont, ':') && 
+      iupFontParseWin(standardfont, typeface, size, is_bold, is_italic, is_underline, is_strikeout))
+    return 1;
+
+  if (!iupFontParsePango(standardfont, typeface, size, is_bold, is_italic, is_underline, is_strikeout))
+    return 0;
+
+  *is_pango = 1;
+  return 1;
+}
+
 static void gtkFontUpdate(IgtkFont* gtkfont)
 {
   PangoAttrList *attrs;
@@ -61,19 +402,15 @@ static IgtkFont* gtkFindFont(const char *standardfont)
 {
   PangoFontMetrics* metrics;
   PangoFontDescription* fontdesc;
-  int i, 
-      is_underline = 0,
-      is_strikeout = 0,
-      count = iupArrayCount(gtk_fonts);
-
-  IgtkFont* fonts = (IgtkFont*)iupArrayGetData(gtk_fonts);
+  IgtkFont* gtkfont;
+  int is_underline = 0,
+      is_strikeout = 0;
+  unsigned int hash = gtkFontHashName(standardfont);
 
   /* Check if the standardfont already exists in cache */
-  for (i = 0; i < count; i++)
-  {
-    if (iupStrEqualNoCase(standardfont, fonts[i].standardfont))
-      return &fonts[i];
-  }
+  gtkfont = gtkFontFindName(standardfont, hash);
+  if (gtkfont)
+    return gtkfont;
 
   /* not found, create a new one */
   {
@@ -83,17 +420,8 @@ static IgtkFont* gtkFindFont(const char *standardfont)
     char typeface[1024];
     const char* mapped_name;
 
-    /* parse the old Windows format first */
-    if (!iupFontParseWin(standardfont, typeface, &size, &is_bold, &is_italic, &is_underline, &is_strikeout))
-    {
-      if (!iupFontParseX(standardfont, typeface, &size, &is_bold, &is_italic, &is_underline, &is_strikeout))
-      {
-        if (!iupFontParsePango(standardfont, typeface, &size, &is_bold, &is_italic, &is_underline, &is_strikeout))
-          return NULL;
-        else
-          is_pango = 1;
-      }
-    }
+    if (!gtkFontParse(standardfont, typeface, &size, &is_bold, &is_italic, &is_underline, &is_strikeout, &is_pango))
+      return NULL;
 
     /* Map standard names to native names */
     mapped_name = iupFontGetPangoName(typeface);
@@ -107,7 +435,7 @@ static IgtkFont* gtkFindFont(const char *standardfont)
       fontdesc = pango_font_description_from_string(standardfont);
     else
     {
-      char new_standardfont[200];
+      char new_standardfont[1100];
       if (size<0)
       {
         double res = ((double)gdk_screen_get_width(gdk_screen_get_default()) / (double)gdk_screen_get_width_mm(gdk_screen_get_default())); /* pixels/mm */
@@ -125,25 +453,47 @@ static IgtkFont* gtkFindFont(const char *standardfont)
   if (!fontdesc) 
     return NULL;
 
-  /* create room in the array */
-  fonts = (IgtkFont*)iupArrayInc(gtk_fonts);
+  /* The canonical name is the normalized Pango description plus the attributes it does not support.
+     If a font with the same canonical name already exists, just register the new name for it. */
+  {
+    char canonical[300];
+    unsigned int canonical_hash;
+    char* desc = pango_font_description_to_string(fontdesc);
+    sprintf(canonical, "%.280s|%s%s", desc, is_underline? "U": "", is_strikeout? "S": "");
+    g_free(desc);
+
+    canonical_hash = gtkFontHashName(canonical);
+    gtkfont = gtkFontFindName(canonical, canonical_hash);
+    if (gtkfont)
+    {
+      pango_font_description_free(fontdesc);
+      gtkFontAddName(standardfont, hash, gtkfont);
+      return gtkfont;
+    }
 
-  strcpy(fonts[i].standardfont, standardfont);
-  fonts[i].fontdesc = fontdesc;
-  fonts[i].strikethrough = pango_attr_strikethrough_new(is_strikeout? TRUE: FALSE);
-  fonts[i].underline = pango_attr_underline_new(is_underline? PANGO_UNDERLINE_SINGLE: PANGO_UNDERLINE_NONE);
-  fonts[i].layout = pango_layout_new(gtk_fonts_context);
+    gtkfont = (IgtkFont*)malloc(sizeof(IgtkFont));
+    gtkFontAddName(canonical, canonical_hash, gtkfont);
+    gtkFontAddName(standardfont, hash, gtkfont);
+  }
+
+  *((IgtkFont**)iupArrayInc(gtk_fonts)) = gtkfont;
+
+  iupStrCopyN(gtkfont->standardfont, sizeof(gtkfont->standardfont), standardfont);
+  gtkfont->fontdesc = fontdesc;
+  gtkfont->strikethrough = pango_attr_strikethrough_new(is_strikeout? TRUE: FALSE);
+  gtkfont->underline = pango_attr_underline_new(is_underline? PANGO_UNDERLINE_SINGLE: PANGO_UNDERLINE_NONE);
+  gtkfont->layout = pango_layout_new(gtk_fonts_context);
 
   metrics = pango_context_get_metrics(gtk_fonts_context, fontdesc, pango_context_get_language(gtk_fonts_context));
-  fonts[i].charheight = pango_font_metrics_get_ascent(metrics) + pango_font_metrics_get_descent(metrics);
-  fonts[i].charheight = iupGTK_PANGOUNITS2PIXELS(fonts[i].charheight);
-  fonts[i].charwidth = pango_font_metrics_get_approximate_char_width(metrics);
-  fonts[i].charwidth = iupGTK_PANGOUNITS2PIXELS(fonts[i].charwidth);
+  gtkfont->charheight = pango_font_metrics_get_ascent(metrics) + pango_font_metrics_get_descent(metrics);
+  gtkfont->charheight = iupGTK_PANGOUNITS2PIXELS(gtkfont->charheight);
+  gtkfont->charwidth = pango_font_metrics_get_approximate_char_width(metrics);
+  gtkfont->charwidth = iupGTK_PANGOUNITS2PIXELS(gtkfont->charwidth);
   pango_font_metrics_unref(metrics); 
 
-  gtkFontUpdate(&(fonts[i]));
+  gtkFontUpdate(gtkfont);
 
-  return &fonts[i];
+  return gtkfont;
 }
 
 static PangoLayout* gtkFontGetWidgetPangoLayout(Ihandle *ih)
@@ -163,13 +513,13 @@ static IgtkFont* gtkFontCreateNativeFont(Ihandle* ih, const char* value)
     return NULL;
   }
 
-  iupAttribSetStr(ih, "_IUP_GTKFONT", (char*)gtkfont);
+  iupAttribSetStr(ih, "_IUPGTK_FONT", (char*)gtkfont);
   return gtkfont;
 }
 
 static IgtkFont* gtkFontGet(Ihandle *ih)
 {
-  IgtkFont* gtkfont = (IgtkFont*)iupAttribGet(ih, "_IUP_GTKFONT");
+  IgtkFont* gtkfont = (IgtkFont*)iupAttribGet(ih, "_IUPGTK_FONT");
   if (!gtkfont)
     gtkfont = gtkFontCreateNativeFont(ih, iupGetFontAttrib(ih));
   return gtkfont;
@@ -260,13 +610,13 @@ char* iupdrvGetSystemFont(void)
 char* iupgtkFindPangoFontDesc(PangoFontDescription* fontdesc)
 {
   int i, count = iupArrayCount(gtk_fonts);
-  IgtkFont* fonts = (IgtkFont*)iupArrayGetData(gtk_fonts);
+  IgtkFont** fonts = (IgtkFont**)iupArrayGetData(gtk_fonts);
 
   /* Check if the standardfont already exists in cache */
   for (i = 0; i < count; i++)
   {
-    if (pango_font_description_equal(fontdesc, fonts[i].fontdesc))
-      return fonts[i].standardfont;
+    if (pango_font_description_equal(fontdesc, fonts[i]->fontdesc))
+      return fonts[i]->standardfont;
   }
 
   return NULL;
@@ -376,16 +726,8 @@ void iupdrvFontGetMultiLineStringSize(Ihandle* ih, const char* str, int *w, int
 
   if (str[0])
   {
-    int dummy_h;
-
     pango_layout_set_attributes(gtkfont->layout, NULL);
-
-    if (iupAttribGetBoolean(ih, "MARKUP"))
-      pango_layout_set_markup(gtkfont->layout, iupgtkStrConvertToUTF8(str), -1);
-    else
-      pango_layout_set_text(gtkfont->layout, iupgtkStrConvertToUTF8(str), -1);
-
-    pango_layout_get_pixel_size(gtkfont->layout, &max_w, &dummy_h);
+    max_w = gtkFontGetTextWidth(ih, gtkfont, str, 0);
   }
 
   if (w) *w = max_w;
@@ -395,8 +737,6 @@ void iupdrvFontGetMultiLineStringSize(Ihandle* ih, const char* str, int *w, int
 int iupdrvFontGetStringWidth(Ihandle* ih, const char* str)
 {
   IgtkFont* gtkfont;
-  int len, w;
-  char* line_end;
 
   if (!str || str[0]==0)
     return 0;
@@ -405,19 +745,7 @@ int iupdrvFontGetStringWidth(Ihandle* ih, const char* str)
   if (!gtkfont)
     return 0;
 
-  line_end = strchr(str, '\n');
-  if (line_end)
-    len = line_end-str;
-  else
-    len = strlen(str);
-
-  if (iupAttribGetBoolean(ih, "MARKUP"))
-    pango_layout_set_markup(gtkfont->layout, iupgtkStrConvertToUTF8(str), len);
-  else
-    pango_layout_set_text(gtkfont->layout, iupgtkStrConvertToUTF8(str), len);
-
-  pango_layout_get_pixel_size(gtkfont->layout, &w, NULL);
-  return w;
+  return gtkFontGetTextWidth(ih, gtkfont, str, 1);  /* only the first line */
 }
 
 void iupdrvFontGetCharSize(Ihandle* ih, int *charwidth, int *charheight)
@@ -439,7 +767,9 @@ void iupdrvFontGetCharSize(Ihandle* ih, int *charwidth, int *charheight)
 
 void iupdrvFontInit(void)
 {
-  gtk_fonts = iupArrayCreate(50, sizeof(IgtkFont));
+  gtk_fonts = iupArrayCreate(50, sizeof(IgtkFont*));
+  gtk_fonts_table_size = 64;
+  gtk_fonts_table = (IgtkFontName**)calloc(gtk_fonts_table_size, sizeof(IgtkFontName*));
   gtk_fonts_context = gdk_pango_context_get();
   pango_context_set_language(gtk_fonts_context, gtk_get_default_language());
 }
@@ -447,13 +777,33 @@ void iupdrvFontInit(void)
 void iupdrvFontFinish(void)
 {
   int i, count = iupArrayCount(gtk_fonts);
-  IgtkFont* fonts = (IgtkFont*)iupArrayGetData(gtk_fonts);
+  IgtkFont** fonts = (IgtkFont**)iupArrayGetData(gtk_fonts);
   for (i = 0; i < count; i++)
   {
-    pango_font_description_free(fonts[i].fontdesc);
-    pango_attribute_destroy(fonts[i].strikethrough);
-    pango_attribute_destroy(fonts[i].underline);
+    pango_font_description_free(fonts[i]->fontdesc);
+    pango_attribute_destroy(fonts[i]->strikethrough);
+    pango_attribute_destroy(fonts[i]->underline);
+    g_object_unref(fonts[i]->layout);
+    free(fonts[i]);
   }
   iupArrayDestroy(gtk_fonts);
+
+  for (i = 0; i < gtk_fonts_table_size; i++)
+  {
+    IgtkFontName *fontname = gtk_fonts_table[i], *next;
+    while (fontname)
+    {
+      next = fontname->next;
+      free(fontname->name);
+      free(fontname);
+      fontname = next;
+    }
+  }
+  free(gtk_fonts_table);
+  gtk_fonts_table = NULL;
+  gtk_fonts_table_size = 0;
+  gtk_fonts_name_count = 0;
   g_object_unref(gtk_fonts_context);
+
+  gtkTextCacheFree();
 }
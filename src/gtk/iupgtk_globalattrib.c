@@ -132,6 +132,7 @@ int iupdrvSetGlobal(const char *name, const char *value)
       iupgtk_utf8autoconvert = 1;
     else
       iupgtk_utf8autoconvert = 0;
+    iupgtkFontTextCacheClear();  /* strings are measured after conversion */
     return 0;
   }
   if (iupStrEqual(name, "SHOWMENUIMAGES"))
@@ -152,6 +153,13 @@ int iupdrvSetGlobal(const char *name, const char *value)
       iupgtk_globalmenu = 0;
     return 0;
   }
+  if (iupStrEqual(name, "TEXTCACHESIZE"))
+  {
+    int size = 0;
+    iupStrToInt(value, &size);
+    iupgtkFontTextCacheSetSize(size);
+    return 0;
+  }
   return 1;
 }
 
@@ -232,5 +240,21 @@ char *iupdrvGetGlobal(const char *name)
     else
       return "NO";
   }
+  if (iupStrEqual(name, "TEXTCACHESIZE") || 
+      iupStrEqual(name, "TEXTCACHEHITS") || 
+      iupStrEqual(name, "TEXTCACHEMISSES"))
+  {
+    char *str = iupStrGetMemory(50);
+    int size;
+    unsigned long hits, misses;
+    iupgtkFontTextCacheGetInfo(&size, &hits, &misses);
+    if (iupStrEqual(name, "TEXTCACHESIZE"))
+      sprintf(str, "%d", size);
+    else if (iupStrEqual(name, "TEXTCACHEHITS"))
+      sprintf(str, "%lu", hits);
+    else
+      sprintf(str, "%lu", misses);
+    return str;
+  }
   return NULL;
 }
@@ -42,6 +42,293 @@ enum
 
 static void gtkListSelectionChanged(GtkTreeSelection* selection, Ihandle* ih);
 static void gtkListComboBoxChanged(GtkComboBox* widget, Ihandle* ih);
+static GtkTreeModel* gtkListGetModel(Ihandle* ih);
+
+
+/*********************************************************************************/
+/* Virtual Mode Model                                                             */
+/* Stores only the number of items,                                               */
+/* text and image are retrieved from VALUE_CB and IMAGE_CB when a row is drawn.   */
+/*********************************************************************************/
+
+typedef struct _iupGtkListModel
+{
+  GObject parent;
+  Ihandle* ih;
+  gint count;
+  gint stamp;
+} iupGtkListModel;
+
+typedef struct _iupGtkListModelClass
+{
+  GObjectClass parent_class;
+} iupGtkListModelClass;
+
+static GType iup_gtk_list_model_get_type (void) G_GNUC_CONST;
+static void iup_gtk_list_model_class_init (iupGtkListModelClass *_class);
+static void iup_gtk_list_model_init (iupGtkListModel *model);
+static void iup_gtk_list_model_iface_init (GtkTreeModelIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (iupGtkListModel, iup_gtk_list_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_MODEL, iup_gtk_list_model_iface_init))
+
+static void iup_gtk_list_model_class_init (iupGtkListModelClass *_class)
+{
+  (void)_class;
+}
+
+static void iup_gtk_list_model_init (iupGtkListModel *model)
+{
+  model->ih = NULL;
+  model->count = 0;
+  model->stamp = g_random_int();
+}
+
+static gboolean gtkListModelSetIter(iupGtkListModel* model, GtkTreeIter* iter, gint pos)
+{
+  if (pos < 0 || pos >= model->count)
+  {
+    iter->stamp = 0;
+    return FALSE;
+  }
+
+  /* the iter stores only the position */
+  iter->stamp = model->stamp;
+  iter->user_data = GINT_TO_POINTER(pos);
+  iter->user_data2 = NULL;
+  iter->user_data3 = NULL;
+  return TRUE;
+}
+
+static GtkTreeModelFlags gtkListModelGetFlags(GtkTreeModel *tree_model)
+{
+  (void)tree_model;
+  return GTK_TREE_MODEL_LIST_ONLY;
+}
+
+static gint gtkListModelGetNColumns(GtkTreeModel *tree_model)
+{
+  (void)tree_model;
+  return IUPGTK_LIST_LAST_DATA;
+}
+
+static GType gtkListModelGetColumnType(GtkTreeModel *tree_model, gint index)
+{
+  (void)tree_model;
+  if (index == IUPGTK_LIST_IMAGE)
+    return GDK_TYPE_PIXBUF;
+  else
+    return G_TYPE_STRING;
+}
+
+static gboolean gtkListModelGetIter(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreePath *path)
+{
+  if (gtk_tree_path_get_depth(path) != 1)
+    return FALSE;
+  return gtkListModelSetIter((iupGtkListModel*)tree_model, iter, gtk_tree_path_get_indices(path)[0]);
+}
+
+static GtkTreePath* gtkListModelGetPath(GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+  (void)tree_model;
+  return gtk_tree_path_new_from_indices(GPOINTER_TO_INT(iter->user_data), -1);
+}
+
+static void gtkListModelGetValue(GtkTreeModel *tree_model, GtkTreeIter *iter, gint column, GValue *value)
+{
+  iupGtkListModel* model = (iupGtkListModel*)tree_model;
+  Ihandle* ih = model->ih;
+  int pos = GPOINTER_TO_INT(iter->user_data)+1;  /* IUP starts at 1 */
+
+  if (column == IUPGTK_LIST_IMAGE)
+  {
+    GdkPixbuf* pixImage = NULL;
+    g_value_init(value, GDK_TYPE_PIXBUF);
+    if (ih->data->show_image)
+    {
+      char* name = iupListGetVirtualImage(ih, pos);
+      if (name)
+        pixImage = iupImageGetImage(name, ih, 0);
+    }
+    g_value_set_object(value, pixImage);
+  }
+  else
+  {
+    char* text = iupListGetVirtualValue(ih, pos);
+    g_value_init(value, G_TYPE_STRING);
+    g_value_set_string(value, iupgtkStrConvertToUTF8(text));
+  }
+}
+
+static gboolean gtkListModelIterNext(GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+  return gtkListModelSetIter((iupGtkListModel*)tree_model, iter, GPOINTER_TO_INT(iter->user_data)+1);
+}
+
+static gboolean gtkListModelIterChildren(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent)
+{
+  if (parent)
+  {
+    iter->stamp = 0;
+    return FALSE;
+  }
+  return gtkListModelSetIter((iupGtkListModel*)tree_model, iter, 0);
+}
+
+static gboolean gtkListModelIterHasChild(GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+  (void)tree_model;
+  (void)iter;
+  return FALSE;
+}
+
+static gint gtkListModelIterNChildren(GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+  if (iter)
+    return 0;
+  return ((iupGtkListModel*)tree_model)->count;
+}
+
+static gboolean gtkListModelIterNthChild(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent, gint n)
+{
+  if (parent)
+  {
+    iter->stamp = 0;
+    return FALSE;
+  }
+  return gtkListModelSetIter((iupGtkListModel*)tree_model, iter, n);
+}
+
+static gboolean gtkListModelIterParent(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *child)
+{
+  (void)tree_model;
+  (void)child;
+  iter->stamp = 0;
+  return FALSE;
+}
+
+static void iup_gtk_list_model_iface_init (GtkTreeModelIface *iface)
+{
+  iface->get_flags = gtkListModelGetFlags;
+  iface->get_n_columns = gtkListModelGetNColumns;
+  iface->get_column_type = gtkListModelGetColumnType;
+  iface->get_iter = gtkListModelGetIter;
+  iface->get_path = gtkListModelGetPath;
+  iface->get_value = gtkListModelGetValue;
+  iface->iter_next = gtkListModelIterNext;
+  iface->iter_children = gtkListModelIterChildren;
+  iface->iter_has_child = gtkListModelIterHasChild;
+  iface->iter_n_children = gtkListModelIterNChildren;
+  iface->iter_nth_child = gtkListModelIterNthChild;
+  iface->iter_parent = gtkListModelIterParent;
+}
+
+static GtkTreeModel* gtkListModelNew(Ihandle* ih)
+{
+  iupGtkListModel* model = g_object_new(iup_gtk_list_model_get_type(), NULL);
+  model->ih = ih;
+  model->count = ih->data->virtual_count;
+  return GTK_TREE_MODEL(model);
+}
+
+typedef struct _IgtkListRanges
+{
+  int *ranges, count, max;
+} IgtkListRanges;
+
+static void gtkListAddSelectedRange(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, IgtkListRanges* sel)
+{
+  int pos = gtk_tree_path_get_indices(path)[0];
+
+  /* rows are visited in ascending order */
+  if (sel->count > 0 && sel->ranges[2*sel->count-1] == pos-1)
+    sel->ranges[2*sel->count-1] = pos;
+  else
+  {
+    if (sel->count == sel->max)
+    {
+      sel->max += 50;
+      sel->ranges = (int*)realloc(sel->ranges, 2*sel->max*sizeof(int));
+    }
+
+    sel->ranges[2*sel->count] = pos;
+    sel->ranges[2*sel->count+1] = pos;
+    sel->count++;
+  }
+
+  (void)model;
+  (void)iter;
+}
+
+static void gtkListUpdateSelectedRanges(Ihandle* ih, GtkTreeSelection* selection, IFniii cb)
+{
+  /* if cb is NULL just updates the stored selection */
+  IgtkListRanges sel;
+  sel.ranges = NULL;
+  sel.count = 0;
+  sel.max = 0;
+
+  gtk_tree_selection_selected_foreach(selection, (GtkTreeSelectionForeachFunc)gtkListAddSelectedRange, &sel);
+  iupListMultipleCallRangeCallback(ih, cb, sel.ranges, sel.count);
+
+  if (sel.ranges)
+    free(sel.ranges);
+}
+
+void iupdrvListSetVirtualCount(Ihandle* ih, int count)
+{
+  iupGtkListModel* model = (iupGtkListModel*)gtkListGetModel(ih);
+  int old_count = model->count;
+  GtkTreePath* path;
+  GtkTreeIter iter;
+
+  if (count > old_count && count-old_count <= old_count)
+  {
+    /* few items added at the end, notify only the new rows */
+    while (model->count < count)
+    {
+      model->count++;
+      path = gtk_tree_path_new_from_indices(model->count-1, -1);
+      gtkListModelSetIter(model, &iter, model->count-1);
+      gtk_tree_model_row_inserted(GTK_TREE_MODEL(model), path, &iter);
+      gtk_tree_path_free(path);
+    }
+  }
+  else if (count < old_count && old_count-count <= count)
+  {
+    /* few items removed from the end, notify only the removed rows */
+    while (model->count > count)
+    {
+      model->count--;
+      path = gtk_tree_path_new_from_indices(model->count, -1);
+      gtk_tree_model_row_deleted(GTK_TREE_MODEL(model), path);
+      gtk_tree_path_free(path);
+
+      if (!ih->data->is_multiple)
+        iupListUpdateOldValue(ih, model->count, 1);
+    }
+  }
+  else if (count != old_count)
+  {
+    /* too many rows changed, it is faster to reset the view, 
+       but the selection is lost. */
+    GtkTreeSelection* selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(ih->handle));
+
+    g_object_ref(model);
+    g_signal_handlers_block_by_func(G_OBJECT(selection), G_CALLBACK(gtkListSelectionChanged), ih);
+
+    gtk_tree_view_set_model(GTK_TREE_VIEW(ih->handle), NULL);
+    model->count = count;
+    model->stamp++;
+    gtk_tree_view_set_model(GTK_TREE_VIEW(ih->handle), GTK_TREE_MODEL(model));
+
+    g_signal_handlers_unblock_by_func(G_OBJECT(selection), G_CALLBACK(gtkListSelectionChanged), ih);
+    g_object_unref(model);
+
+    iupAttribSetStr(ih, "_IUPLIST_OLDVALUE", NULL);
+    iupListMultipleCallRangeCallback(ih, NULL, NULL, 0);
+  }
+}
 
 
 void iupdrvListAddItemSpace(Ihandle* ih, int *h)
@@ -464,6 +751,8 @@ static int gtkListSetValueAttrib(Ihandle* ih, const char* value)
         if (!value)
         {
           iupAttribSetStr(ih, "_IUPLIST_OLDVALUE", NULL);
+          if (ih->data->is_virtual)
+            iupListMultipleCallRangeCallback(ih, NULL, NULL, 0);
           return 0;
         }
 
@@ -483,6 +772,8 @@ static int gtkListSetValueAttrib(Ihandle* ih, const char* value)
           }
         }
         iupAttribStoreStr(ih, "_IUPLIST_OLDVALUE", value);
+        if (ih->data->is_virtual)
+          gtkListUpdateSelectedRanges(ih, selection, NULL);
         g_signal_handlers_unblock_by_func(G_OBJECT(selection), G_CALLBACK(gtkListSelectionChanged), ih);
       }
     }
@@ -909,10 +1200,15 @@ static char* gtkListGetReadOnlyAttrib(Ihandle* ih)
 static int gtkListSetImageAttrib(Ihandle* ih, int id, const char* value)
 {
   GtkTreeModel* model = gtkListGetModel(ih);
-  GdkPixbuf* pixImage = iupImageGetImage(value, ih, 0);
+  GdkPixbuf* pixImage;
   GtkTreeIter iter;
-  int pos = iupListGetPosAttrib(ih, id);
+  int pos;
 
+  if (ih->data->is_virtual)  /* images are provided by IMAGE_CB */
+    return 0;
+
+  pixImage = iupImageGetImage(value, ih, 0);
+  pos = iupListGetPosAttrib(ih, id);
   if (!ih->data->show_image || !gtk_tree_model_iter_nth_child(model, &iter, NULL, pos))
     return 0;
 
@@ -1393,6 +1689,12 @@ static void gtkListSelectionChanged(GtkTreeSelection* selection, Ihandle* ih)
       }
     }
   }
+  else if (ih->data->is_virtual && IupGetCallback(ih, "SELECTRANGE_CB"))
+  {
+    /* notify only the runs of items that changed */
+    IFniii range_cb = (IFniii)IupGetCallback(ih, "SELECTRANGE_CB");
+    gtkListUpdateSelectedRanges(ih, selection, range_cb);
+  }
   else
   {
     IFns multi_cb = (IFns)IupGetCallback(ih, "MULTISELECT_CB");
@@ -1574,8 +1876,19 @@ static int gtkListMapMethod(Ihandle* ih)
     GtkTreeViewColumn *column;
     GtkPolicyType scrollbar_policy;
 
-    ih->handle = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
-    g_object_unref(store);
+    if (ih->data->is_virtual)
+    {
+      GtkTreeModel* model = gtkListModelNew(ih);
+      ih->handle = gtk_tree_view_new_with_model(model);
+      g_object_unref(model);
+      g_object_unref(store);
+      store = NULL;
+    }
+    else
+    {
+      ih->handle = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
+      g_object_unref(store);
+    }
 
     if (!ih->handle)
       return IUP_ERROR;
@@ -1651,7 +1964,16 @@ static int gtkListMapMethod(Ihandle* ih)
     g_object_set(G_OBJECT(renderer), "xpad", 0, NULL);
     g_object_set(G_OBJECT(renderer), "ypad", 0, NULL);
 
+    if (ih->data->is_virtual)
+    {
+      /* rows are not measured, so items are retrieved only when displayed */
+      gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+      gtk_tree_view_column_set_expand(column, TRUE);
+    }
+
     gtk_tree_view_append_column(GTK_TREE_VIEW(ih->handle), column);
+    if (ih->data->is_virtual)
+      gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(ih->handle), TRUE);
     gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(ih->handle), FALSE);
     gtk_tree_view_set_enable_search(GTK_TREE_VIEW(ih->handle), FALSE);   /* TODO: check "start-interactive-search" signal */
 
@@ -1690,10 +2012,10 @@ static int gtkListMapMethod(Ihandle* ih)
   }
 
   /* Enable internal drag and drop support */
-  if(ih->data->show_dragdrop && !ih->data->is_dropdown && !ih->data->is_multiple)
+  if(ih->data->show_dragdrop && !ih->data->is_dropdown && !ih->data->is_multiple && !ih->data->is_virtual)
     gtkListEnableDragDrop(ih);
 
-  if (iupAttribGetBoolean(ih, "SORT"))
+  if (store && iupAttribGetBoolean(ih, "SORT"))
     gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(store), IUPGTK_LIST_TEXT, GTK_SORT_ASCENDING);
 
   /* add to the parent, all GTK controls must call this. */
@@ -12,10 +12,64 @@
 #include "iup.h"
 #include "iupcbs.h"
 
+#include "iup_str.h"
+#include "iup_drv.h"
+#include "iup_loop.h"
+#include "iup_object.h"
+
+#include "iupgtk_drv.h"
+
 
 /* local variables */
 static IFidle gtk_idle_cb = NULL;
 static guint gtk_idle_id;
+static int gtk_loop_mark = 0;  /* transient string memory position when the innermost loop started */
+static int gtk_loop_depth = 0;    /* dispatch depth when the innermost loop started */
+static GSource* gtk_loop_source = NULL;
+
+/* The loop source is never dispatched, 
+   its check function is called once in every main loop iteration before the dispatch.
+   It has a high priority, because lower priority sources are not checked 
+   when a higher priority source is ready. */
+static gboolean gtkLoopPrepare(GSource* source, gint* timeout)
+{
+  (void)source;
+  *timeout = -1;
+  return FALSE;
+}
+
+static gboolean gtkLoopCheck(GSource* source)
+{
+  (void)source;
+
+  /* the previous iteration was dispatched, release the strings returned during the dispatch.
+     But not inside a nested loop that did not take a mark (gtk_dialog_run, menu popup), 
+     the outer dispatch may still be using strings above the mark. */
+  if (g_main_depth() == gtk_loop_depth)
+    iupStrMemoryRelease(gtk_loop_mark);
+
+  return FALSE;
+}
+
+static gboolean gtkLoopDispatch(GSource* source, GSourceFunc callback, gpointer user_data)
+{
+  (void)source;
+  (void)callback;
+  (void)user_data;
+  return TRUE;
+}
+
+static GSourceFuncs gtk_loop_funcs = {gtkLoopPrepare, gtkLoopCheck, gtkLoopDispatch, NULL, NULL, NULL};
+
+void iupgtkLoopRelease(void)
+{
+  if (gtk_loop_source)
+  {
+    g_source_destroy(gtk_loop_source);
+    g_source_unref(gtk_loop_source);
+    gtk_loop_source = NULL;
+  }
+}
 
 static gboolean gtkIdleFunc(gpointer data)
 {
@@ -23,6 +77,7 @@ static gboolean gtkIdleFunc(gpointer data)
   if (gtk_idle_cb)
   {
     int ret = gtk_idle_cb();
+
     if (ret == IUP_CLOSE)
     {
       gtk_idle_cb = NULL;
@@ -52,6 +107,20 @@ void iupdrvSetIdleFunction(Icallback f)
     gtk_idle_id = g_idle_add(gtkIdleFunc, NULL);
 }
 
+static gboolean gtkPostMessageFunc(gpointer data)
+{
+  (void)data;
+  iupLoopProcessPostMessages();
+  return FALSE; /* removes the idle */
+}
+
+void iupdrvLoopWakeUp(void)
+{
+  /* g_idle_add is thread safe, 
+     the default priority is used so posted messages are not delayed by drawing */
+  g_idle_add_full(G_PRIORITY_DEFAULT, gtkPostMessageFunc, NULL, NULL);
+}
+
 void IupExitLoop(void)
 {
   if (gtk_main_iteration_do(FALSE)==FALSE)
@@ -63,22 +132,63 @@ int IupMainLoopLevel(void)
   return gtk_main_level();
 }
 
+typedef struct _IgtkLoopState
+{
+  int mark;
+  int depth;
+} IgtkLoopState;
+
+static void gtkLoopBegin(IgtkLoopState* old_state)
+{
+  if (!gtk_loop_source)
+  {
+    gtk_loop_source = g_source_new(&gtk_loop_funcs, sizeof(GSource));
+    g_source_set_priority(gtk_loop_source, G_PRIORITY_HIGH);
+    g_source_attach(gtk_loop_source, NULL);
+  }
+
+  old_state->mark = gtk_loop_mark;
+  old_state->depth = gtk_loop_depth;
+  gtk_loop_mark = iupStrMemoryMark();
+  gtk_loop_depth = g_main_depth();
+}
+
+static void gtkLoopEnd(IgtkLoopState* old_state)
+{
+  iupStrMemoryRelease(gtk_loop_mark);
+  gtk_loop_mark = old_state->mark;
+  gtk_loop_depth = old_state->depth;
+}
+
 int IupMainLoop(void)
 {
+  IgtkLoopState old_state;
+  gtkLoopBegin(&old_state);
   gtk_main();
+  gtkLoopEnd(&old_state);
   return IUP_NOERROR;
 }
 
 int IupLoopStepWait(void)
 {
-  if (gtk_main_iteration_do(TRUE))
+  IgtkLoopState old_state;
+  gboolean quit;
+  gtkLoopBegin(&old_state);
+  quit = gtk_main_iteration_do(TRUE);
+  gtkLoopEnd(&old_state);
+  if (quit)
     return IUP_CLOSE;
   return IUP_DEFAULT;
 }
 
 int IupLoopStep(void)
 {
-  if (gtk_main_iteration_do(FALSE))
+  IgtkLoopState old_state;
+  gboolean quit;
+  gtkLoopBegin(&old_state);
+  quit = gtk_main_iteration_do(FALSE);
+  gtkLoopEnd(&old_state);
+  if (quit)
     return IUP_CLOSE;
   return IUP_DEFAULT;
 }
@@ -86,6 +196,7 @@ int IupLoopStep(void)
 void IupFlush(void)
 {
   int count = 0;
+  IgtkLoopState old_state;
 
   IFidle old_gtk_idle_cb = NULL;
   if (gtk_idle_cb)
@@ -94,6 +205,8 @@ void IupFlush(void)
     iupdrvSetIdleFunction(NULL);
   }
 
+  gtkLoopBegin(&old_state);
+
   while (count<100 && gtk_events_pending())
   {
     gtk_main_iteration();
@@ -105,6 +218,8 @@ void IupFlush(void)
     count++;
   }
 
+  gtkLoopEnd(&old_state);
+
   if (old_gtk_idle_cb)
     iupdrvSetIdleFunction((Icallback)old_gtk_idle_cb);
 }
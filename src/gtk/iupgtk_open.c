@@ -345,4 +345,5 @@ int iupdrvOpen(int *argc, char ***argv)
 void iupdrvClose(void)
 {
   iupgtkReleaseConvertUTF8();
+  iupgtkLoopRelease();
 }
@@ -62,9 +62,14 @@ enum                   /* comments show cell renderer associations */
   IUPGTK_TREE_SELECTED,
   IUPGTK_TREE_CHECK,   /* "active" */
   IUPGTK_TREE_3STATE,  /* "inconsistent" */
+  IUPGTK_TREE_LAZY,    /* branch with children created on demand */
   IUPGTK_TREE_LAST_DATA  /* used as a count */
 };
 
+/* Kind of the hidden child of a lazy branch that was not populated yet.
+   It exists only to display the expand button, so it is not in the node cache. */
+#define IUPGTK_TREE_PLACEHOLDER 2
+
 static void gtkTreeRebuildNodeCache(Ihandle* ih, int id, GtkTreeIter iterItem);
 
 static void gtkTreeIterInit(Ihandle* ih, GtkTreeIter* iterItem, InodeHandle* node_handle)
@@ -100,6 +105,43 @@ static int gtkTreeToggleGetCheck(Ihandle* ih, GtkTreeStore* store, GtkTreeIter i
     return 0;
 }
 
+static int gtkTreeIsPlaceholder(GtkTreeModel* model, GtkTreeIter* iterItem)
+{
+  int kind;
+  gtk_tree_model_get(model, iterItem, IUPGTK_TREE_KIND, &kind, -1);
+  return kind == IUPGTK_TREE_PLACEHOLDER;
+}
+
+static void gtkTreeAddPlaceholder(GtkTreeModel* model, GtkTreeIter* iterItem)
+{
+  GtkTreeIter iterChild;
+
+  if (gtk_tree_model_iter_has_child(model, iterItem))
+    return;
+
+  gtk_tree_store_append(GTK_TREE_STORE(model), &iterChild, iterItem);
+  gtk_tree_store_set(GTK_TREE_STORE(model), &iterChild, IUPGTK_TREE_TITLE, "",
+                                                        IUPGTK_TREE_KIND, IUPGTK_TREE_PLACEHOLDER,
+                                                        IUPGTK_TREE_SELECTED, 0,
+                                                        IUPGTK_TREE_CHECK, 0,
+                                                        IUPGTK_TREE_3STATE, 0,
+                                                        IUPGTK_TREE_LAZY, 0,
+                                                        -1);
+}
+
+/* returns 1 if the branch had a placeholder */
+static int gtkTreeRemovePlaceholder(GtkTreeModel* model, GtkTreeIter* iterItem)
+{
+  GtkTreeIter iterChild;
+
+  if (!gtk_tree_model_iter_children(model, &iterChild, iterItem) || 
+      !gtkTreeIsPlaceholder(model, &iterChild))
+    return 0;
+
+  gtk_tree_store_remove(GTK_TREE_STORE(model), &iterChild);
+  return 1;
+}
+
 /*****************************************************************************/
 /* COPYING ITEMS (Branches and its children)                                 */
 /*****************************************************************************/
@@ -109,7 +151,7 @@ static void gtkTreeCopyItem(Ihandle* ih, GtkTreeModel* model, GtkTreeIter* iterI
   GtkTreeStore* store = GTK_TREE_STORE(model);
   int kind;
   char* title;
-  gboolean has_image, has_image_expanded;
+  gboolean has_image, has_image_expanded, lazy;
   PangoFontDescription* font;
   GdkColor *color;
   GdkPixbuf* image, *image_expanded;
@@ -122,10 +164,12 @@ static void gtkTreeCopyItem(Ihandle* ih, GtkTreeModel* model, GtkTreeIter* iterI
                                                       IUPGTK_TREE_KIND,  &kind,
                                                       IUPGTK_TREE_COLOR, &color, 
                                                       IUPGTK_TREE_FONT, &font, 
+                                                      IUPGTK_TREE_LAZY, &lazy, 
                                                       -1);
 
-  /* Add the new node */
-  ih->data->node_count++;
+  /* Add the new node, a placeholder is not a node */
+  if (kind != IUPGTK_TREE_PLACEHOLDER)
+    ih->data->node_count++;
   if (position == 2)
     gtk_tree_store_append(store, iterNewItem, iterParent);
   else if (position == 1)                                      /* copy as first child of expanded branch */
@@ -144,6 +188,7 @@ static void gtkTreeCopyItem(Ihandle* ih, GtkTreeModel* model, GtkTreeIter* iterI
                                           IUPGTK_TREE_SELECTED, 0,
                                           IUPGTK_TREE_CHECK, 0,
                                           IUPGTK_TREE_3STATE, 0,
+                                          IUPGTK_TREE_LAZY, lazy,
                                           -1);
 }
 
@@ -261,7 +306,7 @@ static void gtkTreeSelectAll(Ihandle* ih, GtkTreeModel* model, GtkTreeSelection*
 
   for (i = 0; i < ih->data->node_count; i++)
   {
-    gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[i].node_handle);
+    gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, i)->node_handle);
     gtkTreeSelectNodeRaw(model, &iterItem, selected);
   }
 
@@ -278,7 +323,7 @@ static void gtkTreeInvertAllNodeMarking(Ihandle* ih, GtkTreeModel* model, GtkTre
 
   for (i = 0; i < ih->data->node_count; i++)
   {
-    gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[i].node_handle);
+    gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, i)->node_handle);
     gtkTreeSelectNode(model, selection, &iterItem, -1);
   }
 }
@@ -299,7 +344,7 @@ static void gtkTreeSelectRange(Ihandle* ih, GtkTreeModel* model, GtkTreeSelectio
 
   for (i = 0; i < ih->data->node_count; i++)
   {
-    gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[i].node_handle);
+    gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, i)->node_handle);
     if (i < id1 || i > id2)
     {
       if (clear)
@@ -341,15 +386,15 @@ static void gtkTreeGetLastVisibleNode(Ihandle* ih, GtkTreeModel* model, GtkTreeI
 
   for (i = ih->data->node_count-1; i >= 0; i--)
   {
-    if (gtkTreeIsNodeVisible(ih, model, ih->data->node_cache[i].node_handle, &nodeLastParent))
+    if (gtkTreeIsNodeVisible(ih, model, iupTreeGetNodeData(ih, i)->node_handle, &nodeLastParent))
     {
-      gtkTreeIterInit(ih, iterItem, ih->data->node_cache[i].node_handle);
+      gtkTreeIterInit(ih, iterItem, iupTreeGetNodeData(ih, i)->node_handle);
       return;
     }
   }
 
   if (ih->data->node_count)
-    gtkTreeIterInit(ih, iterItem, ih->data->node_cache[0].node_handle);  /* root is always visible */
+    gtkTreeIterInit(ih, iterItem, iupTreeGetNodeData(ih, 0)->node_handle);  /* root is always visible */
   else
     gtkTreeIterInit(ih, iterItem, NULL);  /* invalid iter */
 }
@@ -364,15 +409,15 @@ static void gtkTreeGetNextVisibleNode(Ihandle* ih, GtkTreeModel* model, GtkTreeI
 
   for (i = id; i < ih->data->node_count; i++)
   {
-    if (gtkTreeIsNodeVisible(ih, model, ih->data->node_cache[i].node_handle, &nodeLastParent))
+    if (gtkTreeIsNodeVisible(ih, model, iupTreeGetNodeData(ih, i)->node_handle, &nodeLastParent))
     {
-      gtkTreeIterInit(ih, iterItem, ih->data->node_cache[i].node_handle);
+      gtkTreeIterInit(ih, iterItem, iupTreeGetNodeData(ih, i)->node_handle);
       return;
     }
   }
 
   if (ih->data->node_count)
-    gtkTreeIterInit(ih, iterItem, ih->data->node_cache[0].node_handle);  /* root is always visible */
+    gtkTreeIterInit(ih, iterItem, iupTreeGetNodeData(ih, 0)->node_handle);  /* root is always visible */
   else
     gtkTreeIterInit(ih, iterItem, NULL);  /* invalid iter */
 }
@@ -387,9 +432,9 @@ static void gtkTreeGetPreviousVisibleNode(Ihandle* ih, GtkTreeModel* model, GtkT
 
   for (i = id; i >= 0; i--)
   {
-    if (gtkTreeIsNodeVisible(ih, model, ih->data->node_cache[i].node_handle, &nodeLastParent))
+    if (gtkTreeIsNodeVisible(ih, model, iupTreeGetNodeData(ih, i)->node_handle, &nodeLastParent))
     {
-      gtkTreeIterInit(ih, iterItem, ih->data->node_cache[i].node_handle);
+      gtkTreeIterInit(ih, iterItem, iupTreeGetNodeData(ih, i)->node_handle);
       return;
     }
   }
@@ -409,7 +454,8 @@ static void gtkTreeCallNodeRemovedRec(Ihandle* ih, GtkTreeModel* model, GtkTreeI
   while(hasItem)
   {
     /* go recursive to children */
-    gtkTreeCallNodeRemovedRec(ih, model, &iterChild, cb, id);
+    if (!gtkTreeIsPlaceholder(model, &iterChild))
+      gtkTreeCallNodeRemovedRec(ih, model, &iterChild, cb, id);
 
     /* Go to next sibling item */
     hasItem = gtk_tree_model_iter_next(model, &iterChild);
@@ -419,16 +465,22 @@ static void gtkTreeCallNodeRemovedRec(Ihandle* ih, GtkTreeModel* model, GtkTreeI
   ih->data->node_count--;
   (*id)++;
 
-  cb(ih, (char*)ih->data->node_cache[old_id].userdata);
+  cb(ih, (char*)iupTreeGetNodeData(ih, old_id)->userdata);
 }
 
 static void gtkTreeCallNodeRemoved(Ihandle* ih, GtkTreeModel* model, GtkTreeIter *iterItem)
 {
   int old_count = ih->data->node_count;
-  int id = gtkTreeFindNodeId(ih, iterItem);
-  int old_id = id;
+  int id, old_id;
+  IFns cb;
 
-  IFns cb = (IFns)IupGetCallback(ih, "NODEREMOVED_CB");
+  if (gtkTreeIsPlaceholder(model, iterItem))  /* not in the cache */
+    return;
+
+  id = gtkTreeFindNodeId(ih, iterItem);
+  old_id = id;
+
+  cb = (IFns)IupGetCallback(ih, "NODEREMOVED_CB");
   if (cb) 
     gtkTreeCallNodeRemovedRec(ih, model, iterItem, cb, &id);
   else
@@ -449,7 +501,7 @@ static void gtkTreeCallNodeRemovedAll(Ihandle* ih)
   {
     for (i = 0; i < ih->data->node_count; i++)
     {
-      cb(ih, (char*)ih->data->node_cache[i].userdata);
+      cb(ih, (char*)iupTreeGetNodeData(ih, i)->userdata);
     }
   }
 
@@ -487,7 +539,7 @@ static Iarray* gtkTreeGetSelectedArrayId(Ihandle* ih)
 
   for (i = 0; i < ih->data->node_count; i++)
   {
-    gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[i].node_handle);
+    gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, i)->node_handle);
     if (gtkTreeIsNodeSelected(model, &iterItem))
     {
       int* id_hitem = (int*)iupArrayInc(selarray);
@@ -537,7 +589,7 @@ static void gtkTreeSetFocus(Ihandle* ih, GtkTreePath* pathFocus, GtkTreeIter* it
       iupAttribSetStr(ih, "_IUPTREE_IGNORE_SELECTION_CB", "1");
       for (i=0; i<count; i++)
       {
-        gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[id_hitem[i]].node_handle);
+        gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, id_hitem[i])->node_handle);
         gtkTreeSelectNode(model, selection, &iterItem, 1);
       }
       iupAttribSetStr(ih, "_IUPTREE_IGNORE_SELECTION_CB", NULL);
@@ -559,7 +611,7 @@ static void gtkTreeUpdateImages(Ihandle* ih, int mode)
 
   for (i=0; i<ih->data->node_count; i++)
   {
-    gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[i].node_handle);
+    gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, i)->node_handle);
 
     gtk_tree_model_get(model, &iterItem, IUPGTK_TREE_KIND, &kind, -1);
 
@@ -624,7 +676,7 @@ void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add
   GtkTreeIter iterPrev, iterNewItem, iterParent;
   GtkTreePath* path;
   GdkColor color = {0L,0,0,0};
-  int kindPrev = -1;
+  int kindPrev = -1, lazy_parent = 0;
 
   /* the previous node is not necessary only
      if adding the root in an empty tree or before the root. */
@@ -638,7 +690,11 @@ void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add
   {
     /* Add the new node */
     if (kindPrev == ITREE_BRANCH && add)
+    {
+      /* the first child of a lazy branch replaces its placeholder */
+      lazy_parent = gtkTreeRemovePlaceholder(GTK_TREE_MODEL(store), &iterPrev);
       gtk_tree_store_insert(store, &iterNewItem, &iterPrev, 0);  /* iterPrev is parent of the new item (firstchild of it) */
+    }
     else
       gtk_tree_store_insert_after(store, &iterNewItem, NULL, &iterPrev);  /* iterPrev is sibling of the new item */
     iupTreeAddToCache(ih, add, kindPrev, iterPrev.user_data, iterNewItem.user_data);
@@ -669,6 +725,7 @@ void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add
                                           IUPGTK_TREE_SELECTED, 0,
                                           IUPGTK_TREE_CHECK, 0,
                                           IUPGTK_TREE_3STATE, 0,
+                                          IUPGTK_TREE_LAZY, 0,
                                           -1);
 
   if (kind == ITREE_LEAF)
@@ -684,8 +741,9 @@ void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add
     else if (!gtk_tree_model_iter_parent(GTK_TREE_MODEL(store), &iterParent, &iterNewItem))
       return;
 
-    /* If this is the first child of the parent, then handle the ADDEXPANDED attribute */
-    if (gtk_tree_model_iter_n_children(GTK_TREE_MODEL(store), &iterParent) == 1)
+    /* If this is the first child of the parent, then handle the ADDEXPANDED attribute.
+       A lazy branch keeps its state, it is usually being populated inside the expand event. */
+    if (!lazy_parent && gtk_tree_model_iter_n_children(GTK_TREE_MODEL(store), &iterParent) == 1)
     {
       path = gtk_tree_model_get_path(GTK_TREE_MODEL(store), &iterParent);
       iupAttribSetStr(ih, "_IUPTREE_IGNORE_BRANCH_CB", "1");
@@ -727,8 +785,11 @@ static void gtkTreeChildRebuildCacheRec(Ihandle* ih, GtkTreeModel *model, GtkTre
   int hasItem = gtk_tree_model_iter_children(model, &iterChild, iterItem);  /* get the firstchild */
   while(hasItem)
   {
+    if (gtkTreeIsPlaceholder(model, &iterChild))
+      break;  /* always the only child */
+
     (*id)++;
-    ih->data->node_cache[*id].node_handle = iterChild.user_data;
+    iupTreeSetNode(ih, *id, iterChild.user_data);
 
     /* go recursive to children */
     gtkTreeChildRebuildCacheRec(ih, model, &iterChild, id);
@@ -741,7 +802,7 @@ static void gtkTreeChildRebuildCacheRec(Ihandle* ih, GtkTreeModel *model, GtkTre
 static void gtkTreeRebuildNodeCache(Ihandle* ih, int id, GtkTreeIter iterItem)
 {
   GtkTreeModel* model = gtk_tree_view_get_model(GTK_TREE_VIEW(ih->handle));
-  ih->data->node_cache[id].node_handle = iterItem.user_data;
+  iupTreeSetNode(ih, id, iterItem.user_data);
   gtkTreeChildRebuildCacheRec(ih, model, &iterItem, &id);
 }
 
@@ -751,6 +812,9 @@ static void gtkTreeChildCountRec(GtkTreeModel *model, GtkTreeIter *iterItem, int
   int hasItem = gtk_tree_model_iter_children(model, &iterChild, iterItem);  /* get the firstchild */
   while(hasItem)
   {
+    if (gtkTreeIsPlaceholder(model, &iterChild))
+      break;  /* always the only child */
+
     (*count)++;
 
     /* go recursive to children */
@@ -855,7 +919,7 @@ static void gtkTreeCallMultiSelectionCb(Ihandle* ih)
       so make sure that their selection state is stored. */
   for(i = minmax.id1; i <= minmax.id2; i++)
   {
-    gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[i].node_handle);
+    gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, i)->node_handle);
     gtkTreeSelectNodeRaw(model, &iterItem, 1);
   }
 
@@ -966,10 +1030,35 @@ static int gtkTreeSetSpacingAttrib(Ihandle* ih, const char* value)
     return 1; /* store until not mapped, when mapped will be set again */
 }
 
+static void gtkTreeExpandChildren(Ihandle* ih, GtkTreeModel* model, GtkTreeIter *iterParent)
+{
+  GtkTreeIter iterChild;
+  int hasItem = gtk_tree_model_iter_children(model, &iterChild, iterParent);  /* get the firstchild */
+  while(hasItem)
+  {
+    if (gtk_tree_model_iter_has_child(model, &iterChild))
+    {
+      GtkTreePath* path = gtk_tree_model_get_path(model, &iterChild);
+
+      /* gtk_tree_view_expand_all emits test-expand-row only for the top level branches,
+         so expand one row at a time to populate the nested lazy branches */
+      gtk_tree_view_expand_row(GTK_TREE_VIEW(ih->handle), path, FALSE);
+
+      if (gtk_tree_view_row_expanded(GTK_TREE_VIEW(ih->handle), path))
+        gtkTreeExpandChildren(ih, model, &iterChild);
+
+      gtk_tree_path_free(path);
+    }
+
+    /* Go to next sibling item */
+    hasItem = gtk_tree_model_iter_next(model, &iterChild);
+  }
+}
+
 static int gtkTreeSetExpandAllAttrib(Ihandle* ih, const char* value)
 {
   if (iupStrBoolean(value))
-    gtk_tree_view_expand_all(GTK_TREE_VIEW(ih->handle));
+    gtkTreeExpandChildren(ih, gtk_tree_view_get_model(GTK_TREE_VIEW(ih->handle)), NULL);
   else
     gtk_tree_view_collapse_all(GTK_TREE_VIEW(ih->handle));
 
@@ -1113,14 +1202,20 @@ static char* gtkTreeGetParentAttrib(Ihandle* ih, int id)
 static char* gtkTreeGetChildCountAttrib(Ihandle* ih, int id)
 {
   GtkTreeModel* model = gtk_tree_view_get_model(GTK_TREE_VIEW(ih->handle));
-  GtkTreeIter iterItem;
+  GtkTreeIter iterItem, iterChild;
+  int count;
   char* str;
 
   if (!gtkTreeFindNode(ih, id, &iterItem))
     return NULL;
 
+  count = gtk_tree_model_iter_n_children(model, &iterItem);
+  if (count == 1 && gtk_tree_model_iter_children(model, &iterChild, &iterItem) && 
+      gtkTreeIsPlaceholder(model, &iterChild))
+    count = 0;
+
   str = iupStrGetMemory(10);
-  sprintf(str, "%d", gtk_tree_model_iter_n_children(model, &iterItem));
+  sprintf(str, "%d", count);
   return str;
 }
 
@@ -1187,6 +1282,51 @@ static int gtkTreeSetStateAttrib(Ihandle* ih, int id, const char* value)
   return 0;
 }
 
+static char* gtkTreeGetLazyAttrib(Ihandle* ih, int id)
+{
+  GtkTreeModel* model = gtk_tree_view_get_model(GTK_TREE_VIEW(ih->handle));
+  GtkTreeIter iterItem;
+  gboolean lazy;
+
+  if (!gtkTreeFindNode(ih, id, &iterItem))
+    return NULL;
+
+  gtk_tree_model_get(model, &iterItem, IUPGTK_TREE_LAZY, &lazy, -1);
+  if (lazy)
+    return "YES";
+  else
+    return "NO";
+}
+
+static int gtkTreeSetLazyAttrib(Ihandle* ih, int id, const char* value)
+{
+  GtkTreeModel* model = gtk_tree_view_get_model(GTK_TREE_VIEW(ih->handle));
+  GtkTreeIter iterItem;
+  int kind;
+
+  if (!gtkTreeFindNode(ih, id, &iterItem))
+    return 0;
+
+  gtk_tree_model_get(model, &iterItem, IUPGTK_TREE_KIND, &kind, -1);
+  if (kind != ITREE_BRANCH)
+    return 0;
+
+  if (iupStrBoolean(value))
+  {
+    gtk_tree_store_set(GTK_TREE_STORE(model), &iterItem, IUPGTK_TREE_LAZY, TRUE, -1);
+
+    /* display the expand button if the branch has no children */
+    gtkTreeAddPlaceholder(model, &iterItem);
+  }
+  else
+  {
+    gtk_tree_store_set(GTK_TREE_STORE(model), &iterItem, IUPGTK_TREE_LAZY, FALSE, -1);
+    gtkTreeRemovePlaceholder(model, &iterItem);
+  }
+
+  return 0;
+}
+
 static char* gtkTreeGetTitle(GtkTreeModel* model, GtkTreeIter iterItem)
 {
   char* title;
@@ -1272,7 +1412,7 @@ static char* gtkTreeGetMarkedNodesAttrib(Ihandle* ih)
 
   for (i=0; i<ih->data->node_count; i++)
   {
-    gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[i].node_handle);
+    gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, i)->node_handle);
     if (gtkTreeIsNodeSelected(model, &iterItem))
       str[i] = '+';
     else
@@ -1304,7 +1444,7 @@ static int gtkTreeSetMarkedNodesAttrib(Ihandle* ih, const char* value)
 
   for (i=0; i<count; i++)
   {
-    gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[i].node_handle);
+    gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, i)->node_handle);
     if (value[i] == '+')
       gtkTreeSelectNode(model, selection, &iterItem, 1);
     else
@@ -1553,6 +1693,29 @@ static int gtkTreeSetToggleValueAttrib(Ihandle* ih, int id, const char* value)
   return 0;
 }
 
+static void gtkTreeRemoveChildren(Ihandle* ih, GtkTreeModel* model, GtkTreeIter *iterItem)
+{
+  GtkTreeIter iterChild;
+  gboolean lazy;
+  int hasChildren = gtk_tree_model_iter_children(model, &iterChild, iterItem);
+
+  iupAttribSetStr(ih, "_IUPTREE_IGNORE_SELECTION_CB", "1");
+
+  /* deleting the reference node children */
+  while(hasChildren)
+  {
+    gtkTreeCallNodeRemoved(ih, model, &iterChild);
+    hasChildren = gtk_tree_store_remove(GTK_TREE_STORE(model), &iterChild);
+  }
+
+  iupAttribSetStr(ih, "_IUPTREE_IGNORE_SELECTION_CB", NULL);
+
+  /* a lazy branch will be populated again when expanded */
+  gtk_tree_model_get(model, iterItem, IUPGTK_TREE_LAZY, &lazy, -1);
+  if (lazy)
+    gtkTreeAddPlaceholder(model, iterItem);
+}
+
 static int gtkTreeSetDelNodeAttrib(Ihandle* ih, int id, const char* value)
 {
   if (!ih->handle)  /* do not do the action before map */
@@ -1586,24 +1749,12 @@ static int gtkTreeSetDelNodeAttrib(Ihandle* ih, int id, const char* value)
   else if(iupStrEqualNoCase(value, "CHILDREN"))  /* children of the reference node */
   {
     GtkTreeModel* model = gtk_tree_view_get_model(GTK_TREE_VIEW(ih->handle));
-    GtkTreeIter iterItem, iterChild;
-    int hasChildren;
+    GtkTreeIter iterItem;
 
     if (!gtkTreeFindNode(ih, id, &iterItem))
       return 0;
 
-    hasChildren = gtk_tree_model_iter_children(model, &iterChild, &iterItem);
-
-    iupAttribSetStr(ih, "_IUPTREE_IGNORE_SELECTION_CB", "1");
-
-    /* deleting the reference node children */
-    while(hasChildren)
-    {
-      gtkTreeCallNodeRemoved(ih, model, &iterChild);
-      hasChildren = gtk_tree_store_remove(GTK_TREE_STORE(model), &iterChild);
-    }
-
-    iupAttribSetStr(ih, "_IUPTREE_IGNORE_SELECTION_CB", NULL);
+    gtkTreeRemoveChildren(ih, model, &iterItem);
   }
   else if(iupStrEqualNoCase(value, "MARKED"))  /* Delete the array of marked nodes */
   {
@@ -1615,7 +1766,7 @@ static int gtkTreeSetDelNodeAttrib(Ihandle* ih, int id, const char* value)
 
     for(i = 0; i < ih->data->node_count; /* increment only if not removed */)
     {
-      gtkTreeIterInit(ih, &iterItem, ih->data->node_cache[i].node_handle);
+      gtkTreeIterInit(ih, &iterItem, iupTreeGetNodeData(ih, i)->node_handle);
       if (gtkTreeIsNodeSelected(model, &iterItem))
       {
         gtkTreeCallNodeRemoved(ih, model, &iterItem);
@@ -2190,23 +2341,60 @@ static void gtkTreeRowExpanded(GtkTreeView* tree_view, GtkTreeIter *iterItem, Gt
   (void)path;
 }
 
+static int gtkTreePopulateLazy(Ihandle* ih, GtkTreeModel* model, GtkTreeIter *iterItem)
+{
+  IFni cbBranchPopulate = (IFni)IupGetCallback(ih, "BRANCHPOPULATE_CB");
+  if (cbBranchPopulate && cbBranchPopulate(ih, gtkTreeFindNodeId(ih, iterItem)) == IUP_IGNORE)
+    return 0;  /* keep the placeholder, try again next time */
+
+  /* the placeholder is removed when the first child is added, 
+     if it is still there the branch is empty */
+  if (gtkTreeRemovePlaceholder(model, iterItem))
+    return 0;
+
+  return 1;
+}
+
 static gboolean gtkTreeTestExpandRow(GtkTreeView* tree_view, GtkTreeIter *iterItem, GtkTreePath *path, Ihandle* ih)
 {
+  GtkTreeModel* model = gtk_tree_view_get_model(tree_view);
+  GtkTreeIter iterChild;
   IFni cbBranchOpen = (IFni)IupGetCallback(ih, "BRANCHOPEN_CB");
-  if (cbBranchOpen)
+  if (cbBranchOpen && !iupAttribGet(ih, "_IUPTREE_IGNORE_BRANCH_CB"))
   {
-    if (iupAttribGet(ih, "_IUPTREE_IGNORE_BRANCH_CB"))
-      return FALSE;
-
     if (cbBranchOpen(ih, gtkTreeFindNodeId(ih, iterItem)) == IUP_IGNORE)
       return TRUE;  /* prevent the change */
   }
 
+  /* lazy branch, create its children now */
+  if (gtk_tree_model_iter_children(model, &iterChild, iterItem) && 
+      gtkTreeIsPlaceholder(model, &iterChild))
+  {
+    if (!gtkTreePopulateLazy(ih, model, iterItem))
+      return TRUE;  /* nothing to expand */
+  }
+
   (void)path;
-  (void)tree_view;
   return FALSE;
 }
 
+static void gtkTreeRowCollapsed(GtkTreeView* tree_view, GtkTreeIter *iterItem, GtkTreePath *path, Ihandle* ih)
+{
+  GtkTreeModel* model = gtk_tree_view_get_model(tree_view);
+  gboolean lazy;
+
+  if (!iupAttribGetBoolean(ih, "LAZYEVICT"))
+    return;
+
+  /* release the children of a collapsed lazy branch, 
+     they will be created again by BRANCHPOPULATE_CB */
+  gtk_tree_model_get(model, iterItem, IUPGTK_TREE_LAZY, &lazy, -1);
+  if (lazy && gtk_tree_model_iter_has_child(model, iterItem))
+    gtkTreeRemoveChildren(ih, model, iterItem);
+
+  (void)path;
+}
+
 static gboolean gtkTreeTestCollapseRow(GtkTreeView* tree_view, GtkTreeIter *iterItem, GtkTreePath *path, Ihandle* ih)
 {
   IFni cbBranchClose = (IFni)IupGetCallback(ih, "BRANCHCLOSE_CB");
@@ -2603,7 +2791,8 @@ static int gtkTreeMapMethod(Ihandle* ih)
     PANGO_TYPE_FONT_DESCRIPTION,     /* IUPGTK_TREE_FONT */
     G_TYPE_BOOLEAN,                  /* IUPGTK_TREE_SELECTED */
     G_TYPE_BOOLEAN,                  /* IUPGTK_TREE_CHECK */
-    G_TYPE_BOOLEAN);                 /* IUPGTK_TREE_3STATE */
+    G_TYPE_BOOLEAN,                  /* IUPGTK_TREE_3STATE */
+    G_TYPE_BOOLEAN);                 /* IUPGTK_TREE_LAZY */
 
   ih->handle = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
 
@@ -2714,6 +2903,7 @@ static int gtkTreeMapMethod(Ihandle* ih)
   g_signal_connect(G_OBJECT(ih->handle),    "row-expanded",    G_CALLBACK(gtkTreeRowExpanded), ih);
   g_signal_connect(G_OBJECT(ih->handle),    "test-expand-row", G_CALLBACK(gtkTreeTestExpandRow), ih);
   g_signal_connect(G_OBJECT(ih->handle),  "test-collapse-row", G_CALLBACK(gtkTreeTestCollapseRow), ih);
+  g_signal_connect(G_OBJECT(ih->handle),      "row-collapsed", G_CALLBACK(gtkTreeRowCollapsed), ih);
   g_signal_connect(G_OBJECT(ih->handle),      "row-activated", G_CALLBACK(gtkTreeRowActived), ih);
   g_signal_connect(G_OBJECT(ih->handle),    "key-press-event", G_CALLBACK(gtkTreeKeyPressEvent), ih);
   g_signal_connect(G_OBJECT(ih->handle),  "key-release-event", G_CALLBACK(gtkTreeKeyReleaseEvent), ih);
@@ -2796,6 +2986,7 @@ void iupdrvTreeInitClass(Iclass* ic)
 
   iupClassRegisterAttributeId(ic, "CHILDCOUNT", gtkTreeGetChildCountAttrib, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "TITLEFONT",  gtkTreeGetTitleFontAttrib,  gtkTreeSetTitleFontAttrib, IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "LAZY",       gtkTreeGetLazyAttrib,       gtkTreeSetLazyAttrib, IUPAF_NO_INHERIT);
 
   /* IupTree Attributes - MARKS */
   iupClassRegisterAttributeId(ic, "TOGGLEVALUE", gtkTreeGetToggleValueAttrib, gtkTreeSetToggleValueAttrib, IUPAF_NO_INHERIT);
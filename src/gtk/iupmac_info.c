@@ -18,6 +18,8 @@
 #include <limits.h>
 #include <errno.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <langinfo.h>
 
 #include <gtk/gtk.h>
@@ -186,6 +188,34 @@ int iupdrvSetCurrentDirectory(const char* dir)
   return chdir(dir) == 0? 1: 0;
 }
 
+void* iupdrvMapFile(const char* filename, int *size)
+{
+  struct stat status;
+  void* data;
+  int fd = open(filename, O_RDONLY);
+  if (fd == -1)
+    return NULL;
+
+  if (fstat(fd, &status) != 0 || status.st_size == 0 || status.st_size > INT_MAX)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  /* the mapping remains valid */
+  if (data == MAP_FAILED)
+    return NULL;
+
+  *size = (int)status.st_size;
+  return data;
+}
+
+void iupdrvUnmapFile(void* data, int size)
+{
+  munmap(data, (size_t)size);
+}
+
 int iupdrvGetWindowDecor(void* wnd, int *border, int *caption)
 {
   Rect rect;
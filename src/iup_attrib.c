@@ -21,6 +21,110 @@
 #include "iup_assert.h"
 
 
+/* Attributes with ids at the end of the name ("VALUE12:7") are stored in ih->attrib_id,
+   indexed by the name and the numbers, so the Id functions do not need to build a string. */
+
+#define IATTRIB_MAXNAME 100
+
+static const char* iAttribParseId(const char* str, int *id)
+{
+  int neg = 0, n = 0;
+
+  if (*str == '-')
+  {
+    neg = 1;
+    str++;
+  }
+
+  if (*str < '0' || *str > '9')
+    return NULL;
+
+  if (*str == '0' && str[1] >= '0' && str[1] <= '9')
+    return NULL;  /* leading zeros, not the same name as an Id function would build */
+
+  while (*str >= '0' && *str <= '9')
+  {
+    int d = *str - '0';
+    if (n > (2147483647 - d) / 10)
+      return NULL;  /* overflow */
+    n = n*10 + d;
+    str++;
+  }
+
+  if (neg && n == 0)
+    return NULL;  /* "-0" */
+
+  *id = neg? -n: n;
+  return str;
+}
+
+/* Splits "NAME12:7" or "NAME12" into "NAME" and the ids.
+   Only plain decimal numbers are accepted, so names like "BGCOLOR1:*" or "UTF8MODE" are kept as regular names.
+   Returns the number of ids. */
+static int iAttribSplitId(const char* name, char* base, int *id1, int *id2)
+{
+  const char* name_id = name;
+  const char* str;
+  int len;
+
+  while (*name_id)
+  {
+    if ((*name_id >= '0' && *name_id <= '9') || 
+        (*name_id == '-' && name_id[1] >= '0' && name_id[1] <= '9'))
+      break;
+    name_id++;
+  }
+
+  if (*name_id == 0)
+    return 0;
+
+  len = name_id - name;
+  if (len >= IATTRIB_MAXNAME)
+    return 0;
+
+  str = iAttribParseId(name_id, id1);
+  if (!str)
+    return 0;
+
+  if (*str == 0)
+    *id2 = IUPTABLE_NOID;
+  else if (*str == ':')
+  {
+    str = iAttribParseId(str+1, id2);
+    if (!str || *str != 0 || *id2 == IUPTABLE_NOID)
+      return 0;
+  }
+  else
+    return 0;
+
+  memcpy(base, name, len);
+  base[len] = 0;
+  return (*id2 == IUPTABLE_NOID)? 1: 2;
+}
+
+static void iAttribSetId(Ihandle* ih, const char* name, int id1, int id2, const char* value, Itable_Types itemType)
+{
+  if (!value)
+  {
+    if (ih->attrib_id)
+      iupTableRemoveId(ih->attrib_id, name, id1, id2);
+  }
+  else
+  {
+    if (!ih->attrib_id)
+      ih->attrib_id = iupTableCreate(IUPTABLE_IDINDEXED);
+
+    iupTableSetId(ih->attrib_id, name, id1, id2, (void*)value, itemType);
+  }
+}
+
+static char* iAttribGetId(Ihandle* ih, const char* name, int id1, int id2)
+{
+  if (!ih->attrib_id)
+    return NULL;
+  return iupTableGetId(ih->attrib_id, name, id1, id2);
+}
+
 int IupGetAllAttributes(Ihandle* ih, char** names, int n)
 {
   char *name;
@@ -31,7 +135,7 @@ int IupGetAllAttributes(Ihandle* ih, char** names, int n)
     return 0;
 
   if (!names || !n)
-    return iupTableCount(ih->attrib);
+    return iupTableCount(ih->attrib) + (ih->attrib_id? iupTableCount(ih->attrib_id): 0);
 
   name = iupTableFirst(ih->attrib);
   while (name)
@@ -41,15 +145,43 @@ int IupGetAllAttributes(Ihandle* ih, char** names, int n)
       names[i] = name;
       i++;
       if (i == n)
-        break;
+        return i;
     }
 
     name = iupTableNext(ih->attrib);
   }
 
+  if (ih->attrib_id)
+  {
+    name = iupTableFirst(ih->attrib_id);
+    while (name)
+    {
+      if (!iupATTRIB_ISINTERNAL(name))
+      {
+        names[i] = iupTableGetCurrIdName(ih->attrib_id);
+        i++;
+        if (i == n)
+          break;
+      }
+
+      name = iupTableNext(ih->attrib_id);
+    }
+  }
+
   return i;
 }
 
+static void iAttribAppend(char* buffer, const char* name, const char* value)
+{
+  if (buffer[0] != 0)
+    strcat(buffer,",");
+
+  strcat(buffer, name);
+  strcat(buffer,"=\"");
+  strcat(buffer, value);
+  strcat(buffer,"\"");
+}
+
 char* IupGetAttributes(Ihandle *ih)
 {
   char *buffer;
@@ -68,24 +200,30 @@ char* IupGetAttributes(Ihandle *ih)
   {
     if (!iupATTRIB_ISINTERNAL(name))
     {
-      if (buffer[0] != 0)
-        strcat(buffer,",");
-
       value = iupTableGetCurr(ih->attrib);
       if (iupAttribIsPointer(ih, name))
       {
         sprintf(sb, "%p", (void*) value);
         value = sb;
       }
-      strcat(buffer, name);
-      strcat(buffer,"=\"");
-      strcat(buffer, value);
-      strcat(buffer,"\"");
+      iAttribAppend(buffer, name, value);
     }
 
     name = iupTableNext(ih->attrib);
   }
 
+  if (ih->attrib_id)
+  {
+    name = iupTableFirst(ih->attrib_id);
+    while (name)
+    {
+      if (!iupATTRIB_ISINTERNAL(name))
+        iAttribAppend(buffer, iupTableGetCurrIdName(ih->attrib_id), iupTableGetCurr(ih->attrib_id));
+
+      name = iupTableNext(ih->attrib_id);
+    }
+  }
+
   return buffer;
 }
 
@@ -132,7 +270,7 @@ static void iAttribNotifyChildren(Ihandle *ih, const char* name, const char *val
   Ihandle* child = ih->firstchild;
   while (child)
   {
-    if (!iupTableGet(child->attrib, name))
+    if (!iupAttribGet(child, name))  /* also checks the attributes with ids */
     {
       /* set only if an inheritable attribute at the child */
       if (iAttribIsInherit(child, name))
@@ -162,19 +300,35 @@ void iupAttribUpdateChildren(Ihandle* ih)
 
     name = iupTableNext(ih->attrib);
   }
+
+  if (ih->attrib_id)
+  {
+    name = iupTableFirst(ih->attrib_id);
+    while (name)
+    {
+      /* names with ids are built on demand */
+      char* id_name = iupTableGetCurrIdName(ih->attrib_id);
+      if (!iupATTRIB_ISINTERNAL(id_name) && iAttribIsInherit(ih, id_name))
+        iAttribNotifyChildren(ih, id_name, (char*)iupTableGetCurr(ih->attrib_id));
+
+      name = iupTableNext(ih->attrib_id);
+    }
+  }
 }
 
 void iupAttribUpdate(Ihandle* ih)
 {
   char** name_array;
   char *name, *value;
-  int count, i = 0, inherit, store;
+  int count, id_count = 0, i = 0, inherit, store;
 
   count = iupTableCount(ih->attrib);
-  if (!count)
+  if (ih->attrib_id)
+    id_count = iupTableCount(ih->attrib_id);
+  if (!count && !id_count)
     return;
 
-  name_array = (char**)malloc(count * sizeof(char*));
+  name_array = (char**)malloc((count + id_count) * sizeof(char*));
 
   /* store the names before updating so we can add or remove attributes during the update */
   name = iupTableFirst(ih->attrib);
@@ -185,6 +339,20 @@ void iupAttribUpdate(Ihandle* ih)
     i++;
   }
 
+  if (id_count)
+  {
+    /* names with ids are built on demand, so they must be duplicated */
+    name = iupTableFirst(ih->attrib_id);
+    while (name)
+    {
+      name_array[i] = iupStrDup(iupTableGetCurrIdName(ih->attrib_id));
+      name = iupTableNext(ih->attrib_id);
+      i++;
+    }
+  }
+
+  count += id_count;
+
   /* for all defined attributes updates the native system */
   for (i = 0; i < count; i++)
   {
@@ -192,7 +360,7 @@ void iupAttribUpdate(Ihandle* ih)
     if (!iupATTRIB_ISINTERNAL(name))
     {
       /* retrieve from the table */
-      value = iupTableGet(ih->attrib, name);
+      value = iupAttribGet(ih, name);
 
       /* set on the class */
       store = iupClassObjectSetAttribute(ih, name, value, &inherit);
@@ -201,10 +369,13 @@ void iupAttribUpdate(Ihandle* ih)
         iAttribNotifyChildren(ih, name, value);
 
       if (store == 0)
-        iupTableRemove(ih->attrib, name); /* remove from the table acording to the class SetAttribute */
+        iupAttribSetStr(ih, name, NULL); /* remove from the table acording to the class SetAttribute */
     }
   }
 
+  for (i = count - id_count; i < count; i++)
+    free(name_array[i]);
+
   free(name_array);
 }
 
@@ -219,11 +390,7 @@ void IupSetAttributeId(Ihandle *ih, const char* name, int id, const char *value)
     return;
 
   if (iupClassObjectSetAttributeId(ih, name, id, value)!=0) /* store strings and pointers */
-  {
-    char attr[100];
-    sprintf(attr, "%s%d", name, id);
-    iupAttribSetStr(ih, attr, value);
-  }
+    iupAttribSetStrId(ih, name, id, value);
 }
 
 void IupStoreAttributeId(Ihandle *ih, const char* name, int id, const char *value)
@@ -237,11 +404,7 @@ void IupStoreAttributeId(Ihandle *ih, const char* name, int id, const char *valu
     return;
 
   if (iupClassObjectSetAttributeId(ih, name, id, value)==1) /* store only strings */
-  {
-    char attr[100];
-    sprintf(attr, "%s%d", name, id);
-    iupAttribStoreStr(ih, attr, value);
-  }
+    iupAttribStoreStrId(ih, name, id, value);
 }
 
 char* IupGetAttributeId(Ihandle *ih, const char* name, int id)
@@ -258,11 +421,7 @@ char* IupGetAttributeId(Ihandle *ih, const char* name, int id)
 
   value = iupClassObjectGetAttributeId(ih, name, id);
   if (!value)
-  {
-    char attr[100];
-    sprintf(attr, "%s%d", name, id);
-    value = iupAttribGet(ih, attr);
-  }
+    value = iupAttribGetId(ih, name, id);
 
   return value;
 }
@@ -278,11 +437,7 @@ void IupSetAttributeId2(Ihandle* ih, const char* name, int lin, int col, const c
     return;
 
   if (iupClassObjectSetAttributeId2(ih, name, lin, col, value)!=0) /* store strings and pointers */
-  {
-    char attr[100];
-    sprintf(attr, "%s%d:%d", name, lin, col);
-    iupAttribSetStr(ih, attr, value);
-  }
+    iupAttribSetStrId2(ih, name, lin, col, value);
 }
 
 void IupStoreAttributeId2(Ihandle* ih, const char* name, int lin, int col, const char* value)
@@ -296,11 +451,7 @@ void IupStoreAttributeId2(Ihandle* ih, const char* name, int lin, int col, const
     return;
 
   if (iupClassObjectSetAttributeId2(ih, name, lin, col, value)==1) /* store only strings */
-  {
-    char attr[100];
-    sprintf(attr, "%s%d:%d", name, lin, col);
-    iupAttribStoreStr(ih, attr, value);
-  }
+    iupAttribStoreStrId2(ih, name, lin, col, value);
 }
 
 char* IupGetAttributeId2(Ihandle* ih, const char* name, int lin, int col)
@@ -317,11 +468,7 @@ char* IupGetAttributeId2(Ihandle* ih, const char* name, int lin, int col)
 
   value = iupClassObjectGetAttributeId2(ih, name, lin, col);
   if (!value)
-  {
-    char attr[100];
-    sprintf(attr, "%s%d:%d", name, lin, col);
-    value = iupAttribGet(ih, attr);
-  }
+    value = iupAttribGetId2(ih, name, lin, col);
 
   return value;
 }
@@ -532,6 +679,59 @@ char* IupGetAttribute(Ihandle *ih, const char* name)
   }
 }
 
+static int iAttribCopyToBuffer(const char* value, char* buffer, int size)
+{
+  int len;
+
+  iupStrSetMemoryBuffer(NULL, 0);  /* the getter may not have used it */
+
+  if (!value)
+  {
+    buffer[0] = 0;
+    return -1;
+  }
+
+  len = strlen(value);
+  if (value == buffer)  /* the getter wrote directly in the buffer */
+    return len;
+
+  if (len > size-1)
+    len = size-1;
+  memmove(buffer, value, len);  /* value can be inside buffer */
+  buffer[len] = 0;
+  return len;
+}
+
+int IupGetAttributeBuffer(Ihandle* ih, const char* name, char* buffer, int size)
+{
+  iupASSERT(buffer!=NULL && size>0);
+  if (!buffer || size<=0)
+    return -1;
+
+  iupStrSetMemoryBuffer(buffer, size);
+  return iAttribCopyToBuffer(IupGetAttribute(ih, name), buffer, size);
+}
+
+int IupGetAttributeIdBuffer(Ihandle* ih, const char* name, int id, char* buffer, int size)
+{
+  iupASSERT(buffer!=NULL && size>0);
+  if (!buffer || size<=0)
+    return -1;
+
+  iupStrSetMemoryBuffer(buffer, size);
+  return iAttribCopyToBuffer(IupGetAttributeId(ih, name, id), buffer, size);
+}
+
+int IupGetAttributeId2Buffer(Ihandle* ih, const char* name, int lin, int col, char* buffer, int size)
+{
+  iupASSERT(buffer!=NULL && size>0);
+  if (!buffer || size<=0)
+    return -1;
+
+  iupStrSetMemoryBuffer(buffer, size);
+  return iAttribCopyToBuffer(IupGetAttributeId2(ih, name, lin, col), buffer, size);
+}
+
 float IupGetFloat(Ihandle *ih, const char* name)
 {
   float f = 0;
@@ -667,7 +867,11 @@ Ihandle* IupSetAtt(const char* handle_name, Ihandle* ih, const char* name, ...)
 
 void iupAttribSetStr(Ihandle* ih, const char* name, const char* value)
 {
-  if (!value)
+  char base[IATTRIB_MAXNAME];
+  int id1, id2;
+  if (iAttribSplitId(name, base, &id1, &id2))
+    iAttribSetId(ih, base, id1, id2, value, IUPTABLE_POINTER);
+  else if (!value)
     iupTableRemove(ih->attrib, name);
   else
     iupTableSet(ih->attrib, name, (void*)value, IUPTABLE_POINTER);
@@ -675,12 +879,36 @@ void iupAttribSetStr(Ihandle* ih, const char* name, const char* value)
 
 void iupAttribStoreStr(Ihandle* ih, const char* name, const char* value)
 {
-  if (!value)
+  char base[IATTRIB_MAXNAME];
+  int id1, id2;
+  if (iAttribSplitId(name, base, &id1, &id2))
+    iAttribSetId(ih, base, id1, id2, value, IUPTABLE_STRING);
+  else if (!value)
     iupTableRemove(ih->attrib, name);
   else
     iupTableSet(ih->attrib, name, (void*)value, IUPTABLE_STRING);
 }
 
+void iupAttribSetStrId(Ihandle *ih, const char* name, int id, const char* value)
+{
+  iAttribSetId(ih, name, id, IUPTABLE_NOID, value, IUPTABLE_POINTER);
+}
+
+void iupAttribStoreStrId(Ihandle *ih, const char* name, int id, const char* value)
+{
+  iAttribSetId(ih, name, id, IUPTABLE_NOID, value, IUPTABLE_STRING);
+}
+
+void iupAttribSetStrId2(Ihandle *ih, const char* name, int lin, int col, const char* value)
+{
+  iAttribSetId(ih, name, lin, col, value, IUPTABLE_POINTER);
+}
+
+void iupAttribStoreStrId2(Ihandle *ih, const char* name, int lin, int col, const char* value)
+{
+  iAttribSetId(ih, name, lin, col, value, IUPTABLE_STRING);
+}
+
 void iupAttribSetStrf(Ihandle *ih, const char* name, const char* f, ...)
 {
   int size;
@@ -741,16 +969,39 @@ char* iupAttribGet(Ihandle* ih, const char* name)
 {
   if (!ih || !name)
     return NULL;
+
+  if (ih->attrib_id)
+  {
+    char base[IATTRIB_MAXNAME];
+    int id1, id2;
+    if (iAttribSplitId(name, base, &id1, &id2))
+      return iupTableGetId(ih->attrib_id, base, id1, id2);
+  }
+
   return iupTableGet(ih->attrib, name);
 }
 
+char* iupAttribGetId(Ihandle* ih, const char* name, int id)
+{
+  if (!ih || !name)
+    return NULL;
+  return iAttribGetId(ih, name, id, IUPTABLE_NOID);
+}
+
+char* iupAttribGetId2(Ihandle* ih, const char* name, int lin, int col)
+{
+  if (!ih || !name)
+    return NULL;
+  return iAttribGetId(ih, name, lin, col);
+}
+
 char* iupAttribGetStr(Ihandle* ih, const char* name)
 {
   char* value;
   if (!ih || !name)
     return NULL;
 
-  value = iupTableGet(ih->attrib, name);
+  value = iupAttribGet(ih, name);
 
   if (!value && !iupATTRIB_ISINTERNAL(name))
   {
@@ -783,7 +1034,7 @@ char* iupAttribGetLocal(Ihandle* ih, const char* name)
   if (!ih || !name)
     return NULL;
 
-  value = iupTableGet(ih->attrib, name);
+  value = iupAttribGet(ih, name);
 
   if (!value && !iupATTRIB_ISINTERNAL(name))
   {
@@ -51,6 +51,27 @@ void iupAttribStoreStr(Ihandle* ih, const char* name, const char* value);
  * \ingroup attrib */
 void iupAttribSetStrf(Ihandle *ih, const char* name, const char* format, ...);
 
+/** Sets an attribute with an id only in the hash table as a pointer.
+ * Same as iupAttribSetStr(ih, "NAMEid", value), but no string is built.
+ * Attributes with ids are stored in a separate table indexed by the name and the ids.
+ * \ingroup attrib */
+void iupAttribSetStrId(Ihandle *ih, const char* name, int id, const char* value);
+
+/** Sets an attribute with an id only in the hash table as a string. 
+ * The string is internally duplicated.
+ * \ingroup attrib */
+void iupAttribStoreStrId(Ihandle *ih, const char* name, int id, const char* value);
+
+/** Sets an attribute with two ids only in the hash table as a pointer.
+ * Same as iupAttribSetStr(ih, "NAMElin:col", value), but no string is built.
+ * \ingroup attrib */
+void iupAttribSetStrId2(Ihandle *ih, const char* name, int lin, int col, const char* value);
+
+/** Sets an attribute with two ids only in the hash table as a string. 
+ * The string is internally duplicated.
+ * \ingroup attrib */
+void iupAttribStoreStrId2(Ihandle *ih, const char* name, int lin, int col, const char* value);
+
 /** Sets an integer attribute only in the hash table.
  * It will be stored as a string.
  * It ignores children.
@@ -68,6 +89,16 @@ void iupAttribSetFloat(Ihandle *ih, const char* name, float num);
  * \ingroup attrib */
 char* iupAttribGet(Ihandle* ih, const char* name);
 
+/** Returns the attribute with an id from the hash table only. 
+ * Same as iupAttribGet(ih, "NAMEid"), but no string is built.
+ * \ingroup attrib */
+char* iupAttribGetId(Ihandle* ih, const char* name, int id);
+
+/** Returns the attribute with two ids from the hash table only. 
+ * Same as iupAttribGet(ih, "NAMElin:col"), but no string is built.
+ * \ingroup attrib */
+char* iupAttribGetId2(Ihandle* ih, const char* name, int lin, int col);
+
 /** Returns the attribute from the hash table only, 
  * but if not defined then checks in its parent tree.
  * NO control implementation, NO defalt value here.
@@ -10,6 +10,7 @@
 #include "iup.h"
 
 #include "iup_object.h"
+#include "iup_attrib.h"
 #include "iup_assert.h"
 
   
@@ -18,6 +19,9 @@ char* iupGetCallbackName(Ihandle *ih, const char *name)
   void* value;
   Icallback func = (Icallback)iupTableGetFunc(ih->attrib, name, &value);
 
+  if (!func && !value && ih->attrib_id)
+    value = iupAttribGet(ih, name);  /* old fashion names can be stored with the attributes with ids */
+
   if (!func && value)
   {
     /* if not a IUPTABLE_FUNCPOINTER then it is an old fashion name */
@@ -43,6 +47,9 @@ Icallback IupGetCallback(Ihandle *ih, const char *name)
 
   func = (Icallback)iupTableGetFunc(ih->attrib, name, &value);
 
+  if (!func && !value && ih->attrib_id)
+    value = iupAttribGet(ih, name);  /* old fashion names can be stored with the attributes with ids */
+
   if (!func && value)
   {
     /* if not a IUPTABLE_FUNCPOINTER then it is an old fashion name */
@@ -65,11 +72,17 @@ Icallback IupSetCallback(Ihandle *ih, const char *name, Icallback func)
     return NULL;
 
   if (!func)
+  {
     iupTableRemove(ih->attrib, name);
+    if (ih->attrib_id)
+      iupAttribSetStr(ih, name, NULL);
+  }
   else
   {
     void* value;
     old_func = (Icallback)iupTableGetFunc(ih->attrib, name, &value);
+    if (!old_func && !value && ih->attrib_id)
+      value = iupAttribGet(ih, name);
     if (!old_func && value)
       old_func = IupGetFunction((const char*)value);
 
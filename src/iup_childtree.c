@@ -17,6 +17,7 @@
 #include "iup_assert.h" 
 #include "iup_str.h" 
 #include "iup_drv.h" 
+#include "iup_layout.h" 
 
 
 Ihandle* IupGetDialog(Ihandle* ih)
@@ -55,6 +56,8 @@ static void iChildDetach(Ihandle* parent, Ihandle* child)
   {
     if (c == child) /* Found the right child */
     {
+      iupLayoutMarkDirty(parent);
+
       if (c_prev == NULL)
         parent->firstchild = child->brother;
       else
@@ -148,6 +151,8 @@ static void iupChildTreeInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* chi
   {
     parent->firstchild = child;
     child->parent = parent;
+    iupLayoutMarkDirty(parent);
+    iupLayoutMarkDirty(child);
     return;
   }
 
@@ -167,6 +172,8 @@ static void iupChildTreeInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* chi
       else
         c_prev->brother = child;
 
+      iupLayoutMarkDirty(parent);
+      iupLayoutMarkDirty(child);
       return;
     }
 
@@ -258,6 +265,9 @@ void iupChildTreeAppend(Ihandle* parent, Ihandle* child)
       c = c->brother;
     c->brother = child;
   }
+
+  iupLayoutMarkDirty(parent);
+  iupLayoutMarkDirty(child);
 }
 
 Ihandle* IupAppend(Ihandle* parent, Ihandle* child)
@@ -19,6 +19,7 @@
 #include "iup_assert.h"
 #include "iup_register.h"
 #include "iup_globalattrib.h"
+#include "iup_layout.h"
 
 
 typedef struct _IattribFunc
@@ -68,14 +69,17 @@ static const char* iClassFindId(const char* name)
   return NULL;
 }
 
-static const char* iClassCutNameId(const char* name, const char* name_id)
+#define ICLASS_MAXNAME 100
+
+static const char* iClassCutNameId(const char* name, const char* name_id, char* str)
 {
-  char* str;
   int len = name_id - name;
   if (len == 0)
     return NULL;
 
-  str = iupStrGetMemory(len+1);
+  if (len >= ICLASS_MAXNAME)
+    len = ICLASS_MAXNAME-1;
+
   memcpy(str, name, len);
   str[len] = 0;
   return str;
@@ -97,6 +101,8 @@ int iupClassObjectSetAttributeId2(Ihandle* ih, const char* name, int id1, int id
   if (ih->iclass->has_attrib_id!=2)
     return 0;
 
+  iupLayoutMarkDirty(ih);
+
   if (name[0]==0)
     name = "IDVALUE";  /* pure numbers are used as attributes in IupList and IupMatrix, 
                           translate them into IDVALUE. */
@@ -141,6 +147,8 @@ int iupClassObjectSetAttributeId(Ihandle* ih, const char* name, int id, const ch
   if (ih->iclass->has_attrib_id==0)
     return 0;
 
+  iupLayoutMarkDirty(ih);
+
   if (name[0]==0)
     name = "IDVALUE";  /* pure numbers are used as attributes in IupList and IupMatrix, 
                           translate them into IDVALUE. */
@@ -174,12 +182,16 @@ int iupClassObjectSetAttribute(Ihandle* ih, const char* name, const char * value
 {
   IattribFunc* afunc;
 
+  /* any attribute can change the natural size */
+  iupLayoutMarkDirty(ih);
+
   if (ih->iclass->has_attrib_id!=0)
   {
     const char* name_id = iClassFindId(name);
     if (name_id)
     {
-      const char* partial_name = iClassCutNameId(name, name_id);
+      char partial_buffer[ICLASS_MAXNAME];
+      const char* partial_name = iClassCutNameId(name, name_id, partial_buffer);
       if (!partial_name)
         partial_name = "IDVALUE";  /* pure numbers are used as attributes in IupList and IupMatrix, 
                                       translate them into IDVALUE. */
@@ -348,7 +360,8 @@ char* iupClassObjectGetAttribute(Ihandle* ih, const char* name, char* *def_value
     const char* name_id = iClassFindId(name);
     if (name_id)
     {
-      const char* partial_name = iClassCutNameId(name, name_id);
+      char partial_buffer[ICLASS_MAXNAME];
+      const char* partial_name = iClassCutNameId(name, name_id, partial_buffer);
       if (!partial_name)
         partial_name = "IDVALUE";  /* pure numbers are used as attributes in IupList and IupMatrix, 
                                       translate them into IDVALUE. */
@@ -426,7 +439,8 @@ void iupClassObjectGetAttributeInfo(Ihandle* ih, const char* name, char* *def_va
     const char* name_id = iClassFindId(name);
     if (name_id)
     {
-      const char* partial_name = iClassCutNameId(name, name_id);
+      char partial_buffer[ICLASS_MAXNAME];
+      const char* partial_name = iClassCutNameId(name, name_id, partial_buffer);
       if (!partial_name)
         partial_name = "IDVALUE";  /* pure numbers are used as attributes in IupList and IupMatrix, 
                                       translate them into IDVALUE. */
@@ -490,7 +504,8 @@ int iupClassAttribIsRegistered(Iclass* ic, const char* name)
     const char* name_id = iClassFindId(name);
     if (name_id)
     {
-      const char* partial_name = iClassCutNameId(name, name_id);
+      char partial_buffer[ICLASS_MAXNAME];
+      const char* partial_name = iClassCutNameId(name, name_id, partial_buffer);
       if (!partial_name)
         partial_name = "IDVALUE";  /* pure numbers are used as attributes in IupList and IupMatrix, 
                                       translate them into IDVALUE. */
@@ -813,10 +828,8 @@ void IupSaveClassAttributes(Ihandle* ih)
               value = iupClassObjectGetAttributeId2(ih, name, lin, col);
               if (value && value[0])  /* NOT NULL and not empty */
               {
-                char str[50];
-                sprintf(str, "%s%d:%d", name, lin, col);
-                if (!iupStrEqualNoCase(value, iupAttribGet(ih, str)))     /* NOT already stored */
-                  iupAttribStoreStr(ih, str, value);
+                if (!iupStrEqualNoCase(value, iupAttribGetId2(ih, name, lin, col)))     /* NOT already stored */
+                  iupAttribStoreStrId2(ih, name, lin, col, value);
               }
             }
           }
@@ -829,10 +842,8 @@ void IupSaveClassAttributes(Ihandle* ih)
             value = iupClassObjectGetAttributeId(ih, name, id);
             if (value && value[0])  /* NOT NULL and not empty */
             {
-              char str[50];
-              sprintf(str, "%s%d", name, id);
-              if (!iupStrEqualNoCase(value, iupAttribGet(ih, str)))     /* NOT already stored */
-                iupAttribStoreStr(ih, str, value);
+              if (!iupStrEqualNoCase(value, iupAttribGetId(ih, name, id)))     /* NOT already stored */
+                iupAttribStoreStrId(ih, name, id, value);
             }
           }
         }
@@ -0,0 +1,832 @@
+/** \file
+ * \brief Simple Draw API, driver independent part.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "iup.h"
+
+#include "iup_object.h"
+#include "iup_attrib.h"
+#include "iup_str.h"
+#include "iup_image.h"
+#include "iup_drvfont.h"
+#include "iup_classbase.h"
+#include "iup_draw.h"
+#include "iup_drvdraw.h"
+
+
+/* The IdrawCanvas is a native canvas (drv) created by the driver for an IupCanvas,
+   or a RGBA canvas that is rasterized here into a memory buffer.
+   The RGBA canvas does not use the driver, so it can be used without a display
+   and in other threads, as long as ih is NULL and iupDrawImage is not called. */
+
+struct _IdrawCanvas{
+  Ihandle* ih;
+  int w, h;
+
+  IdrvCanvas* drv;   /* NULL for a RGBA canvas */
+
+  unsigned char* buffer;  /* RGBA, top-down */
+  int release_buffer;
+  int clip_x1, clip_y1, clip_x2, clip_y2;  /* always inside the canvas */
+  unsigned char bg_r, bg_g, bg_b;
+};
+
+#define IDRAW_DASH 4   /* on and off length of dashed lines */
+
+
+/*************************************************************************************/
+/*                                  RGBA Canvas                                      */
+/*************************************************************************************/
+
+
+/* 5x7 glyphs for ASCII 32 to 126, one byte per column, LSB at top */
+static const unsigned char idraw_font[95][5] = {
+  {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+  {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x55,0x22,0x50}, {0x00,0x05,0x03,0x00,0x00},
+  {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x08,0x2A,0x1C,0x2A,0x08}, {0x08,0x08,0x3E,0x08,0x08},
+  {0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x60,0x60,0x00,0x00}, {0x20,0x10,0x08,0x04,0x02},
+  {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4B,0x31},
+  {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03},
+  {0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1E}, {0x00,0x36,0x36,0x00,0x00}, {0x00,0x56,0x36,0x00,0x00},
+  {0x08,0x14,0x22,0x41,0x00}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x51,0x09,0x06},
+  {0x32,0x49,0x79,0x41,0x3E}, {0x7E,0x11,0x11,0x11,0x7E}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+  {0x7F,0x41,0x41,0x22,0x1C}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x49,0x49,0x7A},
+  {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+  {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x0C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+  {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x46,0x49,0x49,0x49,0x31},
+  {0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},
+  {0x63,0x14,0x08,0x14,0x63}, {0x07,0x08,0x70,0x08,0x07}, {0x61,0x51,0x49,0x45,0x43}, {0x00,0x7F,0x41,0x41,0x00},
+  {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x7F,0x00}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+  {0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78}, {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20},
+  {0x38,0x44,0x44,0x48,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x08,0x7E,0x09,0x01,0x02}, {0x0C,0x52,0x52,0x52,0x3E},
+  {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x44,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},
+  {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x18,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+  {0x7C,0x14,0x14,0x14,0x08}, {0x08,0x14,0x14,0x18,0x7C}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20},
+  {0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+  {0x44,0x28,0x10,0x28,0x44}, {0x0C,0x50,0x50,0x50,0x3C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+  {0x00,0x00,0x7F,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x08,0x04,0x08,0x10,0x08}
+};
+
+static unsigned int iDrawColor(unsigned char r, unsigned char g, unsigned char b)
+{
+  /* same byte order in memory for any endianness */
+  unsigned char rgba[4];
+  unsigned int color;
+  rgba[0] = r;
+  rgba[1] = g;
+  rgba[2] = b;
+  rgba[3] = 255;
+  memcpy(&color, rgba, 4);
+  return color;
+}
+
+static void iDrawSpan(IdrawCanvas* dc, int x1, int x2, int y, unsigned int color)
+{
+  unsigned int* line;
+  int n;
+
+  if (y < dc->clip_y1 || y > dc->clip_y2)
+    return;
+  if (x1 < dc->clip_x1) x1 = dc->clip_x1;
+  if (x2 > dc->clip_x2) x2 = dc->clip_x2;
+  if (x1 > x2)
+    return;
+
+  line = (unsigned int*)dc->buffer + y*dc->w + x1;
+  n = x2 - x1 + 1;
+
+  while (n >= 4)
+  {
+    line[0] = color;
+    line[1] = color;
+    line[2] = color;
+    line[3] = color;
+    line += 4;
+    n -= 4;
+  }
+  while (n > 0)
+  {
+    *line++ = color;
+    n--;
+  }
+}
+
+static void iDrawBox(IdrawCanvas* dc, int x1, int x2, int y1, int y2, unsigned int color)
+{
+  int y, size;
+  unsigned char* first;
+
+  if (x1 < dc->clip_x1) x1 = dc->clip_x1;
+  if (x2 > dc->clip_x2) x2 = dc->clip_x2;
+  if (y1 < dc->clip_y1) y1 = dc->clip_y1;
+  if (y2 > dc->clip_y2) y2 = dc->clip_y2;
+  if (x1 > x2 || y1 > y2)
+    return;
+
+  /* fill the first line, then copy it */
+  iDrawSpan(dc, x1, x2, y1, color);
+
+  first = dc->buffer + (y1*dc->w + x1)*4;
+  size = (x2 - x1 + 1)*4;
+  for (y = y1+1; y <= y2; y++)
+    memcpy(dc->buffer + (y*dc->w + x1)*4, first, size);
+}
+
+static void iDrawPixel(IdrawCanvas* dc, int x, int y, unsigned int color)
+{
+  if (x < dc->clip_x1 || x > dc->clip_x2 || y < dc->clip_y1 || y > dc->clip_y2)
+    return;
+
+  *((unsigned int*)dc->buffer + y*dc->w + x) = color;
+}
+
+static void iDrawInvertPixel(IdrawCanvas* dc, int x, int y)
+{
+  unsigned char* pixel;
+
+  if (x < dc->clip_x1 || x > dc->clip_x2 || y < dc->clip_y1 || y > dc->clip_y2)
+    return;
+
+  pixel = dc->buffer + (y*dc->w + x)*4;
+  pixel[0] = ~pixel[0];
+  pixel[1] = ~pixel[1];
+  pixel[2] = ~pixel[2];
+}
+
+/* dash is the position in the dash pattern, NULL for solid lines.
+   The point at step k along the major axis has the minor offset round(k*dminor/dmajor),
+   computed incrementally like Bresenham. Since it depends only on k, 
+   the line is clipped to the canvas before drawing and the drawn pixels are the same of the whole line. */
+static void iDrawLineRGBA(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned int color, int *dash)
+{
+  int major1, minor1, dmajor, dminor, smajor, sminor, y_major, step_major, step_minor,
+      lo, hi, k, k0, k1, minor_off, rem, offset, dash_start = 0;
+  unsigned int* buffer = (unsigned int*)dc->buffer;
+
+  if (!dash)
+  {
+    if (y1 == y2)
+    {
+      if (x1 > x2) { int t = x1; x1 = x2; x2 = t; }
+      iDrawSpan(dc, x1, x2, y1, color);
+      return;
+    }
+    if (x1 == x2)
+    {
+      int y;
+      if (y1 > y2) { int t = y1; y1 = y2; y2 = t; }
+      if (x1 < dc->clip_x1 || x1 > dc->clip_x2)
+        return;
+      if (y1 < dc->clip_y1) y1 = dc->clip_y1;
+      if (y2 > dc->clip_y2) y2 = dc->clip_y2;
+      for (y = y1; y <= y2; y++)
+        buffer[y*dc->w + x1] = color;
+      return;
+    }
+  }
+
+  y_major = abs(y2 - y1) > abs(x2 - x1);
+  if (y_major)
+  {
+    major1 = y1; minor1 = x1;
+    dmajor = abs(y2 - y1); dminor = abs(x2 - x1);
+    smajor = y1 < y2? 1: -1; sminor = x1 < x2? 1: -1;
+    step_major = smajor*dc->w; step_minor = sminor;
+  }
+  else
+  {
+    major1 = x1; minor1 = y1;
+    dmajor = abs(x2 - x1); dminor = abs(y2 - y1);
+    smajor = x1 < x2? 1: -1; sminor = y1 < y2? 1: -1;
+    step_major = smajor; step_minor = sminor*dc->w;
+  }
+
+  if (dash)
+  {
+    /* the pattern continues after the whole line, even if it is clipped */
+    dash_start = *dash;
+    *dash += dmajor + 1;
+  }
+
+  /* clip the steps on the major axis */
+  k0 = 0; 
+  k1 = dmajor;
+  if (y_major)
+  {
+    lo = smajor > 0? dc->clip_y1 - major1: major1 - dc->clip_y2;
+    hi = smajor > 0? dc->clip_y2 - major1: major1 - dc->clip_y1;
+  }
+  else
+  {
+    lo = smajor > 0? dc->clip_x1 - major1: major1 - dc->clip_x2;
+    hi = smajor > 0? dc->clip_x2 - major1: major1 - dc->clip_x1;
+  }
+  if (lo > k0) k0 = lo;
+  if (hi < k1) k1 = hi;
+  if (k0 > k1)
+    return;
+
+  /* range of the minor offset, it never decreases */
+  if (y_major)
+  {
+    lo = sminor > 0? dc->clip_x1 - minor1: minor1 - dc->clip_x2;
+    hi = sminor > 0? dc->clip_x2 - minor1: minor1 - dc->clip_x1;
+  }
+  else
+  {
+    lo = sminor > 0? dc->clip_y1 - minor1: minor1 - dc->clip_y2;
+    hi = sminor > 0? dc->clip_y2 - minor1: minor1 - dc->clip_y1;
+  }
+  if (dminor == 0)
+  {
+    if (lo > 0 || hi < 0)
+      return;
+  }
+  else
+  {
+    /* first k where round(k*dminor/dmajor) >= lo, and last k where it is <= hi.
+       Computed in double to avoid integer overflow with coordinates far away from the canvas,
+       so one step is added on each side, the exact limits are tested in the loop. */
+    double klo = ceil((2.0*dmajor*lo - dmajor)/(2.0*dminor)) - 1;
+    double khi = floor((2.0*dmajor*(hi+1.0) - dmajor - 1.0)/(2.0*dminor)) + 1;
+    if (klo > (double)k1 || khi < (double)k0)
+      return;
+    if (klo > (double)k0) k0 = (int)klo;
+    if (khi < (double)k1) k1 = (int)khi;
+  }
+
+  if (dmajor == 0)  /* a single point */
+  {
+    minor_off = 0;
+    rem = 0;
+  }
+  else
+  {
+    double num = 2.0*k0*dminor + dmajor;
+    minor_off = (int)floor(num/(2.0*dmajor));
+    rem = (int)(num - 2.0*dmajor*minor_off);
+  }
+
+  /* offset in the buffer, used only when the point is inside the canvas */
+  if (y_major)
+    offset = (major1 + smajor*k0)*dc->w + minor1 + sminor*minor_off;
+  else
+    offset = (minor1 + sminor*minor_off)*dc->w + major1 + smajor*k0;
+
+  for (k = k0; k <= k1; k++)
+  {
+    if (minor_off > hi)
+      break;
+
+    if (minor_off >= lo && (!dash || ((dash_start + k)/IDRAW_DASH)%2 == 0))
+      buffer[offset] = color;
+
+    offset += step_major;
+    rem += 2*dminor;
+    if (rem >= 2*dmajor)
+    {
+      rem -= 2*dmajor;
+      minor_off++;
+      offset += step_minor;
+    }
+  }
+}
+
+static int iDrawArcAngleInside(double angle, double a1, double a2)
+{
+  angle -= a1;
+  while (angle < 0) angle += 360;
+  while (angle >= 360) angle -= 360;
+  return angle <= a2 - a1;
+}
+
+static void iDrawArcRGBA(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned int color, int style)
+{
+  double xc = (x1 + x2)/2.0, yc = (y1 + y2)/2.0,
+         rx = (x2 - x1)/2.0, ry = (y2 - y1)/2.0;
+  int full = (a2 - a1 >= 360);
+
+  if (rx < 0) rx = -rx;
+  if (ry < 0) ry = -ry;
+
+  if (style == IUP_DRAW_FILL)
+  {
+    int y, x, ymin = (int)ceil(yc - ry), ymax = (int)floor(yc + ry);
+
+    if (ymin < dc->clip_y1) ymin = dc->clip_y1;
+    if (ymax > dc->clip_y2) ymax = dc->clip_y2;
+
+    for (y = ymin; y <= ymax; y++)
+    {
+      double dy = y - yc, half;
+      int xmin, xmax;
+
+      if (ry == 0)
+        half = rx;
+      else
+      {
+        double f = 1.0 - (dy*dy)/(ry*ry);
+        if (f < 0) continue;
+        half = rx*sqrt(f);
+      }
+
+      xmin = (int)ceil(xc - half - 0.5);
+      xmax = (int)floor(xc + half + 0.5);
+
+      if (full)
+        iDrawSpan(dc, xmin, xmax, y, color);
+      else
+      {
+        /* pie, the angle is counter clockwise and y is top-down */
+        int start = -1;
+        for (x = xmin; x <= xmax + 1; x++)
+        {
+          int inside = 0;
+          if (x <= xmax)
+          {
+            double angle = (x == xc && y == yc)? a1: atan2(yc - y, x - xc)*180.0/3.14159265358979;
+            inside = iDrawArcAngleInside(angle, a1, a2);
+          }
+
+          if (inside && start < 0)
+            start = x;
+          else if (!inside && start >= 0)
+          {
+            iDrawSpan(dc, start, x-1, y, color);
+            start = -1;
+          }
+        }
+      }
+    }
+  }
+  else
+  {
+    int i, n, dash = 0, px = 0, py = 0;
+    double t, t1 = a1*3.14159265358979/180.0, t2 = a2*3.14159265358979/180.0;
+
+    if (full)
+      t2 = t1 + 2*3.14159265358979;
+
+    /* about one segment for each 2 pixels */
+    n = (int)((t2 - t1)*(rx > ry? rx: ry)/2.0) + 8;
+
+    for (i = 0; i <= n; i++)
+    {
+      int x, y;
+      t = t1 + ((t2 - t1)*i)/n;
+      x = (int)floor(xc + rx*cos(t) + 0.5);
+      y = (int)floor(yc - ry*sin(t) + 0.5);
+
+      if (i > 0 && (x != px || y != py))
+      {
+        /* do not draw twice the shared pixel, it would break the dash pattern */
+        if (style == IUP_DRAW_STROKE_DASH)
+        {
+          dash--;
+          iDrawLineRGBA(dc, px, py, x, y, color, &dash);
+        }
+        else
+          iDrawLineRGBA(dc, px, py, x, y, color, NULL);
+      }
+      else if (i == 0)
+        iDrawPixel(dc, x, y, color);
+
+      px = x;
+      py = y;
+    }
+  }
+}
+
+static void iDrawPolygonFillRGBA(IdrawCanvas* dc, int* points, int count, unsigned int color)
+{
+  int i, j, y, ymin, ymax, n;
+  double* nodes;
+
+  ymin = ymax = points[1];
+  for (i = 1; i < count; i++)
+  {
+    if (points[2*i+1] < ymin) ymin = points[2*i+1];
+    if (points[2*i+1] > ymax) ymax = points[2*i+1];
+  }
+
+  if (ymin < dc->clip_y1) ymin = dc->clip_y1;
+  if (ymax > dc->clip_y2) ymax = dc->clip_y2;
+
+  nodes = (double*)malloc(count*sizeof(double));
+
+  for (y = ymin; y <= ymax; y++)
+  {
+    /* even-odd rule, sampling at the pixel center */
+    double yp = y + 0.5;
+
+    n = 0;
+    j = count - 1;
+    for (i = 0; i < count; i++)
+    {
+      double xi = points[2*i], yi = points[2*i+1],
+             xj = points[2*j], yj = points[2*j+1];
+
+      if ((yi <= yp && yj > yp) || (yj <= yp && yi > yp))
+        nodes[n++] = xi + (yp - yi)*(xj - xi)/(yj - yi);
+
+      j = i;
+    }
+
+    /* insertion sort, n is small */
+    for (i = 1; i < n; i++)
+    {
+      double v = nodes[i];
+      for (j = i - 1; j >= 0 && nodes[j] > v; j--)
+        nodes[j+1] = nodes[j];
+      nodes[j+1] = v;
+    }
+
+    for (i = 0; i + 1 < n; i += 2)
+      iDrawSpan(dc, (int)ceil(nodes[i] - 0.5), (int)ceil(nodes[i+1] - 0.5) - 1, y, color);
+  }
+
+  free(nodes);
+
+  /* include the border, as the native drivers */
+  for (i = 0; i < count; i++)
+  {
+    j = (i + 1)%count;
+    iDrawLineRGBA(dc, points[2*i], points[2*i+1], points[2*j], points[2*j+1], color, NULL);
+  }
+}
+
+static void iDrawTextRGBA(IdrawCanvas* dc, const char* text, int len, int x, int y, unsigned int color, const char* font)
+{
+  int size = 0, bold = 0, scale = 1, i, col, row,
+      cx = x, cy = y;
+  char typeface[1024];
+
+  if (font && iupGetFontInfo(font, typeface, &size, &bold, NULL, NULL, NULL))
+  {
+    /* the glyph is 7 pixels high, about a 8 points font at 96 DPI */
+    int height = size < 0? -size: (size*96)/72;
+    scale = height/10;
+    if (scale < 1) scale = 1;
+  }
+
+  for (i = 0; i < len; i++)
+  {
+    unsigned char c = (unsigned char)text[i];
+    const unsigned char* glyph;
+
+    if (c == '\n')
+    {
+      cx = x;
+      cy += 9*scale;
+      continue;
+    }
+
+    if (c >= 0x80 && c < 0xC0)  /* UTF-8 continuation byte */
+      continue;
+
+    if (c < 32 || c > 126)
+      c = '?';
+
+    glyph = idraw_font[c - 32];
+
+    for (col = 0; col < 5; col++)
+    {
+      for (row = 0; row < 7; row++)
+      {
+        if (glyph[col] & (1 << row))
+        {
+          int px = cx + col*scale, py = cy + row*scale;
+          iDrawBox(dc, px, px + scale - 1 + bold, py, py + scale - 1, color);
+        }
+      }
+    }
+
+    cx += (6 + bold)*scale;
+  }
+}
+
+static void iDrawImageRGBA(IdrawCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
+{
+  Ihandle* image = IupGetHandle(name);
+  unsigned char* data;
+  iupColor colors[256];
+  int w, h, bpp, i, j;
+
+  *img_w = 0;
+  *img_h = 0;
+
+  /* only images created by IupImage, IupImageRGB and IupImageRGBA */
+  if (!image)
+    return;
+  data = (unsigned char*)iupAttribGet(image, "WID");
+  if (!data)
+    return;
+
+  w = image->currentwidth;
+  h = image->currentheight;
+  bpp = iupAttribGetInt(image, "BPP");
+  *img_w = w;
+  *img_h = h;
+
+  if (bpp == 8)
+    iupImageInitColorTable(image, colors, NULL);
+
+  for (j = 0; j < h; j++)
+  {
+    int py = y + j;
+    if (py < dc->clip_y1 || py > dc->clip_y2)
+      continue;
+
+    for (i = 0; i < w; i++)
+    {
+      unsigned char r, g, b, a, *pixel;
+      int px = x + i;
+      if (px < dc->clip_x1 || px > dc->clip_x2)
+        continue;
+
+      if (bpp == 8)
+      {
+        iupColor* c = colors + data[j*w + i];
+        r = c->r; g = c->g; b = c->b; a = c->a;
+      }
+      else if (bpp == 24)
+      {
+        unsigned char* p = data + (j*w + i)*3;
+        r = p[0]; g = p[1]; b = p[2]; a = 255;
+      }
+      else
+      {
+        unsigned char* p = data + (j*w + i)*4;
+        r = p[0]; g = p[1]; b = p[2]; a = p[3];
+      }
+
+      if (a == 0)
+        continue;
+
+      if (make_inactive)
+        iupImageColorMakeInactive(&r, &g, &b, dc->bg_r, dc->bg_g, dc->bg_b);
+
+      pixel = dc->buffer + (py*dc->w + px)*4;
+      if (a == 255)
+      {
+        pixel[0] = r;
+        pixel[1] = g;
+        pixel[2] = b;
+        pixel[3] = 255;
+      }
+      else
+      {
+        pixel[0] = iupALPHABLEND(r, pixel[0], a);
+        pixel[1] = iupALPHABLEND(g, pixel[1], a);
+        pixel[2] = iupALPHABLEND(b, pixel[2], a);
+        pixel[3] = (unsigned char)(a + (pixel[3]*(255 - a))/255);
+      }
+    }
+  }
+}
+
+IdrawCanvas* iupDrawCreateCanvasRGBA(Ihandle* ih, int w, int h, unsigned char* buffer)
+{
+  IdrawCanvas* dc;
+
+  if (w <= 0 || h <= 0)
+    return NULL;
+
+  dc = calloc(1, sizeof(IdrawCanvas));
+  dc->ih = ih;
+  dc->w = w;
+  dc->h = h;
+
+  if (buffer)
+    dc->buffer = buffer;
+  else
+  {
+    dc->buffer = calloc(w*h, 4);
+    dc->release_buffer = 1;
+  }
+
+  dc->bg_r = 255;
+  dc->bg_g = 255;
+  dc->bg_b = 255;
+  if (ih)
+    iupStrToRGB(iupBaseNativeParentGetBgColorAttrib(ih), &dc->bg_r, &dc->bg_g, &dc->bg_b);
+
+  iupDrawResetClip(dc);
+  return dc;
+}
+
+unsigned char* iupDrawGetBufferRGBA(IdrawCanvas* dc)
+{
+  return dc->buffer;
+}
+
+
+/*************************************************************************************/
+/*                                  Draw API                                         */
+/*************************************************************************************/
+
+
+IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih)
+{
+  IdrawCanvas* dc;
+  IdrvCanvas* drv = iupdrvDrawCreateCanvas(ih);
+  if (!drv)
+    return NULL;
+
+  dc = calloc(1, sizeof(IdrawCanvas));
+  dc->ih = ih;
+  dc->drv = drv;
+  iupdrvDrawGetSize(drv, &dc->w, &dc->h);
+  return dc;
+}
+
+void iupDrawKillCanvas(IdrawCanvas* dc)
+{
+  if (dc->drv)
+    iupdrvDrawKillCanvas(dc->drv);
+  else if (dc->release_buffer)
+    free(dc->buffer);
+
+  free(dc);
+}
+
+void iupDrawFlush(IdrawCanvas* dc)
+{
+  /* the RGBA buffer is the result */
+  if (dc->drv)
+    iupdrvDrawFlush(dc->drv);
+}
+
+void iupDrawUpdateSize(IdrawCanvas* dc)
+{
+  /* the RGBA canvas has a fixed size */
+  if (dc->drv)
+  {
+    iupdrvDrawUpdateSize(dc->drv);
+    iupdrvDrawGetSize(dc->drv, &dc->w, &dc->h);
+  }
+}
+
+void iupDrawGetSize(IdrawCanvas* dc, int *w, int *h)
+{
+  if (w) *w = dc->w;
+  if (h) *h = dc->h;
+}
+
+void iupDrawParentBackground(IdrawCanvas* dc)
+{
+  if (dc->drv)
+    iupdrvDrawParentBackground(dc->drv);
+  else
+    iDrawBox(dc, 0, dc->w-1, 0, dc->h-1, iDrawColor(dc->bg_r, dc->bg_g, dc->bg_b));
+}
+
+void iupDrawLine(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+{
+  if (dc->drv)
+    iupdrvDrawLine(dc->drv, x1, y1, x2, y2, r, g, b, style);
+  else
+  {
+    int dash = 0;
+    iDrawLineRGBA(dc, x1, y1, x2, y2, iDrawColor(r, g, b), style==IUP_DRAW_STROKE_DASH? &dash: NULL);
+  }
+}
+
+void iupDrawRectangle(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+{
+  if (dc->drv)
+    iupdrvDrawRectangle(dc->drv, x1, y1, x2, y2, r, g, b, style);
+  else
+  {
+    unsigned int color = iDrawColor(r, g, b);
+    if (x1 > x2) { int t = x1; x1 = x2; x2 = t; }
+    if (y1 > y2) { int t = y1; y1 = y2; y2 = t; }
+
+    if (style==IUP_DRAW_FILL)
+      iDrawBox(dc, x1, x2, y1, y2, color);
+    else
+    {
+      int dash = 0, *pdash = style==IUP_DRAW_STROKE_DASH? &dash: NULL;
+      iDrawLineRGBA(dc, x1, y1, x2, y1, color, pdash);
+      iDrawLineRGBA(dc, x2, y1, x2, y2, color, pdash);
+      iDrawLineRGBA(dc, x2, y2, x1, y2, color, pdash);
+      iDrawLineRGBA(dc, x1, y2, x1, y1, color, pdash);
+    }
+  }
+}
+
+void iupDrawArc(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style)
+{
+  if (dc->drv)
+    iupdrvDrawArc(dc->drv, x1, y1, x2, y2, a1, a2, r, g, b, style);
+  else
+    iDrawArcRGBA(dc, x1, y1, x2, y2, a1, a2, iDrawColor(r, g, b), style);
+}
+
+void iupDrawPolygon(IdrawCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style)
+{
+  if (dc->drv)
+    iupdrvDrawPolygon(dc->drv, points, count, r, g, b, style);
+  else if (count > 0)
+  {
+    unsigned int color = iDrawColor(r, g, b);
+    if (style==IUP_DRAW_FILL)
+      iDrawPolygonFillRGBA(dc, points, count, color);
+    else
+    {
+      int i, dash = 0, *pdash = style==IUP_DRAW_STROKE_DASH? &dash: NULL;
+      for (i = 0; i < count; i++)
+      {
+        int j = (i + 1)%count;
+        iDrawLineRGBA(dc, points[2*i], points[2*i+1], points[2*j], points[2*j+1], color, pdash);
+      }
+    }
+  }
+}
+
+void iupDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font)
+{
+  if (dc->drv)
+    iupdrvDrawText(dc->drv, text, len, x, y, r, g, b, font);
+  else
+    iDrawTextRGBA(dc, text, len, x, y, iDrawColor(r, g, b), font);
+}
+
+void iupDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
+{
+  if (dc->drv)
+    iupdrvDrawImage(dc->drv, name, make_inactive, x, y, img_w, img_h);
+  else
+    iDrawImageRGBA(dc, name, make_inactive, x, y, img_w, img_h);
+}
+
+void iupDrawSetClipRect(IdrawCanvas* dc, int x1, int y1, int x2, int y2)
+{
+  if (dc->drv)
+    iupdrvDrawSetClipRect(dc->drv, x1, y1, x2, y2);
+  else
+  {
+    if (x1 > x2) { int t = x1; x1 = x2; x2 = t; }
+    if (y1 > y2) { int t = y1; y1 = y2; y2 = t; }
+
+    /* an empty clip area is kept as x1>x2 */
+    dc->clip_x1 = x1 < 0? 0: x1;
+    dc->clip_y1 = y1 < 0? 0: y1;
+    dc->clip_x2 = x2 > dc->w-1? dc->w-1: x2;
+    dc->clip_y2 = y2 > dc->h-1? dc->h-1: y2;
+  }
+}
+
+void iupDrawResetClip(IdrawCanvas* dc)
+{
+  if (dc->drv)
+    iupdrvDrawResetClip(dc->drv);
+  else
+  {
+    dc->clip_x1 = 0;
+    dc->clip_y1 = 0;
+    dc->clip_x2 = dc->w-1;
+    dc->clip_y2 = dc->h-1;
+  }
+}
+
+void iupDrawSelectRect(IdrawCanvas* dc, int x, int y, int w, int h)
+{
+  if (dc->drv)
+    iupdrvDrawSelectRect(dc->drv, x, y, w, h);
+  else
+  {
+    /* XOR with white, as the native drivers */
+    int i, j;
+    for (j = y; j < y + h; j++)
+      for (i = x; i < x + w; i++)
+        iDrawInvertPixel(dc, i, j);
+  }
+}
+
+void iupDrawFocusRect(IdrawCanvas* dc, int x, int y, int w, int h)
+{
+  if (dc->drv)
+    iupdrvDrawCanvasFocusRect(dc->drv, x, y, w, h);
+  else if (w > 0 && h > 0)
+  {
+    /* dotted XOR border */
+    int i;
+    for (i = x; i < x + w; i += 2)
+    {
+      iDrawInvertPixel(dc, i, y);
+      if (h > 1) iDrawInvertPixel(dc, i, y + h - 1);
+    }
+    for (i = y + 2; i < y + h - 1; i += 2)
+    {
+      iDrawInvertPixel(dc, x, i);
+      if (w > 1) iDrawInvertPixel(dc, x + w - 1, i);
+    }
+  }
+}
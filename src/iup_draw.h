@@ -29,6 +29,21 @@ enum{IUP_DRAW_FILL, IUP_DRAW_STROKE, IUP_DRAW_STROKE_DASH};
  * \ingroup draw */
 IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih);
 
+/** Creates a draw canvas that rasterizes into a RGBA memory buffer, 
+ * without using the driver. So it can be used without a display and in other threads. \n
+ * ih is optional, used only to get the parent background color. Without it the background is white. \n
+ * buffer can be NULL, then it will be allocated and released by the canvas. 
+ * Otherwise it must have w*h*4 bytes, aligned to 4 bytes. Lines are top-down, 
+ * and each pixel has the R,G,B,A bytes in this order. \n
+ * Text uses an internal 5x7 bitmap font, only the font size and bold style are used. 
+ * Images are obtained only from IupImage elements, and they are accessed in the calling thread.
+ * \ingroup draw */
+IdrawCanvas* iupDrawCreateCanvasRGBA(Ihandle* ih, int w, int h, unsigned char* buffer);
+
+/** Returns the buffer of a RGBA canvas.
+ * \ingroup draw */
+unsigned char* iupDrawGetBufferRGBA(IdrawCanvas* dc);
+
 /** Destroys the IdrawCanvas.
  * \ingroup draw */
 void iupDrawKillCanvas(IdrawCanvas* dc);
@@ -51,6 +66,9 @@ void iupDrawGetSize(IdrawCanvas* dc, int *w, int *h);
 void iupDrawParentBackground(IdrawCanvas* dc);
 
 /** Draws a line.
+ * In a RGBA canvas the line is clipped before it is rasterized, so the time depends only on the visible part,
+ * and the drawn pixels are the same as if the whole line were drawn. 
+ * IUP_DRAW_STROKE_DASH uses 4 pixels on and 4 off, along the whole line.
  * \ingroup draw */
 void iupDrawLine(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style);
 
@@ -33,6 +33,11 @@ char* iupdrvGetGlobal(const char* name);
  * \ingroup drv */
 void iupdrvSetIdleFunction(Icallback func);
 
+/** Wakes up the main loop so it will call iupLoopProcessPostMessages. 
+ * Called from IupPostMessage in any thread, so it must be thread safe.
+ * \ingroup drv */
+void iupdrvLoopWakeUp(void);
+
 /** Convert the coordinates from screen relative to client area.
  * \ingroup drv */
 void iupdrvScreenToClient(Ihandle* ih, int *x, int *y);
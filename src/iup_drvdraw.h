@@ -0,0 +1,68 @@
+/** \file
+ * \brief Driver Simple Draw API.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#ifndef __IUP_DRVDRAW_H
+#define __IUP_DRVDRAW_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** \defgroup drvdraw Driver Simple Draw API
+ * \par
+ * Each driver must export the symbols defined here.
+ * They are called by the \ref draw functions when the IdrawCanvas
+ * was created for an IupCanvas. See \ref iup_draw.h for a description of each function.
+ * \par
+ * See \ref iup_drvdraw.h
+ * \ingroup drv */
+
+
+struct _IdrvCanvas;
+typedef struct _IdrvCanvas IdrvCanvas;
+
+/** \ingroup drvdraw */
+IdrvCanvas* iupdrvDrawCreateCanvas(Ihandle* ih);
+/** \ingroup drvdraw */
+void iupdrvDrawKillCanvas(IdrvCanvas* dc);
+/** \ingroup drvdraw */
+void iupdrvDrawFlush(IdrvCanvas* dc);
+/** \ingroup drvdraw */
+void iupdrvDrawUpdateSize(IdrvCanvas* dc);
+/** \ingroup drvdraw */
+void iupdrvDrawGetSize(IdrvCanvas* dc, int *w, int *h);
+/** \ingroup drvdraw */
+void iupdrvDrawParentBackground(IdrvCanvas* dc);
+/** \ingroup drvdraw */
+void iupdrvDrawLine(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style);
+/** \ingroup drvdraw */
+void iupdrvDrawRectangle(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style);
+/** \ingroup drvdraw */
+void iupdrvDrawArc(IdrvCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style);
+/** \ingroup drvdraw */
+void iupdrvDrawPolygon(IdrvCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style);
+/** \ingroup drvdraw */
+void iupdrvDrawText(IdrvCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font);
+/** \ingroup drvdraw */
+void iupdrvDrawImage(IdrvCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h);
+/** \ingroup drvdraw */
+void iupdrvDrawSetClipRect(IdrvCanvas* dc, int x1, int y1, int x2, int y2);
+/** \ingroup drvdraw */
+void iupdrvDrawResetClip(IdrvCanvas* dc);
+/** \ingroup drvdraw */
+void iupdrvDrawSelectRect(IdrvCanvas* dc, int x, int y, int w, int h);
+/** Not the same as iupdrvDrawFocusRect in \ref iup_drv.h, that draws on a native graphics context.
+ * \ingroup drvdraw */
+void iupdrvDrawCanvasFocusRect(IdrvCanvas* dc, int x, int y, int w, int h);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
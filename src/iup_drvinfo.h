@@ -98,6 +98,14 @@ int iupdrvIsDirectory(const char* name);
  * \ingroup drvinfo */
 int iupdrvMakeDirectory(const char* name);
 
+/** Maps a file in memory for reading. Returns NULL if failed.
+ * \ingroup drvinfo */
+void* iupdrvMapFile(const char* filename, int *size);
+
+/** Releases the memory returned by iupdrvMapFile.
+ * \ingroup drvinfo */
+void iupdrvUnmapFile(void* data, int size);
+
 /** Returns the current locale name.
  * \ingroup drvinfo */
 char* iupdrvLocaleInfo(void);
@@ -13,6 +13,7 @@
 #include "iup_func.h"
 #include "iup_drv.h"
 #include "iup_assert.h"
+#include "iup_loop.h"
 
 
 static Itable *ifunc_table = NULL;   /* the function hast table indexed by the name string */
@@ -70,9 +71,9 @@ Icallback IupSetFunction(const char *name, Icallback func)
   else
     iupTableSetFunc(ifunc_table, name, (Ifunc)func);
 
-  /* notifies the driver if changing the Idle */
+  /* notifies the idle scheduler if changing the Idle */
   if (iupStrEqual(name, "IDLE_ACTION"))
-    iupdrvSetIdleFunction(func);
+    iupLoopSetIdleFunction(func);
 
   return old_func;
 }
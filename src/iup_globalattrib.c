@@ -18,6 +18,7 @@
 #include "iup_assert.h"
 #include "iup_str.h"
 #include "iup_strmessage.h"
+#include "iup_loop.h"
 
 
 static Itable *iglobal_table = NULL;
@@ -114,6 +115,11 @@ static void iGlobalSet(const char *name, const char *value, int store)
     iGlobalTableSet(name, value, store);
     return;
   }
+  if (iupStrEqual(name, "IDLEBUDGET"))
+  {
+    iupLoopSetIdleBudget(value);
+    return;
+  }
   if (iupStrEqual(name, "CURSORPOS"))
   {
     int x, y;
@@ -155,6 +161,8 @@ char *IupGetGlobal(const char *name)
 
   if (iupStrEqual(name, "DEFAULTFONTSIZE"))
     return iupGetDefaultFontSizeGlobalAttrib();
+  if (iupStrEqual(name, "IDLEBUDGET"))
+    return iupLoopGetIdleBudget();
   if (iupStrEqual(name, "CURSORPOS"))
   {
     char *str = iupStrGetMemory(50);
@@ -17,7 +17,55 @@
 #include "iup_layout.h"
 #include "iup_assert.h" 
 
- 
+
+/* number of elements computed and updated in the last layout, see LAYOUTCOUNT */
+static int iLayoutComputeCount = 0;
+static int iLayoutUpdateCount = 0;
+
+void iupLayoutMarkDirty(Ihandle* ih)
+{
+  ih->flags |= IUP_LAYOUT_DIRTY;
+
+  /* mark all the parents. 
+     Do not stop at the first parent already marked, because inside a floating element 
+     the flags are cleared only when the application lays it out with IupRefreshChildren. */
+  ih = ih->parent;
+  while (ih)
+  {
+    ih->flags |= IUP_LAYOUT_CHILDDIRTY;
+    ih = ih->parent;
+  }
+}
+
+static void iLayoutUpdateChanged(Ihandle* ih)
+{
+  Ihandle* child;
+
+  if (ih->flags & IUP_FLOATING_IGNORE)
+    return;
+
+  /* floating elements are positioned by the application,
+     the dialog is always updated because its size is changed by the system. */
+  if (ih->flags & (IUP_LAYOUT_MOVED|IUP_FLOATING) ||
+      ih->iclass->nativetype == IUP_TYPEDIALOG)
+  {
+    ih->flags &= ~IUP_LAYOUT_MOVED;
+    iupClassObjectLayoutUpdate(ih);
+    iLayoutUpdateCount++;
+  }
+
+  for (child = ih->firstchild; child; child = child->brother)
+  {
+    if (child->handle)
+      iLayoutUpdateChanged(child);
+  }
+}
+
+static void iLayoutSetCountAttrib(Ihandle* dialog)
+{
+  iupAttribSetStrf(dialog, "LAYOUTCOUNT", "%d:%d", iLayoutComputeCount, iLayoutUpdateCount);
+}
+
 void IupRefreshChildren(Ihandle* ih)
 {
   int shrink;
@@ -44,6 +92,8 @@ void IupRefreshChildren(Ihandle* ih)
      but ih will not be changed, only its children. */
 
   shrink = iupAttribGetBoolean(dialog, "SHRINK");
+  iLayoutComputeCount = 0;
+  iLayoutUpdateCount = 0;
 
   /* children only iupBaseComputeNaturalSize */
   {
@@ -61,12 +111,15 @@ void IupRefreshChildren(Ihandle* ih)
 
 
   /****** local iupLayoutUpdate,
-     but ih will not be changed, only its children. */
+     but ih will not be changed, only its children. 
+     Only the children that actually changed are updated. */
   for (child = ih->firstchild; child; child = child->brother)
   {
     if (child->handle)
-      iupLayoutUpdate(child);
+      iLayoutUpdateChanged(child);
   }
+
+  iLayoutSetCountAttrib(dialog);
 }
 
 void IupRefresh(Ihandle* ih)
@@ -80,9 +133,18 @@ void IupRefresh(Ihandle* ih)
   dialog = IupGetDialog(ih);
   if (dialog)
   {
+    /* only the elements marked as dirty and their parents are computed again,
+       and only the elements that changed size or position are updated. */
+    iupLayoutMarkDirty(ih);
+
     iupLayoutCompute(dialog);
     if (dialog->handle)
-      iupLayoutUpdate(dialog);
+    {
+      iLayoutUpdateCount = 0;
+      iLayoutUpdateChanged(dialog);
+    }
+
+    iLayoutSetCountAttrib(dialog);
   }
 }
 
@@ -142,7 +204,7 @@ void IupRedraw(Ihandle* ih, int children)
     iLayoutDisplayRedrawChildren(ih);
 }
 
-void iupLayoutUpdate(Ihandle* ih)
+static void iLayoutUpdate(Ihandle* ih)
 {
   Ihandle* child;
 
@@ -150,22 +212,42 @@ void iupLayoutUpdate(Ihandle* ih)
     return;
 
   /* update size and position of the native control */
+  ih->flags &= ~IUP_LAYOUT_MOVED;
   iupClassObjectLayoutUpdate(ih);
+  iLayoutUpdateCount++;
 
   /* update its children */
   for (child = ih->firstchild; child; child = child->brother)
   {
     if (child->handle)
-      iupLayoutUpdate(child);
+      iLayoutUpdate(child);
   }
 }
 
+void iupLayoutUpdate(Ihandle* ih)
+{
+  /* update all elements, even if not changed */
+  iLayoutUpdateCount = 0;
+  iLayoutUpdate(ih);
+
+  if (ih->iclass->nativetype == IUP_TYPEDIALOG)
+    iLayoutSetCountAttrib(ih);
+}
+
 void iupLayoutCompute(Ihandle* ih)
 {
   /* called only for the dialog */
 
   int shrink = iupAttribGetBoolean(ih, "SHRINK");
 
+  /* The layout is incremental. Elements that were not marked by iupLayoutMarkDirty 
+     keep their previous natural size and their subtree is not visited.
+     When a natural size changes the parent is marked to distribute again the space of its children,
+     so the propagation stops at the first container whose natural size did not change.
+     The dialog is always computed, because its size can be changed by the system. */
+  ih->flags |= IUP_LAYOUT_DIRTY|IUP_LAYOUT_RELAYOUT;
+  iLayoutComputeCount = 0;
+
   /* Compute the natural size for all elements in the dialog,   
      using the minimum visible size and the defined user size.
      The minimum visible size is the size where all the controls can display
@@ -215,6 +297,22 @@ void iupLayoutApplyMinMaxSize(Ihandle* ih, int *w, int *h)
 
 void iupBaseComputeNaturalSize(Ihandle* ih)
 {
+  int old_width, old_height, old_expand;
+
+  /* nothing changed inside the element since the last computation */
+  if (!(ih->flags & (IUP_LAYOUT_DIRTY|IUP_LAYOUT_CHILDDIRTY)))
+    return;
+
+  old_width = ih->naturalwidth;
+  old_height = ih->naturalheight;
+  old_expand = ih->expand;
+
+  /* clear before computing, so elements marked during the computation remain marked.
+     The element own attributes changed, so its children must be laid out again. */
+  if (ih->flags & IUP_LAYOUT_DIRTY)
+    ih->flags = (ih->flags & ~IUP_LAYOUT_DIRTY) | IUP_LAYOUT_RELAYOUT;
+  iLayoutComputeCount++;
+
   /* always initialize the natural size using the user size */
   ih->naturalwidth = ih->userwidth;
   ih->naturalheight = ih->userheight;
@@ -262,10 +360,27 @@ void iupBaseComputeNaturalSize(Ihandle* ih)
 
   /* crop the natural size */
   iupLayoutApplyMinMaxSize(ih, &(ih->naturalwidth), &(ih->naturalheight));
+
+  if (ih->flags & IUP_FLOATING)
+  {
+    /* floating elements are positioned by the application, iupBaseSetPosition is never called for them,
+       so this is the last step of the layout computation. 
+       Its children keep their flags for IupRefreshChildren. */
+    ih->flags &= ~(IUP_LAYOUT_RELAYOUT|IUP_LAYOUT_CHILDDIRTY);
+  }
+  else if (ih->parent &&
+      (old_width != ih->naturalwidth || old_height != ih->naturalheight || old_expand != ih->expand))
+  {
+    /* the parent must distribute again the space of its children */
+    ih->parent->flags |= IUP_LAYOUT_RELAYOUT;
+  }
 }
 
 void iupBaseSetCurrentSize(Ihandle* ih, int w, int h, int shrink)
 {
+  int old_width = ih->currentwidth, 
+      old_height = ih->currentheight;
+
   if (ih->iclass->nativetype == IUP_TYPEDIALOG)
   {
     /* w and h parameters here are ignored, because they are always 0 for the dialog. */
@@ -310,15 +425,29 @@ void iupBaseSetCurrentSize(Ihandle* ih, int w, int h, int shrink)
   if (ih->expand & IUP_EXPAND_WIDTH || ih->expand & IUP_EXPAND_HEIGHT)
     iupLayoutApplyMinMaxSize(ih, &(ih->currentwidth), &(ih->currentheight));
 
-  if (ih->firstchild)
+  if (old_width != ih->currentwidth || old_height != ih->currentheight)
+    ih->flags |= IUP_LAYOUT_MOVED;
+
+  /* the children are not changed if the size did not change 
+     and nothing changed inside the element */
+  if (ih->firstchild &&
+      ih->flags & (IUP_LAYOUT_MOVED|IUP_LAYOUT_RELAYOUT|IUP_LAYOUT_CHILDDIRTY))
     iupClassObjectSetChildrenCurrentSize(ih, shrink);
 }
 
 void iupBaseSetPosition(Ihandle* ih, int x, int y)
 {
-  ih->x = x;
-  ih->y = y;
+  if (ih->x != x || ih->y != y)
+  {
+    ih->x = x;
+    ih->y = y;
+    ih->flags |= IUP_LAYOUT_MOVED;
+  }
 
-  if (ih->firstchild)
+  if (ih->firstchild &&
+      ih->flags & (IUP_LAYOUT_MOVED|IUP_LAYOUT_RELAYOUT|IUP_LAYOUT_CHILDDIRTY))
     iupClassObjectSetChildrenPosition(ih, x, y);
+
+  /* this is the last step of the layout computation */
+  ih->flags &= ~(IUP_LAYOUT_RELAYOUT|IUP_LAYOUT_CHILDDIRTY);
 }
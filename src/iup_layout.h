@@ -17,6 +17,11 @@ void iupLayoutUpdate(Ihandle* ih);   /* called only after map */
 
 void iupLayoutApplyMinMaxSize(Ihandle* ih, int *w, int *h);
 
+/* Marks the element natural size to be recomputed in the next layout computation.
+   Its parents are marked so only the modified subtrees are visited.
+   Called when attributes are set and when the child tree is changed. */
+void iupLayoutMarkDirty(Ihandle* ih);
+
 /* Other functions declared in <iup.h> and implemented here. 
 IupRefresh
 */
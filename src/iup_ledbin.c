@@ -0,0 +1,376 @@
+/** \file
+ * \brief loader and builder for binary LED.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iup.h"
+
+#include "iup_object.h"
+#include "iup_register.h"
+#include "iup_ledbin.h"
+#include "iup_str.h"
+
+
+/* The strings of the description are used directly,
+   the string parameters and attribute values are copied by the elements when needed.
+   There is no tokenizing, only the numeric parameters are converted. */
+
+static char iledb_error[1024];
+
+static char* iLedBinError(const char* filename, const char* msg, const char* name)
+{
+  if (name)
+    sprintf(iledb_error, "led(%.400s): bad input - %s '%.400s'\n", filename, msg, name);
+  else
+    sprintf(iledb_error, "led(%.400s): bad input - %s\n", filename, msg);
+  return iledb_error;
+}
+
+static const char* iLedBinString(const IledbDesc* desc, int index)
+{
+  return desc->pool + desc->strings[index];
+}
+
+static int iLedBinCheckSection(int size, int count, int offset, int item_size)
+{
+  if (count < 0 || offset < (int)sizeof(IledbHeader) || offset % sizeof(int) != 0)
+    return 0;
+  if (count > (size - offset) / item_size)
+    return 0;
+  return 1;
+}
+
+static int iLedBinCheck(const IledbDesc* desc, int pool_size)
+{
+  int i;
+
+  /* the last string must be terminated, so all the strings are */
+  if (pool_size > 0 && desc->pool[pool_size-1] != 0)
+    return 0;
+
+  for (i = 0; i < desc->string_count; i++)
+  {
+    if (desc->strings[i] < 0 || desc->strings[i] >= pool_size)
+      return 0;
+  }
+
+  for (i = 0; i < desc->class_count; i++)
+  {
+    if (desc->classes[i] < 0 || desc->classes[i] >= desc->string_count)
+      return 0;
+  }
+
+  for (i = 0; i < desc->elem_count; i++)
+  {
+    const IledbElem* elem = desc->elems + i;
+    if (elem->class_index < -1 || elem->class_index >= desc->class_count ||
+        elem->name < -1 || elem->name >= desc->string_count ||
+        elem->first_param < 0 || elem->param_count < 0 || elem->param_count > desc->param_count - elem->first_param ||
+        elem->first_attrib < 0 || elem->attrib_count < 0 || elem->attrib_count > desc->attrib_count - elem->first_attrib)
+      return 0;
+
+    /* a reference has only the name or the element */
+    if (elem->class_index == -1 &&
+        (elem->param_count != 1 || elem->attrib_count != 0 ||
+         (desc->params[elem->first_param].type != IUPLEDB_PARAM_NAME && desc->params[elem->first_param].type != IUPLEDB_PARAM_ELEM)))
+      return 0;
+  }
+
+  for (i = 0; i < desc->param_count; i++)
+  {
+    const IledbParam* param = desc->params + i;
+    switch (param->type)
+    {
+    case IUPLEDB_PARAM_STRING:
+    case IUPLEDB_PARAM_NAME:
+      if (param->value < 0 || param->value >= desc->string_count)
+        return 0;
+      break;
+    case IUPLEDB_PARAM_ELEM:
+      if (param->value < 0 || param->value >= desc->elem_count)
+        return 0;
+      break;
+    case IUPLEDB_PARAM_DATA:
+      {
+        int data_size;
+        if (param->value < 0 || param->value % sizeof(int) != 0 || param->value > desc->data_size - (int)sizeof(int))
+          return 0;
+        data_size = *(const int*)(desc->data + param->value);
+        if (data_size < 0 || data_size > desc->data_size - param->value - (int)sizeof(int))
+          return 0;
+        break;
+      }
+    default:
+      return 0;
+    }
+  }
+
+  for (i = 0; i < desc->attrib_count; i++)
+  {
+    const IledbAttrib* attrib = desc->attribs + i;
+    if (attrib->name < 0 || attrib->name >= desc->string_count ||
+        attrib->value < -1 || attrib->value >= desc->string_count)
+      return 0;
+  }
+
+  return 1;
+}
+
+int iupLedBinIsBinary(const void* data, int size)
+{
+  return size >= (int)sizeof(IledbHeader) && memcmp(data, IUPLEDB_SIGNATURE, 8) == 0;
+}
+
+const char* iupLedBinOpen(IledbDesc* desc, const void* data, int size)
+{
+  const char* base = (const char*)data;
+  const IledbHeader* header = (const IledbHeader*)data;
+
+  if (header->byte_order != IUPLEDB_BYTEORDER || header->version != IUPLEDB_VERSION)
+    return "incompatible version or byte order";
+
+  if (header->size != size ||
+      !iLedBinCheckSection(size, header->string_count, header->string_offset, sizeof(int)) ||
+      !iLedBinCheckSection(size, header->pool_size, header->pool_offset, 1) ||
+      !iLedBinCheckSection(size, header->class_count, header->class_offset, sizeof(int)) ||
+      !iLedBinCheckSection(size, header->elem_count, header->elem_offset, sizeof(IledbElem)) ||
+      !iLedBinCheckSection(size, header->param_count, header->param_offset, sizeof(IledbParam)) ||
+      !iLedBinCheckSection(size, header->attrib_count, header->attrib_offset, sizeof(IledbAttrib)) ||
+      !iLedBinCheckSection(size, header->data_size, header->data_offset, 1))
+    return "corrupted file";
+
+  desc->string_count = header->string_count;
+  desc->strings = (const int*)(base + header->string_offset);
+  desc->pool = base + header->pool_offset;
+  desc->class_count = header->class_count;
+  desc->classes = (const int*)(base + header->class_offset);
+  desc->elem_count = header->elem_count;
+  desc->elems = (const IledbElem*)(base + header->elem_offset);
+  desc->param_count = header->param_count;
+  desc->params = (const IledbParam*)(base + header->param_offset);
+  desc->attrib_count = header->attrib_count;
+  desc->attribs = (const IledbAttrib*)(base + header->attrib_offset);
+  desc->data_size = header->data_size;
+  desc->data = (const unsigned char*)(base + header->data_offset);
+
+  if (!iLedBinCheck(desc, header->pool_size))
+    return "corrupted file";
+
+  return NULL;
+}
+
+static void* iLedBinNameParam(const char* name, char format)
+{
+  /* same conversions of the text LED parser */
+  switch(format)
+  {
+  case 'b':
+  case 'c':
+    {
+      unsigned int b = 0;
+      sscanf(name, "%u", &b);
+      if (b>255) b = 255;
+      return (void*)(unsigned long)b;
+    }
+  case 'i':
+  case 'j':
+    {
+      int i = 0;
+      sscanf(name, "%d", &i);
+      return (void*)(long)i;
+    }
+  case 'f':
+    {
+      float f = 0;
+      unsigned long* l = (unsigned long*)&f;
+      sscanf(name, "%g", &f);
+      return (void*)*l;
+    }
+  default:  /* 'a' */
+    return (void*)name;
+  }
+}
+
+static int iLedBinImageChannels(Iclass* ic)
+{
+  if (iupStrEqual(ic->name, "imagergba"))
+    return 4;
+  if (iupStrEqual(ic->name, "imagergb"))
+    return 3;
+  return 1;
+}
+
+static char* iLedBinCreate(const IledbDesc* desc, const char* filename, const IledbElem* elem, Iclass* ic, Ihandle** handles, Ihandle* *ih)
+{
+  const char* format = ic->format;
+  void** params;
+  int i, f, count;
+
+  if (!format || format[0] == 0)
+  {
+    *ih = iupObjectCreate(ic, NULL);
+    return NULL;
+  }
+
+  /* image data uses 2 parameters */
+  params = (void**)malloc(sizeof(void*)*(elem->param_count+2));
+
+  count = 0;
+  f = 0;
+  for (i = 0; i < elem->param_count; i++)
+  {
+    const IledbParam* param = desc->params + elem->first_param + i;
+    char p_format = format[f];
+
+    if (p_format == 0)
+    {
+      free(params);
+      return iLedBinError(filename, "too many parameters for", ic->name);
+    }
+
+    switch (param->type)
+    {
+    case IUPLEDB_PARAM_STRING:
+      params[count++] = (void*)iLedBinString(desc, param->value);
+      break;
+    case IUPLEDB_PARAM_ELEM:
+      params[count++] = handles[param->value];
+      break;
+    case IUPLEDB_PARAM_DATA:
+      {
+        int data_size = *(const int*)(desc->data + param->value);
+        int width = count == 2? (int)(long)params[0]: 0;
+        int height = count == 2? (int)(long)params[1]: 0;
+
+        /* width*height*channels <= data_size, compared with divisions so it can not overflow */
+        if (width <= 0 || height <= 0 ||
+            width > data_size / iLedBinImageChannels(ic) / height)
+        {
+          free(params);
+          return iLedBinError(filename, "invalid image data for", ic->name);
+        }
+
+        /* compacted in one pointer, see IupImage */
+        params[count++] = (void*)(desc->data + param->value + sizeof(int));
+        params[count++] = (void*)-1;
+        break;
+      }
+    case IUPLEDB_PARAM_NAME:
+      {
+        const char* name = iLedBinString(desc, param->value);
+        if (p_format == 'g' || p_format == 'h')
+        {
+          Ihandle* child = IupGetHandle(name);
+          if (!child)
+          {
+            free(params);
+            return iLedBinError(filename, "symbol not defined", name);
+          }
+          params[count++] = child;
+        }
+        else
+          params[count++] = iLedBinNameParam(name, p_format);
+        break;
+      }
+    }
+
+    /* an array of parameters uses the rest of the list */
+    if (p_format != 'j' && p_format != 'g' && p_format != 'c')
+      f++;
+  }
+
+  params[count] = NULL;
+  *ih = iupObjectCreate(ic, params);
+  free(params);
+  return NULL;
+}
+
+char* iupLedBinBuild(const IledbDesc* desc, const char* filename)
+{
+  Iclass** classes;
+  Ihandle** handles;
+  char* error = NULL;
+  int i, j;
+
+  /* find each class once */
+  classes = (Iclass**)malloc(sizeof(Iclass*)*(desc->class_count+1));
+  for (i = 0; i < desc->class_count; i++)
+  {
+    classes[i] = iupRegisterFindClass(iLedBinString(desc, desc->classes[i]));
+    if (!classes[i])
+    {
+      error = iLedBinError(filename, "unknown class", iLedBinString(desc, desc->classes[i]));
+      free(classes);
+      return error;
+    }
+  }
+
+  handles = (Ihandle**)malloc(sizeof(Ihandle*)*(desc->elem_count+1));
+  for (i = 0; i < desc->elem_count; i++)
+  {
+    const IledbElem* elem = desc->elems + i;
+    Ihandle* ih = NULL;
+
+    /* children are always before their parents */
+    for (j = 0; j < elem->param_count; j++)
+    {
+      const IledbParam* param = desc->params + elem->first_param + j;
+      if (param->type == IUPLEDB_PARAM_ELEM && param->value >= i)
+      {
+        error = iLedBinError(filename, "invalid child of", elem->class_index == -1? "reference": classes[elem->class_index]->name);
+        break;
+      }
+    }
+    if (error)
+      break;
+
+    if (elem->class_index == -1)
+    {
+      const IledbParam* param = desc->params + elem->first_param;
+      if (param->type == IUPLEDB_PARAM_ELEM)
+        ih = handles[param->value];
+      else
+      {
+        ih = IupGetHandle(iLedBinString(desc, param->value));
+        if (!ih)
+        {
+          error = iLedBinError(filename, "symbol not defined", iLedBinString(desc, param->value));
+          break;
+        }
+      }
+    }
+    else
+    {
+      Iclass* ic = classes[elem->class_index];
+
+      error = iLedBinCreate(desc, filename, elem, ic, handles, &ih);
+      if (error)
+        break;
+      if (!ih)
+      {
+        error = iLedBinError(filename, "creation failed for", ic->name);
+        break;
+      }
+
+      for (j = 0; j < elem->attrib_count; j++)
+      {
+        const IledbAttrib* attrib = desc->attribs + elem->first_attrib + j;
+        IupStoreAttribute(ih, iLedBinString(desc, attrib->name), attrib->value == -1? NULL: iLedBinString(desc, attrib->value));
+      }
+    }
+
+    if (elem->name != -1)
+      IupSetHandle(iLedBinString(desc, elem->name), ih);
+
+    handles[i] = ih;
+  }
+
+  free(handles);
+  free(classes);
+  return error;
+}
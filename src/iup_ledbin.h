@@ -0,0 +1,134 @@
+/** \file
+ * \brief Binary LED format.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#ifndef __IUP_LEDBIN_H
+#define __IUP_LEDBIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \defgroup ledbin Binary LED
+ * \par
+ * Compact form of a LED file, generated by "ledc -b" and loaded by \ref IupLoad.
+ * The text LED parser produces the same description in memory.
+ * \par
+ * The file is a header followed by sections. Except for the string pool and the image data,
+ * all sections are arrays of int in the byte order of the machine that generated the file.
+ * Offsets are in bytes from the start of the file, and are aligned to sizeof(int).
+ * \par
+ * Strings are stored only once, and referenced by their index in the string table.
+ * Class names are stored in the class table, so each class is searched only once.
+ * Elements are stored in creation order, so a child is always before its parent.
+ * \par
+ * This header is also used by the ledc compiler, so it must not depend on other IUP headers.
+ * \par
+ * See \ref iup_ledbin.h
+ * \ingroup util */
+
+/** \ingroup ledbin */
+#define IUPLEDB_SIGNATURE  "IUPLEDB\n"   /* 8 characters, no terminator in the file */
+/** \ingroup ledbin */
+#define IUPLEDB_VERSION    1
+/** Written in the byte order of the compiler, the loader rejects the file if it does not match.
+ * \ingroup ledbin */
+#define IUPLEDB_BYTEORDER  0x01020304
+
+/** Binary LED file header.
+ * \ingroup ledbin */
+typedef struct _IledbHeader
+{
+  char signature[8];
+  int version;
+  int byte_order;
+  int size;                        /* total file size */
+  int string_count, string_offset; /* int[string_count], offset of each string in the pool */
+  int pool_size, pool_offset;      /* zero terminated strings */
+  int class_count, class_offset;   /* int[class_count], string index of each class name */
+  int elem_count, elem_offset;     /* IledbElem[elem_count] */
+  int param_count, param_offset;   /* IledbParam[param_count] */
+  int attrib_count, attrib_offset; /* IledbAttrib[attrib_count] */
+  int data_size, data_offset;      /* image data */
+} IledbHeader;
+
+/** Element, an Ihandle to be created.
+ * class_index is -1 for a reference to an existing handle,
+ * given by its only parameter, a name or an element.
+ * \ingroup ledbin */
+typedef struct _IledbElem
+{
+  int class_index;
+  int name;                        /* string index of the handle name, -1 if none */
+  int first_param, param_count;
+  int first_attrib, attrib_count;
+} IledbElem;
+
+/** Types of parameters.
+ * \ingroup ledbin */
+enum { IUPLEDB_PARAM_STRING,  /* quoted string, value is a string index */
+       IUPLEDB_PARAM_NAME,    /* identifier or number, value is a string index.
+                                 Converted according to the class format, or the name of an existing handle. */
+       IUPLEDB_PARAM_ELEM,    /* child element, value is an element index */
+       IUPLEDB_PARAM_DATA     /* image data, value is an offset in the data section, 
+                                 where an int with the data size is followed by the data */
+};
+
+/** Parameter of the element creation.
+ * \ingroup ledbin */
+typedef struct _IledbParam
+{
+  int type;
+  int value;
+} IledbParam;
+
+/** Attribute set after the element creation.
+ * \ingroup ledbin */
+typedef struct _IledbAttrib
+{
+  int name, value;                 /* string indices, value is -1 to reset the attribute */
+} IledbAttrib;
+
+/** Sections of a binary LED file in memory.
+ * Also filled by the LED parser, so both are built by \ref iupLedBinBuild.
+ * \ingroup ledbin */
+typedef struct _IledbDesc
+{
+  int string_count;
+  const int* strings;
+  const char* pool;
+  int class_count;
+  const int* classes;
+  int elem_count;
+  const IledbElem* elems;
+  int param_count;
+  const IledbParam* params;
+  int attrib_count;
+  const IledbAttrib* attribs;
+  int data_size;
+  const unsigned char* data;
+} IledbDesc;
+
+/** Returns non zero if the data starts with the binary LED signature.
+ * \ingroup ledbin */
+int iupLedBinIsBinary(const void* data, int size);
+
+/** Validates the binary LED file in data, and fills the description with its sections.
+ * data must be aligned to sizeof(int), and must exist while the description is used.
+ * Returns NULL or the error description. Does not use IUP, so it can be called from any thread.
+ * \ingroup ledbin */
+const char* iupLedBinOpen(IledbDesc* desc, const void* data, int size);
+
+/** Creates the elements of the description, sets their attributes and their names.
+ * Must be called in the same thread of the IUP main loop.
+ * Returns NULL or the error message.
+ * \ingroup ledbin */
+char* iupLedBinBuild(const IledbDesc* desc, const char* filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -20,163 +20,107 @@
 #include "iup_register.h"
 
 
-static struct          /* lexical variables */
+static int iLexGetChar (Ilex* lex);
+static int iLexToken(Ilex* lex, int *erro);
+static int iLexCapture (Ilex* lex, char* dlm);
+static void iLexSkipComment (Ilex* lex);
+static int iLexCaptureAttr (Ilex* lex);
+
+void iupLexInit(Ilex* lex, const char* filename)
 {
-  const char* filename;   /* file name */
-  const char* f;
-  FILE* file;             /* file handle */
-  int token;              /* lookahead iLexToken */
-  char name[40960];       /* lexical identifier value */
-  float number;           /* lexical number value */
-  int line;               /* line number */
-  Iclass *ic;             /* control class when func is CONTROL_ */
-} ilex = {NULL, NULL, NULL, 0, "", (float) 0.0, 0, NULL};
-
-static int iLexGetChar (void);
-static int iLexToken(int *erro);
-static int iLexCapture (char* dlm);
-static void iLexSkipComment (void);
-static int iLexCaptureAttr (void);
-
-int iupLexStart(const char* filename, int is_file)      /* initialize lexical analysis */
+  memset(lex, 0, sizeof(Ilex));
+  lex->filename = filename;
+  lex->line = 1;
+}
+
+int iupLexStart(Ilex* lex, const char* buffer, int size)      /* initialize lexical analysis */
 {
-  ilex.filename = filename;
-  if (is_file)
-  {
-    ilex.file = fopen (ilex.filename,"r");
-    if (!ilex.file)
-      return iupLexError (IUPLEX_FILENOTOPENED, filename);
-  }
-  else
-  {
-    ilex.f = ilex.filename;
-    ilex.file = NULL;
-  }
-  ilex.line = 0;
-  ilex.line = 1;
-  return iupLexAdvance();
+  lex->pos = buffer;
+  lex->end = buffer + size;
+  lex->line = 1;
+  return iupLexAdvance(lex);
 }
 
-void iupLexClose(void)
+void iupLexClose(Ilex* lex)
 {
-  if (!ilex.file)
-    return;
-  fclose (ilex.file);
-  ilex.file = NULL;
+  if (lex->name)
+    free(lex->name);
+  lex->name = NULL;
+  lex->name_len = lex->name_max = 0;
 }
 
-static void iLexUngetc(int c)
+static int iLexGetc(Ilex* lex)
 {
-  if (ilex.file)
-    ungetc(c, ilex.file);
-  else
-  {
-    if (*ilex.f != 0)
-      *(char*)ilex.f = (char)c;  /* write back to the string ???? */
-  }
+  int c;
+  if (lex->pos == lex->end)
+    return EOF;
+
+  c = (unsigned char)*lex->pos++;
+
+  /* same as a file opened in text mode */
+  if (c == '\r' && lex->pos != lex->end && *lex->pos == '\n')
+    c = (unsigned char)*lex->pos++;
+
+  return c;
 }
 
-static int iLexGetc(void)
+static void iLexAddName(Ilex* lex, int c)
 {
-  if (ilex.file)
-    return getc(ilex.file);
-  else
+  if (lex->name_len == lex->name_max)
   {
-    if (*ilex.f != 0)
-      ilex.f++;
-    if (*ilex.f == 0)
-      return EOF;
-    return *ilex.f;
+    lex->name_max = lex->name_max? 2*lex->name_max: 256;
+    lex->name = (char*)realloc(lex->name, lex->name_max);
   }
+  lex->name[lex->name_len++] = (char)c;
 }
 
-int iupLexLookAhead(void)
+int iupLexLookAhead(Ilex* lex)
 {
-  return ilex.token;
+  return lex->token;
 }
 
-int iupLexAdvance(void)
+int iupLexAdvance(Ilex* lex)
 {
   int erro = 0;
-  ilex.token = iLexToken(&erro);
+  lex->token = iLexToken(lex, &erro);
   return erro;
 }
 
-int iupLexFollowedBy(int t)
+int iupLexMatch(Ilex* lex, int t)
 {
-  return (ilex.token==t);
-}
-
-int iupLexMatch(int t)
-{
-  if (ilex.token==t)
-    return iupLexAdvance();
+  if (lex->token==t)
+    return iupLexAdvance(lex);
   else
-    return iupLexError (IUPLEX_NOTMATCH, ilex.token, t);
+    return iupLexError (lex, IUPLEX_NOTMATCH, lex->token, t);
 }
 
 
-int iupLexSeenMatch(int t, int *erro)
+int iupLexSeenMatch(Ilex* lex, int t, int *erro)
 {
-  if (ilex.token==t)
+  if (lex->token==t)
   {
-    *erro = iupLexAdvance();
+    *erro = iupLexAdvance(lex);
     return 1;
   }
   else
     return 0;
 }
 
-unsigned char iupLexByte(void)
+char* iupLexName(Ilex* lex)
 {
-  unsigned int b;
-  sscanf(ilex.name,"%u", &b);  /* read as integer to avoid reading number as characters */
-  if (b>255) b = 255;
-  return (unsigned char)b;
+  return lex->name? lex->name: "";
 }
 
-int iupLexInt(void)
+Iclass *iupLexGetClass(Ilex* lex)
 {
-  int i;
-  sscanf(ilex.name,"%d", &i);
-  return i;
+  return lex->ic;
 }
 
-float iupLexFloat(void)
-{
-  float f;
-  sscanf(ilex.name,"%g", &f);
-  return f;
-}
-
-char* iupLexGetName(void)
-{
-  if (ilex.name)
-    return iupStrDup(ilex.name);
-  else
-    return NULL;
-}
-
-char* iupLexName(void)
-{
-  return ilex.name;
-}
-
-float iupLexGetNumber(void)
-{
-  return ilex.number;
-}
-
-Iclass *iupLexGetClass(void)
-{
-  return ilex.ic;
-}
-
-static int iLexToken(int *erro)
+static int iLexToken(Ilex* lex, int *erro)
 {
   for (;;)
   {
-    int c = iLexGetChar();
+    int c = iLexGetChar(lex);
     switch (c)
     {
     case 26:
@@ -188,7 +132,7 @@ static int iLexToken(int *erro)
 
     case '#':          /* Skip comment */
     case '%':          /* Skip comment */
-      iLexSkipComment();
+      iLexSkipComment(lex);
       continue;
 
     case ' ':          /* ignore whitespace */
@@ -212,30 +156,49 @@ static int iLexToken(int *erro)
       return IUPLEX_TK_ENDP;
 
     case '[':          /* attributes */
-      if (iLexCaptureAttr() == IUPLEX_TK_END)
+      if (iLexCaptureAttr(lex) == IUPLEX_TK_END)
       {
-        *erro=iupLexError (IUPLEX_NOTENDATTR);
+        *erro=iupLexError (lex, IUPLEX_NOTENDATTR);
         return 0;
       }
       return IUPLEX_TK_ATTR;
 
     case '\"':          /* string */
-      iLexCapture ("\"");
+      iLexCapture (lex, "\"");
       return IUPLEX_TK_STR;
 
     case '\'':          /* string */
-      iLexCapture ("\'");
+      iLexCapture (lex, "\'");
       return IUPLEX_TK_STR;
 
     default:
       if (c > 32)          /* identifier */
       {
-        char class_name[50];
-        iLexUngetc(c);
-        iLexUngetc(iLexCapture ("=[](), \t\n\r\f\v"));
-        iupStrLower(class_name, iupLexName());
-        ilex.ic = iupRegisterFindClass(class_name);
-        if (ilex.ic)
+        const char* dlm_pos;
+        int dlm_line;
+
+        lex->name_len = 0;
+        for (;;)
+        {
+          iLexAddName(lex, c);
+          dlm_pos = lex->pos;   /* the delimiter is read again by the next token */
+          dlm_line = lex->line;
+          c = iLexGetChar(lex);
+          if (c <= 0 || strchr("=[](), \t\n\r\f\v", c))
+            break;
+        }
+        iLexAddName(lex, 0);
+        lex->pos = dlm_pos;
+        lex->line = dlm_line;
+
+        lex->ic = NULL;
+        if (lex->name_len <= 50)
+        {
+          char class_name[50];
+          iupStrLower(class_name, lex->name);
+          lex->ic = iupRegisterFindClass(class_name);
+        }
+        if (lex->ic)
           return IUPLEX_TK_FUNC;
         else
           return IUPLEX_TK_NAME;
@@ -245,52 +208,54 @@ static int iLexToken(int *erro)
   }
 }
 
-static int iLexCapture (char* dlm)
+static int iLexCapture (Ilex* lex, char* dlm)
 {
-  int i=0;
   int c;
-  do
+  lex->name_len = 0;
+  for (;;)
   {
-    c = iLexGetChar ();
-    if (i < sizeof(ilex.name))
-      ilex.name[i++] = (char) c;
-  } while ((c > 0) && !strchr (dlm,c));
-  ilex.name[i-1]='\0';                            /* discard delimiter */
+    c = iLexGetChar (lex);
+    if (c <= 0 || strchr (dlm,c))
+      break;
+    iLexAddName(lex, c);
+  }
+  iLexAddName(lex, 0);                           /* discard delimiter */
   return c;                                      /* return delimiter */
 }
 
-static int iLexCaptureAttr (void)
+static int iLexCaptureAttr (Ilex* lex)
 {
-  int i=0;
   int c;
   int aspas=0;
-  do
+  lex->name_len = 0;
+  for (;;)
   {
-    c = iLexGetChar ();
-    if (i < sizeof(ilex.name))
-      ilex.name[i++] = (char) c;
+    c = iLexGetChar (lex);
+    if (c <= 0 || (!(aspas & 1) && c == ']'))
+      break;
+    iLexAddName(lex, c);
     if (c == '"')
       ++aspas;
-  } while ((c > 0) && ((aspas & 1) || c != ']'));
-  ilex.name[i-1]='\0';                            /* discard delimiter */
+  }
+  iLexAddName(lex, 0);                           /* discard delimiter */
   return c;                                      /* return delimiter */
 }
 
-static void iLexSkipComment (void)
+static void iLexSkipComment (Ilex* lex)
 {
   int c;
   do
   {
-    c = iLexGetChar();
+    c = iLexGetChar(lex);
   } while ((c > 0) && (c != '\n'));
 }
 
-static int iLexGetChar (void)
+static int iLexGetChar (Ilex* lex)
 {
-  int c = iLexGetc(); if (c == '\n') ++ilex.line;
+  int c = iLexGetc(lex); if (c == '\n') ++lex->line;
   if (c == '\\')
   {
-    c = iLexGetc();
+    c = iLexGetc(lex);
     if (c == 'n')
       return '\n';
     else if (c == '\\')
@@ -318,16 +283,14 @@ static char* iupTokenStr(int t)
   return "";
 }
 
-static char ilex_erromsg[10240];
-
-char *iupLexGetError(void)
+char *iupLexGetError(Ilex* lex)
 {
-  return ilex_erromsg;
+  return lex->error;
 }
 
-int iupLexError (int n, ...)
+int iupLexError (Ilex* lex, int n, ...)
 {
-  char msg[10240];
+  char msg[512] = "";
   va_list va;
   va_start(va,n);
   switch (n)
@@ -335,7 +298,7 @@ int iupLexError (int n, ...)
   case IUPLEX_FILENOTOPENED:
     {
       char *fn=va_arg(va,char *);
-      sprintf (msg, "cannot open file %s", fn);
+      sprintf (msg, "cannot open file %.400s", fn);
     }
     break;
   case IUPLEX_NOTMATCH:
@@ -360,6 +323,6 @@ int iupLexError (int n, ...)
     break;
   }
   va_end(va);
-  sprintf(ilex_erromsg, "led(%s): bad input at line %d - %s\n", ilex.filename, ilex.line, msg);
+  sprintf(lex->error, "led(%.400s): bad input at line %d - %s\n", lex->filename, lex->line, msg);
   return n;
 }
@@ -30,22 +30,33 @@ extern "C" {
 #define IUPLEX_NOTENDATTR      3
 #define IUPLEX_PARSEERROR      4
 
-char*   iupLexGetError   (void);
-int     iupLexStart      (const char *filename, int is_file);
-void    iupLexClose      (void);
-int     iupLexLookAhead  (void);
-int     iupLexAdvance    (void);
-int     iupLexFollowedBy (int t);
-int     iupLexMatch      (int t);
-int     iupLexSeenMatch  (int t, int *erro);
-unsigned char iupLexByte (void);
-int     iupLexInt        (void);
-float   iupLexFloat      (void);
-char*   iupLexGetName    (void);
-char*   iupLexName       (void);
-float   iupLexGetNumber  (void);
-int     iupLexError      (int n, ...);
-Iclass* iupLexGetClass   (void);
+/* Lexical state, one for each source being parsed.
+   There is no global state, so several sources can be parsed at the same time in different threads,
+   as long as no classes are registered meanwhile. The buffer is never changed. */
+typedef struct _Ilex
+{
+  const char* filename;   /* used only in error messages */
+  const char* pos;        /* current position in the buffer */
+  const char* end;        /* end of the buffer, it does not need a terminator */
+  int line;               /* line number */
+  int token;              /* lookahead token */
+  char* name;             /* lexical identifier value */
+  int name_len, name_max;
+  Iclass *ic;             /* control class when token is IUPLEX_TK_FUNC */
+  char error[1024];       /* last error message */
+} Ilex;
+
+void    iupLexInit       (Ilex* lex, const char *filename);
+int     iupLexStart      (Ilex* lex, const char *buffer, int size);
+void    iupLexClose      (Ilex* lex);
+int     iupLexLookAhead  (Ilex* lex);
+int     iupLexAdvance    (Ilex* lex);
+int     iupLexMatch      (Ilex* lex, int t);
+int     iupLexSeenMatch  (Ilex* lex, int t, int *erro);
+char*   iupLexName       (Ilex* lex);
+int     iupLexError      (Ilex* lex, int n, ...);
+char*   iupLexGetError   (Ilex* lex);
+Iclass* iupLexGetClass   (Ilex* lex);
 
 #ifdef __cplusplus
 }
@@ -1,5 +1,5 @@
 /** \file
- * \brief parser for LED. 
+ * \brief parser for LED.
  *
  * See Copyright Notice in "iup.h"
  */
@@ -8,282 +8,702 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <memory.h>
-#include <string.h>         
+#include <string.h>
 
 #include "iup.h"
 
 #include "iup_object.h"
 #include "iup_ledlex.h"
+#include "iup_ledbin.h"
+#include "iup_drvinfo.h"
 #include "iup_str.h"
 #include "iup_assert.h"
-            
-            
-#define IPARSE_SYMBEXIST       1
-#define IPARSE_SYMBNOTDEF      2
 
-static Ihandle* iParseExp (void);
-static Ihandle* iParseFunction (Iclass *ic);
-static int iParseError (int err, char *s);
 
-static int iparse_error = 0;
-#define IPARSE_RETURN_IF_ERRO(_e)        {iparse_error=(_e); if (iparse_error) return NULL;}
-#define IPARSE_RETURN_IF_ERRO2(_e, _x)   {iparse_error=(_e); if (iparse_error) { if (_x) free(_x); return NULL;} }
+/* The parser does not create the elements, it fills a description of them,
+   the same description of a binary LED file, and both are built by iupLedBinBuild.
+   The parser has no global state and uses only the class registry for reading,
+   so several LED sources can be parsed at the same time in other threads. */
 
+typedef struct _IparseSection   /* expandable array, grows exponentially */
+{
+  char* data;
+  int count, max, item_size;
+} IparseSection;
 
-char* IupLoad(const char *filename)
+struct Iled_
 {
-  iupASSERT(filename!=NULL);
-  if (!filename)
-    return "invalid file name";
+  char* filename;
+  char* error;
+  IledbDesc desc;
+  void* map;                     /* binary LED file, mapped in memory */
+  int map_size;
+  char* buffer;                  /* copy of a binary LED buffer */
+  IparseSection strings, pool, classes, elems, params, attribs, data;
+  IparseSection class_ptrs;      /* Iclass* of each class */
+};
+
+static char iparse_error[1024];
+
+static void iParseSectionInit(IparseSection* section, int item_size)
+{
+  section->data = NULL;
+  section->count = 0;
+  section->max = 0;
+  section->item_size = item_size;
+}
 
-  iparse_error = iupLexStart(filename, 1);
-  if (iparse_error)
+static void* iParseSectionAdd(IparseSection* section, int add_count)
+{
+  if (section->count + add_count > section->max)
   {
-    iupLexClose();
-    return iupLexGetError();
+    section->max = 2*(section->count + add_count) + 32;
+    section->data = (char*)realloc(section->data, section->max*section->item_size);
   }
+  section->count += add_count;
+  return section->data + (section->count - add_count)*section->item_size;
+}
 
-  while (iupLexLookAhead() != IUPLEX_TK_END)
+static int iParseAddStringN(Iled* led, const char* str, int len)
+{
+  char* pool_str;
+  *(int*)iParseSectionAdd(&led->strings, 1) = led->pool.count;
+  pool_str = (char*)iParseSectionAdd(&led->pool, len+1);
+  memcpy(pool_str, str, len);
+  pool_str[len] = 0;
+  return led->strings.count-1;
+}
+
+static int iParseAddString(Iled* led, const char* str)
+{
+  return iParseAddStringN(led, str, strlen(str));
+}
+
+static int iParseAddClass(Iled* led, Iclass* ic)
+{
+  Iclass** class_ptrs = (Iclass**)led->class_ptrs.data;
+  int i;
+
+  for (i = 0; i < led->class_ptrs.count; i++)
   {
-    iParseExp();
-    if (iparse_error)
+    if (class_ptrs[i] == ic)
+      return i;
+  }
+
+  *(Iclass**)iParseSectionAdd(&led->class_ptrs, 1) = ic;
+  *(int*)iParseSectionAdd(&led->classes, 1) = iParseAddString(led, ic->name);
+  return i;
+}
+
+static int iParseAddElem(Iled* led, int class_index, const IledbParam* params, int param_count)
+{
+  IledbElem* elem = (IledbElem*)iParseSectionAdd(&led->elems, 1);
+  elem->class_index = class_index;
+  elem->name = -1;
+  elem->first_param = led->params.count;
+  elem->param_count = param_count;
+  elem->first_attrib = led->attribs.count;
+  elem->attrib_count = 0;
+
+  if (param_count)
+    memcpy(iParseSectionAdd(&led->params, param_count), params, param_count*sizeof(IledbParam));
+
+  return led->elems.count-1;
+}
+
+static int iParseAddReference(Iled* led, int type, int value)
+{
+  IledbParam param;
+  param.type = type;
+  param.value = value;
+  return iParseAddElem(led, -1, &param, 1);
+}
+
+static int iParseSetName(Iled* led, int elem, int name)
+{
+  IledbElem* elems = (IledbElem*)led->elems.data;
+
+  if (elems[elem].name != -1)  /* a = b = ... */
+  {
+    elem = iParseAddReference(led, IUPLEDB_PARAM_ELEM, elem);
+    elems = (IledbElem*)led->elems.data;
+  }
+
+  elems[elem].name = name;
+  return elem;
+}
+
+static int iParseAttribToken(const char* *str, const char* *value, int *len)
+{
+  /* same tokens of IupSetAttributes */
+  const char* s = *str;
+  for (;;)
+  {
+    int c = (unsigned char)*s;
+    switch (c)
     {
-      iupLexClose();
-      return iupLexGetError();
+    case 0:
+      *str = s;
+      return IUPLEX_TK_END;
+
+    case '#':          /* Skip comment */
+    case '%':          /* Skip comment */
+      while (*s && *s != '\n')
+        s++;
+      continue;
+
+    case ' ':          /* ignore whitespace */
+    case '\t':
+    case '\n':
+    case '\r':
+    case '\f':
+    case '\v':
+      s++;
+      continue;
+
+    case '=':
+      *str = s+1;
+      return IUPLEX_TK_SET;
+
+    case ',':
+      *str = s+1;
+      return IUPLEX_TK_COMMA;
+
+    case '\"':          /* string */
+      *value = ++s;
+      while (*s && *s != '\"')
+        s++;
+      *len = (int)(s - *value);
+      *str = *s? s+1: s;
+      return IUPLEX_TK_NAME;
+
+    default:
+      if (c > 32)          /* identifier */
+      {
+        *value = s;
+        while (*s && !strchr("=, \t\n\r\f\v", *s))
+          s++;
+        *len = (int)(s - *value);
+        *str = s;
+        return IUPLEX_TK_NAME;
+      }
+      s++;
     }
   }
+}
+
+static void iParseAttributes(Iled* led, const char* str)
+{
+  int name = -1, value = -1, count = 0;
+  char state = 'a';               /* get attribute */
+  int end = 0;
+
+  for (;;)
+  {
+    const char* token = NULL;
+    int len = 0;
 
-  iupLexClose();
-  return NULL;
+    switch (iParseAttribToken(&str, &token, &len))
+    {
+    case IUPLEX_TK_END:           /* same as IUPLEX_TK_COMMA */
+      end = 1;
+    case IUPLEX_TK_COMMA:
+      if (name != -1)
+      {
+        IledbAttrib* attrib = (IledbAttrib*)iParseSectionAdd(&led->attribs, 1);
+        attrib->name = name;
+        attrib->value = value;
+        count++;
+      }
+      if (end)
+      {
+        /* attributes of the last element */
+        ((IledbElem*)led->elems.data)[led->elems.count-1].attrib_count += count;
+        return;
+      }
+      name = value = -1;
+      state = 'a';
+      break;
+
+    case IUPLEX_TK_SET:
+      state = 'v';                /* get value */
+      break;
+
+    case IUPLEX_TK_NAME:
+      if (state == 'a')
+        name = iParseAddStringN(led, token, len);
+      else
+        value = iParseAddStringN(led, token, len);
+      break;
+    }
+  }
 }
 
-char* IupLoadBuffer(const char *buffer)
+static int iParseExp(Ilex* lex, Iled* led);
+
+static int iParseControlParam(Ilex* lex, Iled* led, char type, IparseSection* params)
 {
-  iupASSERT(buffer!=NULL);
-  if (!buffer)
-    return "invalid buffer";
+  IledbParam* param;
+  int param_type, value;
 
-  iparse_error = iupLexStart(buffer, 0);
-  if (iparse_error)
+  switch(type)
   {
-    iupLexClose();
-    return iupLexGetError();
+  case 'a':
+  case 'b':
+  case 'i':
+  case 'j':
+  case 'f':
+    if (iupLexLookAhead(lex) != IUPLEX_TK_NAME)
+      return iupLexMatch(lex, IUPLEX_TK_NAME);
+    /* converted only when built */
+    value = iParseAddString(led, iupLexName(lex));
+    param_type = IUPLEDB_PARAM_NAME;
+    break;
+
+  case 's':
+    if (iupLexLookAhead(lex) != IUPLEX_TK_STR)
+      return iupLexMatch(lex, IUPLEX_TK_STR);
+    value = iParseAddString(led, iupLexName(lex));
+    param_type = IUPLEDB_PARAM_STRING;
+    break;
+
+  case 'g':
+  case 'h':
+    value = iParseExp(lex, led);
+    if (value == -1)
+      return IUPLEX_PARSEERROR;
+    param_type = IUPLEDB_PARAM_ELEM;
+    break;
+
+  default:
+    return 0;  /* not supported in LED */
   }
 
-  while (iupLexLookAhead() != IUPLEX_TK_END)
+  param = (IledbParam*)iParseSectionAdd(params, 1);
+  param->type = param_type;
+  param->value = value;
+
+  if (param_type == IUPLEDB_PARAM_ELEM)
+    return 0;
+  return iupLexAdvance(lex);
+}
+
+static int iParseControlData(Ilex* lex, Iled* led, IparseSection* params)
+{
+  /* an array of bytes is stored compacted, see IupImage */
+  IparseSection bytes;
+  IledbParam* param;
+  int match, erro = 0;
+
+  iParseSectionInit(&bytes, 1);
+  do
+  {
+    unsigned int b = 0;
+    if (iupLexLookAhead(lex) != IUPLEX_TK_NAME)
+      erro = iupLexMatch(lex, IUPLEX_TK_NAME);
+    else
+    {
+      sscanf(iupLexName(lex), "%u", &b);  /* read as integer to avoid reading number as characters */
+      if (b>255) b = 255;
+      *(unsigned char*)iParseSectionAdd(&bytes, 1) = (unsigned char)b;
+      erro = iupLexAdvance(lex);
+    }
+    if (erro)
+    {
+      free(bytes.data);
+      return erro;
+    }
+    match = iupLexSeenMatch(lex, IUPLEX_TK_COMMA, &erro);
+    if (erro)
+    {
+      free(bytes.data);
+      return erro;
+    }
+  } while (match);
+
+  param = (IledbParam*)iParseSectionAdd(params, 1);
+  param->type = IUPLEDB_PARAM_DATA;
+  param->value = led->data.count;
+
+  /* the size, the data, and the padding to keep the next size aligned */
+  *(int*)iParseSectionAdd(&led->data, sizeof(int)) = bytes.count;
+  memcpy(iParseSectionAdd(&led->data, bytes.count), bytes.data, bytes.count);
+  iParseSectionAdd(&led->data, (sizeof(int) - bytes.count % sizeof(int)) % sizeof(int));
+
+  free(bytes.data);
+  return 0;
+}
+
+static int iParseControlParams(Ilex* lex, Iled* led, Iclass *ic, IparseSection* params)
+{
+  const char *format = ic->format;
+  int i, erro;
+
+  if (!format)
+    return 0;
+
+  for (i = 0; format[i]; )
   {
-    iParseExp();
-    if (iparse_error)
+    char p_format = format[i];
+
+    if (i > 0)
     {
-      iupLexClose();
-      return iupLexGetError();
+      erro = iupLexMatch(lex, IUPLEX_TK_COMMA);
+      if (erro)
+        return erro;
+    }
+
+    if (p_format == 'c')   /* array of bytes */
+      return iParseControlData(lex, led, params);
+    else if (p_format != 'j' &&    /* not array */
+             p_format != 'g')
+    {
+      erro = iParseControlParam(lex, led, p_format, params);
+      if (erro)
+        return erro;
+      i++;
+    }
+    else    /* array */
+    {
+      int match;
+      do
+      {
+        erro = iParseControlParam(lex, led, p_format, params);
+        if (erro)
+          return erro;
+        match = iupLexSeenMatch(lex, IUPLEX_TK_COMMA, &erro);
+        if (erro)
+          return erro;
+      } while (match);
+
+      /* after an array of parameters there are no more parameters */
+      break;
     }
   }
 
-  iupLexClose();
-  return NULL;
+  return 0;
 }
 
-static Ihandle* iParseExp(void)
+static int iParseControl(Ilex* lex, Iled* led, Iclass *ic)
 {
-  char* nm = NULL;
-  Ihandle* ih = NULL;
+  IparseSection params;
+  int elem = -1;
 
-  int match = iupLexSeenMatch(IUPLEX_TK_FUNC,&iparse_error);
-  IPARSE_RETURN_IF_ERRO(iparse_error);
+  /* the parameters of the children are stored before,
+     so the parameters of the control are kept apart until all are parsed */
+  iParseSectionInit(&params, sizeof(IledbParam));
 
-  if (match)
-    return iParseFunction(iupLexGetClass());
+  if (!iParseControlParams(lex, led, ic, &params))
+    elem = iParseAddElem(led, iParseAddClass(led, ic), (IledbParam*)params.data, params.count);
 
-  if (iupLexLookAhead() == IUPLEX_TK_NAME)
+  if (params.data)
+    free(params.data);
+  return elem;
+}
+
+static int iParseFunction(Ilex* lex, Iled* led, Iclass *ic)
+{
+  char *attr = NULL;
+  int elem;
+
+  if (iupLexLookAhead(lex) == IUPLEX_TK_ATTR)
   {
-    nm = iupLexGetName();
-    IPARSE_RETURN_IF_ERRO(iupLexAdvance());
+    attr = iupStrDup(iupLexName(lex));
+    if (iupLexAdvance(lex))
+    {
+      free(attr);
+      return -1;
+    }
   }
-  else
+
+  if (iupLexMatch(lex, IUPLEX_TK_BEGP))
+  {
+    if (attr) free(attr);
+    return -1;
+  }
+
+  elem = iParseControl(lex, led, ic);
+  if (elem == -1)
+  {
+    if (attr) free(attr);
+    return -1;
+  }
+
+  if (attr)
   {
-    iparse_error = iupLexMatch(IUPLEX_TK_NAME);
-    return NULL;  /* force iparse_error */
+    iParseAttributes(led, attr);
+    free(attr);
   }
 
-  match = iupLexSeenMatch(IUPLEX_TK_SET,&iparse_error); 
-  IPARSE_RETURN_IF_ERRO(iparse_error);
+  if (iupLexMatch(lex, IUPLEX_TK_ENDP))
+    return -1;
+  return elem;
+}
+
+static int iParseExp(Ilex* lex, Iled* led)
+{
+  int name, elem, match, erro = 0;
+
+  if (iupLexLookAhead(lex) == IUPLEX_TK_FUNC)
+  {
+    Iclass* ic = iupLexGetClass(lex);
+    if (iupLexAdvance(lex))
+      return -1;
+    return iParseFunction(lex, led, ic);
+  }
+
+  if (iupLexLookAhead(lex) != IUPLEX_TK_NAME)
+  {
+    iupLexMatch(lex, IUPLEX_TK_NAME);  /* force the error */
+    return -1;
+  }
+
+  name = iParseAddString(led, iupLexName(lex));
+  if (iupLexAdvance(lex))
+    return -1;
+
+  match = iupLexSeenMatch(lex, IUPLEX_TK_SET, &erro);
+  if (erro)
+    return -1;
 
   if (match)
   {
-    ih = iParseExp();  
-    IPARSE_RETURN_IF_ERRO(iparse_error);
-    IupSetHandle(nm, ih);
+    elem = iParseExp(lex, led);
+    if (elem == -1)
+      return -1;
+    return iParseSetName(led, elem, name);
+  }
+
+  /* the handle is searched only when built,
+     so it can be declared in other source parsed at the same time */
+  return iParseAddReference(led, IUPLEDB_PARAM_NAME, name);
+}
+
+static void iParseBuffer(Iled* led, const char* buffer, int size)
+{
+  Ilex lex;
+  int erro;
+
+  iupLexInit(&lex, led->filename);
+
+  erro = iupLexStart(&lex, buffer, size);
+  while (!erro && iupLexLookAhead(&lex) != IUPLEX_TK_END)
+  {
+    if (iParseExp(&lex, led) == -1)
+      erro = IUPLEX_PARSEERROR;
   }
+
+  if (erro)
+    led->error = iupStrDup(iupLexGetError(&lex));
   else
   {
-    ih = IupGetHandle(nm);
-    if (!ih)
-      IPARSE_RETURN_IF_ERRO(iParseError(IPARSE_SYMBNOTDEF,nm));
+    IledbDesc* desc = &led->desc;
+    desc->string_count = led->strings.count;
+    desc->strings = (const int*)led->strings.data;
+    desc->pool = led->pool.data;
+    desc->class_count = led->classes.count;
+    desc->classes = (const int*)led->classes.data;
+    desc->elem_count = led->elems.count;
+    desc->elems = (const IledbElem*)led->elems.data;
+    desc->param_count = led->params.count;
+    desc->params = (const IledbParam*)led->params.data;
+    desc->attrib_count = led->attribs.count;
+    desc->attribs = (const IledbAttrib*)led->attribs.data;
+    desc->data_size = led->data.count;
+    desc->data = (const unsigned char*)led->data.data;
   }
 
-  if (nm) free(nm);
-  return ih;
+  iupLexClose(&lex);
 }
 
-static void* iParseControlParam(char type)
+static void iParseBinary(Iled* led, const void* data, int size)
 {
-  switch(type)
+  const char* msg = iupLedBinOpen(&led->desc, data, size);
+  if (msg)
   {
-  case 'a':
-    IPARSE_RETURN_IF_ERRO(iupLexMatch(IUPLEX_TK_NAME));
-    return iupLexGetName();
+    char error[1024];
+    sprintf(error, "led(%.400s): bad binary input - %s\n", led->filename, msg);
+    led->error = iupStrDup(error);
+  }
+}
 
-  case 's':
-    IPARSE_RETURN_IF_ERRO(iupLexMatch(IUPLEX_TK_STR));
-    return iupLexGetName();
+static Iled* iParseCreate(const char* filename)
+{
+  Iled* led = (Iled*)malloc(sizeof(Iled));
+  memset(led, 0, sizeof(Iled));
+  led->filename = iupStrDup(filename);
+  iParseSectionInit(&led->strings, sizeof(int));
+  iParseSectionInit(&led->pool, 1);
+  iParseSectionInit(&led->classes, sizeof(int));
+  iParseSectionInit(&led->elems, sizeof(IledbElem));
+  iParseSectionInit(&led->params, sizeof(IledbParam));
+  iParseSectionInit(&led->attribs, sizeof(IledbAttrib));
+  iParseSectionInit(&led->data, 1);
+  iParseSectionInit(&led->class_ptrs, sizeof(Iclass*));
+  return led;
+}
 
-  case 'b':
-  case 'c':
-    IPARSE_RETURN_IF_ERRO(iupLexMatch(IUPLEX_TK_NAME));
-    return (void*)(unsigned long)iupLexByte();
+Iled* IupLedParse(const char* filename)
+{
+  Iled* led;
+  void* map;
+  int size;
 
-  case 'i':
-  case 'j':
-    IPARSE_RETURN_IF_ERRO(iupLexMatch(IUPLEX_TK_NAME));
-    return (void*)(unsigned long)iupLexInt();
+  /* no iupASSERT, it is not thread safe */
+  if (!filename)
+    return NULL;
 
-  case 'f':
-    IPARSE_RETURN_IF_ERRO(iupLexMatch(IUPLEX_TK_NAME));
+  led = iParseCreate(filename);
+
+  map = iupdrvMapFile(filename, &size);
+  if (map)
+  {
+    if (iupLedBinIsBinary(map, size))
+    {
+      /* files generated by "ledc -b" are used without parsing */
+      led->map = map;
+      led->map_size = size;
+      iParseBinary(led, map, size);
+    }
+    else
+    {
+      iParseBuffer(led, (const char*)map, size);
+      iupdrvUnmapFile(map, size);
+    }
+  }
+  else
+  {
+    /* empty files can not be mapped */
+    IparseSection buffer;
+    FILE* file = fopen(filename, "rb");
+    if (!file)
     {
-      float f = iupLexFloat();
-      unsigned long* l = (unsigned long*)&f;
-      return (void*)*l;
+      Ilex lex;
+      iupLexInit(&lex, filename);
+      iupLexError(&lex, IUPLEX_FILENOTOPENED, filename);
+      led->error = iupStrDup(iupLexGetError(&lex));
+      return led;
     }
 
-  case 'g':
-  case 'h':
+    iParseSectionInit(&buffer, 1);
+    for (;;)
     {
-      char *new_control = (char*)iParseExp();
-      IPARSE_RETURN_IF_ERRO(iparse_error);
-      return new_control;
+      char* buf = (char*)iParseSectionAdd(&buffer, 4096);
+      int count = (int)fread(buf, 1, 4096, file);
+      buffer.count -= 4096 - count;
+      if (count < 4096)
+        break;
     }
+    fclose(file);
 
-  default:
-    return 0;
+    iParseBuffer(led, buffer.data, buffer.count);
+    free(buffer.data);
   }
+
+  return led;
 }
 
-static Ihandle* iParseControl(Iclass *ic)
+Iled* IupLedParseBuffer(const char* buffer, int size)
 {
-  const char *format = ic->format;
-  if (!format || format[0] == 0)
-    return iupObjectCreate(ic, NULL); 
-  else
-  { 
-    Ihandle *new_control;
-    void** params;
-    int i, alloc_arg, num_arg,
-        num_format = strlen(format);
-                      
-    num_arg = num_format;
-    alloc_arg = num_arg+20;
-    params = (void**)malloc(sizeof(void*)*alloc_arg);
-
-    for (i = 0; i < num_arg; )
-    {
-      char p_format = format[i];
+  Iled* led;
 
-      if (i > 0)
-        IPARSE_RETURN_IF_ERRO2(iupLexMatch (IUPLEX_TK_COMMA), params);
+  /* no iupASSERT, it is not thread safe */
+  if (!buffer || size < 0)
+    return NULL;
 
-      if (p_format != 'j' &&    /* not array */
-          p_format != 'g' && 
-          p_format != 'c')
-      {
-        params[i] = iParseControlParam(p_format);
-        i++;
-        IPARSE_RETURN_IF_ERRO2(iparse_error, params);
-      }
-      else    /* array */
-      {
-        int match;
-        do
-        {
-          if (num_arg == i)
-          {
-            num_arg++;
-            if (num_arg >= alloc_arg)
-            {
-              alloc_arg = num_arg+20;
-              params = realloc(params, sizeof(void*)*alloc_arg);
-            }
-          }
-          params[i] = iParseControlParam(p_format);
-          i++;
-          IPARSE_RETURN_IF_ERRO2(iparse_error, params);
-          match = iupLexSeenMatch(IUPLEX_TK_COMMA,&iparse_error);
-          IPARSE_RETURN_IF_ERRO2(iparse_error, params);
-        } while (match); 
-
-        /* after an array of parameters there are no more parameters */
-        break;
-      }
-    }
+  led = iParseCreate("buffer");
 
-    params[i] = NULL;
-    new_control = iupObjectCreate(ic, params);
+  if (iupLedBinIsBinary(buffer, size))
+  {
+    /* copied, because the buffer may not be aligned */
+    led->buffer = (char*)malloc(size);
+    memcpy(led->buffer, buffer, size);
+    iParseBinary(led, led->buffer, size);
+  }
+  else
+    iParseBuffer(led, buffer, size);
 
-    for (i = 0; params[i] && i<num_format ; i++)
-    {
-      if (format[i] == 'j' ||
-          format[i] == 'g' || 
-          format[i] == 'c')
-        break;
+  return led;
+}
 
-      if (format[i] == 'a' || format[i] == 's')
-        free(params[i]);   /* iupLexGetName returned a duplicated string */
-    }
+char* IupLedGetError(Iled* led)
+{
+  if (!led)
+    return NULL;
 
-    free(params);
-    return new_control;
-  }
+  return led->error;
 }
 
-static Ihandle* iParseFunction(Iclass *ic)
+char* IupLedBuild(Iled* led)
 {
-  Ihandle* ih = NULL;
-  char *attr = NULL;
+  char* error;
 
-  int match = iupLexSeenMatch(IUPLEX_TK_ATTR,&iparse_error); 
-  IPARSE_RETURN_IF_ERRO(iparse_error);
+  iupASSERT(led!=NULL);
+  if (!led)
+    return "invalid LED";
 
-  if (match)
-    attr = (char*)iupStrDup(iupLexName());
+  if (led->error)
+    return led->error;
 
-  IPARSE_RETURN_IF_ERRO(iupLexMatch(IUPLEX_TK_BEGP));
+  error = iupLedBinBuild(&led->desc, led->filename);
+  if (error)
+    led->error = iupStrDup(error);
 
-  ih = iParseControl(ic);
-  IPARSE_RETURN_IF_ERRO(iparse_error);
+  return led->error;
+}
 
-  if (attr)
+void IupLedDestroy(Iled* led)
+{
+  if (!led)
+    return;
+
+  if (led->map)
+    iupdrvUnmapFile(led->map, led->map_size);
+  if (led->buffer)
+    free(led->buffer);
+  if (led->error)
+    free(led->error);
+
+  free(led->strings.data);
+  free(led->pool.data);
+  free(led->classes.data);
+  free(led->elems.data);
+  free(led->params.data);
+  free(led->attribs.data);
+  free(led->data.data);
+  free(led->class_ptrs.data);
+
+  free(led->filename);
+  free(led);
+}
+
+static char* iParseLoad(Iled* led)
+{
+  char* error = IupLedBuild(led);
+  if (error)
   {
-    IupSetAttributes(ih, attr);
-    free(attr);
+    iupStrCopyN(iparse_error, sizeof(iparse_error), error);
+    error = iparse_error;
   }
 
-  IPARSE_RETURN_IF_ERRO(iupLexMatch(IUPLEX_TK_ENDP));
-  return ih;
+  IupLedDestroy(led);
+  return error;
 }
 
-static int iParseError(int err, char *s)
+char* IupLoad(const char *filename)
 {
-  char msg[256] = "";
+  iupASSERT(filename!=NULL);
+  if (!filename)
+    return "invalid file name";
 
-  switch (err)
-  {
-  case IPARSE_SYMBEXIST:
-    sprintf(msg, "symbol '%s' already exists", s);
-    break;
-  case IUPLEX_NOTMATCH:
-    sprintf(msg, "symbol '%s' not defined", s);
-    break;
-  }
+  return iParseLoad(IupLedParse(filename));
+}
+
+char* IupLoadBuffer(const char *buffer)
+{
+  iupASSERT(buffer!=NULL);
+  if (!buffer)
+    return "invalid buffer";
 
-  return iupLexError(IUPLEX_PARSEERROR, msg);
+  return iParseLoad(IupLedParseBuffer(buffer, (int)strlen(buffer)));
 }
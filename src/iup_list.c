@@ -25,6 +25,8 @@
 #include "iup_list.h"
 
 
+#define ILIST_MAX_SAMPLE 1000  /* maximum number of items measured to compute the natural size */
+
 void iupListSingleCallDblClickCallback(Ihandle* ih, IFnis cb, int pos)
 {
   char *text;
@@ -173,6 +175,109 @@ void iupListMultipleCallActionCallback(Ihandle* ih, IFnsii cb, IFns multi_cb, in
   free(str);
 }
 
+static void iListCallRangeCallback(Ihandle* ih, IFniii cb, int first, int last, int state)
+{
+  if (cb(ih, first+1, last+1, state) == IUP_CLOSE)  /* IUP starts at 1 */
+    IupExitLoop();
+}
+
+void iupListMultipleCallRangeCallback(Ihandle* ih, IFniii cb, int* ranges, int range_count)
+{
+  /* ranges are sorted disjoint pairs of first,last positions (starting at 0).
+     The new selection is compared with the last notified one 
+     and only the runs of items that changed its state are notified.
+     If cb is NULL just stores the new selection. */
+  int* old_ranges = ih->data->sel_ranges;
+  int old_count = ih->data->sel_range_count;
+  int i = 0, j = 0, pos = 0;
+  int run_first = -1, run_last = -1, run_state = 0;
+
+  while (cb && (i < range_count || j < old_count))
+  {
+    int in_new = 0, in_old = 0, next_new = -1, next_old = -1, next;
+
+    if (i < range_count)
+    {
+      in_new = (pos >= ranges[2*i]);
+      next_new = in_new? ranges[2*i+1]+1: ranges[2*i];
+    }
+    if (j < old_count)
+    {
+      in_old = (pos >= old_ranges[2*j]);
+      next_old = in_old? old_ranges[2*j+1]+1: old_ranges[2*j];
+    }
+
+    if (next_new == -1)
+      next = next_old;
+    else if (next_old == -1 || next_new < next_old)
+      next = next_new;
+    else
+      next = next_old;
+
+    /* all the items in [pos,next-1] have the same state */
+    if (in_new != in_old)
+    {
+      if (run_first != -1 && (run_state != in_new || run_last+1 != pos))
+      {
+        iListCallRangeCallback(ih, cb, run_first, run_last, run_state);
+        run_first = -1;
+      }
+
+      if (run_first == -1)
+      {
+        run_first = pos;
+        run_state = in_new;
+      }
+      run_last = next-1;
+    }
+
+    pos = next;
+    if (i < range_count && pos > ranges[2*i+1])
+      i++;
+    if (j < old_count && pos > old_ranges[2*j+1])
+      j++;
+  }
+
+  if (run_first != -1)
+    iListCallRangeCallback(ih, cb, run_first, run_last, run_state);
+
+  if (range_count > ih->data->sel_range_max)
+  {
+    ih->data->sel_range_max = range_count;
+    ih->data->sel_ranges = (int*)realloc(ih->data->sel_ranges, 2*range_count*sizeof(int));
+  }
+  if (range_count)
+    memcpy(ih->data->sel_ranges, ranges, 2*range_count*sizeof(int));
+  ih->data->sel_range_count = range_count;
+}
+
+static void iListClipSelRanges(Ihandle* ih, int count)
+{
+  /* items removed from the end are not notified */
+  int n = ih->data->sel_range_count;
+  while (n > 0 && ih->data->sel_ranges[2*(n-1)] >= count)
+    n--;
+  if (n > 0 && ih->data->sel_ranges[2*n-1] >= count)
+    ih->data->sel_ranges[2*n-1] = count-1;
+  ih->data->sel_range_count = n;
+}
+
+char* iupListGetVirtualValue(Ihandle* ih, int pos)
+{
+  sIFni cb = (sIFni)IupGetCallback(ih, "VALUE_CB");
+  if (cb)
+    return cb(ih, pos);  /* starts at 1 */
+  return NULL;
+}
+
+char* iupListGetVirtualImage(Ihandle* ih, int pos)
+{
+  sIFni cb = (sIFni)IupGetCallback(ih, "IMAGE_CB");
+  if (cb)
+    return cb(ih, pos);  /* starts at 1 */
+  return NULL;
+}
+
 int iupListGetPosAttrib(Ihandle* ih, int pos)
 {
   int count;
@@ -194,6 +299,10 @@ void iupListSetInitialItems(Ihandle* ih)
 {
   char str[20], *value;
   int i = 1;
+
+  if (ih->data->is_virtual)
+    return;
+
   sprintf(str, "%d", i);
   while ((value = iupAttribGet(ih, str))!=NULL)
   {
@@ -243,7 +352,12 @@ char* iupListGetNCAttrib(Ihandle* ih)
 
 int iupListSetIdValueAttrib(Ihandle* ih, int pos, const char* value)
 {
-  int count = iupdrvListGetCount(ih);
+  int count;
+
+  if (ih->data->is_virtual)  /* items are provided by VALUE_CB */
+    return 0;
+
+  count = iupdrvListGetCount(ih);
 
   pos--; /* IUP starts at 1 */
 
@@ -282,7 +396,7 @@ int iupListSetIdValueAttrib(Ihandle* ih, int pos, const char* value)
 
 static int iListSetAppendItemAttrib(Ihandle* ih, const char* value)
 {
-  if (!ih->handle)  /* do not do the action before map */
+  if (!ih->handle || ih->data->is_virtual)  /* do not do the action before map */
     return 0;
   if (value)
     iupdrvListAppendItem(ih, value);
@@ -291,7 +405,7 @@ static int iListSetAppendItemAttrib(Ihandle* ih, const char* value)
 
 static int iListSetInsertItemAttrib(Ihandle* ih, int id, const char* value)
 {
-  if (!ih->handle)  /* do not do the action before map */
+  if (!ih->handle || ih->data->is_virtual)  /* do not do the action before map */
     return 0;
   if (value)
   {
@@ -306,7 +420,7 @@ static int iListSetInsertItemAttrib(Ihandle* ih, int id, const char* value)
 
 static int iListSetRemoveItemAttrib(Ihandle* ih, const char* value)
 {
-  if (!ih->handle)  /* do not do the action before map */
+  if (!ih->handle || ih->data->is_virtual)  /* do not do the action before map */
     return 0;
   if (!value || iupStrEqualNoCase(value, "ALL"))
   {
@@ -329,7 +443,9 @@ static int iListSetRemoveItemAttrib(Ihandle* ih, const char* value)
 static int iListGetCount(Ihandle* ih)
 {
   int count;
-  if (ih->handle)
+  if (ih->data->is_virtual)
+    count = ih->data->virtual_count;
+  else if (ih->handle)
     count = iupdrvListGetCount(ih);
   else
   {
@@ -352,6 +468,52 @@ static char* iListGetCountAttrib(Ihandle* ih)
   return str;
 }
 
+static int iListSetCountAttrib(Ihandle* ih, const char* value)
+{
+  int count;
+
+  /* read-only when not in virtual mode */
+  if (!ih->data->is_virtual)
+    return 0;
+
+  if (iupStrToInt(value, &count) && count >= 0)
+  {
+    iListClipSelRanges(ih, count);
+    ih->data->virtual_count = count;
+
+    if (ih->handle)
+      iupdrvListSetVirtualCount(ih, count);
+  }
+
+  return 0;
+}
+
+static int iListSetVirtualModeAttrib(Ihandle* ih, const char* value)
+{
+  /* valid only before map */
+  if (ih->handle)
+    return 0;
+
+  if (iupStrBoolean(value))
+  {
+    ih->data->is_virtual = 1;
+    ih->data->is_dropdown = 0;
+    ih->data->has_editbox = 0;
+  }
+  else
+    ih->data->is_virtual = 0;
+
+  return 0;
+}
+
+static char* iListGetVirtualModeAttrib(Ihandle* ih)
+{
+  if (ih->data->is_virtual)
+    return "YES";
+  else
+    return "NO";
+}
+
 static int iListSetDropdownAttrib(Ihandle* ih, const char* value)
 {
   /* valid only before map */
@@ -362,6 +524,7 @@ static int iListSetDropdownAttrib(Ihandle* ih, const char* value)
   {
     ih->data->is_dropdown = 1;
     ih->data->is_multiple = 0;
+    ih->data->is_virtual = 0;
   }
   else
     ih->data->is_dropdown = 0;
@@ -413,6 +576,7 @@ static int iListSetEditboxAttrib(Ihandle* ih, const char* value)
   {
     ih->data->has_editbox = 1;
     ih->data->is_multiple = 0;
+    ih->data->is_virtual = 0;
   }
   else
     ih->data->has_editbox = 0;
@@ -653,7 +817,13 @@ static void iListGetItemImageInfo(Ihandle *ih, int id, int *img_w, int *img_h)
   *img_w = 0;
   *img_h = 0;
 
-  if (!ih->handle)
+  if (ih->data->is_virtual)
+  {
+    char *value = iupListGetVirtualImage(ih, id);
+    if (value)
+      iupImageGetInfo(value, img_w, img_h, NULL);
+  }
+  else if (!ih->handle)
   {
     char *value;
     char str[20];
@@ -673,12 +843,37 @@ static void iListGetItemImageInfo(Ihandle *ih, int id, int *img_w, int *img_h)
   }
 }
 
-static void iListGetNaturalItemsSize(Ihandle *ih, int *w, int *h)
+static int iListGetSampleStep(Ihandle *ih, int count)
+{
+  /* large virtual lists are measured using only a sample of evenly spaced items,
+     regular lists measure all the items as before */
+  if (ih->data->is_virtual && count > ILIST_MAX_SAMPLE)
+    return count / ILIST_MAX_SAMPLE;
+  else
+    return 1;
+}
+
+static int iListGetItemWidth(Ihandle *ih, int pos)
 {
   char *value;
+
+  if (ih->data->is_virtual)
+    value = iupListGetVirtualValue(ih, pos);
+  else
+    value = IupGetAttributeId(ih, "", pos);  /* must use IupGetAttribute to check the native system */
+
+  if (value)
+    return iupdrvFontGetStringWidth(ih, value);
+  else
+    return 0;
+}
+
+static void iListGetNaturalItemsSize(Ihandle *ih, int *w, int *h)
+{
   int max_w = 0, max_h = 0;
   int visiblecolumns, i, 
-      count = iListGetCount(ih);
+      count = iListGetCount(ih),
+      step = iListGetSampleStep(ih, count);
 
   *w = 0;
   *h = 0;
@@ -695,14 +890,16 @@ static void iListGetNaturalItemsSize(Ihandle *ih, int *w, int *h)
   {
     int item_w;
 
-    for (i=1; i<=count; i++)
+    for (i=1; i<=count; i+=step)
     {
-      item_w = 0;
-
-      value = IupGetAttributeId(ih, "", i);  /* must use IupGetAttribute to check the native system */
-      if (value)
-        item_w = iupdrvFontGetStringWidth(ih, value);
+      item_w = iListGetItemWidth(ih, i);
+      if (item_w > *w)
+        *w = item_w;
+    }
 
+    if (step > 1)  /* also the last item */
+    {
+      item_w = iListGetItemWidth(ih, count);
       if (item_w > *w)
         *w = item_w;
     }
@@ -713,7 +910,7 @@ static void iListGetNaturalItemsSize(Ihandle *ih, int *w, int *h)
 
   if (ih->data->show_image)
   {
-    for (i=1; i<=count; i++)
+    for (i=1; i<=count; i+=step)
     {
       int img_w, img_h;
       iListGetItemImageInfo(ih, i, &img_w, &img_h);
@@ -809,6 +1006,9 @@ static void iListDestroyMethod(Ihandle* ih)
 {
   if (ih->data->mask)
     iupMaskDestroy(ih->data->mask);
+
+  if (ih->data->sel_ranges)
+    free(ih->data->sel_ranges);
 }
 
 
@@ -852,6 +1052,9 @@ Iclass* iupListNewClass(void)
   iupClassRegisterCallback(ic, "MOTION_CB", "iis");
   iupClassRegisterCallback(ic, "BUTTON_CB", "iiiis");
   iupClassRegisterCallback(ic, "DRAGDROP_CB", "iiii");
+  iupClassRegisterCallback(ic, "VALUE_CB", "i=s");
+  iupClassRegisterCallback(ic, "IMAGE_CB", "i=s");
+  iupClassRegisterCallback(ic, "SELECTRANGE_CB", "iii");
 
   iupClassRegisterCallback(ic, "EDIT_CB", "is");
   iupClassRegisterCallback(ic, "CARET_CB", "iii");
@@ -873,7 +1076,8 @@ Iclass* iupListNewClass(void)
   iupClassRegisterAttribute(ic, "MULTIPLE", iListGetMultipleAttrib, iListSetMultipleAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "DROPDOWN", iListGetDropdownAttrib, iListSetDropdownAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "EDITBOX", iListGetEditboxAttrib, iListSetEditboxAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "COUNT", iListGetCountAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "COUNT", iListGetCountAttrib, iListSetCountAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "VIRTUALMODE", iListGetVirtualModeAttrib, iListSetVirtualModeAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "INSERTITEM", NULL, iListSetInsertItemAttrib, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "APPENDITEM", NULL, iListSetAppendItemAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "REMOVEITEM", NULL, iListSetRemoveItemAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
@@ -20,12 +20,16 @@ void iupdrvListAppendItem(Ihandle* ih, const char* value);
 void iupdrvListInsertItem(Ihandle* ih, int pos, const char* value);
 void iupdrvListRemoveItem(Ihandle* ih, int pos);
 void iupdrvListRemoveAllItems(Ihandle* ih);
+void iupdrvListSetVirtualCount(Ihandle* ih, int count);
 
 int iupListGetPosAttrib(Ihandle* ih, int id);
 int iupListSetIdValueAttrib(Ihandle* ih, int id, const char* value);
 void iupListSetInitialItems(Ihandle* ih);
 void iupListSingleCallActionCallback(Ihandle* ih, IFnsii cb, int pos);
 void iupListMultipleCallActionCallback(Ihandle* ih, IFnsii cb, IFns multi_cb, int* pos, int sel_count);
+void iupListMultipleCallRangeCallback(Ihandle* ih, IFniii cb, int* ranges, int range_count);
+char* iupListGetVirtualValue(Ihandle* ih, int pos);
+char* iupListGetVirtualImage(Ihandle* ih, int pos);
 char* iupListGetNCAttrib(Ihandle* ih);
 char* iupListGetPaddingAttrib(Ihandle* ih);
 char* iupListGetSpacingAttrib(Ihandle* ih);
@@ -47,7 +51,12 @@ struct _IcontrolData
       has_editbox,
       maximg_w, maximg_h, /* used only in Windows */
       show_image,
-      show_dragdrop;
+      show_dragdrop,
+      is_virtual,     /* items are provided by VALUE_CB, only for a non dropdown list without editbox */
+      virtual_count;
+  int *sel_ranges,    /* last notified selection, pairs of first,last 0 based positions, used only by SELECTRANGE_CB */
+      sel_range_count, 
+      sel_range_max;
   Imask* mask;
 };
 
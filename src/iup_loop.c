@@ -0,0 +1,551 @@
+/** \file
+ * \brief Message Loop Utilities, independent from the driver
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "iup.h"
+#include "iupcbs.h"
+
+#include "iup_object.h"
+#include "iup_drv.h"
+#include "iup_assert.h"
+#include "iup_str.h"
+#include "iup_loop.h"
+
+
+/* Messages posted from any thread to the main loop.
+
+   Each element keeps only its last message not delivered yet (ih->post_message),
+   a new post replaces the pending one, so repeated posts are coalesced.
+   When the element had no pending message a token is pushed into a lock free stack,
+   shared by all the threads. The main thread is the only consumer,
+   it takes the whole stack at once and reverses it to deliver the tokens in FIFO order.
+
+   Both the stack and the pending message are changed only by atomic operations,
+   so each message is either delivered by the main thread or released by the thread that replaced it.
+   The driver is waked up only when the stack changes from empty to not empty. */
+
+#if defined(WIN32)
+#define iLoopAtomicCAS(_ptr, _old, _new) InterlockedCompareExchangePointer((PVOID volatile*)(_ptr), (_new), (_old))
+#define iLoopAtomicExchange(_ptr, _value) InterlockedExchangePointer((PVOID volatile*)(_ptr), (_value))
+#elif defined(__GNUC__)
+#define iLoopAtomicCAS(_ptr, _old, _new) __sync_val_compare_and_swap((_ptr), (_old), (_new))
+static void* iLoopAtomicExchange(void* volatile* ptr, void* value)
+{
+  /* __sync_lock_test_and_set is only an acquire barrier, 
+     the compare and swap is a full barrier */
+  void* old_value = __sync_val_compare_and_swap(ptr, NULL, NULL);
+  for (;;)
+  {
+    void* cur_value = __sync_val_compare_and_swap(ptr, old_value, value);
+    if (cur_value == old_value)
+      return old_value;
+    old_value = cur_value;
+  }
+}
+#else
+/* not thread safe, works only when posting from the main thread */
+static void* iLoopAtomicCAS(void* volatile* ptr, void* old_value, void* new_value)
+{
+  void* value = *ptr;
+  if (value == old_value)
+    *ptr = new_value;
+  return value;
+}
+static void* iLoopAtomicExchange(void* volatile* ptr, void* value)
+{
+  void* old_value = *ptr;
+  *ptr = value;
+  return old_value;
+}
+#endif
+
+#define iLoopAtomicGet(_ptr) iLoopAtomicCAS((_ptr), NULL, NULL)
+
+typedef struct _IloopMessage
+{
+  char* s;      /* stored after the structure */
+  int i;
+  double d;
+  void* p;
+} IloopMessage;
+
+typedef struct _IloopToken
+{
+  Ihandle* ih;  /* NULL if cancelled */
+  struct _IloopToken* next;
+} IloopToken;
+
+static void* volatile iloop_post_stack = NULL;  /* IloopToken*, shared by all threads */
+static IloopToken* iloop_post_first = NULL;     /* tokens taken from the stack, used only by the main thread */
+
+static void iLoopGrabTokens(void)
+{
+  IloopToken *token, *next, *reversed = NULL, *last;
+
+  token = (IloopToken*)iLoopAtomicExchange(&iloop_post_stack, NULL);
+  if (!token)
+    return;
+
+  /* the stack is in LIFO order */
+  while (token)
+  {
+    next = token->next;
+    token->next = reversed;
+    reversed = token;
+    token = next;
+  }
+
+  if (!iloop_post_first)
+    iloop_post_first = reversed;
+  else
+  {
+    last = iloop_post_first;
+    while (last->next)
+      last = last->next;
+    last->next = reversed;
+  }
+}
+
+void IupPostMessage(Ihandle* ih, const char* s, int i, double d, void* p)
+{
+  IloopMessage *msg, *old_msg;
+  IloopToken *token;
+  void *head, *old_head;
+  int size = sizeof(IloopMessage);
+
+  /* can NOT use iupObjectCheck here,
+     because the element can not be accessed outside the main thread */
+  iupASSERT(ih!=NULL);
+  if (!ih)
+    return;
+
+  if (s)
+    size += (int)strlen(s)+1;
+
+  msg = (IloopMessage*)malloc(size);
+  if (s)
+  {
+    msg->s = (char*)(msg+1);
+    strcpy(msg->s, s);
+  }
+  else
+    msg->s = NULL;
+  msg->i = i;
+  msg->d = d;
+  msg->p = p;
+
+  old_msg = (IloopMessage*)iLoopAtomicExchange(&(ih->post_message), msg);
+  if (old_msg)
+  {
+    /* still not delivered, so there is already a token for it */
+    free(old_msg);
+    return;
+  }
+
+  token = (IloopToken*)malloc(sizeof(IloopToken));
+  token->ih = ih;
+
+  head = iLoopAtomicGet(&iloop_post_stack);
+  for (;;)
+  {
+    token->next = (IloopToken*)head;
+    old_head = iLoopAtomicCAS(&iloop_post_stack, head, token);
+    if (old_head == head)
+      break;
+    head = old_head;
+  }
+
+  if (!head)
+    iupdrvLoopWakeUp();
+}
+
+void iupLoopProcessPostMessages(void)
+{
+  IloopToken* token;
+  int count = 0;
+
+  iLoopGrabTokens();
+
+  /* process only the tokens available now,
+     tokens posted during the callbacks will wake up the driver again */
+  for (token = iloop_post_first; token; token = token->next)
+    count++;
+
+  while (count > 0 && iloop_post_first)
+  {
+    Ihandle* ih;
+
+    token = iloop_post_first;
+    iloop_post_first = token->next;
+    ih = token->ih;
+    free(token);
+    count--;
+
+    if (ih)
+    {
+      IloopMessage* msg = (IloopMessage*)iLoopAtomicExchange(&(ih->post_message), NULL);
+      if (msg)
+      {
+        IFnsidv cb = (IFnsidv)IupGetCallback(ih, "POSTMESSAGE_CB");
+        if (cb && cb(ih, msg->s, msg->i, msg->d, msg->p) == IUP_CLOSE)
+          IupExitLoop();
+
+        free(msg);
+      }
+    }
+  }
+}
+
+void iupLoopCancelPostMessages(Ihandle* ih)
+{
+  IloopMessage* msg;
+  IloopToken* token;
+
+  msg = (IloopMessage*)iLoopAtomicExchange(&(ih->post_message), NULL);
+  if (!msg)
+    return;  /* no token for it */
+
+  free(msg);
+
+  /* the token can be anywhere, so move all of them to the main thread list */
+  iLoopGrabTokens();
+
+  for (token = iloop_post_first; token; token = token->next)
+  {
+    if (token->ih == ih)
+      token->ih = NULL;
+  }
+}
+
+
+/* Idle tasks.
+
+   The driver idle is owned by the scheduler, it is set while there is at least one task.
+   Each time the driver calls the idle, tasks are called until the time budget is consumed,
+   higher priority first, in round robin among tasks of the same priority.
+   The IDLE_ACTION function is just a task of priority 0.
+   A task can start a nested loop (IupPopup, IupMessage, ...) that calls the dispatch again,
+   so the running tasks are skipped and the removed tasks are released only 
+   when the outermost dispatch returns. */
+
+typedef struct _IloopIdleTask
+{
+  int id;            /* 0 when removed */
+  int priority;
+  IFv func;
+  void* user_data;
+  int calls;
+  int running;       /* inside its function, can not be called again by a nested loop */
+  double time,       /* accumulated time in milliseconds */
+         max_time;   /* longest call in milliseconds */
+  struct _IloopIdleTask* next;
+} IloopIdleTask;
+
+static IloopIdleTask* iloop_idle_tasks = NULL;  /* sorted by priority, higher first */
+static int iloop_idle_last_id = 0;
+static int iloop_idle_running = 0;      /* the driver idle is set */
+static int iloop_idle_dispatching = 0;  /* dispatch nesting depth, removed tasks are released only at 0 */
+static double iloop_idle_budget = 10;   /* milliseconds per idle iteration */
+static IFidle iloop_idle_action = NULL;
+static int iloop_idle_action_id = 0;
+
+double iupLoopGetTime(void)
+{
+#if defined(WIN32)
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER count;
+  if (freq.QuadPart == 0)
+    QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return ((double)count.QuadPart * 1000.0) / (double)freq.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0;
+#endif
+}
+
+static void iLoopIdleInsert(IloopIdleTask* task)
+{
+  /* after all the tasks of the same priority */
+  IloopIdleTask** prev = &iloop_idle_tasks;
+  while (*prev && (*prev)->priority >= task->priority)
+    prev = &((*prev)->next);
+  task->next = *prev;
+  *prev = task;
+}
+
+static void iLoopIdleUnlink(IloopIdleTask* task)
+{
+  IloopIdleTask** prev = &iloop_idle_tasks;
+  while (*prev && *prev != task)
+    prev = &((*prev)->next);
+  if (*prev)
+    *prev = task->next;
+}
+
+static IloopIdleTask* iLoopIdleFind(int id)
+{
+  IloopIdleTask* task;
+  if (id <= 0)
+    return NULL;
+  for (task = iloop_idle_tasks; task; task = task->next)
+  {
+    if (task->id == id)
+      return task;
+  }
+  return NULL;
+}
+
+static IloopIdleTask* iLoopIdleFirst(void)
+{
+  IloopIdleTask* task;
+  for (task = iloop_idle_tasks; task; task = task->next)
+  {
+    if (task->id && !task->running)
+      return task;
+  }
+  return NULL;
+}
+
+static void iLoopIdleRelease(IloopIdleTask* task)
+{
+  if (task->id == iloop_idle_action_id)
+  {
+    /* the function remains registered as IDLE_ACTION, 
+       but it is not called until set again */
+    iloop_idle_action = NULL;
+    iloop_idle_action_id = 0;
+  }
+
+  task->id = 0;
+
+  if (!iloop_idle_dispatching)
+  {
+    iLoopIdleUnlink(task);
+    free(task);
+  }
+}
+
+static void iLoopIdleCollect(void)
+{
+  IloopIdleTask** prev = &iloop_idle_tasks;
+  while (*prev)
+  {
+    IloopIdleTask* task = *prev;
+    if (!task->id)
+    {
+      *prev = task->next;
+      free(task);
+    }
+    else
+      prev = &(task->next);
+  }
+}
+
+static int iLoopIdleDispatch(void)
+{
+  IloopIdleTask* task;
+  double start, t0, t1;
+  int ret, exit_loop = 0;
+
+  iloop_idle_dispatching++;
+
+  start = t1 = iupLoopGetTime();
+
+  /* at least one task is called, even with a zero budget */
+  while ((task = iLoopIdleFirst()) != NULL)
+  {
+    t0 = t1;
+    task->running = 1;
+    ret = task->func(task->user_data);
+    task->running = 0;
+    t1 = iupLoopGetTime();
+
+    if (task->id)  /* can be removed inside the callback */
+    {
+      task->calls++;
+      task->time += t1 - t0;
+      if (t1 - t0 > task->max_time)
+        task->max_time = t1 - t0;
+
+      if (ret == IUP_IGNORE || ret == IUP_CLOSE)
+        iLoopIdleRelease(task);
+      else
+      {
+        /* round robin among tasks of the same priority */
+        iLoopIdleUnlink(task);
+        iLoopIdleInsert(task);
+      }
+    }
+
+    if (ret == IUP_CLOSE)
+    {
+      exit_loop = 1;
+      break;
+    }
+
+    if (t1 - start >= iloop_idle_budget)
+      break;
+  }
+
+  iloop_idle_dispatching--;
+  if (iloop_idle_dispatching)
+  {
+    /* inside a nested loop, the outer dispatch still holds a task.
+       Keep the driver idle, the outer dispatch will update it. */
+    if (exit_loop)
+      IupExitLoop();
+    return IUP_DEFAULT;
+  }
+
+  iLoopIdleCollect();
+
+  if (exit_loop)
+    IupExitLoop();
+
+  if (!iloop_idle_tasks)
+  {
+    iloop_idle_running = 0;
+    return IUP_IGNORE;  /* the driver removes the idle */
+  }
+
+  return IUP_DEFAULT;
+}
+
+static void iLoopIdleUpdateDriver(void)
+{
+  if (iloop_idle_dispatching)
+    return;  /* will be updated by the dispatch return value */
+
+  if (iloop_idle_tasks && !iloop_idle_running)
+  {
+    iloop_idle_running = 1;
+    iupdrvSetIdleFunction((Icallback)iLoopIdleDispatch);
+  }
+  else if (!iloop_idle_tasks && iloop_idle_running)
+  {
+    iloop_idle_running = 0;
+    iupdrvSetIdleFunction(NULL);
+  }
+}
+
+int IupAddIdleTask(Icallback func, void* user_data, int priority)
+{
+  IloopIdleTask* task;
+
+  iupASSERT(func!=NULL);
+  if (!func)
+    return 0;
+
+  task = (IloopIdleTask*)calloc(1, sizeof(IloopIdleTask));
+  task->id = ++iloop_idle_last_id;
+  task->priority = priority;
+  task->func = (IFv)func;
+  task->user_data = user_data;
+
+  iLoopIdleInsert(task);
+  iLoopIdleUpdateDriver();
+
+  return task->id;
+}
+
+void IupRemoveIdleTask(int id)
+{
+  IloopIdleTask* task = iLoopIdleFind(id);
+  if (!task)
+    return;
+
+  iLoopIdleRelease(task);
+  iLoopIdleUpdateDriver();
+}
+
+int IupGetIdleTaskInfo(int id, int *calls, double *time, double *max_time)
+{
+  IloopIdleTask* task = iLoopIdleFind(id);
+  if (!task)
+    return 0;
+
+  if (calls) *calls = task->calls;
+  if (time) *time = task->time;
+  if (max_time) *max_time = task->max_time;
+  return 1;
+}
+
+static int iLoopIdleActionTask(void* user_data)
+{
+  (void)user_data;
+  return iloop_idle_action();
+}
+
+void iupLoopSetIdleFunction(Icallback func)
+{
+  if (iloop_idle_action_id)
+    IupRemoveIdleTask(iloop_idle_action_id);
+
+  if (func)
+  {
+    iloop_idle_action = (IFidle)func;
+    iloop_idle_action_id = IupAddIdleTask((Icallback)iLoopIdleActionTask, NULL, 0);
+  }
+}
+
+void iupLoopSetIdleBudget(const char* value)
+{
+  float budget;
+  if (!value)
+    iloop_idle_budget = 10;
+  else if (iupStrToFloat(value, &budget) && budget >= 0)
+    iloop_idle_budget = budget;
+}
+
+char* iupLoopGetIdleBudget(void)
+{
+  char* str = iupStrGetMemory(50);
+  sprintf(str, "%g", iloop_idle_budget);
+  return str;
+}
+
+void iupLoopFinish(void)
+{
+  IloopToken* token;
+
+  while (iloop_idle_tasks)
+  {
+    IloopIdleTask* task = iloop_idle_tasks;
+    iloop_idle_tasks = task->next;
+    free(task);
+  }
+  iloop_idle_running = 0;
+  iloop_idle_action = NULL;
+  iloop_idle_action_id = 0;
+
+  iLoopGrabTokens();
+
+  while (iloop_post_first)
+  {
+    token = iloop_post_first;
+    iloop_post_first = token->next;
+
+    if (token->ih)
+    {
+      IloopMessage* msg = (IloopMessage*)iLoopAtomicExchange(&(token->ih->post_message), NULL);
+      if (msg)
+        free(msg);
+    }
+
+    free(token);
+  }
+}
@@ -0,0 +1,52 @@
+/** \file
+ * \brief Message Loop Utilities, independent from the driver
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#ifndef __IUP_LOOP_H
+#define __IUP_LOOP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Delivers the messages posted by IupPostMessage to POSTMESSAGE_CB.
+   Called by the driver in the main thread after iupdrvLoopWakeUp. */
+void iupLoopProcessPostMessages(void);
+
+/* Discards the messages posted to the element and not delivered yet.
+   Called from IupDestroy. */
+void iupLoopCancelPostMessages(Ihandle* ih);
+
+/* Replaces the idle task associated with IDLE_ACTION.
+   Called from IupSetFunction. */
+void iupLoopSetIdleFunction(Icallback func);
+
+/* IDLEBUDGET global attribute, in milliseconds. */
+void iupLoopSetIdleBudget(const char* value);
+char* iupLoopGetIdleBudget(void);
+
+/* Returns the wall clock time in milliseconds. 
+   The origin is arbitrary, use only for intervals. */
+double iupLoopGetTime(void);
+
+/* Releases all the messages not delivered yet and all the idle tasks.
+   Called from IupClose. */
+void iupLoopFinish(void);
+
+
+/* Other functions declared in <iup.h> and implemented here.
+IupPostMessage
+IupAddIdleTask
+IupRemoveIdleTask
+IupGetIdleTaskInfo
+*/
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -14,6 +14,7 @@
 #include "iup_str.h"
 #include "iup_array.h"
 #include "iup_stdcontrols.h"
+#include "iup_layout.h"
 
 
 enum {NORMALIZE_NONE, NORMALIZE_WIDTH, NORMALIZE_HEIGHT};
@@ -57,6 +58,10 @@ void iupNormalizeSizeBoxChild(Ihandle *ih, int normalize, int children_natural_m
         child->naturalwidth = children_natural_maxwidth;
       if (normalize & NORMALIZE_HEIGHT)
         child->naturalheight = children_natural_maxheight;
+
+      /* the cached natural size is not the child own size anymore,
+         so it must be recomputed the next time the box is computed. */
+      child->flags |= IUP_LAYOUT_DIRTY;
     }
   }
 }
@@ -89,10 +94,16 @@ static int iNormalizerSetNormalizeAttrib(Ihandle* ih, const char* value)
         (ih_control->iclass->nativetype != IUP_TYPEVOID || 
          !IupClassMatch(ih_control, "fill")))
     {
+      int old_w = ih_control->userwidth, 
+          old_h = ih_control->userheight;
+
       if (normalize & NORMALIZE_WIDTH)
         ih_control->userwidth = natural_maxwidth;
       if (normalize & NORMALIZE_HEIGHT)
         ih_control->userheight = natural_maxheight;
+
+      if (old_w != ih_control->userwidth || old_h != ih_control->userheight)
+        iupLayoutMarkDirty(ih_control);
     }
   }
   return 1;
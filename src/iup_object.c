@@ -15,6 +15,7 @@
 #include "iup_assert.h"
 #include "iup_register.h"
 #include "iup_names.h"
+#include "iup_loop.h"
 
 
 static Ihandle* iHandleCreate(void)
@@ -29,6 +30,9 @@ static Ihandle* iHandleCreate(void)
 
   ih->serial = -1;
 
+  /* not computed and not updated yet */
+  ih->flags = IUP_LAYOUT_DIRTY|IUP_LAYOUT_MOVED;
+
   ih->attrib = iupTableCreate(IUPTABLE_STRINGINDEXED);
 
   return ih;
@@ -37,6 +41,8 @@ static Ihandle* iHandleCreate(void)
 static void iHandleDestroy(Ihandle* ih)
 {
   iupTableDestroy(ih->attrib);
+  if (ih->attrib_id)
+    iupTableDestroy(ih->attrib_id);
   memset(ih, 0, sizeof(Ihandle));
   free(ih);
 }
@@ -179,6 +185,10 @@ void IupDestroy(Ihandle *ih)
   /* destroy the element */
   iupClassObjectDestroy(ih);
 
+  /* discard messages not delivered yet,
+     after the class destroy method, that must stop any thread that posts to the element */
+  iupLoopCancelPostMessages(ih);
+
   /* destroy the private data */
   if (ih->data)
     free(ih->data);
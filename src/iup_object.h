@@ -85,7 +85,11 @@ enum Iflags {
   IUP_FLOATING_IGNORE  = 0x02,   /**< is a floating element. FLOATING=Ignore. Do not compute layout. */
   IUP_MAXSIZE     = 0x04,   /**< has the MAXSIZE attribute set */
   IUP_MINSIZE     = 0x08,   /**< has the MAXSIZE attribute set */
-  IUP_INTERNAL    = 0x10    /**< it is an internal element of the container */
+  IUP_INTERNAL    = 0x10,   /**< it is an internal element of the container */
+  IUP_LAYOUT_DIRTY      = 0x20,   /**< natural size must be recomputed, set when an attribute is changed */
+  IUP_LAYOUT_CHILDDIRTY = 0x40,   /**< a descendant natural size must be recomputed */
+  IUP_LAYOUT_RELAYOUT   = 0x80,   /**< children current size and position must be recomputed */
+  IUP_LAYOUT_MOVED      = 0x100   /**< current size or position changed, but the native element was not updated yet */
 };
 
 
@@ -96,6 +100,7 @@ struct Ihandle_
   char sig[4];           /**< IUP Signature, initialized with "IUP", cleared on destroy */
   Iclass* iclass;        /**< Ihandle Class */
   Itable* attrib;        /**< attributes table */
+  Itable* attrib_id;     /**< attributes with ids at the end of the name ("VALUE12:7"), indexed by name and ids. created when first used */
   int serial;            /**< serial number used for controls that need a numeric id, initialized with -1 */
   InativeHandle* handle; /**< native handle. initialized when mapped. InativeHandle definition is system dependent. */
   int expand;            /**< expand configuration, a combination of \ref Iexpand, for containers is a combination of the children expand's */
@@ -108,6 +113,7 @@ struct Ihandle_
   Ihandle* firstchild;   /**< first child control in the hierarchy tree */
   Ihandle* brother;      /**< next control inside parent */
   IcontrolData* data;    /**< private control data. automatically freed if not NULL in destroy */
+  void* volatile post_message; /**< last message posted by IupPostMessage and not delivered yet. Changed only by atomic operations. */
 };
 
 
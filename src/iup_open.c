@@ -24,6 +24,7 @@
 #include "iup_dlglist.h"
 #include "iup_assert.h"
 #include "iup_strmessage.h"
+#include "iup_loop.h"
 
 
 static int iup_opened = 0;
@@ -103,6 +104,7 @@ void IupClose(void)
 
   iupDlgListDestroyAll();    /* destroy all dialogs and their children */
   iupNamesDestroyHandles();  /* destroy everything that do not belong to a dialog */
+  iupLoopFinish();           /* release messages not delivered */
   iupImageStockFinish();     /* release stock images hash table and the images */
 
   iupRegisterFinish();  /* release native classes */
@@ -7,7 +7,6 @@
 #include <stdlib.h>      
 #include <stdio.h>      
 #include <string.h>      
-#include <time.h>
 
 #include "iup.h" 
 #include "iup_key.h"
@@ -16,15 +15,17 @@
 #include "iup_drvfont.h"
 #include "iup_drvinfo.h"
 #include "iup_str.h"
+#include "iup_loop.h"
 
 
 static FILE* irec_file = NULL;
-static int irec_lastclock = 0;
+static double irec_lastclock = 0;
 static int irec_mode = 0;
 
-static int iRecClock(void)
+static double iRecClock(void)
 {
-  return (int)((clock()*1000)/CLOCKS_PER_SEC); /* time in miliseconds */
+  /* wall clock, clock() is the process time in some systems */
+  return iupLoopGetTime(); /* time in miliseconds */
 }
 
 static void iRecWriteInt(FILE* file, int value, int mode)
@@ -72,7 +73,7 @@ static void iRecInputWheelCB(float delta, int x, int y, char* status)
   (void)status;
   if (irec_file)
   {
-    int time = iRecClock() - irec_lastclock;
+    int time = (int)(iRecClock() - irec_lastclock);
     iRecWriteStr(irec_file, "WHE", irec_mode);
     iRecWriteInt(irec_file, time, irec_mode);
     iRecWriteFloat(irec_file, delta, irec_mode);
@@ -87,7 +88,7 @@ static void iRecInputButtonCB(int button, int pressed, int x, int y, char* statu
 {
   if (irec_file)
   {
-    int time = iRecClock() - irec_lastclock;
+    int time = (int)(iRecClock() - irec_lastclock);
     if (pressed && iup_isdouble(status)) pressed = 2;
     iRecWriteStr(irec_file, "BUT", irec_mode);
     iRecWriteInt(irec_file, time, irec_mode);
@@ -105,7 +106,7 @@ static void iRecInputMotionCB(int x, int y, char* status)
   if (irec_file)
   {
     char button = '0';
-    int time = iRecClock() - irec_lastclock;
+    int time = (int)(iRecClock() - irec_lastclock);
     iRecWriteStr(irec_file, "MOV", irec_mode);
     iRecWriteInt(irec_file, time, irec_mode);
     iRecWriteInt(irec_file, x, irec_mode);
@@ -125,7 +126,7 @@ static void iRecInputKeyPressCB(int key, int pressed)
 {
   if (irec_file)
   {
-    int time = iRecClock() - irec_lastclock;
+    int time = (int)(iRecClock() - irec_lastclock);
     iRecWriteStr(irec_file, "KEY", irec_mode);
     iRecWriteInt(irec_file, time, irec_mode);
     iRecWriteInt(irec_file, key, irec_mode);
@@ -180,207 +181,402 @@ int IupRecordInput(const char* filename, int mode)
 /*************************************************************************************/
 
 
-static void iPlayReadInt(FILE* file, int *value, int mode)
+/* The file is loaded and parsed at once when the play starts.
+   Times are converted to the elapsed time since the start of the record,
+   so each timer tick sends all the events that are due,
+   and delays in processing the events do not accumulate. */
+
+#define IPLAY_TIMER "10"    /* milliseconds between ticks */
+#define IPLAY_BUDGET 100    /* milliseconds per tick when playing as fast as possible */
+
+typedef struct _IplayEvent
 {
-  if (mode == IUP_RECTEXT)
-    fscanf(file, "%d ", value);
-  else
-    fread(value, sizeof(int), 1, file);
+  int time;      /* milliseconds since the start of the record */
+  char action;   /* 'B', 'M', 'K' or 'W' */
+  char button;   /* button, or pressed for keys */
+  char status;
+  int x, y;      /* position, or x is the key code for keys */
+  float delta;
+} IplayEvent;
+
+typedef struct _IplayState
+{
+  Ihandle* timer;
+  IplayEvent* events;
+  int count, current;
+  float speed;         /* 0 means as fast as possible */
+  double start;        /* time when the record starts, adjusted after pauses */
+  double pause_start;
+  int paused,
+      depth,           /* nested ticks, when a modal dialog was shown by an event */
+      loop_level,      /* loop level of the innermost tick */
+      finished;
+  /* statistics */
+  double play_start, lag_sum, lag_max;
+  int ticks, lag_count;
+} IplayState;
+
+static IplayState* iplay_state = NULL;
+
+typedef struct _IplayReader
+{
+  const char* cur;
+  const char* end;   /* buffer is terminated by 0 */
+  int mode;
+  int error;
+} IplayReader;
+
+static void iPlaySkipSpace(IplayReader* reader)
+{
+  while (reader->cur < reader->end && (*reader->cur == ' ' || *reader->cur == '\n' || *reader->cur == '\r' || *reader->cur == '\t'))
+    reader->cur++;
 }
 
-static void iPlayReadFloat(FILE* file, float *value, int mode)
+static void iPlayReadInt(IplayReader* reader, int *value)
 {
-  if (mode == IUP_RECTEXT)
-    fscanf(file, "%g ", value);
+  if (reader->mode == IUP_RECTEXT)
+  {
+    char* end;
+    iPlaySkipSpace(reader);
+    *value = (int)strtol(reader->cur, &end, 10);
+    if (end == reader->cur)
+      reader->error = 1;
+    reader->cur = end;
+  }
   else
-    fread(value, sizeof(float), 1, file);
+  {
+    if (reader->end - reader->cur < (int)sizeof(int))
+    {
+      reader->error = 1;
+      return;
+    }
+    memcpy(value, reader->cur, sizeof(int));
+    reader->cur += sizeof(int);
+  }
 }
 
-static void iPlayReadByte(FILE* file, char *value, int mode)
+static void iPlayReadFloat(IplayReader* reader, float *value)
 {
-  if (mode == IUP_RECTEXT)
+  if (reader->mode == IUP_RECTEXT)
   {
-    int ivalue;
-    fscanf(file, "%d ", &ivalue);
-    *value = (char)ivalue;
+    char* end;
+    iPlaySkipSpace(reader);
+    *value = (float)strtod(reader->cur, &end);
+    if (end == reader->cur)
+      reader->error = 1;
+    reader->cur = end;
   }
   else
-    fread(value, 1, 1, file);
+  {
+    if (reader->end - reader->cur < (int)sizeof(float))
+    {
+      reader->error = 1;
+      return;
+    }
+    memcpy(value, reader->cur, sizeof(float));
+    reader->cur += sizeof(float);
+  }
 }
 
-static void iPlayReadChar(FILE* file, char *value, int mode)
+static void iPlayReadByte(IplayReader* reader, char *value)
 {
-  if (mode == IUP_RECTEXT)
-    fscanf(file, "%c ", value);
+  if (reader->mode == IUP_RECTEXT)
+  {
+    int ivalue = 0;
+    iPlayReadInt(reader, &ivalue);
+    *value = (char)ivalue;
+  }
   else
-    fread(value, 1, 1, file);
+  {
+    if (reader->cur >= reader->end)
+    {
+      reader->error = 1;
+      return;
+    }
+    *value = *reader->cur;
+    reader->cur++;
+  }
 }
 
-static void iPlayReadStr(FILE* file, char* value, int len, int mode)
+static void iPlayReadChar(IplayReader* reader, char *value)
 {
-  fread(value, 1, len, file);
-  value[len] = 0;
+  if (reader->mode == IUP_RECTEXT)
+    iPlaySkipSpace(reader);
 
-  if (mode == IUP_RECTEXT)
+  if (reader->cur >= reader->end)
   {
-    char spc;
-    fread(&spc, 1, 1, file); /* skip space */
+    reader->error = 1;
+    return;
   }
+  *value = *reader->cur;
+  reader->cur++;
 }
 
-static int iPlayAction(FILE* file, int mode)
+static int iPlayReadEvent(IplayReader* reader, IplayEvent* evt)
 {
-  char action[4];
   char eol;
-  int time;
-  static int pressed = 0;
 
-  iPlayReadStr(file, action, 3, mode);
-  iPlayReadInt(file, &time, mode);
-  if (ferror(file)) return -1;
+  if (reader->mode == IUP_RECTEXT)
+    iPlaySkipSpace(reader);
+  if (reader->end - reader->cur < 3)
+    return 0;
 
-  time -= iRecClock() - irec_lastclock;
-  if (time < 0) time = 0;
-  if (time)
-    iupdrvSleep(time);
+  evt->action = reader->cur[0];
+  reader->cur += 3;
+  iPlayReadInt(reader, &evt->time);
 
-  switch (action[0])
+  switch (evt->action)
   {
   case 'B':
-    {
-      char button, status;
-      int x, y;
-      iPlayReadChar(file, &button, mode);
-      iPlayReadByte(file, &status, mode);
-      iPlayReadInt(file, &x, mode);
-      iPlayReadInt(file, &y, mode);
-      if (mode == IUP_RECBINARY) iPlayReadByte(file, &eol, mode);
-      if (ferror(file)) return -1;
-
-      /*IupSetfAttribute(NULL, "MOUSEBUTTON", "%dx%d %c %d", x, y, button, (int)status);*/
-      iupdrvSendMouse(x, y, (int)button, (int)status);
-
-      /* Process all messages between button press and release without interruption.
-         This will not work if two butons are pressed together. */
-/*      if (status == 1 || status == 2)
-        pressed = 1;
-      else if (status == 0)
-        pressed = 0; */
-      break;
-    }
+    iPlayReadChar(reader, &evt->button);
+    iPlayReadByte(reader, &evt->status);
+    iPlayReadInt(reader, &evt->x);
+    iPlayReadInt(reader, &evt->y);
+    break;
   case 'M':
-    {
-      char button;
-      int x, y;
-      iPlayReadInt(file, &x, mode);
-      iPlayReadInt(file, &y, mode);
-      iPlayReadChar(file, &button, mode);
-      if (mode == IUP_RECBINARY) iPlayReadByte(file, &eol, mode);
-      if (ferror(file)) return -1;
-
-      /* IupSetfAttribute(NULL, "CURSORPOS", "%dx%d", x, y); */
-      iupdrvSendMouse(x, y, (int)button, -1);
-      break;
-    }
+    iPlayReadInt(reader, &evt->x);
+    iPlayReadInt(reader, &evt->y);
+    iPlayReadChar(reader, &evt->button);
+    break;
   case 'K':
-    {
-      int key;
-      char pressed;
-      iPlayReadInt(file, &key, mode);
-      iPlayReadByte(file, &pressed, mode);
-      if (mode == IUP_RECBINARY) iPlayReadByte(file, &eol, mode);
-      if (ferror(file)) return -1;
-
-      if (pressed)
-        /* IupSetfAttribute(NULL, "KEYPRESS", "%d", key); */
-        iupdrvSendKey(key, 0x01);
-      else
-        /* IupSetfAttribute(NULL, "KEYRELEASE", "%d", key); */
-        iupdrvSendKey(key, 0x02);
-      break;
-    }
+    iPlayReadInt(reader, &evt->x);
+    iPlayReadByte(reader, &evt->button);
+    break;
   case 'W':
-    {
-      float delta;
-      int x, y;
-      iPlayReadFloat(file, &delta, mode);
-      iPlayReadInt(file, &x, mode);
-      iPlayReadInt(file, &y, mode);
-      if (mode == IUP_RECBINARY) iPlayReadByte(file, &eol, mode);
-      if (ferror(file)) return -1;
-
-      /*IupSetfAttribute(NULL, "MOUSEBUTTON", "%dx%d %c %d", x, y, 'W', (int)delta);*/
-      iupdrvSendMouse(x, y, 'W', (int)delta);
-      break;
-    }
+    iPlayReadFloat(reader, &evt->delta);
+    iPlayReadInt(reader, &evt->x);
+    iPlayReadInt(reader, &evt->y);
+    break;
   default:
-      return -1;
+    return 0;
   }
 
-  irec_lastclock = iRecClock();
-  return pressed;
+  if (reader->mode == IUP_RECBINARY)
+    iPlayReadByte(reader, &eol);
+
+  return !reader->error;
 }
 
-static int iPlayTimer_CB(Ihandle* timer)
+static IplayEvent* iPlayLoadFile(const char* filename, int *count)
 {
-  FILE* file = (FILE*)IupGetAttribute(timer, "_IUP_PLAYFILE");
-  if(feof(file) || ferror(file))
+  FILE* file;
+  char* buffer;
+  long size;
+  IplayReader reader;
+  IplayEvent* events = NULL;
+  int max_count = 0, time = 0;
+
+  file = fopen(filename, "rb");
+  if (!file)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (size < 13)  /* "IUPINPUT BIN\n" */
   {
     fclose(file);
-    IupSetAttribute(timer, "RUN", "NO");
-    IupDestroy(timer);
-    IupSetGlobal("_IUP_PLAYTIMER", NULL);
-    return IUP_IGNORE;
+    return NULL;
   }
-  else
+
+  buffer = (char*)malloc(size+1);
+  if ((long)fread(buffer, 1, size, file) != size)
   {
-    int cont = 1;
-    int mode = IupGetInt(timer, "_IUP_PLAYMODE");
+    free(buffer);
+    fclose(file);
+    return NULL;
+  }
+  buffer[size] = 0;
+  fclose(file);
+
+  if (strncmp(buffer, "IUPINPUT ", 9) != 0)
+  {
+    free(buffer);
+    return NULL;
+  }
+
+  reader.mode = IUP_RECBINARY;
+  if (strncmp(buffer+9, "TXT", 3) == 0)
+    reader.mode = IUP_RECTEXT;
+  reader.cur = buffer + 13;
+  reader.end = buffer + size;
+  reader.error = 0;
+
+  *count = 0;
+  for (;;)
+  {
+    IplayEvent evt;
+
+    /* a truncated or invalid record ends the play, as before */
+    if (!iPlayReadEvent(&reader, &evt))
+      break;
+
+    if (evt.time < 0) evt.time = 0;
+    time += evt.time;
+    evt.time = time;
 
-/*    while (cont)    //did not work, menus do not receive the click, why? */
+    if (*count == max_count)
     {
-      cont = iPlayAction(file, mode);
+      max_count += 1024;
+      events = (IplayEvent*)realloc(events, max_count*sizeof(IplayEvent));
+    }
+    events[*count] = evt;
+    (*count)++;
+  }
 
-      if (cont == -1)  /* error */
-      {
-        fclose(file);
-        IupSetAttribute(timer, "RUN", "NO");
-        IupDestroy(timer);
-        IupSetGlobal("_IUP_PLAYTIMER", NULL);
-        return IUP_IGNORE;
-      }
+  free(buffer);
+
+  if (!events)
+    events = (IplayEvent*)malloc(sizeof(IplayEvent));  /* empty record */
+  return events;
+}
+
+static void iPlaySendEvent(IplayEvent* evt)
+{
+  switch (evt->action)
+  {
+  case 'B':
+    /*IupSetfAttribute(NULL, "MOUSEBUTTON", "%dx%d %c %d", x, y, button, (int)status);*/
+    iupdrvSendMouse(evt->x, evt->y, (int)evt->button, (int)evt->status);
+    break;
+  case 'M':
+    /* IupSetfAttribute(NULL, "CURSORPOS", "%dx%d", x, y); */
+    iupdrvSendMouse(evt->x, evt->y, (int)evt->button, -1);
+    break;
+  case 'K':
+    if (evt->button)
+      /* IupSetfAttribute(NULL, "KEYPRESS", "%d", key); */
+      iupdrvSendKey(evt->x, 0x01);
+    else
+      /* IupSetfAttribute(NULL, "KEYRELEASE", "%d", key); */
+      iupdrvSendKey(evt->x, 0x02);
+    break;
+  case 'W':
+    /*IupSetfAttribute(NULL, "MOUSEBUTTON", "%dx%d %c %d", x, y, 'W', (int)delta);*/
+    iupdrvSendMouse(evt->x, evt->y, 'W', (int)evt->delta);
+    break;
+  }
+}
+
+static void iPlayRelease(IplayState* play)
+{
+  IupDestroy(play->timer);
+  free(play->events);
+  free(play);
+}
+
+static void iPlayStop(IplayState* play)
+{
+  char stats[200];
+  double lag_avg = 0;
+  if (play->lag_count)
+    lag_avg = play->lag_sum / play->lag_count;
+
+  /* events:ticks:time:lagavg:lagmax */
+  sprintf(stats, "%d:%d:%d:%.1f:%.1f", play->current, play->ticks,
+          (int)(iupLoopGetTime() - play->play_start), lag_avg, play->lag_max);
+  IupStoreGlobal("PLAYINPUTSTATS", stats);
+
+  IupSetAttribute(play->timer, "RUN", "NO");
+  play->finished = 1;
+
+  if (iplay_state == play)
+    iplay_state = NULL;
+
+  /* if inside a tick, released when the outer tick returns */
+  if (play->depth == 0)
+    iPlayRelease(play);
+}
+
+static int iPlayTimer_CB(Ihandle* timer)
+{
+  IplayState* play = (IplayState*)IupGetAttribute(timer, "_IUP_PLAYSTATE");
+  int old_loop_level;
+  double now, end;
+
+  if (play->finished || play->paused)
+    return IUP_DEFAULT;
+
+  /* A new tick inside IupFlush is ignored,
+     unless a modal dialog was shown by the event, then the play must continue inside its loop. */
+  if (play->depth > 0 && IupMainLoopLevel() <= play->loop_level)
+    return IUP_DEFAULT;
+
+  old_loop_level = play->loop_level;
+  play->loop_level = IupMainLoopLevel();
+  play->depth++;
+  play->ticks++;
+
+  now = iupLoopGetTime();
+  end = now + IPLAY_BUDGET;
+
+  while (play->current < play->count && !play->finished && !play->paused)
+  {
+    IplayEvent* evt = play->events + play->current;
+
+    if (play->speed > 0)
+    {
+      double due = play->start + evt->time / play->speed;
+      if (due > now)
+        break;
+
+      play->lag_sum += now - due;
+      play->lag_count++;
+      if (now - due > play->lag_max)
+        play->lag_max = now - due;
     }
+    else if (now > end)
+      break;
 
+    play->current++;
+    iPlaySendEvent(evt);
+
+    /* process the event before sending the next one */
     IupFlush();
+
+    now = iupLoopGetTime();
+  }
+
+  play->depth--;
+  play->loop_level = old_loop_level;
+
+  if (play->finished)
+  {
+    if (play->depth == 0)
+      iPlayRelease(play);
+    return IUP_DEFAULT;
   }
 
+  if (play->current == play->count)
+    iPlayStop(play);
+
   return IUP_DEFAULT;
 }
 
 int IupPlayInput(const char* filename)
 {
-  Ihandle* timer = (Ihandle*)IupGetGlobal("_IUP_PLAYTIMER");
-  FILE* file;
-  char sig[9], mode_str[4];
-  int mode;
+  IplayState* play = iplay_state;
 
-  if (timer)
+  if (play)
   {
     if (filename && filename[0]==0)
     {
-      if (IupGetInt(timer, "RUN"))
-        IupSetAttribute(timer, "RUN", "NO");
+      if (play->paused)
+      {
+        play->start += iupLoopGetTime() - play->pause_start;
+        play->paused = 0;
+        IupSetAttribute(play->timer, "RUN", "Yes");
+      }
       else
-        IupSetAttribute(timer, "RUN", "Yes");
+      {
+        play->pause_start = iupLoopGetTime();
+        play->paused = 1;
+        IupSetAttribute(play->timer, "RUN", "NO");
+      }
       return IUP_NOERROR;
     }
 
-    file = (FILE*)IupGetAttribute(timer, "_IUP_PLAYFILE");
-
-    fclose(file);
-    IupSetAttribute(timer, "RUN", "NO");
-    IupDestroy(timer);
-    IupSetGlobal("_IUP_PLAYTIMER", NULL);
+    iPlayStop(play);
   }
   else
   {
@@ -391,37 +587,30 @@ int IupPlayInput(const char* filename)
   if (!filename)
     return IUP_NOERROR;
 
-  file = fopen(filename, "rb");
-  if (!file)
-    return IUP_ERROR;
-
-  iPlayReadStr(file, sig, 8, IUP_RECTEXT);
-  iPlayReadStr(file, mode_str, 3, IUP_RECTEXT); /* read also the eol */
-  if (ferror(file))
+  play = (IplayState*)calloc(1, sizeof(IplayState));
+  play->events = iPlayLoadFile(filename, &play->count);
+  if (!play->events)
   {
-    fclose(file);
+    free(play);
     return IUP_ERROR;
   }
 
-  if (!iupStrEqual(sig, "IUPINPUT"))
+  play->speed = 1;
+  if (IupGetGlobal("PLAYINPUTSPEED"))
   {
-    fclose(file);
-    return IUP_ERROR;
+    float speed;
+    if (iupStrToFloat(IupGetGlobal("PLAYINPUTSPEED"), &speed) && speed >= 0)
+      play->speed = speed;
   }
 
-  mode = IUP_RECBINARY;
-  if (iupStrEqual(mode_str, "TXT"))
-    mode = IUP_RECTEXT;
-
-  irec_lastclock = iRecClock();
+  play->play_start = play->start = iupLoopGetTime();
 
-  timer = IupTimer();
-  IupSetCallback(timer, "ACTION_CB", (Icallback)iPlayTimer_CB);
-  IupSetAttribute(timer, "TIME", "20");
-  IupSetAttribute(timer, "_IUP_PLAYFILE", (char*)file);
-  IupSetfAttribute(timer, "_IUP_PLAYMODE", "%d", mode);
-  IupSetAttribute(timer, "RUN", "YES");
+  play->timer = IupTimer();
+  IupSetCallback(play->timer, "ACTION_CB", (Icallback)iPlayTimer_CB);
+  IupSetAttribute(play->timer, "TIME", IPLAY_TIMER);
+  IupSetAttribute(play->timer, "_IUP_PLAYSTATE", (char*)play);
+  IupSetAttribute(play->timer, "RUN", "YES");
 
-  IupSetGlobal("_IUP_PLAYTIMER", (char*)timer);
+  iplay_state = play;
   return IUP_NOERROR;
 }
@@ -26,7 +26,23 @@ void iupRegisterInit(void)
 
 void iupRegisterFinish(void)
 {
-  char* name = iupTableFirst(iregister_table);
+  char* name;
+
+  /* Release methods can destroy elements of other classes (IupSpin destroys its timer), 
+     so all of them are called before any class is freed, independent of the table order. */
+  name = iupTableFirst(iregister_table);
+  while (name)
+  {
+    Iclass* ic = (Iclass*)iupTableGetCurr(iregister_table);
+    if (ic->Release)
+    {
+      ic->Release(ic);
+      ic->Release = NULL;
+    }
+    name = iupTableNext(iregister_table);
+  }
+
+  name = iupTableFirst(iregister_table);
   while (name)
   {
     Iclass* ic = (Iclass*)iupTableGetCurr(iregister_table);
@@ -21,6 +21,7 @@ extern "C" {
 
 
 /** Returns a class instance from a class name. The class name must be previously registered using \ref iupRegisterClass.
+ * Can be called from other threads, as long as no class is being registered at the same time.
  * \ingroup register */
 Iclass* iupRegisterFindClass(const char* name);
 
@@ -83,6 +83,10 @@ int IupMap(Ihandle* ih)
     return IUP_ERROR;
   }
 
+  /* the native element must receive the layout at least once */
+  ih->flags |= IUP_LAYOUT_MOVED;
+  iupLayoutMarkDirty(ih);
+
   /* update FONT, must be before several others, so we do it here */
   if (ih->iclass->nativetype != IUP_TYPEVOID &&
       ih->iclass->nativetype != IUP_TYPEIMAGE &&
@@ -241,93 +241,273 @@ char *iupStrCopyUntilNoCase(char **str, int c)
   }
 }
 
-char *iupStrGetLargeMem(int *size)
+/* Transient string memory.
+   Each thread has its own arena, allocated on first use.
+   Small requests are served by bumping a position inside a single block,
+   when the block is exhausted it wraps around to the start.
+   Large requests use a ring of heap buffers like the old implementation.
+   The position can be rewound to a mark at well defined points
+   (after a message is dispatched by the main loop), so the arena is normally 
+   reused from the start keeping the memory hot in cache. */
+
+#if defined(_MSC_VER)
+#define ISTR_THREAD __declspec(thread)
+#define ISTR_THREAD_EXIT
+#elif defined(__GNUC__)
+#define ISTR_THREAD __thread
+#define ISTR_THREAD_EXIT
+#else
+#define ISTR_THREAD
+#endif
+
+#define ISTR_ARENA_SIZE  131072   /* 128Kb per thread */
+#define ISTR_SMALL_MAX   1024     /* up to this size requests go to the arena, so at least 128 results are kept */
+#define ISTR_ALIGN(_s)   (((_s) + 7) & ~7)
+#define ISTR_LARGE_MAX   50       /* same number of buffers of the old ring */
+#define ISTR_LARGEMEM_MAX  10
+#define ISTR_LARGEMEM_SIZE SHRT_MAX
+
+typedef struct _IstrArena
 {
-#define LARGE_MAX_BUFFERS 10
-#define LARGE_SIZE SHRT_MAX
-  static char buffers[LARGE_MAX_BUFFERS][LARGE_SIZE];
-  static int buffers_index = -1;
-  char* ret_str;
+  char* buffer;
+  int pos;
+
+  char* large[ISTR_LARGE_MAX];
+  int large_sizes[ISTR_LARGE_MAX];
+  int large_index;
+
+  char* largemem;         /* ISTR_LARGEMEM_MAX buffers of ISTR_LARGEMEM_SIZE */
+  int largemem_index;
+
+  char* user_buffer;      /* set by iupStrSetMemoryBuffer, used once */
+  int user_size;
+} IstrArena;
+
+static ISTR_THREAD IstrArena* istr_arena = NULL;
+
+static void iStrArenaDestroy(IstrArena* arena)
+{
+  int i;
+
+  for (i = 0; i < ISTR_LARGE_MAX; i++)
+  {
+    if (arena->large[i]) 
+      free(arena->large[i]);
+  }
+
+  if (arena->largemem)
+    free(arena->largemem);
+
+  free(arena->buffer);
+  free(arena);
+}
 
-  /* init buffers array */
-  if (buffers_index == -1)
+/* The arena of a secondary thread is destroyed when the thread exits.
+   The arena of the main thread is destroyed by IupClose. */
+#if defined(ISTR_THREAD_EXIT) && defined(WIN32)
+#ifdef IUP_DLL
+/* the DLL destroys the arena in DllMain at DLL_THREAD_DETACH */
+#define iStrThreadExitSet(_arena)
+#else
+#include <windows.h>
+
+/* Fiber local storage is used only for its destructor callback. 
+   It is available since Windows Vista, so it is loaded dynamically. */
+typedef void (WINAPI *IFlsCallback)(void*);
+typedef DWORD (WINAPI *IFlsAlloc)(IFlsCallback);
+typedef BOOL (WINAPI *IFlsSetValue)(DWORD, void*);
+
+static volatile LONG istr_fls_state = 0;  /* 0-not initialized, 1-initializing, 2-initialized */
+static DWORD istr_fls_index = 0xFFFFFFFF;  /* FLS_OUT_OF_INDEXES */
+static IFlsSetValue istr_fls_set = NULL;
+
+static void WINAPI iStrThreadExit(void* arena)
+{
+  if (arena)
   {
-    memset(buffers, 0, sizeof(char*)*LARGE_MAX_BUFFERS);
-    buffers_index = 0;
+    iStrArenaDestroy((IstrArena*)arena);
+    istr_arena = NULL;
+  }
+}
+
+static void iStrThreadExitSet(IstrArena* arena)
+{
+  if (istr_fls_state != 2)
+  {
+    if (InterlockedCompareExchange((LONG*)&istr_fls_state, 1, 0) == 0)
+    {
+      HMODULE kernel = GetModuleHandleA("kernel32.dll");
+      IFlsAlloc fls_alloc = (IFlsAlloc)GetProcAddress(kernel, "FlsAlloc");
+      istr_fls_set = (IFlsSetValue)GetProcAddress(kernel, "FlsSetValue");
+      if (fls_alloc && istr_fls_set)
+        istr_fls_index = fls_alloc(iStrThreadExit);
+      InterlockedExchange((LONG*)&istr_fls_state, 2);
+    }
+    else
+    {
+      while (istr_fls_state != 2)
+        Sleep(0);
+    }
   }
 
-  /* clear memory */
-  memset(buffers[buffers_index], 0, LARGE_SIZE);
-  ret_str = buffers[buffers_index];
+  if (istr_fls_index != 0xFFFFFFFF)
+    istr_fls_set(istr_fls_index, arena);
+}
+#endif
+#elif defined(ISTR_THREAD_EXIT)
+#include <pthread.h>
+
+static pthread_key_t istr_key;
+static pthread_once_t istr_key_once = PTHREAD_ONCE_INIT;
+
+static void iStrThreadExit(void* arena)
+{
+  iStrArenaDestroy((IstrArena*)arena);
+  istr_arena = NULL;
+}
+
+static void iStrKeyCreate(void)
+{
+  pthread_key_create(&istr_key, iStrThreadExit);
+}
+
+static void iStrThreadExitSet(IstrArena* arena)
+{
+  pthread_once(&istr_key_once, iStrKeyCreate);
+  pthread_setspecific(istr_key, arena);
+}
+#else
+/* no thread local storage, the arena is shared by all threads */
+#define iStrThreadExitSet(_arena)
+#endif
 
-  buffers_index++;
-  if (buffers_index == LARGE_MAX_BUFFERS)
-    buffers_index = 0;
+static IstrArena* iStrGetArena(void)
+{
+  IstrArena* arena = istr_arena;
+  if (!arena)
+  {
+    arena = (IstrArena*)calloc(1, sizeof(IstrArena));
+    arena->buffer = (char*)malloc(ISTR_ARENA_SIZE);
+    istr_arena = arena;
+    iStrThreadExitSet(arena);
+  }
+  return arena;
+}
 
-  *size = LARGE_SIZE;
+static void iStrFreeArena(void)
+{
+  IstrArena* arena = istr_arena;
+  if (!arena)
+    return;
+
+  iStrThreadExitSet(NULL);
+  iStrArenaDestroy(arena);
+  istr_arena = NULL;
+}
+
+char *iupStrGetLargeMem(int *size)
+{
+  IstrArena* arena = iStrGetArena();
+  char* ret_str;
+
+  if (!arena->largemem)
+    arena->largemem = (char*)malloc(ISTR_LARGEMEM_MAX*ISTR_LARGEMEM_SIZE);
+
+  ret_str = arena->largemem + arena->largemem_index*ISTR_LARGEMEM_SIZE;
+
+  arena->largemem_index++;
+  if (arena->largemem_index == ISTR_LARGEMEM_MAX)
+    arena->largemem_index = 0;
+
+  /* do not clear the whole buffer, 
+     but leave the last byte always zero so a truncated vsnprintf is still terminated */
+  ret_str[0] = 0;
+  ret_str[ISTR_LARGEMEM_SIZE-1] = 0;
+
+  *size = ISTR_LARGEMEM_SIZE-1;
   return ret_str;
-#undef LARGE_MAX_BUFFERS
-#undef LARGE_SIZE 
 }
 
 char *iupStrGetMemory(int size)
 {
-#define MAX_BUFFERS 50
-  static char* buffers[MAX_BUFFERS];
-  static int buffers_sizes[MAX_BUFFERS];
-  static int buffers_index = -1;
-
-  int i;
+  IstrArena* arena;
+  char* ret_str;
 
   if (size == -1) /* Frees memory */
   {
-    buffers_index = -1;
-    for (i = 0; i < MAX_BUFFERS; i++)
-    {
-      if (buffers[i]) 
-      {
-        free(buffers[i]);
-        buffers[i] = NULL;
-      }
-      buffers_sizes[i] = 0;
-    }
+    iStrFreeArena();
     return NULL;
   }
-  else
+
+  arena = iStrGetArena();
+
+  if (arena->user_buffer)
   {
-    char* ret_str;
+    ret_str = arena->user_buffer;
+    arena->user_buffer = NULL;
 
-    /* init buffers array */
-    if (buffers_index == -1)
+    if (size+1 <= arena->user_size)
     {
-      memset(buffers, 0, sizeof(char*)*MAX_BUFFERS);
-      memset(buffers_sizes, 0, sizeof(int)*MAX_BUFFERS);
-      buffers_index = 0;
+      memset(ret_str, 0, size+1);
+      return ret_str;
     }
+  }
 
-    /* first alocation */
-    if (!(buffers[buffers_index]))
-    {
-      buffers_sizes[buffers_index] = size+1;
-      buffers[buffers_index] = (char*)malloc(buffers_sizes[buffers_index]);
-    }
-    else if (buffers_sizes[buffers_index] < size+1)  /* reallocate if necessary */
+  if (size+1 <= ISTR_SMALL_MAX)
+  {
+    int alloc_size = ISTR_ALIGN(size+1);
+
+    if (arena->pos + alloc_size > ISTR_ARENA_SIZE)
+      arena->pos = 0;  /* wrap around */
+
+    ret_str = arena->buffer + arena->pos;
+    arena->pos += alloc_size;
+  }
+  else
+  {
+    int i = arena->large_index;
+
+    if (arena->large_sizes[i] < size+1)  /* (re)allocate if necessary */
     {
-      buffers_sizes[buffers_index] = size+1;
-      buffers[buffers_index] = (char*)realloc(buffers[buffers_index], buffers_sizes[buffers_index]);
+      arena->large_sizes[i] = size+1;
+      arena->large[i] = (char*)realloc(arena->large[i], arena->large_sizes[i]);
     }
 
-    /* clear memory */
-    memset(buffers[buffers_index], 0, buffers_sizes[buffers_index]);
-    ret_str = buffers[buffers_index];
-
-    buffers_index++;
-    if (buffers_index == MAX_BUFFERS)
-      buffers_index = 0;
+    ret_str = arena->large[i];
 
-    return ret_str;
+    arena->large_index++;
+    if (arena->large_index == ISTR_LARGE_MAX)
+      arena->large_index = 0;
   }
-#undef MAX_BUFFERS
+
+  /* clear only the requested memory */
+  memset(ret_str, 0, size+1);
+  return ret_str;
+}
+
+int iupStrMemoryMark(void)
+{
+  IstrArena* arena = istr_arena;
+  if (!arena)
+    return 0;
+  return arena->pos;
+}
+
+void iupStrMemoryRelease(int mark)
+{
+  IstrArena* arena = istr_arena;
+  if (!arena)
+    return;
+  if (mark >= 0 && mark <= ISTR_ARENA_SIZE)
+    arena->pos = mark;
+  arena->user_buffer = NULL;
+}
+
+void iupStrSetMemoryBuffer(char* buffer, int size)
+{
+  IstrArena* arena = iStrGetArena();
+  arena->user_buffer = buffer;
+  arena->user_size = buffer? size: 0;
 }
 
 char *iupStrGetMemoryCopy(const char* str)
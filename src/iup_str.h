@@ -80,18 +80,37 @@ char *iupStrCopyUntil(char **str, int c);
  * \ingroup str */
 void iupStrCopyN(char* dst_str, int dst_max_size, const char* src_str);
 
-/** Returns a buffer with the specified size+1. \n
- * The buffer is resused after 50 calls. It must NOT be freed.
- * Use size=-1 to free all the internal buffers.
+/** Returns a buffer with the specified size+1, filled with zeros. \n
+ * The memory comes from a per thread arena and it must NOT be freed.
+ * The buffer is valid until the arena wraps around (at least 128 buffers later) 
+ * or until the arena is released to a previous mark, 
+ * which is done by the main loop after each message is processed. \n
+ * Use size=-1 to free all the internal buffers of the calling thread, 
+ * they are also freed when a secondary thread exits.
  * \ingroup str */
 char *iupStrGetMemory(int size);
 
+/** Returns the current position of the arena used by \ref iupStrGetMemory in the calling thread.
+ * \ingroup str */
+int iupStrMemoryMark(void);
+
+/** Rewinds the arena used by \ref iupStrGetMemory in the calling thread to the given mark.
+ * All the buffers returned after the mark was obtained are invalidated.
+ * \ingroup str */
+void iupStrMemoryRelease(int mark);
+
+/** The next call to \ref iupStrGetMemory in the calling thread will return the given buffer 
+ * if the requested size fits in it. Use NULL to cancel. Used to write results directly into the application memory.
+ * \ingroup str */
+void iupStrSetMemoryBuffer(char* buffer, int size);
+
 /** Returns a buffer that contains a copy of the given buffer using \ref iupStrGetMemory.
  * \ingroup str */
 char *iupStrGetMemoryCopy(const char* str);
 
 /** Returns a very large buffer to be used in unknown size string construction.
- * Use snprintf or vsnprintf with the given size.
+ * Use snprintf or vsnprintf with the given size. The buffer is resused after 10 calls. \n
+ * The memory is per thread and released with \ref iupStrGetMemory (-1).
  * \ingroup str */
 char *iupStrGetLargeMem(int *size);
 
@@ -1,6 +1,7 @@
 /** \file
  * \brief iupTable functions.
- * Implementation by Danny Reinhold and Antonio Scuri. 
+ * Implementation by Danny Reinhold and Antonio Scuri.
+ * Open addressing with interned keys.
  *
  * See Copyright Notice in "iup.h"
  */
@@ -9,6 +10,13 @@
 #include <stdio.h>
 #include <string.h>
 #include <memory.h>
+#include <stddef.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 #include "iup_table.h"
 #include "iup_str.h"
@@ -17,106 +25,495 @@
 /* #define DEBUGTABLE 1 */
 
 /* Adjust these parameters for optimal performance and memory usage */
+#define ITABLE_SMALLSIZE 8  /* inline slots, must be a power of 2 */
 static const unsigned int itable_maxTableSizeIndex = 8;
-static const unsigned int itable_hashTableSize[] = { 31, 101, 401, 1601, 4001, 8009, 16001, 32003, 64007 };
-static const unsigned int itable_resizeLimit = 2;
-static const unsigned int itable_itemGrow = 5;
+static const unsigned int itable_hashTableSize[] = { ITABLE_SMALLSIZE, 128, 512, 2048, 4096, 8192, 16384, 32768, 65536 };
+
+/* Marks a removed slot.
+ * Removed slots are kept until the next rehash,
+ * so an iteration is not affected by removals. */
+static char itable_removedKey = 0;
+#define ITABLE_REMOVED (&itable_removedKey)
+
+#define iTableIsUsed(_key) ((_key) != NULL && (_key) != ITABLE_REMOVED)
 
-/* Iteration context.
- */
-typedef struct _ItableContext
-{
-  unsigned int entryIndex;  /* index at the Itable::entries array */
-  unsigned int itemIndex;   /* index at the ItableEntry::items array */
-} ItableContext;
-
-/* A key of an item.
- * To avoid lots of string comparisions we store
- * a keyindex as an integer.
- * To find a key in an item list we only have to
- * do integer comparisions.
- * Additionally the key itself is stored in
- * keyStr. In a string indexed hashtable this is
- * a duplicated string, in a pointer indexed hash table
- * this is simply the pointer (in this case keyIndex
- * and keyStr are equal).
-*/
-typedef struct _ItableKey
-{
-  unsigned long keyIndex;  /* the secondary hash number */
-  const char   *keyStr;
-}
-ItableKey;
 
 /* An item in the hash table.
- * Such an item is stored in the item list of
- * an entry.
- */
+ * In a string indexed hashtable the key is an interned string (an atom),
+ * so comparing two keys is comparing two pointers.
+ * In a pointer indexed hash table this is simply the pointer.
+ * hash is stored so the table can be rehashed without computing it again.
+*/
 typedef struct _ItableItem
 {
+  const char*   key;
+  unsigned int  hash;
   Itable_Types  itemType;
-  ItableKey     key;
   void*         value;
 }
 ItableItem;
 
-/* An entry in the hash table.
- * An entry is chosen by an index in the hash table
- * and contains a list of items.
- * The number of items in this list is stored
- * in nextItemIndex.
- * size is the current size of the items array.
+/* The numbers of an item in a id indexed hash table.
+ * name is the full name of the item, built only when requested.
  */
-typedef struct _ItableEntry
+typedef struct _ItableId
 {
-  unsigned int  nextItemIndex;
-  unsigned int  itemsSize;
-  ItableItem*   items;
+  int   id1, id2;
+  char* name;
 }
-ItableEntry;
-
+ItableId;
 
 /* A hash table.
- * entries is an array of entries. Select an
- * entry by its index.
- * size is the number of entries in the hash table...
+ * items is an array of slots, its size is always a power of 2.
+ * While the table is small items points to smallItems and
+ * the slots are searched linearly, so no memory is allocated
+ * besides the table itself.
+ * used is the number of slots that are not empty (keys + removed).
+ * ids is used only in id indexed tables, it is parallel to items.
  */
 struct _Itable
 {
-  unsigned int         entriesSize;
+  unsigned int         size;
   unsigned int         numberOfEntries;
-  unsigned int         tableSizeIndex;  /* index into itable_hashTableSize array */
+  unsigned int         used;
   Itable_IndexTypes    indexType;  /* type of the index: string or pointer. */
-  ItableEntry          *entries;
-  ItableContext        context;
+  ItableItem          *items;
+  ItableId            *ids;
+  unsigned int         context;    /* iteration context, index at the items array */
+  ItableItem           smallItems[ITABLE_SMALLSIZE];
 };
 
 
-/* Prototypes of private functions */
+/********************************************/
+/*           Key Atoms                      */
+/********************************************/
+
+/* A string key shared by all string indexed tables.
+ * The atom is freed when it is not used by any table.
+ * Tables can be used in different threads, each table by only one thread at a time,
+ * so the atoms are accessed only while holding the atoms lock.
+ * A key found in a table is always valid, because the table holds a reference to it.
+ */
+typedef struct _ItableAtom
+{
+  unsigned int hash;
+  unsigned int refCount;
+  char         str[1];
+}
+ItableAtom;
+
+#define iTableAtomFromKey(_key) ((ItableAtom*)((char*)(_key) - offsetof(ItableAtom, str)))
+
+static ItableAtom** itable_atoms = NULL;
+static unsigned int itable_atomsSize = 0;
+static unsigned int itable_atomsCount = 0;
+static unsigned int itable_atomsUsed = 0;   /* count + removed */
+static ItableAtom   itable_removedAtom;
+
+#ifdef WIN32
+static volatile LONG itable_lockState = 0;  /* 0-not initialized, 1-initializing, 2-initialized */
+static CRITICAL_SECTION itable_lock;
+
+static void iTableAtomLock(void)
+{
+  if (itable_lockState != 2)
+  {
+    if (InterlockedCompareExchange((LONG*)&itable_lockState, 1, 0) == 0)
+    {
+      InitializeCriticalSection(&itable_lock);
+      InterlockedExchange((LONG*)&itable_lockState, 2);
+    }
+    else
+    {
+      while (itable_lockState != 2)
+        Sleep(0);
+    }
+  }
+
+  EnterCriticalSection(&itable_lock);
+}
+
+#define iTableAtomUnlock() LeaveCriticalSection(&itable_lock)
+#else
+static pthread_mutex_t itable_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define iTableAtomLock()   pthread_mutex_lock(&itable_lock)
+#define iTableAtomUnlock() pthread_mutex_unlock(&itable_lock)
+#endif
+
+static unsigned int iTableHashString(const char *key)
+{
+  register unsigned int checksum = 0;
+
+  while (*key)
+  {
+    checksum *= 31;
+    checksum += *key;
+    key++;
+  }
+
+  /* mix the bits, the table sizes are powers of 2 */
+  checksum ^= checksum >> 16;
+  checksum *= 0x85ebca6b;
+  checksum ^= checksum >> 13;
+  return checksum;
+}
+
+static unsigned int iTableHashId(unsigned int hash, int id1, int id2)
+{
+  hash ^= (unsigned int)id1 * 0x9e3779b1;
+  hash ^= (unsigned int)id2 * 0x85ebca6b;
+  hash ^= hash >> 15;
+  return hash;
+}
+
+static unsigned int iTableHashPointer(const void *key)
+{
+  unsigned int checksum = (unsigned int)((size_t)key >> 3);
+#if defined(_WIN64) || defined(__LP64__) || defined(_LP64)
+  checksum ^= (unsigned int)((size_t)key >> 32);
+#endif
+  checksum *= 0x9e3779b1;
+  checksum ^= checksum >> 15;
+  return checksum;
+}
+
+static ItableAtom* iTableAtomFind(const char *key, unsigned int hash, unsigned int *atomIndex)
+{
+  unsigned int mask, index, insertIndex = (unsigned int)-1;
+  ItableAtom* atom;
+
+  if (!itable_atoms)
+  {
+    *atomIndex = (unsigned int)-1;
+    return NULL;
+  }
+
+  mask = itable_atomsSize - 1;
+  index = hash & mask;
+  while ((atom = itable_atoms[index]) != NULL)
+  {
+    if (atom == &itable_removedAtom)
+    {
+      if (insertIndex == (unsigned int)-1)
+        insertIndex = index;
+    }
+    else if (atom->hash == hash && strcmp(atom->str, key) == 0)
+      return atom;
+
+    index = (index + 1) & mask;
+  }
+
+  /* if not found "atomIndex" will have the new insert position. */
+  *atomIndex = (insertIndex != (unsigned int)-1)? insertIndex: index;
+  return NULL;
+}
+
+static void iTableAtomResize(void)
+{
+  unsigned int i, newSize = 256, mask;
+  ItableAtom** newAtoms;
+
+  while (itable_atomsCount*2 >= newSize)
+    newSize *= 2;
+
+  newAtoms = (ItableAtom**)calloc(newSize, sizeof(ItableAtom*));
+  mask = newSize - 1;
+
+  for (i = 0; i < itable_atomsSize; i++)
+  {
+    ItableAtom* atom = itable_atoms[i];
+    if (atom && atom != &itable_removedAtom)
+    {
+      unsigned int index = atom->hash & mask;
+      while (newAtoms[index])
+        index = (index + 1) & mask;
+      newAtoms[index] = atom;
+    }
+  }
+
+  if (itable_atoms)
+    free(itable_atoms);
+
+  itable_atoms = newAtoms;
+  itable_atomsSize = newSize;
+  itable_atomsUsed = itable_atomsCount;
+}
+
+/* Returns the atom of the key with a new reference */
+static ItableAtom* iTableAtomAdd(const char *key)
+{
+  unsigned int hash = iTableHashString(key), atomIndex;
+  ItableAtom* atom;
+  int size;
+
+  iTableAtomLock();
+
+  atom = iTableAtomFind(key, hash, &atomIndex);
+  if (atom)
+  {
+    atom->refCount++;
+    iTableAtomUnlock();
+    return atom;
+  }
+
+  if ((itable_atomsUsed+1)*4 > itable_atomsSize*3)   /* max load is 75% */
+  {
+    iTableAtomResize();
+    iTableAtomFind(key, hash, &atomIndex);
+  }
+
+  size = strlen(key);
+  atom = (ItableAtom*)malloc(sizeof(ItableAtom) + size);
+  iupASSERT(atom!=NULL);
+  if (!atom)
+  {
+    iTableAtomUnlock();
+    return NULL;
+  }
+
+  atom->hash = hash;
+  atom->refCount = 1;
+  memcpy(atom->str, key, size+1);
+
+  if (itable_atoms[atomIndex] == NULL)
+    itable_atomsUsed++;
+  itable_atoms[atomIndex] = atom;
+  itable_atomsCount++;
+
+  iTableAtomUnlock();
+  return atom;
+}
+
+static void iTableAtomRelease(const char *key)
+{
+  ItableAtom* atom = iTableAtomFromKey(key);
+  unsigned int mask, index;
+
+  iTableAtomLock();
+
+  atom->refCount--;
+  if (atom->refCount > 0)
+  {
+    iTableAtomUnlock();
+    return;
+  }
+
+  mask = itable_atomsSize - 1;
+  index = atom->hash & mask;
+  while (itable_atoms[index] != atom)
+    index = (index + 1) & mask;
+
+  itable_atoms[index] = &itable_removedAtom;
+  itable_atomsCount--;
+  free(atom);
+
+  if (itable_atomsCount == 0)
+  {
+    /* no more tables with string keys, release all memory */
+    free(itable_atoms);
+    itable_atoms = NULL;
+    itable_atomsSize = 0;
+    itable_atomsUsed = 0;
+  }
+
+  iTableAtomUnlock();
+}
+
+
+/********************************************/
+/*           Private functions              */
+/********************************************/
 
-static void iTableFreeItemArray(Itable_IndexTypes indexType, unsigned int nextFreeIndex, 
-                                                            ItableItem *items);
-static unsigned int iTableGetEntryIndex(Itable *it, const char *key, unsigned long *keyIndex);
-static unsigned int iTableFindItem(Itable *it, const char *key, ItableEntry **entry, 
-                                                          unsigned int *itemIndex,
-                                                          unsigned long *keyIndex);
-static unsigned int iTableResize(Itable *it);
-static void iTableAdd(Itable *it, ItableKey *key, void *value, Itable_Types itemType);
-static void iTableUpdateArraySize(ItableEntry *entry);   
 
 #ifdef DEBUGTABLE
 static void iTableShowStatistics(Itable *it);
-static void iTableCheckDuplicated(ItableItem *item, unsigned int nextItemIndex, 
-                                              const char *key, 
-                                              unsigned long keyIndex);
 #endif
 
+/* Returns the key used in the table, or NULL if the key is not in any table */
+static const char* iTableGetKey(Itable *it, const char *key, unsigned int *hash)
+{
+  if (it->indexType != IUPTABLE_POINTERINDEXED)
+  {
+    unsigned int atomIndex;
+    ItableAtom* atom;
 
-Itable *iupTableCreate(Itable_IndexTypes indexType)
+    *hash = iTableHashString(key);
+    iTableAtomLock();
+    atom = iTableAtomFind(key, *hash, &atomIndex);
+    iTableAtomUnlock();
+    if (!atom)
+      return NULL;
+
+    return atom->str;
+  }
+  else
+  {
+    *hash = iTableHashPointer(key);
+    return key;
+  }
+}
+
+#define iTableIdEqual(_ids, _i, _id1, _id2) (!(_ids) || ((_ids)[_i].id1 == (_id1) && (_ids)[_i].id2 == (_id2)))
+
+static unsigned int iTableFindItem(Itable *it, const char *key, unsigned int hash, int id1, int id2, unsigned int *itemIndex)
+{
+  ItableItem *items = it->items;
+  ItableId *ids = it->ids;
+  unsigned int i, insertIndex = (unsigned int)-1;
+
+  if (items == it->smallItems)
+  {
+    /* small table, just a linear search */
+    for (i = 0; i < ITABLE_SMALLSIZE; i++)
+    {
+      if (items[i].key == key)
+      {
+        *itemIndex = i;
+        return 1;
+      }
+
+      if (insertIndex == (unsigned int)-1 && !iTableIsUsed(items[i].key))
+        insertIndex = i;
+    }
+  }
+  else
+  {
+    unsigned int mask = it->size - 1;
+
+    i = hash & mask;
+    while (items[i].key)
+    {
+      if (items[i].key == key && iTableIdEqual(ids, i, id1, id2))
+      {
+        *itemIndex = i;
+        return 1;
+      }
+
+      if (insertIndex == (unsigned int)-1 && items[i].key == ITABLE_REMOVED)
+        insertIndex = i;
+
+      i = (i + 1) & mask;
+    }
+
+    if (insertIndex == (unsigned int)-1)
+      insertIndex = i;
+  }
+
+  /* if not found "itemIndex" will have the new insert position, or -1 if full. */
+  *itemIndex = insertIndex;
+  return 0;
+}
+
+static void iTableRehash(Itable *it, unsigned int newSize)
+{
+  ItableItem *oldItems = it->items;
+  ItableId *oldIds = it->ids;
+  unsigned int oldSize = it->size, i, mask;
+
+  iupASSERT(newSize > ITABLE_SMALLSIZE);
+
+  it->items = (ItableItem*)calloc(newSize, sizeof(ItableItem));
+  iupASSERT(it->items!=NULL);
+  if (!it->items)
+  {
+    it->items = oldItems;
+    return;
+  }
+
+  if (it->indexType == IUPTABLE_IDINDEXED)
+    it->ids = (ItableId*)calloc(newSize, sizeof(ItableId));
+
+  it->size = newSize;
+  mask = newSize - 1;
+
+  for (i = 0; i < oldSize; i++)
+  {
+    if (iTableIsUsed(oldItems[i].key))
+    {
+      unsigned int index = oldItems[i].hash & mask;
+      while (it->items[index].key)
+        index = (index + 1) & mask;
+      it->items[index] = oldItems[i];
+      if (oldIds)
+        it->ids[index] = oldIds[i];
+    }
+  }
+
+  if (oldItems != it->smallItems)
+    free(oldItems);
+  if (oldIds)
+    free(oldIds);
+
+  it->used = it->numberOfEntries;
+}
+
+static int iTableResize(Itable *it)
 {
-  return iupTableCreateSized(indexType, 1);  /* 101 shows to be a better start for IUP */
+  unsigned int newSize;
+
+  if (it->items == it->smallItems)
+  {
+    if (it->numberOfEntries < ITABLE_SMALLSIZE)
+      return 0;
+  }
+  else
+  {
+    if ((it->used+1)*4 <= it->size*3)   /* max load is 75% */
+      return 0;
+  }
+
+  newSize = it->size;
+  while ((it->numberOfEntries+1)*2 > newSize)
+    newSize *= 2;
+
+  iTableRehash(it, newSize);
+  return 1;
 }
 
+static void iTableRemoveItem(Itable *it, unsigned int itemIndex)
+{
+  ItableItem *item = &(it->items[itemIndex]);
+
+  if (it->indexType != IUPTABLE_POINTERINDEXED)
+    iTableAtomRelease(item->key);
+
+  if (item->itemType == IUPTABLE_STRING)
+    free(item->value);
+
+  if (it->ids && it->ids[itemIndex].name)
+  {
+    free(it->ids[itemIndex].name);
+    it->ids[itemIndex].name = NULL;
+  }
+
+  /* small tables are searched linearly, so the slot can be simply released */
+  item->key = (it->items == it->smallItems)? NULL: ITABLE_REMOVED;
+  item->value = NULL;
+
+  it->numberOfEntries--;
+}
+
+static unsigned int iTableNextUsed(Itable *it, unsigned int itemIndex)
+{
+  for (; itemIndex < it->size; itemIndex++)
+  {
+    if (iTableIsUsed(it->items[itemIndex].key))
+      return itemIndex;
+  }
+  return (unsigned int)-1;
+}
+
+
+/********************************************/
+/*           Public functions               */
+/********************************************/
+
+
+Itable *iupTableCreate(Itable_IndexTypes indexType)
+{
+  return iupTableCreateSized(indexType, 0);  /* most IUP elements have just a few attributes */
+}
 
 Itable *iupTableCreateSized(Itable_IndexTypes indexType, unsigned int initialSizeIndex)
 {
@@ -128,23 +525,17 @@ Itable *iupTableCreateSized(Itable_IndexTypes indexType, unsigned int initialSiz
   if (initialSizeIndex > itable_maxTableSizeIndex)
     initialSizeIndex = itable_maxTableSizeIndex;
 
-  it->entriesSize    = itable_hashTableSize[initialSizeIndex];
-  it->tableSizeIndex  = initialSizeIndex;
-  it->numberOfEntries = 0;
-  it->indexType       = indexType;
-
-  it->entries = (ItableEntry *)malloc(it->entriesSize * sizeof(ItableEntry));
-  iupASSERT(it->entries!=NULL);
-  if (!it->entries)
-  {
-    free(it);
-    return 0;
-  }
+  memset(it, 0, sizeof(Itable));
 
-  memset(it->entries, 0, it->entriesSize * sizeof(ItableEntry));
+  it->size       = ITABLE_SMALLSIZE;
+  it->items      = it->smallItems;
+  it->indexType  = indexType;
+  it->context    = (unsigned int)-1;
 
-  it->context.entryIndex = (unsigned int)-1;
-  it->context.itemIndex = (unsigned int)-1;
+  if (initialSizeIndex > 0)
+    iTableRehash(it, itable_hashTableSize[initialSizeIndex]);
+  else if (indexType == IUPTABLE_IDINDEXED)
+    iTableRehash(it, 4*ITABLE_SMALLSIZE);  /* id indexed tables are never small */
 
   return it;
 }
@@ -156,22 +547,29 @@ void iupTableClear(Itable *it)
   if (!it)
     return;
 
-  for (i = 0; i < it->entriesSize; i++)
+  for (i = 0; i < it->size; i++)
   {
-    ItableEntry *entry = &(it->entries[i]);
-    if (entry->items)
+    ItableItem *item = &(it->items[i]);
+    if (iTableIsUsed(item->key))
     {
-      iTableFreeItemArray(it->indexType, entry->nextItemIndex, entry->items);
-      entry->items = NULL;
+      if (it->indexType != IUPTABLE_POINTERINDEXED)
+        iTableAtomRelease(item->key);
+
+      if (item->itemType == IUPTABLE_STRING)
+        free(item->value);
+
+      if (it->ids && it->ids[i].name)
+        free(it->ids[i].name);
     }
   }
 
-  it->numberOfEntries = 0;
-
-  memset(it->entries, 0, it->entriesSize * sizeof(ItableEntry));
+  memset(it->items, 0, it->size * sizeof(ItableItem));
+  if (it->ids)
+    memset(it->ids, 0, it->size * sizeof(ItableId));
 
-  it->context.entryIndex = (unsigned int)-1;
-  it->context.itemIndex = (unsigned int)-1;
+  it->numberOfEntries = 0;
+  it->used = 0;
+  it->context = (unsigned int)-1;
 }
 
 void iupTableDestroy(Itable *it)
@@ -185,11 +583,10 @@ void iupTableDestroy(Itable *it)
 
   iupTableClear(it);
 
-  if (it->entries)
-  {
-    free(it->entries);
-    it->entries = NULL;
-  }
+  if (it->items != it->smallItems)
+    free(it->items);
+  if (it->ids)
+    free(it->ids);
 
   free(it);
 }
@@ -207,62 +604,75 @@ void iupTableSetFunc(Itable *it, const char *key, Ifunc func)
   iupTableSet(it, key, (void*)func, IUPTABLE_FUNCPOINTER); /* type cast from function pointer to void* */
 }
 
-void iupTableSet(Itable *it, const char *key, void *value, Itable_Types itemType)
+static void iTableSetItem(Itable *it, const char *key, int id1, int id2, void *value, Itable_Types itemType)
 {
-  unsigned int  itemIndex,
-                itemFound;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
+  unsigned int  itemIndex, hash;
   ItableItem   *item;
   void         *v;
 
-  iupASSERT(it!=NULL);
-  iupASSERT(key!=NULL);
-  if (!it || !key || !value)
-    return;
-
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
+  if (it->indexType != IUPTABLE_POINTERINDEXED)
+  {
+    ItableAtom* atom = iTableAtomAdd(key);
+    if (!atom)
+      return;
+    key = atom->str;
+    hash = atom->hash;
 
-#ifdef DEBUGTABLE
-  if (it->indexType == IUPTABLE_STRINGINDEXED)
-    iTableCheckDuplicated(&(entry->items[0]), entry->nextItemIndex, key, keyIndex);
-#endif
+    if (it->indexType == IUPTABLE_IDINDEXED)
+      hash = iTableHashId(hash, id1, id2);
+  }
+  else
+    hash = iTableHashPointer(key);
 
-  if (!itemFound)
+  if (!iTableFindItem(it, key, hash, id1, id2, &itemIndex))
   {
     /* create a new item */
 
     /* first check if the hash table has to be reorganized */
     if (iTableResize(it))
     {
-      /* We have to search for the entry again, since it may
-       * have been moved by iTableResize. */
-      iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
+      /* We have to search for the insert position again,
+         since the table was rehashed. */
+      iTableFindItem(it, key, hash, id1, id2, &itemIndex);
     }
 
-    iTableUpdateArraySize(entry);
+    if (itemIndex == (unsigned int)-1)
+    {
+      if (it->indexType != IUPTABLE_POINTERINDEXED)
+        iTableAtomRelease(key);
+      return;
+    }
 
-    /* add the item at the end of the item array */
     if (itemType == IUPTABLE_STRING)
       v = iupStrDup(value);
     else
       v = value;
 
-    item = &(entry->items[entry->nextItemIndex]);
+    item = &(it->items[itemIndex]);
 
-    item->itemType     = itemType;
-    item->key.keyIndex = keyIndex;
-    item->key.keyStr   = it->indexType == IUPTABLE_STRINGINDEXED? iupStrDup(key) : key;
-    item->value        = v;
+    if (item->key == NULL)
+      it->used++;
+
+    item->itemType = itemType;
+    item->key      = key;
+    item->hash     = hash;
+    item->value    = v;
+
+    if (it->ids)
+    {
+      it->ids[itemIndex].id1 = id1;
+      it->ids[itemIndex].id2 = id2;
+    }
 
-    entry->nextItemIndex++;
     it->numberOfEntries++;
   }
   else
   {
-    /* change an existing item */
-    void *v;
-    item = &(entry->items[itemIndex]);
+    /* change an existing item, it already has a reference to the key */
+    if (it->indexType != IUPTABLE_POINTERINDEXED)
+      iTableAtomRelease(key);
+
+    item = &(it->items[itemIndex]);
 
     if (itemType == IUPTABLE_STRING && item->itemType == IUPTABLE_STRING)
     {
@@ -284,445 +694,227 @@ void iupTableSet(Itable *it, const char *key, void *value, Itable_Types itemType
   }
 }
 
-static void iTableRemoveItem(Itable *it, ItableEntry *entry, unsigned int itemIndex)
+static ItableItem* iTableGetItem(Itable *it, const char *key, int id1, int id2, unsigned int *itemIndex)
 {
-  ItableItem   *item;
-  unsigned int  i;
+  unsigned int hash;
 
-  item = &(entry->items[itemIndex]);
+  key = iTableGetKey(it, key, &hash);
+  if (!key)
+    return NULL;
 
-  if (it->indexType == IUPTABLE_STRINGINDEXED)
-  {
-    free((void *)item->key.keyStr);
-    item->key.keyStr = NULL;
-  }
+  if (it->indexType == IUPTABLE_IDINDEXED)
+    hash = iTableHashId(hash, id1, id2);
 
-  if (item->itemType == IUPTABLE_STRING)
-  {
-    free(item->value);
-    item->value = NULL;
-  }
+  if (!iTableFindItem(it, key, hash, id1, id2, itemIndex))
+    return NULL;
 
-  /* re-order the remaining items */
-  for (i = itemIndex; i < entry->nextItemIndex-1; i++)
-    entry->items[i] = entry->items[i+1];
+  return &(it->items[*itemIndex]);
+}
 
-  /* clear the released item */
-  memset(entry->items + entry->nextItemIndex-1, 0, sizeof (ItableItem));
+void iupTableSet(Itable *it, const char *key, void *value, Itable_Types itemType)
+{
+  iupASSERT(it!=NULL);
+  iupASSERT(key!=NULL);
+  if (!it || !key || !value)
+    return;
 
-  entry->nextItemIndex--;
-  it->numberOfEntries--;
+  iTableSetItem(it, key, 0, 0, value, itemType);
 }
 
 void iupTableRemove(Itable *it, const char *key)
 {
-  unsigned int itemFound,
-               itemIndex;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
+  unsigned int itemIndex;
 
   iupASSERT(it!=NULL);
   iupASSERT(key!=NULL);
   if (!it || !key)
     return;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-  if (itemFound)
-    iTableRemoveItem(it, entry, itemIndex);
+  if (iTableGetItem(it, key, 0, 0, &itemIndex))
+    iTableRemoveItem(it, itemIndex);
 }
 
 void *iupTableGet(Itable *it, const char *key)
 {
-  unsigned int  itemFound,
-                itemIndex;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
-  void         *value = 0;
+  unsigned int itemIndex;
+  ItableItem *item;
 
   iupASSERT(it!=NULL);
   iupASSERT(key!=NULL);
   if (!it || !key)
     return 0;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-  if (itemFound)
-    value = entry->items[itemIndex].value;
+  item = iTableGetItem(it, key, 0, 0, &itemIndex);
+  if (item)
+    return item->value;
 
-  return value;
-}
-
-Ifunc iupTableGetFunc(Itable *it, const char *key, void **value)
-{
-  Itable_Types itemType = IUPTABLE_POINTER;
-  *value = iupTableGetTyped(it, key, &itemType);
-  if (itemType == IUPTABLE_FUNCPOINTER)
-    return (Ifunc)(*value); /* type cast from void* to function pointer */
-  else
-    return (Ifunc)0;
+  return 0;
 }
 
-void *iupTableGetTyped(Itable *it, const char *key, Itable_Types *itemType)
+void iupTableSetId(Itable *it, const char *name, int id1, int id2, void *value, Itable_Types itemType)
 {
-  unsigned int  itemFound,
-                itemIndex;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
-  void         *value = 0;
-
   iupASSERT(it!=NULL);
-  iupASSERT(key!=NULL);
-  if (!it || !key)
-    return 0;
-
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-  if (itemFound)
-  {
-    value = entry->items[itemIndex].value;
-    if (itemType) 
-      *itemType = entry->items[itemIndex].itemType;
-  }
+  iupASSERT(name!=NULL);
+  if (!it || !name || !value)
+    return;
 
-  return value;
+  iupASSERT(it->indexType == IUPTABLE_IDINDEXED);
+  iTableSetItem(it, name, id1, id2, value, itemType);
 }
 
-void *iupTableGetCurr(Itable *it)
+void iupTableRemoveId(Itable *it, const char *name, int id1, int id2)
 {
+  unsigned int itemIndex;
+
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
-    return 0;
+  iupASSERT(name!=NULL);
+  if (!it || !name)
+    return;
 
-  return it->entries[it->context.entryIndex].items[it->context.itemIndex].value;
+  if (iTableGetItem(it, name, id1, id2, &itemIndex))
+    iTableRemoveItem(it, itemIndex);
 }
 
-
-char *iupTableFirst(Itable *it)
+void *iupTableGetId(Itable *it, const char *name, int id1, int id2)
 {
-  unsigned int entryIndex;
+  unsigned int itemIndex;
+  ItableItem *item;
 
   iupASSERT(it!=NULL);
-  if (!it)
+  iupASSERT(name!=NULL);
+  if (!it || !name)
     return 0;
 
-  it->context.entryIndex = (unsigned int)-1;
-  it->context.itemIndex = (unsigned int)-1;
-
-  /* find the first used entry */
-  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
-  {
-    if (it->entries[entryIndex].nextItemIndex > 0)
-    {
-      it->context.entryIndex = entryIndex;
-      it->context.itemIndex = 0;
-      return (char*)it->entries[entryIndex].items[0].key.keyStr;
-    }
-  }
+  item = iTableGetItem(it, name, id1, id2, &itemIndex);
+  if (item)
+    return item->value;
 
   return 0;
 }
 
-
-char *iupTableNext(Itable *it)
+Ifunc iupTableGetFunc(Itable *it, const char *key, void **value)
 {
-  unsigned int entryIndex;
-
-  iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
-    return 0;
-
-  if (it->context.itemIndex + 1 < it->entries[it->context.entryIndex].nextItemIndex)
-  {
-    /* key in the current entry */
-    it->context.itemIndex++;
-    return (char*)it->entries[it->context.entryIndex].items[it->context.itemIndex].key.keyStr;
-  }
+  Itable_Types itemType = IUPTABLE_POINTER;
+  *value = iupTableGetTyped(it, key, &itemType);
+  if (itemType == IUPTABLE_FUNCPOINTER)
+    return (Ifunc)(*value); /* type cast from void* to function pointer */
   else
-  {
-    /* find the next used entry */
-    for (entryIndex = it->context.entryIndex+1; entryIndex < it->entriesSize; entryIndex++)
-    {
-      if (it->entries[entryIndex].nextItemIndex > 0)
-      {
-        it->context.entryIndex = entryIndex;
-        it->context.itemIndex = 0;
-        return (char*)it->entries[entryIndex].items[0].key.keyStr;
-      }
-    }
-  }
-
-  return 0;
+    return (Ifunc)0;
 }
 
-char *iupTableRemoveCurr(Itable *it)
+void *iupTableGetTyped(Itable *it, const char *key, Itable_Types *itemType)
 {
-  char* key;
-  unsigned int entryIndex;
-  ItableEntry  *entry;
   unsigned int itemIndex;
+  ItableItem *item;
 
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
+  iupASSERT(key!=NULL);
+  if (!it || !key)
     return 0;
 
-  entry = &it->entries[it->context.entryIndex];
-  itemIndex = it->context.itemIndex;
-
-  if (it->context.itemIndex + 1 < it->entries[it->context.entryIndex].nextItemIndex)
+  item = iTableGetItem(it, key, 0, 0, &itemIndex);
+  if (item)
   {
-    /* key in the current entry */
-    it->context.itemIndex++;
-    key = (char*)it->entries[it->context.entryIndex].items[it->context.itemIndex].key.keyStr;
-
-    iTableRemoveItem(it, entry, itemIndex);
-    return key;
-  }
-  else
-  {
-    /* find the next used entry */
-    for (entryIndex = it->context.entryIndex+1; entryIndex < it->entriesSize; entryIndex++)
-    {
-      if (it->entries[entryIndex].nextItemIndex > 0)
-      {
-        it->context.entryIndex = entryIndex;
-        it->context.itemIndex = 0;
-        key = (char*)it->entries[entryIndex].items[0].key.keyStr;
-
-        iTableRemoveItem(it, entry, itemIndex);
-        return key;
-       }
-    }
+    if (itemType)
+      *itemType = item->itemType;
+    return item->value;
   }
 
   return 0;
 }
 
-
-/********************************************/
-/*           Private functions              */
-/********************************************/
-
-
-static void iTableFreeItemArray(Itable_IndexTypes indexType, unsigned int nextFreeIndex, ItableItem *items)
+void *iupTableGetCurr(Itable *it)
 {
-  unsigned int i;
-
-  /* Used only in iupTableClear */
-
-  iupASSERT(items!=NULL);
-  if (!items)
-    return;
-
-  if (indexType == IUPTABLE_STRINGINDEXED)
-  {
-    for (i = 0; i < nextFreeIndex; i++)
-    {
-      free((void *)(items[i].key.keyStr));
-      items[i].key.keyStr = NULL;
-    }
-  }
-
-  for (i = 0; i < nextFreeIndex; i++)
-  {
-    if (items[i].itemType == IUPTABLE_STRING)
-    {
-      free(items[i].value);
-      items[i].value = NULL;
-    }
-  }
+  iupASSERT(it!=NULL);
+  if (!it || it->context == (unsigned int)-1)
+    return 0;
 
-  free(items);
+  return it->items[it->context].value;
 }
 
-
-static unsigned int iTableGetEntryIndex(Itable *it, const char *key, unsigned long *keyIndex)
+void iupTableGetCurrId(Itable *it, int *id1, int *id2)
 {
-  if (it->indexType == IUPTABLE_STRINGINDEXED)
-  {
-    register unsigned int checksum = 0;
-
-/*     Orignal version
-    unsigned int i;
-    for (i = 0; key[i]; i++)
-      checksum = checksum*31 + key[i];  
-*/
-
-    while (*key)
-    {
-      checksum *= 31;
-      checksum += *key;
-      key++;
-    }
-
-    *keyIndex = checksum;            /* this could NOT be dependent from table size */
-  }
-  else
-  {
-    /* Pointer indexed */
-    *keyIndex = (unsigned long)key;   /* this could NOT be dependent from table size */
-  }
-
-  return (unsigned int)((*keyIndex) % it->entriesSize);
-}
+  iupASSERT(it!=NULL);
+  if (!it || !it->ids || it->context == (unsigned int)-1)
+    return;
 
-#ifdef DEBUGTABLE
-static void iTableCheckDuplicated(ItableItem *item, unsigned int nextItemIndex, const char *key, 
-                                                                          unsigned long keyIndex)
-{
-  unsigned int i;
-  for (i = 0; i < nextItemIndex; i++, item++)
-  {
-    if (!iupStrEqual((char*)item->key.keyStr, (char*)key) && 
-        item->key.keyIndex == keyIndex)
-    {
-      fprintf(stderr, "#ERROR# Duplicated key index (%ld): %s %s \n", keyIndex, 
-                                                                     (char*)item->key.keyStr, 
-                                                                     (char*)key);
-    }
-  }
+  if (id1) *id1 = it->ids[it->context].id1;
+  if (id2) *id2 = it->ids[it->context].id2;
 }
-#endif
 
-static unsigned int iTableFindItem(Itable *it, const char *key, ItableEntry **entry, 
-                                                          unsigned int *itemIndex,
-                                                          unsigned long *keyIndex)
+char *iupTableGetCurrIdName(Itable *it)
 {
-  unsigned int entryIndex,
-               itemFound,
-               i;
-  ItableItem  *item;
-
-  entryIndex = iTableGetEntryIndex(it, key, keyIndex);
+  ItableId *id;
 
-  *entry = &(it->entries[entryIndex]);
+  iupASSERT(it!=NULL);
+  if (!it || !it->ids || it->context == (unsigned int)-1)
+    return 0;
 
-  item = &((*entry)->items[0]);
-  for (i = 0; i < (*entry)->nextItemIndex; i++, item++)
+  id = &(it->ids[it->context]);
+  if (!id->name)
   {
-    if (it->indexType == IUPTABLE_STRINGINDEXED)
-      itemFound = item->key.keyIndex == *keyIndex; 
-/*    itemFound = iupStrEqual(item->key.keyStr, key);  This is the original safe version */
+    const char* name = it->items[it->context].key;
+    id->name = (char*)malloc(strlen(name) + 30);
+    if (id->id2 == IUPTABLE_NOID)
+      sprintf(id->name, "%s%d", name, id->id1);
     else
-      itemFound = item->key.keyStr == key;
-
-    if (itemFound)
-    {
-      *itemIndex = i;
-      return 1;
-    }
+      sprintf(id->name, "%s%d:%d", name, id->id1, id->id2);
   }
 
-  /* if not found "entry", "itemIndex" and "keyIndex" will have the new insert position. */
-
-  *itemIndex = i;
-  return 0;
+  return id->name;
 }
 
-static void iTableUpdateArraySize(ItableEntry *entry)
+char *iupTableFirst(Itable *it)
 {
-  if (entry->nextItemIndex >= entry->itemsSize)
-  {
-    /* we have to expand the item array */
-    unsigned int newSize;
-
-    newSize = entry->itemsSize + itable_itemGrow;
-
-    entry->items = (ItableItem *)realloc(entry->items, newSize * sizeof(ItableItem));
-    iupASSERT(entry->items!=NULL);
-    if (!entry->items)
-      return;
+  iupASSERT(it!=NULL);
+  if (!it)
+    return 0;
 
-    memset(entry->items + entry->itemsSize, 0, itable_itemGrow * sizeof(ItableItem));
+  it->context = iTableNextUsed(it, 0);
+  if (it->context == (unsigned int)-1)
+    return 0;
 
-    entry->itemsSize = newSize;
-  }
+  return (char*)it->items[it->context].key;
 }
 
-static void iTableAdd(Itable *it, ItableKey *key, void *value, Itable_Types itemType)
+char *iupTableNext(Itable *it)
 {
-  unsigned int entryIndex;
-  unsigned long keyIndex;
-  ItableEntry *entry;
-  ItableItem* item;
-
-  entryIndex = iTableGetEntryIndex(it, key->keyStr, &keyIndex);
-
-  entry = &(it->entries[entryIndex]);
-  iTableUpdateArraySize(entry);
+  iupASSERT(it!=NULL);
+  if (!it || it->context == (unsigned int)-1)
+    return 0;
 
-  /* add a new item at the end of the item array without duplicating memory. */
-  item = &(entry->items[entry->nextItemIndex]);
-  item->itemType     = itemType;
-  item->key.keyIndex = keyIndex;
-  item->key.keyStr   = key->keyStr;
-  item->value        = value;
+  it->context = iTableNextUsed(it, it->context+1);
+  if (it->context == (unsigned int)-1)
+    return 0;
 
-  entry->nextItemIndex++;
-  it->numberOfEntries++;
+  return (char*)it->items[it->context].key;
 }
 
-static unsigned int iTableResize(Itable *it)
+char *iupTableRemoveCurr(Itable *it)
 {
-  unsigned int   newSizeIndex,
-                 entryIndex,
-                 i;
-  Itable        *newTable;
-  ItableEntry   *entry;
-  ItableItem    *item;
+  unsigned int itemIndex;
 
-  /* check if we do not need to resize the hash table */
-  if (it->numberOfEntries == 0 ||
-     it->tableSizeIndex >= itable_maxTableSizeIndex ||
-     it->entriesSize / it->numberOfEntries >= itable_resizeLimit)
+  iupASSERT(it!=NULL);
+  if (!it || it->context == (unsigned int)-1)
     return 0;
 
-  /* create a new hash table and copy the contents of
-   * the current table into the new one
-   */
-  newSizeIndex = it->tableSizeIndex + 1;
-  newTable = iupTableCreateSized(it->indexType, newSizeIndex);
+  itemIndex = it->context;
 
-  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
-  {
-    entry = &(it->entries[entryIndex]);
-
-    if (entry->items)
-    {
-      item = &(entry->items[0]);
+  /* removed slots are not moved, so the next key is still valid after the removal */
+  it->context = iTableNextUsed(it, itemIndex+1);
+  iTableRemoveItem(it, itemIndex);
 
-      for (i = 0; i < entry->nextItemIndex; i++, item++)
-      {
-        iTableAdd(newTable, &(item->key), item->value, item->itemType);
-      }     
-
-      free(entry->items);
-      entry->items = NULL;
-    }
-  }
-
-  free(it->entries);
-
-  it->entriesSize    = newTable->entriesSize;
-  it->tableSizeIndex  = newTable->tableSizeIndex;
-  it->numberOfEntries = newTable->numberOfEntries;
-  it->entries         = newTable->entries;
-
-  free(newTable);
+  if (it->context == (unsigned int)-1)
+    return 0;
 
-  return 1;
+  return (char*)it->items[it->context].key;
 }
 
 #ifdef DEBUGTABLE
 static void iTableShowStatistics(Itable *it)
 {
-  unsigned int nofSlots        = 0;
-  unsigned int nofKeys         = 0;
-  double optimalNofKeysPerSlot = 0.0;
-  unsigned int nofSlotsWithMoreKeys = 0;
-  unsigned int nofSlotsWithLessKeys = 0;
+  unsigned int i, probes = 0, maxProbes = 0;
 
-  unsigned int entryIndex;
   fprintf(stderr, "\n--- HASH TABLE STATISTICS ---\n");
   if (!it)
   {
@@ -730,25 +922,26 @@ static void iTableShowStatistics(Itable *it)
     return;
   }
 
-  nofSlots = it->entriesSize;
-  nofKeys  = it->numberOfEntries;
-  optimalNofKeysPerSlot = (double)nofKeys / (double)nofSlots;
-
-  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
+  if (it->items != it->smallItems)
   {
-    ItableEntry *entry = &(it->entries[entryIndex]);
-
-    if (entry->nextItemIndex > optimalNofKeysPerSlot + 3)
-      nofSlotsWithMoreKeys++;
-    else if (entry->nextItemIndex < optimalNofKeysPerSlot - 3)
-      nofSlotsWithLessKeys++;
+    unsigned int mask = it->size - 1;
+    for (i = 0; i < it->size; i++)
+    {
+      if (iTableIsUsed(it->items[i].key))
+      {
+        unsigned int dist = (i - (it->items[i].hash & mask)) & mask;
+        probes += dist;
+        if (dist > maxProbes) maxProbes = dist;
+      }
+    }
   }
 
-  fprintf(stderr, "Number of slots: %d\n", nofSlots);
-  fprintf(stderr, "Number of keys: %d\n", nofKeys);
-  fprintf(stderr, "Optimal number of keys per slot: %f\n", optimalNofKeysPerSlot);
-  fprintf(stderr, "Number of slots with much more keys: %d\n", nofSlotsWithMoreKeys);
-  fprintf(stderr, "Number of slots with far less keys: %d\n", nofSlotsWithLessKeys);
+  fprintf(stderr, "Number of slots: %d%s\n", it->size, it->items == it->smallItems? " (small)": "");
+  fprintf(stderr, "Number of keys: %d\n", it->numberOfEntries);
+  fprintf(stderr, "Number of removed slots: %d\n", it->used - it->numberOfEntries);
+  fprintf(stderr, "Average probe distance: %f\n", it->numberOfEntries? (double)probes / (double)it->numberOfEntries: 0.0);
+  fprintf(stderr, "Max probe distance: %d\n", maxProbes);
+  fprintf(stderr, "Number of atoms: %d\n", itable_atomsCount);
   fprintf(stderr, "\n");
 }
 #endif
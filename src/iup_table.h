@@ -27,9 +27,14 @@ extern "C"
 typedef enum _Itable_IndexTypes
 {
   IUPTABLE_POINTERINDEXED = 10, /**< a pointer address is used as key. */
-  IUPTABLE_STRINGINDEXED        /**< a string as key */
+  IUPTABLE_STRINGINDEXED,       /**< a string as key */
+  IUPTABLE_IDINDEXED            /**< a string and two numbers as key, see \ref iupTableSetId */
 } Itable_IndexTypes;
 
+/** Used as the second id for items with only one id in a IUPTABLE_IDINDEXED table.
+ * \ingroup table */
+#define IUPTABLE_NOID (-2147483647-1)
+
 /** How the value is interpreted.
  * \ingroup table */
 typedef enum _Itable_Types
@@ -48,6 +53,8 @@ typedef struct _Itable Itable;
 
 /** Creates a hash table with an initial default size.
  * This function is equivalent to iupTableCreateSized(0);
+ * A new table stores its first few items inside the table structure,
+ * no additional memory is allocated until it grows.
  * \ingroup table */
 Itable *iupTableCreate(Itable_IndexTypes indexType);
 
@@ -57,6 +64,9 @@ Itable *iupTableCreate(Itable_IndexTypes indexType);
  * possible hash table sizes. Currently only indexes from 0 to 8
  * are supported. If you specify a higher value here, the maximum
  * allowed value will be used.
+ * \par
+ * String keys are interned in a global table shared by all string indexed tables,
+ * so inside each table keys are compared by address.
  * \ingroup table */
 Itable *iupTableCreateSized(Itable_IndexTypes indexType, unsigned int initialSizeIndex);
 
@@ -104,6 +114,21 @@ void *iupTableGetTyped(Itable *it, const char *key, Itable_Types *itemType);
  * \ingroup table */
 void iupTableRemove(Itable *it, const char *key);
 
+/** Store an element in a IUPTABLE_IDINDEXED table.
+ * The key is the name plus the two numbers, so no string is built for each id.
+ * Use id2=IUPTABLE_NOID for elements with only one id.
+ * \ingroup table */
+void iupTableSetId(Itable *it, const char *name, int id1, int id2, void *value, Itable_Types itemType);
+
+/** Retrieves an element from a IUPTABLE_IDINDEXED table.
+ * Returns NULL if not found.
+ * \ingroup table */
+void *iupTableGetId(Itable *it, const char *name, int id1, int id2);
+
+/** Removes an element from a IUPTABLE_IDINDEXED table.
+ * \ingroup table */
+void iupTableRemoveId(Itable *it, const char *name, int id1, int id2);
+
 /** Key iteration function. Returns a key.
  * To iterate over all keys call iupTableFirst at the first
  * and call iupTableNext in a loop
@@ -129,6 +154,17 @@ char *iupTableNext(Itable *it);
  * \ingroup table */
 void *iupTableGetCurr(Itable *it);
 
+/** Returns the ids at the current position of a IUPTABLE_IDINDEXED table.
+ * The key returned by iupTableNext() is the name without the ids.
+ * \ingroup table */
+void iupTableGetCurrId(Itable *it, int *id1, int *id2);
+
+/** Returns the full name at the current position of a IUPTABLE_IDINDEXED table,
+ * in the format "NAME%d" or "NAME%d:%d". 
+ * The string is built on the first call and it is valid while the element exists.
+ * \ingroup table */
+char *iupTableGetCurrIdName(Itable *it);
+
 /** Removes the current element and returns the next key.
  * Use this function to remove an element during an iteration.
  * \ingroup table */
@@ -34,16 +34,12 @@ char* iupTabsGetPaddingAttrib(Ihandle* ih)
 
 char* iupTabsAttribGetStrId(Ihandle* ih, const char* name, int pos)
 {
-  char str[50];
-  sprintf(str, "%s%d", name, pos);
-  return iupAttribGet(ih, str);
+  return iupAttribGetId(ih, name, pos);
 }
 
 void iupTabsAttribSetStrId(Ihandle* ih, const char* name, int pos, const char* value)
 {
-  char str[50];
-  sprintf(str, "%s%d", name, pos);
-  iupAttribStoreStr(ih, str, value);
+  iupAttribStoreStrId(ih, name, pos, value);
 }
 
 static int iTabsGetMaxWidth(Ihandle* ih)
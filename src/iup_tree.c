@@ -217,119 +217,555 @@ void iupTreeSelectLastCollapsedBranch(Ihandle* ih, int *last_id)
   }
 }
 
-int iupTreeForEach(Ihandle* ih, iupTreeNodeFunc func, void* userdata)
+/*************************************************************************/
+/*  Node cache                                                           */
+/*  The nodes are stored by id in blocks of at most ITREE_BLOCK nodes.   */
+/*  A Fenwick tree with the number of nodes of each block gives the     */
+/*  block of an id and the first id of a block in O(log n), and a hash  */
+/*  table gives the block of a node handle. Inserting or removing a     */
+/*  node moves only the nodes of its block.                              */
+/*************************************************************************/
+
+#define ITREE_BLOCK 256
+
+typedef struct _ItreeBlock
+{
+  int index;    /* position in the blocks array */
+  int count;
+  InodeData nodes[ITREE_BLOCK];
+} ItreeBlock;
+
+typedef struct _ItreeHashItem
+{
+  InodeHandle* node_handle;   /* NULL if empty */
+  ItreeBlock* block;
+} ItreeHashItem;
+
+struct _ItreeNodeCache
+{
+  ItreeBlock** blocks;
+  int block_count, block_max;
+  int* tree;                 /* Fenwick tree of the number of nodes of each block, 1 based */
+  int count;                 /* number of nodes, node_count can be different during updates in the driver */
+
+  ItreeHashItem* hash;
+  int hash_max, hash_count;  /* hash_max is a power of 2 */
+
+  int last_index, last_first;  /* last block found, last_index=-1 if none */
+};
+
+static InodeData iTreeEmptyNode = {NULL, NULL};
+
+static unsigned int iTreeHashPointer(InodeHandle* node_handle)
+{
+  unsigned int h = (unsigned int)((size_t)node_handle >> 3);
+  h ^= h >> 16;
+  h *= 0x45d9f3b;
+  h ^= h >> 16;
+  return h;
+}
+
+static int iTreeHashFind(ItreeNodeCache* cache, InodeHandle* node_handle)
+{
+  int mask = cache->hash_max-1;
+  int i = iTreeHashPointer(node_handle) & mask;
+  while (cache->hash[i].node_handle)
+  {
+    if (cache->hash[i].node_handle == node_handle)
+      return i;
+    i = (i+1) & mask;
+  }
+  return -1;
+}
+
+static void iTreeHashSet(ItreeNodeCache* cache, InodeHandle* node_handle, ItreeBlock* block);
+
+static void iTreeHashGrow(ItreeNodeCache* cache)
+{
+  ItreeHashItem* old_hash = cache->hash;
+  int old_max = cache->hash_max, i;
+
+  cache->hash_max = old_max? 2*old_max: 1024;
+  cache->hash = (ItreeHashItem*)calloc(cache->hash_max, sizeof(ItreeHashItem));
+  cache->hash_count = 0;
+
+  for (i = 0; i < old_max; i++)
+  {
+    if (old_hash[i].node_handle)
+      iTreeHashSet(cache, old_hash[i].node_handle, old_hash[i].block);
+  }
+
+  if (old_hash)
+    free(old_hash);
+}
+
+static void iTreeHashSet(ItreeNodeCache* cache, InodeHandle* node_handle, ItreeBlock* block)
+{
+  int mask, i;
+
+  if (2*(cache->hash_count+1) > cache->hash_max)
+    iTreeHashGrow(cache);
+
+  mask = cache->hash_max-1;
+  i = iTreeHashPointer(node_handle) & mask;
+  while (cache->hash[i].node_handle && cache->hash[i].node_handle != node_handle)
+    i = (i+1) & mask;
+
+  if (!cache->hash[i].node_handle)
+  {
+    cache->hash[i].node_handle = node_handle;
+    cache->hash_count++;
+  }
+  cache->hash[i].block = block;
+}
+
+static void iTreeHashRemove(ItreeNodeCache* cache, InodeHandle* node_handle)
+{
+  int mask = cache->hash_max-1;
+  int i = iTreeHashFind(cache, node_handle), j;
+  if (i == -1)
+    return;
+
+  /* move back the items of the same probe sequence */
+  j = i;
+  for (;;)
+  {
+    int k;
+    j = (j+1) & mask;
+    if (!cache->hash[j].node_handle)
+      break;
+
+    k = iTreeHashPointer(cache->hash[j].node_handle) & mask;
+    if ((i <= j)? (i < k && k <= j): (i < k || k <= j))
+      continue;
+
+    cache->hash[i] = cache->hash[j];
+    i = j;
+  }
+
+  cache->hash[i].node_handle = NULL;
+  cache->hash[i].block = NULL;
+  cache->hash_count--;
+}
+
+/* While the driver rebuilds the handles after a move the same handle can be 
+   temporarily in two nodes, so remove it from the hash only if it points to
+   this block and no other node of the block outside [start,end) uses it. */
+static void iTreeHashRelease(ItreeNodeCache* cache, ItreeBlock* block, InodeHandle* node_handle, int start, int end)
+{
+  int pos = iTreeHashFind(cache, node_handle), i;
+  if (pos == -1 || cache->hash[pos].block != block)
+    return;
+
+  for (i = 0; i < block->count; i++)
+  {
+    if ((i < start || i >= end) && block->nodes[i].node_handle == node_handle)
+      return;
+  }
+
+  iTreeHashRemove(cache, node_handle);
+}
+
+/* Updates the blocks from index to the end, after a block was inserted or removed at index.
+   The count of the other blocks must be already updated in the tree.
+   The tree entries before index cover only the blocks before index, so they are kept,
+   and each entry after it is the block count plus its children, already updated.
+   Appending or removing the last block is O(log n). A block in the middle is inserted
+   only when a full block is split, and removed when it is empty or merged,
+   so it happens at most once for ITREE_BLOCK/2 inserted or removed nodes, 
+   and costs O(blocks) only to shift the blocks after it. */
+static void iTreeCacheUpdateTree(ItreeNodeCache* cache, int index)
 {
   int i;
-  for (i = 0; i < ih->data->node_count; i++)
+
+  for (i = index+1; i <= cache->block_count; i++)
   {
-    if (!func(ih, ih->data->node_cache[i].node_handle, i, userdata))
-      return 0;
+    int j, low = i - (i & -i);
+
+    cache->blocks[i-1]->index = i-1;
+    cache->tree[i] = cache->blocks[i-1]->count;
+
+    for (j = i-1; j > low; j -= j & -j)
+      cache->tree[i] += cache->tree[j];
   }
 
-  return 1;
+  if (cache->last_index >= index)
+    cache->last_index = -1;
 }
 
-int iupTreeFindNodeId(Ihandle* ih, InodeHandle* node_handle)
+static void iTreeCacheAddTree(ItreeNodeCache* cache, int index, int diff)
 {
-  /* Unoptimized version:
   int i;
-  for (i = 0; i < ih->data->node_count; i++)
+  for (i = index+1; i <= cache->block_count; i += i & -i)
+    cache->tree[i] += diff;
+}
+
+static int iTreeCacheFirstId(ItreeNodeCache* cache, int index)
+{
+  int i, first = 0;
+  for (i = index; i > 0; i -= i & -i)
+    first += cache->tree[i];
+  return first;
+}
+
+/* returns the block that contains id, id must be valid */
+static int iTreeCacheFindBlock(ItreeNodeCache* cache, int id, int *first)
+{
+  int index = 0, remain = id, step = 1;
+
+  /* usually the nodes are accessed in sequence */
+  if (cache->last_index != -1 && id >= cache->last_first && 
+      id < cache->last_first + cache->blocks[cache->last_index]->count)
   {
-    if (ih->data->node_cache[i].node_handle == node_handle)
-      return i;
+    *first = cache->last_first;
+    return cache->last_index;
+  }
+
+  while (2*step <= cache->block_count)
+    step *= 2;
+
+  for (; step > 0; step /= 2)
+  {
+    if (index+step <= cache->block_count && cache->tree[index+step] <= remain)
+    {
+      index += step;
+      remain -= cache->tree[index];
+    }
+  }
+
+  *first = id - remain;
+  cache->last_index = index;
+  cache->last_first = *first;
+  return index;
+}
+
+static void iTreeCacheInsertBlock(ItreeNodeCache* cache, int index, ItreeBlock* block)
+{
+  if (cache->block_count == cache->block_max)
+  {
+    cache->block_max = cache->block_max? 2*cache->block_max: 16;
+    cache->blocks = (ItreeBlock**)realloc(cache->blocks, cache->block_max*sizeof(ItreeBlock*));
+    cache->tree = (int*)realloc(cache->tree, (cache->block_max+1)*sizeof(int));
+  }
+
+  memmove(cache->blocks+index+1, cache->blocks+index, (cache->block_count-index)*sizeof(ItreeBlock*));
+  cache->blocks[index] = block;
+  cache->block_count++;
+
+  iTreeCacheUpdateTree(cache, index);
+}
+
+static void iTreeCacheRemoveBlock(ItreeNodeCache* cache, int index)
+{
+  free(cache->blocks[index]);
+  memmove(cache->blocks+index, cache->blocks+index+1, (cache->block_count-index-1)*sizeof(ItreeBlock*));
+  cache->block_count--;
+
+  iTreeCacheUpdateTree(cache, index);
+}
+
+static ItreeBlock* iTreeCacheNewBlock(void)
+{
+  return (ItreeBlock*)calloc(1, sizeof(ItreeBlock));
+}
+
+static void iTreeCacheMoveNodes(ItreeNodeCache* cache, ItreeBlock* dst, ItreeBlock* src, int start)
+{
+  int i, count = src->count - start;
+
+  memcpy(dst->nodes + dst->count, src->nodes + start, count*sizeof(InodeData));
+  for (i = dst->count; i < dst->count+count; i++)
+  {
+    if (dst->nodes[i].node_handle)
+      iTreeHashSet(cache, dst->nodes[i].node_handle, dst);
+  }
+
+  dst->count += count;
+  src->count = start;
+}
+
+/* inserts the node at id, 0<=id<=count */
+static void iTreeCacheInsert(ItreeNodeCache* cache, int id, InodeData* node)
+{
+  ItreeBlock* block;
+  int first, off;
+
+  if (cache->block_count == 0)
+  {
+    block = iTreeCacheNewBlock();
+    iTreeCacheInsertBlock(cache, 0, block);
+    first = 0;
+  }
+  else if (id == cache->count)
+  {
+    block = cache->blocks[cache->block_count-1];
+    first = cache->count - block->count;
+
+    if (block->count == ITREE_BLOCK)
+    {
+      /* appending nodes, do not split */
+      block = iTreeCacheNewBlock();
+      iTreeCacheInsertBlock(cache, cache->block_count, block);
+      first = cache->count;
+    }
   }
-  */
-  InodeData *node_cache = ih->data->node_cache;
-  while(node_cache->node_handle != node_handle && 
-        node_cache->node_handle != NULL)   /* the cache always have zeros at the end */
-    node_cache++;
-
-  if (node_cache->node_handle != NULL)
-    return node_cache - ih->data->node_cache;
   else
-    return -1;
+  {
+    block = cache->blocks[iTreeCacheFindBlock(cache, id, &first)];
+
+    if (block->count == ITREE_BLOCK)
+    {
+      /* split the block in two halves */
+      ItreeBlock* next = iTreeCacheNewBlock();
+      iTreeCacheMoveNodes(cache, next, block, ITREE_BLOCK/2);
+      iTreeCacheAddTree(cache, block->index, -next->count);
+      iTreeCacheInsertBlock(cache, block->index+1, next);
+
+      if (id - first >= block->count)
+      {
+        first += block->count;
+        block = next;
+      }
+    }
+  }
+
+  off = id - first;
+  memmove(block->nodes+off+1, block->nodes+off, (block->count-off)*sizeof(InodeData));
+  block->nodes[off] = *node;
+  block->count++;
+  cache->count++;
+
+  iTreeCacheAddTree(cache, block->index, 1);
+  cache->last_index = -1;
+
+  if (node->node_handle)
+    iTreeHashSet(cache, node->node_handle, block);
 }
 
-static int iTreeFindUserDataId(Ihandle* ih, void* userdata)
+static void iTreeCacheRemoveAll(ItreeNodeCache* cache)
 {
-  /* Unoptimized version:
   int i;
-  for (i = 0; i < ih->data->node_count; i++)
+  for (i = 0; i < cache->block_count; i++)
+    free(cache->blocks[i]);
+  cache->block_count = 0;
+  cache->count = 0;
+  cache->last_index = -1;
+
+  if (cache->hash)
   {
-    if (ih->data->node_cache[i].node_handle == node_handle)
-      return i;
+    memset(cache->hash, 0, cache->hash_max*sizeof(ItreeHashItem));
+    cache->hash_count = 0;
   }
-  */
-  InodeData *node_cache = ih->data->node_cache;
-  while(node_cache->userdata != userdata && 
-        node_cache->node_handle != NULL)   /* the cache always have zeros at the end */
-    node_cache++;
-
-  if (node_cache->node_handle != NULL)
-    return node_cache - ih->data->node_cache;
-  else
-    return -1;
 }
 
-InodeHandle* iupTreeGetNode(Ihandle* ih, int id)
+/* removes count nodes starting at id */
+static void iTreeCacheRemove(ItreeNodeCache* cache, int id, int count)
 {
-  if (id >= 0 && id < ih->data->node_count)
-    return ih->data->node_cache[id].node_handle;
-  else if (id == IUP_INVALID_ID && ih->data->node_count!=0)
-    return iupdrvTreeGetFocusNode(ih);
-  else
-    return NULL;
+  if (id == 0 && count >= cache->count)
+  {
+    iTreeCacheRemoveAll(cache);
+    return;
+  }
+
+  while (count > 0)
+  {
+    int first, off, n, i;
+    int index = iTreeCacheFindBlock(cache, id, &first);
+    ItreeBlock* block = cache->blocks[index];
+
+    off = id - first;
+    n = block->count - off;
+    if (n > count)
+      n = count;
+
+    for (i = off; i < off+n; i++)
+    {
+      if (block->nodes[i].node_handle)
+        iTreeHashRelease(cache, block, block->nodes[i].node_handle, off, off+n);
+    }
+
+    memmove(block->nodes+off, block->nodes+off+n, (block->count-(off+n))*sizeof(InodeData));
+    block->count -= n;
+    cache->count -= n;
+    count -= n;
+
+    if (block->count == 0)
+      iTreeCacheRemoveBlock(cache, index);
+    else
+    {
+      iTreeCacheAddTree(cache, index, -n);
+      cache->last_index = -1;
+
+      /* merge with the next block when both are small */
+      if (index+1 < cache->block_count && 
+          block->count + cache->blocks[index+1]->count <= ITREE_BLOCK/2)
+      {
+        int moved = cache->blocks[index+1]->count;
+        iTreeCacheMoveNodes(cache, block, cache->blocks[index+1], 0);
+        iTreeCacheAddTree(cache, index, moved);
+        iTreeCacheRemoveBlock(cache, index+1);
+      }
+    }
+  }
 }
 
-InodeHandle* iupTreeGetNodeFromString(Ihandle* ih, const char* name_id)
+static ItreeNodeCache* iTreeCacheCreate(void)
 {
-  int id = IUP_INVALID_ID;
-  iupStrToInt(name_id, &id);
-  return iupTreeGetNode(ih, id);
+  ItreeNodeCache* cache = (ItreeNodeCache*)calloc(1, sizeof(ItreeNodeCache));
+  cache->last_index = -1;
+  return cache;
+}
+
+static void iTreeCacheDestroy(ItreeNodeCache* cache)
+{
+  iTreeCacheRemoveAll(cache);
+  if (cache->blocks) free(cache->blocks);
+  if (cache->tree) free(cache->tree);
+  if (cache->hash) free(cache->hash);
+  free(cache);
+}
+
+InodeData* iupTreeGetNodeData(Ihandle* ih, int id)
+{
+  ItreeNodeCache* cache = ih->data->node_cache;
+  int first, index;
+
+  if (id < 0 || id >= cache->count)
+    return &iTreeEmptyNode;
+
+  index = iTreeCacheFindBlock(cache, id, &first);
+  return cache->blocks[index]->nodes + (id - first);
 }
 
-static void iTreeAddToCache(Ihandle* ih, int id, InodeHandle* node_handle)
+void iupTreeSetNode(Ihandle* ih, int id, InodeHandle* node_handle)
 {
-  iupASSERT(id >= 0 && id < ih->data->node_count);
-  if (id < 0 || id >= ih->data->node_count)
+  ItreeNodeCache* cache = ih->data->node_cache;
+  ItreeBlock* block;
+  InodeData* node;
+  int first, off;
+
+  iupASSERT(id >= 0 && id < cache->count);
+  if (id < 0 || id >= cache->count)
     return;
 
-  /* node_count here already contains the final count */
+  block = cache->blocks[iTreeCacheFindBlock(cache, id, &first)];
+  off = id - first;
+  node = block->nodes + off;
+  if (node->node_handle == node_handle)
+    return;
 
-  if (id == ih->data->node_count-1)
-    ih->data->node_cache[id].node_handle = node_handle;
-  else
+  if (node->node_handle)
+    iTreeHashRelease(cache, block, node->node_handle, off, off+1);
+
+  node->node_handle = node_handle;
+
+  if (node_handle)
+    iTreeHashSet(cache, node_handle, block);
+}
+
+int iupTreeForEach(Ihandle* ih, iupTreeNodeFunc func, void* userdata)
+{
+  ItreeNodeCache* cache = ih->data->node_cache;
+  int b, i, id = 0;
+
+  for (b = 0; b < cache->block_count; b++)
   {
-    /* open space for the new id */
-    int remain_count = ih->data->node_count-id;
-    memmove(ih->data->node_cache+id+1, ih->data->node_cache+id, remain_count*sizeof(InodeData));
-    ih->data->node_cache[id].node_handle = node_handle;
+    ItreeBlock* block = cache->blocks[b];
+    for (i = 0; i < block->count; i++, id++)
+    {
+      if (id >= ih->data->node_count)
+        return 1;
+
+      if (!func(ih, block->nodes[i].node_handle, id, userdata))
+        return 0;
+    }
   }
 
-  ih->data->node_cache[id].userdata = NULL;
+  return 1;
 }
 
-static void iTreeIncCacheMem(Ihandle* ih)
+int iupTreeFindNodeId(Ihandle* ih, InodeHandle* node_handle)
 {
-  /* node_count here already contains the final count */
+  ItreeNodeCache* cache = ih->data->node_cache;
+  ItreeBlock* block;
+  int pos, i, b;
+
+  if (!node_handle || !cache->hash)
+    return -1;
+
+  pos = iTreeHashFind(cache, node_handle);
+  if (pos == -1)
+    return -1;
+
+  block = cache->hash[pos].block;
+  for (i = 0; i < block->count; i++)
+  {
+    if (block->nodes[i].node_handle == node_handle)
+      return iTreeCacheFirstId(cache, block->index) + i;
+  }
 
-  if (ih->data->node_count+10 > ih->data->node_cache_max)
+  /* hash entry left by a handle that was duplicated during a rebuild, 
+     search all the blocks and fix it */
+  for (b = 0; b < cache->block_count; b++)
   {
-    int old_node_cache_max = ih->data->node_cache_max;
-    ih->data->node_cache_max += 20;
-    ih->data->node_cache = realloc(ih->data->node_cache, ih->data->node_cache_max*sizeof(InodeData));
-    memset(ih->data->node_cache+old_node_cache_max, 0, 20*sizeof(InodeData));
+    block = cache->blocks[b];
+    for (i = 0; i < block->count; i++)
+    {
+      if (block->nodes[i].node_handle == node_handle)
+      {
+        cache->hash[pos].block = block;
+        return iTreeCacheFirstId(cache, b) + i;
+      }
+    }
   }
+
+  iTreeHashRemove(cache, node_handle);
+  return -1;
+}
+
+static int iTreeFindUserDataId(Ihandle* ih, void* userdata)
+{
+  ItreeNodeCache* cache = ih->data->node_cache;
+  int b, i, id = 0;
+
+  for (b = 0; b < cache->block_count; b++)
+  {
+    ItreeBlock* block = cache->blocks[b];
+    for (i = 0; i < block->count; i++, id++)
+    {
+      if (block->nodes[i].userdata == userdata)
+        return id;
+    }
+  }
+
+  return -1;
+}
+
+InodeHandle* iupTreeGetNode(Ihandle* ih, int id)
+{
+  if (id >= 0 && id < ih->data->node_count)
+    return iupTreeGetNodeData(ih, id)->node_handle;
+  else if (id == IUP_INVALID_ID && ih->data->node_count!=0)
+    return iupdrvTreeGetFocusNode(ih);
+  else
+    return NULL;
+}
+
+InodeHandle* iupTreeGetNodeFromString(Ihandle* ih, const char* name_id)
+{
+  int id = IUP_INVALID_ID;
+  iupStrToInt(name_id, &id);
+  return iupTreeGetNode(ih, id);
 }
 
 void iupTreeAddToCache(Ihandle* ih, int add, int kindPrev, InodeHandle* prevNode, InodeHandle* node_handle)
 {
+  InodeData node;
   int new_id = 0;
 
   ih->data->node_count++;
 
   /* node_count here already contains the final count */
-  iTreeIncCacheMem(ih);
 
   if (prevNode)
   {
@@ -349,13 +785,20 @@ void iupTreeAddToCache(Ihandle* ih, int add, int kindPrev, InodeHandle* prevNode
     }
   }
 
-  iTreeAddToCache(ih, new_id, node_handle);
+  iupASSERT(new_id >= 0 && new_id <= ih->data->node_cache->count);
+  if (new_id < 0 || new_id > ih->data->node_cache->count)
+    return;
+
+  node.node_handle = node_handle;
+  node.userdata = NULL;
+  iTreeCacheInsert(ih->data->node_cache, new_id, &node);
+
   iupAttribSetInt(ih, "LASTADDNODE", new_id);
 }
 
 void iupTreeDelFromCache(Ihandle* ih, int id, int count)
 {
-  int remain_count, last_add_node;
+  int last_add_node;
 
   /* id can be the last node, actually==node_count becase node_count is already updated */
   iupASSERT(id >= 0 && id <= ih->data->node_count);  
@@ -371,17 +814,16 @@ void iupTreeDelFromCache(Ihandle* ih, int id, int count)
 
   /* node_count here already contains the final count */
 
-  /* remove id+count */
-  remain_count = ih->data->node_count-id;
-  memmove(ih->data->node_cache+id, ih->data->node_cache+id+count, remain_count*sizeof(InodeData));
+  if (id+count > ih->data->node_cache->count)
+    count = ih->data->node_cache->count - id;
 
-  /* clear the remaining space */
-  memset(ih->data->node_cache+ih->data->node_count, 0, count*sizeof(InodeData));
+  iTreeCacheRemove(ih->data->node_cache, id, count);
 }
 
 void iupTreeCopyMoveCache(Ihandle* ih, int id_src, int id_dst, int count, int is_copy)
 {
-  int remain_count;
+  ItreeNodeCache* cache = ih->data->node_cache;
+  int i;
 
   iupASSERT(id_src >= 0 && id_src < ih->data->node_count);
   if (id_src < 0 || id_src >= ih->data->node_count)
@@ -397,39 +839,35 @@ void iupTreeCopyMoveCache(Ihandle* ih, int id_src, int id_dst, int count, int is
 
   /* id_dst here points to the final position for a copy operation */
 
-  /* node_count here contains the final count for a copy operation */
-  iTreeIncCacheMem(ih);
-
-  /* add space for new nodes */
-  remain_count = ih->data->node_count - (id_dst + count);
-  memmove(ih->data->node_cache+id_dst+count, ih->data->node_cache+id_dst, remain_count*sizeof(InodeData));
-
-  /* compensate because we add space for new nodes */
-  if (id_src > id_dst)
-    id_src += count;
-
   if (is_copy) 
   {
-    /* during a copy, the userdata is not reused, so clear it */
-    memset(ih->data->node_cache+id_dst, 0, count*sizeof(InodeData));
+    /* during a copy, the userdata is not reused, so clear it.
+       The new node handles are set later by the driver. */
+    for (i = 0; i < count; i++)
+      iTreeCacheInsert(cache, id_dst+i, &iTreeEmptyNode);
   }
   else /* move = copy + delete */
   {
-    /* copy userdata from src to dst */
-    memcpy(ih->data->node_cache+id_dst, ih->data->node_cache+id_src, count*sizeof(InodeData));
+    /* keep the userdata, the node handles are updated later by the driver */
+    InodeData* nodes = (InodeData*)malloc(count*sizeof(InodeData));
+    for (i = 0; i < count; i++)
+      nodes[i] = *iupTreeGetNodeData(ih, id_src+i);
+
+    iTreeCacheRemove(cache, id_src, count);
+
+    /* compensate because we removed the nodes */
+    if (id_dst > id_src)
+      id_dst -= count;
 
-    /* remove the src */
-    remain_count = ih->data->node_count - (id_src + count);
-    memmove(ih->data->node_cache+id_src, ih->data->node_cache+id_src+count, remain_count*sizeof(InodeData));
+    for (i = 0; i < count; i++)
+      iTreeCacheInsert(cache, id_dst+i, nodes+i);
 
-    /* clear the remaining space */
-    memset(ih->data->node_cache+ih->data->node_count-count, 0, count*sizeof(InodeData));
+    free(nodes);
   }
 
   iupAttribSetStr(ih, "LASTADDNODE", NULL);
 }
 
-
 /*************************************************************************/
 
 
@@ -616,13 +1054,13 @@ static char* iTreeGetTotalChildCountAttrib(Ihandle* ih, int id)
 static char* iTreeGetUserDataAttrib(Ihandle* ih, int id)
 {
   if (id >= 0 && id < ih->data->node_count)
-    return ih->data->node_cache[id].userdata;
+    return iupTreeGetNodeData(ih, id)->userdata;
   else if (id == IUP_INVALID_ID && ih->data->node_count!=0)
   {
     InodeHandle* node_handle = iupdrvTreeGetFocusNode(ih);
     id = iupTreeFindNodeId(ih, node_handle);
     if (id >= 0 && id < ih->data->node_count)
-      return ih->data->node_cache[id].userdata;
+      return iupTreeGetNodeData(ih, id)->userdata;
   }
   return NULL;
 }
@@ -630,13 +1068,13 @@ static char* iTreeGetUserDataAttrib(Ihandle* ih, int id)
 static int iTreeSetUserDataAttrib(Ihandle* ih, int id, const char* value)
 {
   if (id >= 0 && id < ih->data->node_count)
-    ih->data->node_cache[id].userdata = (void*)value;
+    iupTreeGetNodeData(ih, id)->userdata = (void*)value;
   else if (id == IUP_INVALID_ID && ih->data->node_count!=0)
   {
     InodeHandle* node_handle = iupdrvTreeGetFocusNode(ih);
     id = iupTreeFindNodeId(ih, node_handle);
     if (id >= 0 && id < ih->data->node_count)
-      ih->data->node_cache[id].userdata = (void*)value;
+      iupTreeGetNodeData(ih, id)->userdata = (void*)value;
   }
   return 0;
 }
@@ -654,8 +1092,7 @@ static int iTreeCreateMethod(Ihandle* ih, void **params)
   IupSetAttribute(ih, "EXPAND", "YES");
 
   ih->data->add_expanded = 1;
-  ih->data->node_cache_max = 20;
-  ih->data->node_cache = calloc(ih->data->node_cache_max, sizeof(InodeData));
+  ih->data->node_cache = iTreeCacheCreate();
 
   return IUP_NOERROR;
 }
@@ -663,7 +1100,7 @@ static int iTreeCreateMethod(Ihandle* ih, void **params)
 static void iTreeDestroyMethod(Ihandle* ih)
 {
   if (ih->data->node_cache)
-    free(ih->data->node_cache);
+    iTreeCacheDestroy(ih->data->node_cache);
 }
 
 /*************************************************************************/
@@ -697,6 +1134,7 @@ Iclass* iupTreeNewClass(void)
   iupClassRegisterCallback(ic, "MULTIUNSELECTION_CB", "Ii");
   iupClassRegisterCallback(ic, "BRANCHOPEN_CB",     "i");
   iupClassRegisterCallback(ic, "BRANCHCLOSE_CB",    "i");
+  iupClassRegisterCallback(ic, "BRANCHPOPULATE_CB", "i");
   iupClassRegisterCallback(ic, "EXECUTELEAF_CB",    "i");
   iupClassRegisterCallback(ic, "SHOWRENAME_CB",     "i");
   iupClassRegisterCallback(ic, "RENAME_CB",         "is");
@@ -805,7 +1243,7 @@ int IupTreeSetUserId(Ihandle* ih, int id, void* userdata)
 
   if (id >= 0 && id < ih->data->node_count)
   {
-    ih->data->node_cache[id].userdata = userdata;
+    iupTreeGetNodeData(ih, id)->userdata = userdata;
     return 1;
   }
 
@@ -828,7 +1266,48 @@ void* IupTreeGetUserId(Ihandle* ih, int id)
     return NULL;
 
   if (id >= 0 && id < ih->data->node_count)
-    return ih->data->node_cache[id].userdata;
+    return iupTreeGetNodeData(ih, id)->userdata;
 
   return NULL;
 }
+
+int IupTreeAddNodeList(Ihandle* ih, const char* kind, int id, const char** titles, int count)
+{
+  int i, first_id, k;
+  char* last_add_node;
+
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return -1;
+
+  if (!ih->handle || !titles || count <= 0)  /* do not do the action before map */
+    return -1;
+
+  if (iupStrEqualNoCase(kind, "BRANCH"))
+    k = ITREE_BRANCH;
+  else if (iupStrEqualNoCase(kind, "LEAF"))
+    k = ITREE_LEAF;
+  else
+    return -1;
+
+  /* the first node is added like ADDLEAF/ADDBRANCH, 
+     the others are inserted after the previous one, 
+     so the ids are consecutive and the cache is updated in O(log n) for each node */
+  iupAttribSetStr(ih, "LASTADDNODE", NULL);
+  iupdrvTreeAddNode(ih, id, k, titles[0], 1);
+
+  last_add_node = iupAttribGet(ih, "LASTADDNODE");
+  if (!last_add_node)
+    return -1;
+
+  iupStrToInt(last_add_node, &first_id);
+  id = first_id;
+
+  for (i = 1; i < count; i++)
+  {
+    iupdrvTreeAddNode(ih, id, k, titles[i], 0);
+    id++;
+  }
+
+  return first_id;
+}
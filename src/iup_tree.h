@@ -45,12 +45,20 @@ typedef struct _InodeData
   void* userdata;
 } InodeData;
 
+typedef struct _ItreeNodeCache ItreeNodeCache;  /* defined in iup_tree.c */
+
 typedef int (*iupTreeNodeFunc)(Ihandle* ih, InodeHandle* node_handle, int id, void* userdata);
 int iupTreeForEach(Ihandle* ih, iupTreeNodeFunc func, void* userdata);
 InodeHandle* iupTreeGetNode(Ihandle* ih, int id);
 InodeHandle* iupTreeGetNodeFromString(Ihandle* ih, const char* name_id);
 int iupTreeFindNodeId(Ihandle* ih, InodeHandle* node_handle);
 
+/* Access to the node cache by id in O(log n).
+   iupTreeGetNodeData returns an empty node if id is invalid.
+   iupTreeSetNode must be used to change the handle of a node. */
+InodeData* iupTreeGetNodeData(Ihandle* ih, int id);
+void iupTreeSetNode(Ihandle* ih, int id, InodeHandle* node_handle);
+
 InodeHandle* iupdrvTreeGetFocusNode(Ihandle* ih);
 int iupdrvTreeTotalChildCount(Ihandle* ih, InodeHandle* node_handle);
 void iupTreeSelectLastCollapsedBranch(Ihandle* ih, int *last_id);
@@ -78,8 +86,8 @@ struct _IcontrolData
   void* def_image_collapsed_mask;  
   void* def_image_expanded_mask;  
 
-  InodeData *node_cache;
-  int node_cache_max, node_count;
+  ItreeNodeCache *node_cache;
+  int node_count;
 };
 
 
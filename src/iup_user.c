@@ -17,6 +17,8 @@ static int iUserSetClearAttributesAttrib(Ihandle* ih, const char* value)
 {
   (void)value;
   iupTableClear(ih->attrib);
+  if (ih->attrib_id)
+    iupTableClear(ih->attrib_id);
   return 0;
 }
 
@@ -20,12 +20,13 @@
 #include "iup_object.h"
 #include "iup_image.h"
 #include "iup_draw.h"
+#include "iup_drvdraw.h"
 
 #include "iupmot_drv.h"
 #include "iupmot_color.h"
 
 
-struct _IdrawCanvas{
+struct _IdrvCanvas{
   Ihandle* ih;
   int w, h;
 
@@ -45,9 +46,9 @@ static void motDrawGetGeometry(Display *dpy, Drawable wnd, int *_w, int *_h, int
   *_d = d;
 }
 
-IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih)
+IdrvCanvas* iupdrvDrawCreateCanvas(Ihandle* ih)
 {
-  IdrawCanvas* dc = calloc(1, sizeof(IdrawCanvas));
+  IdrvCanvas* dc = calloc(1, sizeof(IdrvCanvas));
   int depth;
 
   dc->ih = ih;
@@ -62,7 +63,7 @@ IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih)
   return dc;
 }
 
-void iupDrawKillCanvas(IdrawCanvas* dc)
+void iupdrvDrawKillCanvas(IdrvCanvas* dc)
 {
   XFreeGC(iupmot_display, dc->pixmap_gc);
   XFreePixmap(iupmot_display, dc->pixmap);
@@ -71,7 +72,7 @@ void iupDrawKillCanvas(IdrawCanvas* dc)
   free(dc);
 }
 
-void iupDrawUpdateSize(IdrawCanvas* dc)
+void iupdrvDrawUpdateSize(IdrvCanvas* dc)
 {
   int w, h, depth;
 
@@ -90,26 +91,26 @@ void iupDrawUpdateSize(IdrawCanvas* dc)
   }
 }
 
-void iupDrawFlush(IdrawCanvas* dc)
+void iupdrvDrawFlush(IdrvCanvas* dc)
 {
   XCopyArea(iupmot_display, dc->pixmap, dc->wnd, dc->gc, 0, 0, dc->w, dc->h, 0, 0);
 }
 
-void iupDrawGetSize(IdrawCanvas* dc, int *w, int *h)
+void iupdrvDrawGetSize(IdrvCanvas* dc, int *w, int *h)
 {
   if (w) *w = dc->w;
   if (h) *h = dc->h;
 }
 
-void iupDrawParentBackground(IdrawCanvas* dc)
+void iupdrvDrawParentBackground(IdrvCanvas* dc)
 {
   unsigned char r=0, g=0, b=0;
   char* color = iupBaseNativeParentGetBgColorAttrib(dc->ih);
   iupStrToRGB(color, &r, &g, &b);
-  iupDrawRectangle(dc, 0, 0, dc->w-1, dc->h-1, r, g, b, IUP_DRAW_FILL);
+  iupdrvDrawRectangle(dc, 0, 0, dc->w-1, dc->h-1, r, g, b, IUP_DRAW_FILL);
 }
 
-void iupDrawRectangle(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawRectangle(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   XSetForeground(iupmot_display, dc->pixmap_gc, iupmotColorGetPixel(r, g, b));
 
@@ -128,7 +129,7 @@ void iupDrawRectangle(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned
   }
 }
 
-void iupDrawLine(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawLine(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   XGCValues gcval;
   if (style==IUP_DRAW_STROKE_DASH)
@@ -142,7 +143,7 @@ void iupDrawLine(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char
   XDrawLine(iupmot_display, dc->pixmap, dc->pixmap_gc, x1, y1, x2, y2);
 }
 
-void iupDrawArc(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawArc(IdrvCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   XSetForeground(iupmot_display, dc->pixmap_gc, iupmotColorGetPixel(r, g, b));
 
@@ -164,7 +165,7 @@ void iupDrawArc(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, doub
   }
 }
 
-void iupDrawPolygon(IdrawCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawPolygon(IdrvCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   int i;
   XPoint* pnt = (XPoint*)malloc(count*sizeof(XPoint)); /* XPoint uses short for coordinates */
@@ -194,7 +195,7 @@ void iupDrawPolygon(IdrawCanvas* dc, int* points, int count, unsigned char r, un
   free(pnt);
 }
 
-void iupDrawSetClipRect(IdrawCanvas* dc, int x1, int y1, int x2, int y2)
+void iupdrvDrawSetClipRect(IdrvCanvas* dc, int x1, int y1, int x2, int y2)
 {
   XRectangle rect;
   rect.x      = (short)x1;
@@ -204,12 +205,12 @@ void iupDrawSetClipRect(IdrawCanvas* dc, int x1, int y1, int x2, int y2)
   XSetClipRectangles(iupmot_display, dc->pixmap_gc, 0, 0, &rect, 1, Unsorted);
 }
 
-void iupDrawResetClip(IdrawCanvas* dc)
+void iupdrvDrawResetClip(IdrvCanvas* dc)
 {
   XSetClipMask(iupmot_display, dc->pixmap_gc, None);
 }
 
-void iupDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font)
+void iupdrvDrawText(IdrvCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font)
 {
   XFontStruct* xfont = (XFontStruct*)iupmotGetFontStruct(font);
   XSetForeground(iupmot_display, dc->pixmap_gc, iupmotColorGetPixel(r, g, b));
@@ -217,7 +218,7 @@ void iupDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, unsig
   XDrawString(iupmot_display, dc->pixmap, dc->pixmap_gc, x, y+xfont->ascent, text, len);
 }
 
-void iupDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
+void iupdrvDrawImage(IdrvCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
 {
   int bpp;
   Pixmap pixmap = (Pixmap)iupImageGetImage(name, dc->ih, make_inactive);
@@ -230,7 +231,7 @@ void iupDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, i
   XCopyArea(iupmot_display, pixmap, dc->pixmap, dc->pixmap_gc, 0, 0, *img_w, *img_h, x, y);
 }
 
-void iupDrawSelectRect(IdrawCanvas* dc, int x, int y, int w, int h)
+void iupdrvDrawSelectRect(IdrvCanvas* dc, int x, int y, int w, int h)
 {
   XSetFunction(iupmot_display, dc->pixmap_gc, GXxor);
   XSetForeground(iupmot_display, dc->pixmap_gc, iupmotColorGetPixel(255, 255, 255));
@@ -241,7 +242,7 @@ void iupDrawSelectRect(IdrawCanvas* dc, int x, int y, int w, int h)
 #include <Xm/XmP.h>
 #include <Xm/DrawP.h>
 
-void iupDrawFocusRect(IdrawCanvas* dc, int x, int y, int w, int h)
+void iupdrvDrawCanvasFocusRect(IdrvCanvas* dc, int x, int y, int w, int h)
 {
   XmeDrawHighlight(iupmot_display, dc->wnd, dc->gc, x, y, w, h, 1);
 }
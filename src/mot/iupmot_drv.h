@@ -49,6 +49,10 @@ void iupmotTipEnterNotify(Ihandle* ih);
 void iupmotTipLeaveNotify(void);
 void iupmotTipsFinish(void);
 
+/* loop */
+void iupmotLoopInit(void);
+void iupmotLoopFinish(void);
+
 /* common */
 void iupmotPointerMotionEvent(Widget w, Ihandle *ih, XEvent *evt, Boolean *cont);
 void iupmotDummyPointerMotionEvent(Widget w, XtPointer *data, XEvent *evt, Boolean *cont);
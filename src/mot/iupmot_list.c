@@ -208,6 +208,13 @@ void iupdrvListRemoveAllItems(Ihandle* ih)
     XmListDeleteAllItems(ih->handle);
 }
 
+void iupdrvListSetVirtualCount(Ihandle* ih, int count)
+{
+  /* virtual mode is not supported in this driver */
+  (void)ih;
+  (void)count;
+}
+
 
 /*********************************************************************************/
 
@@ -1433,6 +1440,8 @@ static int motListMapMethod(Ihandle* ih)
   Widget parent = iupChildTreeGetNativeParentHandle(ih);
   char* child_id = iupDialogGetChildIdStr(ih);
 
+  ih->data->is_virtual = 0;  /* virtual mode is not supported in this driver */
+
   if (ih->data->is_dropdown || ih->data->has_editbox)
   {
     /* could not set XmNmappedWhenManaged to False because the list and the edit box where not displayed */
@@ -5,12 +5,18 @@
  */
 
 #include <stdio.h>    
+#include <unistd.h>
+#include <fcntl.h>
 
 #include <Xm/Xm.h>
 
 #include "iup.h"
 #include "iupcbs.h"
 
+#include "iup_str.h"
+#include "iup_drv.h"
+#include "iup_loop.h"
+
 #include "iupmot_drv.h"
 
 
@@ -19,6 +25,8 @@ static int mot_mainloop = 0;
 static int mot_exitmainloop = 0;
 static IFidle mot_idle_cb = NULL;
 static XtWorkProcId mot_idle_id;
+static int mot_post_pipe[2] = {-1, -1};  /* used by IupPostMessage to wake up the loop */
+static XtInputId mot_post_id;
 
 
 static Boolean motIdlecbWorkProc(XtPointer client_data)
@@ -56,9 +64,59 @@ void iupdrvSetIdleFunction(Icallback f)
     mot_idle_id = XtAppAddWorkProc(iupmot_appcontext, motIdlecbWorkProc, NULL);
 }
 
+static void motLoopPostMessageInput(XtPointer client_data, int* source, XtInputId* id)
+{
+  char buffer[64];
+  (void)client_data;
+  (void)id;
+
+  /* empty the pipe, all the posted messages will be processed at once */
+  while (read(*source, buffer, sizeof(buffer)) > 0);
+
+  iupLoopProcessPostMessages();
+}
+
+void iupmotLoopInit(void)
+{
+  if (pipe(mot_post_pipe) != 0)
+  {
+    mot_post_pipe[0] = mot_post_pipe[1] = -1;
+    return;
+  }
+
+  fcntl(mot_post_pipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(mot_post_pipe[1], F_SETFL, O_NONBLOCK);
+
+  mot_post_id = XtAppAddInput(iupmot_appcontext, mot_post_pipe[0], (XtPointer)XtInputReadMask, motLoopPostMessageInput, NULL);
+}
+
+void iupmotLoopFinish(void)
+{
+  if (mot_post_pipe[0] != -1)
+  {
+    XtRemoveInput(mot_post_id);
+    close(mot_post_pipe[0]);
+    close(mot_post_pipe[1]);
+    mot_post_pipe[0] = mot_post_pipe[1] = -1;
+  }
+}
+
+void iupdrvLoopWakeUp(void)
+{
+  /* write is thread safe, and it will wake up the select inside the Xt loop */
+  if (mot_post_pipe[1] != -1)
+  {
+    char c = 0;
+    if (write(mot_post_pipe[1], &c, 1) < 0) 
+      return;  /* pipe is full, the loop will be waked up anyway */
+  }
+}
+
 static int motLoopProcessEvent(void)
 {
+  int mark = iupStrMemoryMark();
   XtAppProcessEvent(iupmot_appcontext, XtIMAll);
+  iupStrMemoryRelease(mark);  /* release the strings returned during the dispatch */
   return (mot_exitmainloop)? IUP_CLOSE : IUP_DEFAULT;
 }
 
@@ -110,6 +110,7 @@ int iupdrvOpen(int *argc, char ***argv)
   }
 
   iupmotColorInit();
+  iupmotLoopInit();
 
   /* dialog background color */
   {
@@ -135,6 +136,7 @@ void iupdrvClose(void)
 { 
   iupmotColorFinish();
   iupmotTipsFinish();
+  iupmotLoopFinish();
 
   if (iupmot_appshell)
     XtDestroyWidget(iupmot_appshell);
@@ -159,7 +159,7 @@ static void motTreeChildRebuildCacheRec(Ihandle* ih, Widget wItem, int *id)
   for (i = 0; i < numChild; i++)
   {
     (*id)++;
-    ih->data->node_cache[*id].node_handle = itemChildList[i];
+    iupTreeSetNode(ih, *id, itemChildList[i]);
 
     /* go recursive to children */
     motTreeChildRebuildCacheRec(ih, itemChildList[i], id);
@@ -170,7 +170,7 @@ static void motTreeChildRebuildCacheRec(Ihandle* ih, Widget wItem, int *id)
 
 static void motTreeRebuildNodeCache(Ihandle* ih, int id, Widget wItem)
 {
-  ih->data->node_cache[id].node_handle = wItem;
+  iupTreeSetNode(ih, id, wItem);
   motTreeChildRebuildCacheRec(ih, wItem, &id);
 }
 
@@ -326,11 +326,11 @@ static Widget motTreeGetLastVisibleNode(Ihandle* ih)
 
   for (i = ih->data->node_count-1; i >= 0; i--)
   {
-    if (motTreeIsNodeVisible(ih->data->node_cache[i].node_handle, &wLastItemParent))
-      return ih->data->node_cache[i].node_handle;
+    if (motTreeIsNodeVisible(iupTreeGetNodeData(ih, i)->node_handle, &wLastItemParent))
+      return iupTreeGetNodeData(ih, i)->node_handle;
   }
 
-  return ih->data->node_cache[0].node_handle;  /* root is always visible */
+  return iupTreeGetNodeData(ih, 0)->node_handle;  /* root is always visible */
 }
 
 static Widget motTreeGetNextVisibleNode(Ihandle* ih, Widget wItem, int count)
@@ -343,11 +343,11 @@ static Widget motTreeGetNextVisibleNode(Ihandle* ih, Widget wItem, int count)
 
   for (i = id; i < ih->data->node_count; i++)
   {
-    if (motTreeIsNodeVisible(ih->data->node_cache[i].node_handle, &wLastItemParent))
-      return ih->data->node_cache[i].node_handle;
+    if (motTreeIsNodeVisible(iupTreeGetNodeData(ih, i)->node_handle, &wLastItemParent))
+      return iupTreeGetNodeData(ih, i)->node_handle;
   }
 
-  return ih->data->node_cache[0].node_handle; /* root is always visible */
+  return iupTreeGetNodeData(ih, 0)->node_handle; /* root is always visible */
 }
 
 static Widget motTreeGetPreviousVisibleNode(Ihandle* ih, Widget wItem, int count)
@@ -360,8 +360,8 @@ static Widget motTreeGetPreviousVisibleNode(Ihandle* ih, Widget wItem, int count
 
   for (i = id; i >= 0; i--)
   {
-    if (motTreeIsNodeVisible(ih->data->node_cache[i].node_handle, &wLastItemParent))
-      return ih->data->node_cache[i].node_handle;
+    if (motTreeIsNodeVisible(iupTreeGetNodeData(ih, i)->node_handle, &wLastItemParent))
+      return iupTreeGetNodeData(ih, i)->node_handle;
   }
 
   return motTreeGetLastVisibleNode(ih);
@@ -398,7 +398,7 @@ static void motTreeUpdateBgColor(Ihandle* ih, Pixel bgcolor)
   int i;
   for (i = 0; i < ih->data->node_count; i++)
   {
-    XtVaSetValues(ih->data->node_cache[i].node_handle, XmNbackground, bgcolor, NULL);
+    XtVaSetValues(iupTreeGetNodeData(ih, i)->node_handle, XmNbackground, bgcolor, NULL);
   }
 }
 
@@ -409,7 +409,7 @@ static void motTreeUpdateImages(Ihandle* ih, int mode)
   for (i = 0; i < ih->data->node_count; i++)
   {
     motTreeItemData *itemData;
-    Widget wItem = ih->data->node_cache[i].node_handle;
+    Widget wItem = iupTreeGetNodeData(ih, i)->node_handle;
 
     XtVaGetValues(wItem, XmNuserData, &itemData, NULL);
 
@@ -530,10 +530,10 @@ static void motTreeSelectRange(Ihandle* ih, Widget wItem1, Widget wItem2, int cl
     if (i < id1 || i > id2)
     {
       if (clear)
-        XtVaSetValues(ih->data->node_cache[i].node_handle, XmNvisualEmphasis, XmNOT_SELECTED, NULL);
+        XtVaSetValues(iupTreeGetNodeData(ih, i)->node_handle, XmNvisualEmphasis, XmNOT_SELECTED, NULL);
     }
     else
-      XtVaSetValues(ih->data->node_cache[i].node_handle, XmNvisualEmphasis, XmSELECTED, NULL);
+      XtVaSetValues(iupTreeGetNodeData(ih, i)->node_handle, XmNvisualEmphasis, XmSELECTED, NULL);
   }
 }
 
@@ -544,7 +544,7 @@ void motTreeExpandCollapseAllNodes(Ihandle* ih, unsigned char itemState)
   for (i = 0; i < ih->data->node_count; i++)
   {
     motTreeItemData *itemData;
-    Widget wItem = ih->data->node_cache[i].node_handle;
+    Widget wItem = iupTreeGetNodeData(ih, i)->node_handle;
 
     XtVaGetValues(wItem, XmNuserData, &itemData, NULL);
   
@@ -561,7 +561,7 @@ static void motTreeDestroyItemData(Ihandle* ih, Widget wItem, int del_data, IFns
   if (itemData)
   {
     if (cb) 
-      cb(ih, (char*)ih->data->node_cache[id].userdata);
+      cb(ih, (char*)iupTreeGetNodeData(ih, id)->userdata);
 
     if (del_data)
     {
@@ -1256,7 +1256,7 @@ static char* motTreeGetMarkedNodesAttrib(Ihandle* ih)
 
   for (i=0; i<ih->data->node_count; i++)
   {
-    if (motTreeIsNodeSelected(ih->data->node_cache[i].node_handle))
+    if (motTreeIsNodeSelected(iupTreeGetNodeData(ih, i)->node_handle))
       str[i] = '+';
     else
       str[i] = '-';
@@ -1280,9 +1280,9 @@ static int motTreeSetMarkedNodesAttrib(Ihandle* ih, const char* value)
   for (i=0; i<count; i++)
   {
     if (value[i] == '+')
-      XtVaSetValues(ih->data->node_cache[i].node_handle, XmNvisualEmphasis, XmSELECTED, NULL);
+      XtVaSetValues(iupTreeGetNodeData(ih, i)->node_handle, XmNvisualEmphasis, XmSELECTED, NULL);
     else
-      XtVaSetValues(ih->data->node_cache[i].node_handle, XmNvisualEmphasis, XmNOT_SELECTED, NULL);
+      XtVaSetValues(iupTreeGetNodeData(ih, i)->node_handle, XmNvisualEmphasis, XmNOT_SELECTED, NULL);
   }
 
   return 0;
@@ -1575,7 +1575,7 @@ static void motTreeRemoveAllNodes(Ihandle* ih, int call_cb)
 
   for (i = 0; i < ih->data->node_count; i++)
   {
-    wItem = ih->data->node_cache[i].node_handle;
+    wItem = iupTreeGetNodeData(ih, i)->node_handle;
 
     motTreeDestroyItemData(ih, wItem, 1, cb, i);
 
@@ -1626,8 +1626,8 @@ static int motTreeSetDelNodeAttrib(Ihandle* ih, int id, const char* value)
     int i;
     for(i = 0; i < ih->data->node_count; /* increment only if not removed */)
     {
-      if (motTreeIsNodeSelected(ih->data->node_cache[i].node_handle))
-        motTreeRemoveNode(ih, ih->data->node_cache[i].node_handle, 1, 1);
+      if (motTreeIsNodeSelected(iupTreeGetNodeData(ih, i)->node_handle))
+        motTreeRemoveNode(ih, iupTreeGetNodeData(ih, i)->node_handle, 1, 1);
       else
         i++;
     }
@@ -1853,8 +1853,8 @@ static void motTreeFindRange(Ihandle* ih, WidgetList wSelectedItemList, int coun
      so make sure that they are selected. */
   for(i = *id1; i <= *id2; i++)
   {
-    if (!motTreeIsNodeSelected(ih->data->node_cache[i].node_handle))
-      XtVaSetValues(ih->data->node_cache[i].node_handle, XmNvisualEmphasis, XmSELECTED, NULL);
+    if (!motTreeIsNodeSelected(iupTreeGetNodeData(ih, i)->node_handle))
+      XtVaSetValues(iupTreeGetNodeData(ih, i)->node_handle, XmNvisualEmphasis, XmSELECTED, NULL);
   }
 
   /* if last selected item is a branch, then select its children */
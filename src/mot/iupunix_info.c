@@ -9,6 +9,8 @@
 #include <string.h> 
 #include <limits.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 
 /* This module should depend only on IUP core headers 
    and UNIX system headers. NO Motif headers allowed. */
@@ -91,6 +93,34 @@ int iupdrvSetCurrentDirectory(const char* dir)
   return chdir(dir) == 0? 1: 0;
 }
 
+void* iupdrvMapFile(const char* filename, int *size)
+{
+  struct stat status;
+  void* data;
+  int fd = open(filename, O_RDONLY);
+  if (fd == -1)
+    return NULL;
+
+  if (fstat(fd, &status) != 0 || status.st_size == 0 || status.st_size > INT_MAX)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  /* the mapping remains valid */
+  if (data == MAP_FAILED)
+    return NULL;
+
+  *size = (int)status.st_size;
+  return data;
+}
+
+void iupdrvUnmapFile(void* data, int size)
+{
+  munmap(data, (size_t)size);
+}
+
 static int xGetWorkAreaSize(Display* display, int screen, int *width, int *height)
 {
   /* _NET_WORKAREA, x, y, width, height CARDINAL[][4]/32 */
@@ -22,6 +22,7 @@
 #include "iup_object.h"
 #include "iup_image.h"
 #include "iup_draw.h"
+#include "iup_drvdraw.h"
 
 #include "iupwin_drv.h"
 #include "iupwin_info.h"
@@ -362,7 +363,7 @@ void iupwinDrawDestroyBitmapDC(iupwinBitmapDC *bmpDC)
                              Simple Draw
 *******************************************************************************/
 
-struct _IdrawCanvas{
+struct _IdrvCanvas{
   Ihandle* ih;
   int w, h;
 
@@ -371,9 +372,9 @@ struct _IdrawCanvas{
   HDC hBitmapDC, hDC;
 };
 
-IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih)
+IdrvCanvas* iupdrvDrawCreateCanvas(Ihandle* ih)
 {
-  IdrawCanvas* dc = calloc(1, sizeof(IdrawCanvas));
+  IdrvCanvas* dc = calloc(1, sizeof(IdrvCanvas));
   RECT rect;
 
   dc->ih = ih;
@@ -400,7 +401,7 @@ IdrawCanvas* iupDrawCreateCanvas(Ihandle* ih)
   return dc;
 }
 
-void iupDrawKillCanvas(IdrawCanvas* dc)
+void iupdrvDrawKillCanvas(IdrvCanvas* dc)
 {
   SelectObject(dc->hBitmapDC, dc->hOldBitmap);
   DeleteObject(dc->hBitmap);
@@ -411,7 +412,7 @@ void iupDrawKillCanvas(IdrawCanvas* dc)
   free(dc);
 }
 
-void iupDrawUpdateSize(IdrawCanvas* dc)
+void iupdrvDrawUpdateSize(IdrvCanvas* dc)
 {
   int w, h;
   RECT rect;
@@ -438,26 +439,26 @@ void iupDrawUpdateSize(IdrawCanvas* dc)
   }
 }
 
-void iupDrawFlush(IdrawCanvas* dc)
+void iupdrvDrawFlush(IdrvCanvas* dc)
 {
   BitBlt(dc->hDC, 0, 0, dc->w, dc->h, dc->hBitmapDC, 0, 0, SRCCOPY);
 }
 
-void iupDrawGetSize(IdrawCanvas* dc, int *w, int *h)
+void iupdrvDrawGetSize(IdrvCanvas* dc, int *w, int *h)
 {
   if (w) *w = dc->w;
   if (h) *h = dc->h;
 }
 
-void iupDrawParentBackground(IdrawCanvas* dc)
+void iupdrvDrawParentBackground(IdrvCanvas* dc)
 {
   unsigned char r=0, g=0, b=0;
   char* color = iupBaseNativeParentGetBgColorAttrib(dc->ih);
   iupStrToRGB(color, &r, &g, &b);
-  iupDrawRectangle(dc, 0, 0, dc->w-1, dc->h-1, r, g, b, IUP_DRAW_FILL);
+  iupdrvDrawRectangle(dc, 0, 0, dc->w-1, dc->h-1, r, g, b, IUP_DRAW_FILL);
 }
 
-void iupDrawRectangle(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawRectangle(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   SetDCBrushColor(dc->hBitmapDC, RGB(r,g,b));
 
@@ -494,7 +495,7 @@ void iupDrawRectangle(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned
   }
 }
 
-void iupDrawLine(IdrawCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawLine(IdrvCanvas* dc, int x1, int y1, int x2, int y2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   POINT line_poly[2];
   HPEN hPen = CreatePen(style==IUP_DRAW_STROKE_DASH? PS_DASH: PS_SOLID, 1, RGB(r, g, b));
@@ -524,7 +525,7 @@ static int winDrawCalcArc(int c1, int c2, double a, int start)
   return iupROUND(off);
 }
 
-void iupDrawArc(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawArc(IdrvCanvas* dc, int x1, int y1, int x2, int y2, double a1, double a2, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   int XStartArc = winDrawCalcArc(x1, x2, a1, 1);
   int XEndArc = winDrawCalcArc(x1, x2, a2, 0);
@@ -552,7 +553,7 @@ void iupDrawArc(IdrawCanvas* dc, int x1, int y1, int x2, int y2, double a1, doub
   }
 }
 
-void iupDrawPolygon(IdrawCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style)
+void iupdrvDrawPolygon(IdrvCanvas* dc, int* points, int count, unsigned char r, unsigned char g, unsigned char b, int style)
 {
   if (style==IUP_DRAW_FILL)
   {
@@ -575,19 +576,19 @@ void iupDrawPolygon(IdrawCanvas* dc, int* points, int count, unsigned char r, un
   }
 }
 
-void iupDrawSetClipRect(IdrawCanvas* dc, int x1, int y1, int x2, int y2)
+void iupdrvDrawSetClipRect(IdrvCanvas* dc, int x1, int y1, int x2, int y2)
 {
   HRGN clip_hrgn = CreateRectRgn(x1, y1, x2+1, y2+1);
   SelectClipRgn(dc->hBitmapDC, clip_hrgn);
   DeleteObject(clip_hrgn);
 }
 
-void iupDrawResetClip(IdrawCanvas* dc)
+void iupdrvDrawResetClip(IdrvCanvas* dc)
 {
   SelectClipRgn(dc->hBitmapDC, NULL);
 }
 
-void iupDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font)
+void iupdrvDrawText(IdrvCanvas* dc, const char* text, int len, int x, int y, unsigned char r, unsigned char g, unsigned char b, const char* font)
 {
   HFONT hOldFont, hFont = (HFONT)iupwinGetHFont(font);
   SetTextColor(dc->hBitmapDC, RGB(r, g, b));
@@ -598,7 +599,7 @@ void iupDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, unsig
   SelectObject(dc->hBitmapDC, hOldFont);
 }
 
-void iupDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
+void iupdrvDrawImage(IdrvCanvas* dc, const char* name, int make_inactive, int x, int y, int *img_w, int *img_h)
 {
   int bpp;
   HBITMAP hMask = NULL;
@@ -618,12 +619,12 @@ void iupDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, i
     DeleteObject(hMask);
 }
 
-void iupDrawSelectRect(IdrawCanvas* dc, int x, int y, int w, int h)
+void iupdrvDrawSelectRect(IdrvCanvas* dc, int x, int y, int w, int h)
 {
   BitBlt(dc->hBitmapDC, x, y, w, h, dc->hBitmapDC, x, y, DSTINVERT);
 }
 
-void iupDrawFocusRect(IdrawCanvas* dc, int x, int y, int w, int h)
+void iupdrvDrawCanvasFocusRect(IdrvCanvas* dc, int x, int y, int w, int h)
 {
   RECT rect;
 
@@ -33,6 +33,10 @@ void iupwinTipsGetDispInfo(LPARAM lp);
 void iupwinTipsUpdateInfo(Ihandle* ih, HWND tips_hwnd);
 void iupwinTipsDestroy(Ihandle* ih);
 
+/* loop */
+void iupwinLoopInit(void);
+void iupwinLoopFinish(void);
+
 /* touch */
 void iupwinTouchInit(void);
 void iupwinTouchRegisterAttrib(Iclass* ic);
@@ -329,6 +329,13 @@ void iupdrvListRemoveAllItems(Ihandle* ih)
     SendMessage(ih->handle, WIN_SETHORIZONTALEXTENT(ih), 0, 0);
 }
 
+void iupdrvListSetVirtualCount(Ihandle* ih, int count)
+{
+  /* virtual mode is not supported in this driver */
+  (void)ih;
+  (void)count;
+}
+
 static int winListGetCaretPos(HWND cbedit)
 {
   int pos = 0;
@@ -1777,6 +1784,8 @@ static int winListMapMethod(Ihandle* ih)
   if (!ih->parent)
     return IUP_ERROR;
 
+  ih->data->is_virtual = 0;  /* virtual mode is not supported in this driver */
+
   if (ih->data->is_dropdown || ih->data->has_editbox)
   {
     class_name = "COMBOBOX";
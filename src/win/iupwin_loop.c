@@ -16,6 +16,8 @@
 #include "iup_object.h"
 #include "iup_attrib.h"
 #include "iup_str.h"
+#include "iup_drv.h"
+#include "iup_loop.h"
 
 #include "iupwin_drv.h"
 #include "iupwin_handle.h"
@@ -23,6 +25,9 @@
 
 static IFidle win_idle_cb = NULL;
 static int win_main_loop = 0;
+static HWND win_post_hwnd = NULL;  /* message only window used by IupPostMessage */
+
+#define WM_IUPPOSTMESSAGE WM_APP+2   /* Custom IUP message */
 
 
 void iupdrvSetIdleFunction(Icallback f)
@@ -43,6 +48,47 @@ static int winLoopCallIdle(void)
   return ret;
 }
 
+static LRESULT CALLBACK winLoopPostWndProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
+{
+  if (msg == WM_IUPPOSTMESSAGE)
+  {
+    iupLoopProcessPostMessages();
+    return 0;
+  }
+
+  return DefWindowProc(hwnd, msg, wp, lp);
+}
+
+void iupwinLoopInit(void)
+{
+  /* the window belongs to the main thread, 
+     so messages sent to it are processed even inside modal loops */
+  WNDCLASS wndclass;
+  ZeroMemory(&wndclass, sizeof(WNDCLASS));
+  wndclass.hInstance = iupwin_hinstance;
+  wndclass.lpszClassName = "IupPostMessage";
+  wndclass.lpfnWndProc = (WNDPROC)winLoopPostWndProc;
+  RegisterClass(&wndclass);
+
+  win_post_hwnd = CreateWindow("IupPostMessage", NULL, 0, 0, 0, 0, 0, HWND_MESSAGE, NULL, iupwin_hinstance, NULL);
+}
+
+void iupwinLoopFinish(void)
+{
+  if (win_post_hwnd)
+  {
+    DestroyWindow(win_post_hwnd);
+    win_post_hwnd = NULL;
+  }
+}
+
+void iupdrvLoopWakeUp(void)
+{
+  /* PostMessage is thread safe */
+  if (win_post_hwnd)
+    PostMessage(win_post_hwnd, WM_IUPPOSTMESSAGE, 0, 0);
+}
+
 void IupExitLoop(void)
 {
   PostQuitMessage(0);
@@ -60,6 +106,14 @@ static int winLoopProcessMessage(MSG* msg)
   }
 }
 
+static int winLoopProcessMessageStep(MSG* msg)
+{
+  int mark = iupStrMemoryMark();
+  int ret = winLoopProcessMessage(msg);
+  iupStrMemoryRelease(mark);
+  return ret;
+}
+
 int IupMainLoopLevel(void)
 {
   return win_main_loop;
@@ -69,6 +123,7 @@ int IupMainLoop(void)
 {
   MSG msg;
   int ret;
+  int mark = iupStrMemoryMark();
 
   win_main_loop++;
 
@@ -109,6 +164,9 @@ int IupMainLoop(void)
         return IUP_NOERROR;
       }
     }
+
+    /* release the strings returned during the dispatch */
+    iupStrMemoryRelease(mark);
   } while (ret);
 
   win_main_loop--;
@@ -122,7 +180,7 @@ int IupLoopStepWait(void)
   if (ret == -1) /* error */
     return IUP_ERROR;
   if (ret == 0 || /* WM_QUIT */
-      winLoopProcessMessage(&msg) == IUP_CLOSE)  /* ret != 0 */
+      winLoopProcessMessageStep(&msg) == IUP_CLOSE)  /* ret != 0 */
     return IUP_CLOSE;
   return IUP_DEFAULT;
 }
@@ -131,7 +189,7 @@ int IupLoopStep(void)
 {
   MSG msg;
   if (PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
-    return winLoopProcessMessage(&msg);
+    return winLoopProcessMessageStep(&msg);
   else if (win_idle_cb)
     return winLoopCallIdle();
 
@@ -145,7 +203,7 @@ void IupFlush(void)
 
   while (PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
   {
-    if (winLoopProcessMessage(&msg) == IUP_CLOSE)
+    if (winLoopProcessMessageStep(&msg) == IUP_CLOSE)
     {
       post_quit = 1;
       break;
@@ -112,6 +112,7 @@ int iupdrvOpen(int *argc, char ***argv)
   iupwinHandleInit();
   iupwinBrushInit();
   iupwinDrawInit();
+  iupwinLoopInit();
 
   if (iupwinIs7OrNew())
     iupwinTouchInit();
@@ -131,6 +132,7 @@ void iupdrvClose(void)
 {
   iupwinHandleFinish();
   iupwinBrushFinish();
+  iupwinLoopFinish();
 
   if (IupGetGlobal("_IUPWIN_OLEINITIALIZE"))
 	  OleUninitialize();
@@ -140,7 +140,7 @@ static void winTreeChildRebuildCacheRec(Ihandle* ih, HTREEITEM hItem, int *id)
   while(hItem != NULL)
   {
     (*id)++;
-    ih->data->node_cache[*id].node_handle = hItem;
+    iupTreeSetNode(ih, *id, hItem);
 
     /* go recursive to children */
     winTreeChildRebuildCacheRec(ih, hItem, id);
@@ -152,7 +152,7 @@ static void winTreeChildRebuildCacheRec(Ihandle* ih, HTREEITEM hItem, int *id)
 
 static void winTreeRebuildNodeCache(Ihandle* ih, int id, HTREEITEM hItem)
 {
-  ih->data->node_cache[id].node_handle = hItem;
+  iupTreeSetNode(ih, id, hItem);
   winTreeChildRebuildCacheRec(ih, hItem, &id);
 }
 
@@ -398,10 +398,10 @@ static void winTreeSelectRange(Ihandle* ih, HTREEITEM hItem1, HTREEITEM hItem2,
     if (i < id1 || i > id2)
     {
       if (clear)
-        winTreeSelectNode(ih, ih->data->node_cache[i].node_handle, 0);
+        winTreeSelectNode(ih, iupTreeGetNodeData(ih, i)->node_handle, 0);
     }
     else
-      winTreeSelectNode(ih, ih->data->node_cache[i].node_handle, 1);
+      winTreeSelectNode(ih, iupTreeGetNodeData(ih, i)->node_handle, 1);
   }
 }
 
@@ -409,7 +409,7 @@ static void winTreeSelectAll(Ihandle* ih)
 {
   int i;
   for (i = 0; i < ih->data->node_count; i++)
-    winTreeSelectNode(ih, ih->data->node_cache[i].node_handle, 1);
+    winTreeSelectNode(ih, iupTreeGetNodeData(ih, i)->node_handle, 1);
 }
 
 static void winTreeClearAllSelectionExcept(Ihandle* ih, HTREEITEM hItemExcept)
@@ -417,8 +417,8 @@ static void winTreeClearAllSelectionExcept(Ihandle* ih, HTREEITEM hItemExcept)
   int i;
   for (i = 0; i < ih->data->node_count; i++)
   {
-    if (ih->data->node_cache[i].node_handle != hItemExcept)
-      winTreeSelectNode(ih, ih->data->node_cache[i].node_handle, 0);
+    if (iupTreeGetNodeData(ih, i)->node_handle != hItemExcept)
+      winTreeSelectNode(ih, iupTreeGetNodeData(ih, i)->node_handle, 0);
   }
 }
 
@@ -602,7 +602,7 @@ static void winTreeUpdateImages(Ihandle* ih, int mode)
   /* called when one of the default images is changed */
   for (i = 0; i < ih->data->node_count; i++)
   {
-    hItem = ih->data->node_cache[i].node_handle;
+    hItem = iupTreeGetNodeData(ih, i)->node_handle;
 
     /* Get node attributes */
     item.hItem = hItem;
@@ -1440,7 +1440,7 @@ static void winTreeRemoveItemData(Ihandle* ih, HTREEITEM hItem, IFns cb, int id)
     if (itemData)
     {
       if (cb) 
-        cb(ih, (char*)ih->data->node_cache[id].userdata);
+        cb(ih, (char*)iupTreeGetNodeData(ih, id)->userdata);
 
       free(itemData);
       item.lParam = (LPARAM)NULL;
@@ -1493,7 +1493,7 @@ static void winTreeRemoveAllNodeData(Ihandle* ih, int call_cb)
 
   for (i = 0; i < ih->data->node_count; i++)
   {
-    hItem = ih->data->node_cache[i].node_handle;
+    hItem = iupTreeGetNodeData(ih, i)->node_handle;
     winTreeRemoveItemData(ih, hItem, cb, i);
   }
 
@@ -1561,9 +1561,9 @@ static int winTreeSetDelNodeAttrib(Ihandle* ih, int id, const char* value)
 
     for(i = 0; i < ih->data->node_count; /* increment only if not removed */)
     {
-      if (winTreeIsNodeSelected(ih, ih->data->node_cache[i].node_handle))
+      if (winTreeIsNodeSelected(ih, iupTreeGetNodeData(ih, i)->node_handle))
       {
-        HTREEITEM hItem = ih->data->node_cache[i].node_handle;
+        HTREEITEM hItem = iupTreeGetNodeData(ih, i)->node_handle;
         if (hItemFocus == hItem)
         {
           del_focus = 1;
@@ -1724,7 +1724,7 @@ static char* winTreeGetMarkedNodesAttrib(Ihandle* ih)
 
   for (i=0; i<ih->data->node_count; i++)
   {
-    if (winTreeIsNodeSelected(ih, ih->data->node_cache[i].node_handle))
+    if (winTreeIsNodeSelected(ih, iupTreeGetNodeData(ih, i)->node_handle))
       str[i] = '+';
     else
       str[i] = '-';
@@ -1748,9 +1748,9 @@ static int winTreeSetMarkedNodesAttrib(Ihandle* ih, const char* value)
   for (i=0; i<count; i++)
   {
     if (value[i] == '+')
-      winTreeSelectNode(ih, ih->data->node_cache[i].node_handle, 1);
+      winTreeSelectNode(ih, iupTreeGetNodeData(ih, i)->node_handle, 1);
     else
-      winTreeSelectNode(ih, ih->data->node_cache[i].node_handle, 0);
+      winTreeSelectNode(ih, iupTreeGetNodeData(ih, i)->node_handle, 0);
   }
 
   return 0;
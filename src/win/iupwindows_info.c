@@ -69,6 +69,43 @@ int iupdrvSetCurrentDirectory(const char* dir)
   return SetCurrentDirectory(dir);
 }
 
+void* iupdrvMapFile(const char* filename, int *size)
+{
+  HANDLE file, mapping;
+  DWORD high_size, low_size;
+  void* data;
+
+  file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return NULL;
+
+  low_size = GetFileSize(file, &high_size);
+  if (low_size == INVALID_FILE_SIZE || low_size == 0 || high_size != 0 || low_size > 0x7FFFFFFF)
+  {
+    CloseHandle(file);
+    return NULL;
+  }
+
+  mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (!mapping)
+    return NULL;
+
+  data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);  /* the view remains valid */
+  if (!data)
+    return NULL;
+
+  *size = (int)low_size;
+  return data;
+}
+
+void iupdrvUnmapFile(void* data, int size)
+{
+  UnmapViewOfFile(data);
+  (void)size;
+}
+
 void iupdrvGetScreenSize(int *width, int *height)
 {
   RECT area;
@@ -9,6 +9,8 @@
 #include <stdlib.h> /* declaration of __argc and __argv */
 
 #include "iup.h"
+
+#include "iup_str.h"
               
               
 #ifdef __WATCOMC__     /* force Watcom to link this module, called from IupOpen */
@@ -26,11 +28,13 @@ HINSTANCE iupwin_dll_hinstance = 0;
 #ifdef IUP_DLL 
 BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved)
 {
-  (void)fdwReason;
   (void)lpvReserved;
 
   iupwin_dll_hinstance = hinstDLL;
 
+  if (fdwReason == DLL_THREAD_DETACH)
+    iupStrGetMemory(-1);  /* destroy the transient string memory of the thread */
+
   return TRUE;
 }
 #else
@@ -9,7 +9,7 @@ SRCCOLOR := $(addprefix color/, $(SRCCOLOR))
 
 SRCMATRIX = iupmat_key.c iupmat_mark.c iupmat_aux.c iupmat_mem.c iupmat_mouse.c iupmat_numlc.c \
             iupmat_colres.c iupmat_draw.c iupmat_getset.c iupmatrix.c \
-            iupmat_scroll.c iupmat_edit.c
+            iupmat_scroll.c iupmat_edit.c iupmat_cache.c iupmat_store.c
 SRCMATRIX := $(addprefix matrix/, $(SRCMATRIX))
 
 SRC = iup_cdutil.c iup_gauge.c iup_cells.c iup_colorbar.c iup_controls.c \
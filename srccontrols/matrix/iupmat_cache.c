@@ -0,0 +1,341 @@
+/** \file
+ * \brief iupmatrix control
+ * cache of values in virtual mode
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+/**************************************************************************/
+/*  In virtual mode the application returns the values of a block of     */
+/*  lines at once. The lines are kept in a cache with a hash table by    */
+/*  line number and a list of the most recently used lines. When a line  */
+/*  is missing the visible lines plus one page in the scroll direction   */
+/*  are requested.                                                        */
+/**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iup.h"
+#include "iupcbs.h"
+
+#include <cd.h>
+
+#include "iup_object.h"
+#include "iup_attrib.h"
+#include "iup_str.h"
+#include "iup_stdcontrols.h"
+
+#include "iupmat_def.h"
+#include "iupmat_cache.h"
+
+
+#define IMAT_CACHE_MIN_LINES 256   /* minimum number of lines in the cache */
+#define IMAT_CACHE_MIN_PAGE   16   /* minimum number of lines requested at once */
+
+typedef struct _ImatCacheLine
+{
+  int lin;          /* line number, -1 if not used */
+  int next_hash;    /* next line in the same hash bucket */
+  int prev, next;   /* most recently used list */
+  char** values;    /* values of all the columns */
+} ImatCacheLine;
+
+struct _ImatCache
+{
+  ImatCacheLine* lines;
+  int count, max;          /* used and allocated lines */
+  int num_col;             /* number of values in each line */
+  int* hash;               /* first line of each bucket, -1 if empty */
+  int hash_mask;           /* number of buckets - 1 */
+  int mru, lru;            /* most and least recently used lines */
+  int last_first;          /* lines.first at the last request, gives the scroll direction */
+  char** block;            /* values returned by the application */
+  int block_size;
+};
+
+
+static void iMatrixCacheFreeValues(ImatCache* cache, ImatCacheLine* line)
+{
+  int col;
+  for (col = 0; col < cache->num_col; col++)
+  {
+    if (line->values[col])
+    {
+      free(line->values[col]);
+      line->values[col] = NULL;
+    }
+  }
+}
+
+static void iMatrixCacheFree(ImatCache* cache)
+{
+  int i;
+
+  for (i = 0; i < cache->count; i++)
+  {
+    iMatrixCacheFreeValues(cache, &cache->lines[i]);
+    free(cache->lines[i].values);
+  }
+
+  if (cache->lines) free(cache->lines);
+  if (cache->hash) free(cache->hash);
+  if (cache->block) free(cache->block);
+
+  memset(cache, 0, sizeof(ImatCache));
+  cache->mru = -1;
+  cache->lru = -1;
+}
+
+static void iMatrixCacheAlloc(ImatCache* cache, int max, int num_col)
+{
+  int hash_size = 1, i;
+
+  while (hash_size < 2*max)
+    hash_size *= 2;
+
+  cache->lines = (ImatCacheLine*)calloc(max, sizeof(ImatCacheLine));
+  cache->max = max;
+  cache->num_col = num_col;
+
+  cache->hash = (int*)malloc(hash_size*sizeof(int));
+  cache->hash_mask = hash_size-1;
+  for (i = 0; i < hash_size; i++)
+    cache->hash[i] = -1;
+}
+
+static int iMatrixCacheFind(ImatCache* cache, int lin)
+{
+  int i = cache->hash[lin & cache->hash_mask];
+  while (i != -1 && cache->lines[i].lin != lin)
+    i = cache->lines[i].next_hash;
+  return i;
+}
+
+static void iMatrixCacheHashRemove(ImatCache* cache, int i)
+{
+  int* pi = &cache->hash[cache->lines[i].lin & cache->hash_mask];
+  while (*pi != i)
+    pi = &cache->lines[*pi].next_hash;
+  *pi = cache->lines[i].next_hash;
+}
+
+static void iMatrixCacheListRemove(ImatCache* cache, int i)
+{
+  ImatCacheLine* line = &cache->lines[i];
+
+  if (line->prev != -1)
+    cache->lines[line->prev].next = line->next;
+  else
+    cache->mru = line->next;
+
+  if (line->next != -1)
+    cache->lines[line->next].prev = line->prev;
+  else
+    cache->lru = line->prev;
+}
+
+static void iMatrixCacheListInsert(ImatCache* cache, int i)
+{
+  ImatCacheLine* line = &cache->lines[i];
+
+  line->prev = -1;
+  line->next = cache->mru;
+  if (cache->mru != -1)
+    cache->lines[cache->mru].prev = i;
+  cache->mru = i;
+  if (cache->lru == -1)
+    cache->lru = i;
+}
+
+/* returns a line for lin, the least recently used line is replaced when the cache is full */
+static int iMatrixCacheAddLine(ImatCache* cache, int lin)
+{
+  int i = iMatrixCacheFind(cache, lin);
+  if (i != -1)
+  {
+    iMatrixCacheFreeValues(cache, &cache->lines[i]);
+    iMatrixCacheListRemove(cache, i);
+  }
+  else
+  {
+    if (cache->count < cache->max)
+    {
+      i = cache->count;
+      cache->lines[i].values = (char**)calloc(cache->num_col, sizeof(char*));
+      cache->count++;
+    }
+    else
+    {
+      i = cache->lru;
+      iMatrixCacheFreeValues(cache, &cache->lines[i]);
+      iMatrixCacheListRemove(cache, i);
+      if (cache->lines[i].lin != -1)
+        iMatrixCacheHashRemove(cache, i);
+    }
+
+    cache->lines[i].lin = lin;
+    cache->lines[i].next_hash = cache->hash[lin & cache->hash_mask];
+    cache->hash[lin & cache->hash_mask] = i;
+  }
+
+  iMatrixCacheListInsert(cache, i);
+  return i;
+}
+
+static void iMatrixCacheFetch(Ihandle* ih, int lin)
+{
+  ImatCache* cache = ih->data->cache;
+  IFniiiiv valueblock_cb = (IFniiiiv)IupGetCallback(ih, "VALUEBLOCK_CB");
+  int page, lin1, lin2, num_col, count, size, l, col;
+  char** values;
+
+  if (!valueblock_cb)
+    return;
+
+  page = ih->data->lines.last - ih->data->lines.first + 1;
+  if (page < IMAT_CACHE_MIN_PAGE)
+    page = IMAT_CACHE_MIN_PAGE;
+
+  /* the visible lines from lin plus one page in the scroll direction */
+  if (ih->data->lines.first >= cache->last_first)
+  {
+    lin1 = lin;
+    lin2 = lin + 2*page - 1;
+  }
+  else
+  {
+    lin1 = lin - page;
+    lin2 = lin + page - 1;
+  }
+  if (lin1 < 0) lin1 = 0;
+  if (lin2 > ih->data->lines.num-1) lin2 = ih->data->lines.num-1;
+
+  /* the cache must hold the visible lines and the requested lines */
+  num_col = ih->data->columns.num;
+  if (cache->num_col != num_col || cache->max < 4*page)
+  {
+    int max = 4*page;
+    if (max < IMAT_CACHE_MIN_LINES)
+      max = IMAT_CACHE_MIN_LINES;
+
+    iMatrixCacheFree(cache);
+    iMatrixCacheAlloc(cache, max, num_col);
+  }
+  cache->last_first = ih->data->lines.first;
+
+  /* the lines that are already in the cache are not requested again */
+  while (lin1 < lin && iMatrixCacheFind(cache, lin1) != -1)
+    lin1++;
+  while (lin2 > lin && iMatrixCacheFind(cache, lin2) != -1)
+    lin2--;
+
+  count = lin2-lin1+1;
+  size = count*num_col;
+  if (size > cache->block_size)
+  {
+    cache->block = (char**)realloc(cache->block, size*sizeof(char*));
+    cache->block_size = size;
+  }
+  memset(cache->block, 0, size*sizeof(char*));
+
+  if (valueblock_cb(ih, lin1, 0, lin2, num_col-1, cache->block) == IUP_IGNORE)
+    return;
+
+  values = cache->block;
+  for (l = lin1; l <= lin2; l++)
+  {
+    ImatCacheLine* line = &cache->lines[iMatrixCacheAddLine(cache, l)];
+    for (col = 0; col < num_col; col++)
+    {
+      if (values[col])
+        line->values[col] = iupStrDup(values[col]);
+    }
+    values += num_col;
+  }
+}
+
+void iupMatrixCacheCreate(Ihandle* ih)
+{
+  ImatCache* cache = (ImatCache*)calloc(1, sizeof(ImatCache));
+  cache->mru = -1;
+  cache->lru = -1;
+  ih->data->cache = cache;
+}
+
+void iupMatrixCacheDestroy(Ihandle* ih)
+{
+  if (ih->data->cache)
+  {
+    iMatrixCacheFree(ih->data->cache);
+    free(ih->data->cache);
+    ih->data->cache = NULL;
+  }
+}
+
+char* iupMatrixCacheGetValue(Ihandle* ih, int lin, int col)
+{
+  ImatCache* cache = ih->data->cache;
+  int i = -1;
+
+  if (cache->max)
+    i = iMatrixCacheFind(cache, lin);
+
+  if (i == -1)
+  {
+    iMatrixCacheFetch(ih, lin);
+
+    if (!cache->max)
+      return NULL;
+    i = iMatrixCacheFind(cache, lin);
+    if (i == -1)
+      return NULL;
+  }
+  else if (i != cache->mru)
+  {
+    iMatrixCacheListRemove(cache, i);
+    iMatrixCacheListInsert(cache, i);
+  }
+
+  if (col >= cache->num_col)
+    return NULL;
+  return cache->lines[i].values[col];
+}
+
+void iupMatrixCacheInvalidate(Ihandle* ih, int lin1, int lin2)
+{
+  ImatCache* cache = ih->data->cache;
+  int i;
+
+  if (!cache || !cache->max)
+    return;
+
+  /* the removed lines are kept in the list, but without values and out of the hash table */
+  for (i = 0; i < cache->count; i++)
+  {
+    ImatCacheLine* line = &cache->lines[i];
+    if (line->lin >= lin1 && line->lin <= lin2)
+    {
+      iMatrixCacheFreeValues(cache, line);
+      iMatrixCacheHashRemove(cache, i);
+      line->lin = -1;
+
+      /* reuse it first */
+      iMatrixCacheListRemove(cache, i);
+      line->prev = cache->lru;
+      line->next = -1;
+      if (cache->lru != -1)
+        cache->lines[cache->lru].next = i;
+      cache->lru = i;
+      if (cache->mru == -1)
+        cache->mru = i;
+    }
+  }
+}
+
+void iupMatrixCacheClear(Ihandle* ih)
+{
+  if (ih->data->cache)
+    iMatrixCacheFree(ih->data->cache);
+}
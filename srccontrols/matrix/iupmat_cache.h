@@ -0,0 +1,31 @@
+/** \file
+ * \brief iupmatrix. cache of values in virtual mode.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#ifndef __IUPMAT_CACHE_H
+#define __IUPMAT_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* In virtual mode the values are obtained by blocks of lines with VALUEBLOCK_CB,
+   and are kept in a cache of the most recently used lines. */
+
+void  iupMatrixCacheCreate(Ihandle* ih);
+void  iupMatrixCacheDestroy(Ihandle* ih);
+
+char* iupMatrixCacheGetValue(Ihandle* ih, int lin, int col);
+
+/* Values must be obtained again from the application */
+void  iupMatrixCacheInvalidate(Ihandle* ih, int lin1, int lin2);
+void  iupMatrixCacheClear(Ihandle* ih);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
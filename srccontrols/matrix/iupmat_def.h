@@ -48,6 +48,18 @@ typedef struct _ImatCell
 } ImatCell;
 
 
+/* Block of cells that changed and was not drawn yet, includes titles */
+typedef struct _ImatDirtyRect
+{
+  int lin1, col1, lin2, col2;
+} ImatDirtyRect;
+
+#define IMAT_DIRTY_MAX 16   /* more blocks are merged with the closest one */
+
+
+typedef struct _ImatCache ImatCache;  /* see iupmat_cache.c */
+typedef struct _ImatStore ImatStore;  /* see iupmat_store.c */
+
 typedef struct _ImatLinColData
 {
   int* sizes;            /* Width/height of the columns/lines  (allocated after map)   */
@@ -74,7 +86,9 @@ struct _IcontrolData
 {
   iupCanvas canvas; /* from IupCanvas (must reserve it) */
 
-  ImatCell** cells; /* Cell value, this will be NULL if in callback mode (allocated after map) */
+  ImatCell** cells; /* Cell value, this will be NULL if in callback mode or if store is used (allocated after map) */
+  ImatStore* store; /* Cell value and flags when COMPACTSTORAGE=Yes, replaces cells (allocated after map) */
+  ImatCache* cache; /* Cell values in virtual mode, when VALUEBLOCK_CB is defined (allocated after map) */
 
   Ihandle* texth;   /* Text handle                    */
   Ihandle* droph;   /* Dropdown handle                */
@@ -125,6 +139,12 @@ struct _IcontrolData
 
   /* Clipping AUX for cell  */
   int clip_x1, clip_x2, clip_y1, clip_y2;
+
+  /* Dirty cells AUX */
+  ImatDirtyRect dirty[IMAT_DIRTY_MAX];
+  int dirty_count;
+  int update_count;   /* BEGINUPDATE nesting level, drawing is postponed until ENDUPDATE */
+  int damage_x1, damage_x2, damage_y1, damage_y2;  /* area drawn in the buffer since the last reset, x1>x2 if empty */
 };
 
 
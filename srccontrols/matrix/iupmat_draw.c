@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 #undef CD_NO_OLD_INTERFACE
 
@@ -32,6 +33,8 @@
 #include "iupmat_aux.h"
 #include "iupmat_getset.h"
 #include "iupmat_mark.h"
+#include "iupmat_cache.h"
+#include "iupmat_mem.h"
 
 
 /* Text alignment that will be draw. Used by iMatrixDrawCellValue */
@@ -49,6 +52,37 @@
 /*  Private functions                                                     */
 /**************************************************************************/
 
+static void iMatrixDrawAddDamage(Ihandle* ih, int x1, int x2, int y1, int y2)
+{
+  if (x1 < 0) x1 = 0;
+  if (y1 < 0) y1 = 0;
+  if (x2 > ih->data->w-1) x2 = ih->data->w-1;
+  if (y2 > ih->data->h-1) y2 = ih->data->h-1;
+  if (x1 > x2 || y1 > y2)
+    return;
+
+  if (ih->data->damage_x1 > ih->data->damage_x2)
+  {
+    ih->data->damage_x1 = x1;
+    ih->data->damage_x2 = x2;
+    ih->data->damage_y1 = y1;
+    ih->data->damage_y2 = y2;
+  }
+  else
+  {
+    if (x1 < ih->data->damage_x1) ih->data->damage_x1 = x1;
+    if (x2 > ih->data->damage_x2) ih->data->damage_x2 = x2;
+    if (y1 < ih->data->damage_y1) ih->data->damage_y1 = y1;
+    if (y2 > ih->data->damage_y2) ih->data->damage_y2 = y2;
+  }
+}
+
+static void iMatrixDrawResetDamage(Ihandle* ih)
+{
+  ih->data->damage_x1 = 0;
+  ih->data->damage_x2 = -1;
+}
+
 static void iMatrixDrawSetCellClipping(Ihandle* ih, int x1, int x2, int y1, int y2)
 {
   int old_clip = cdCanvasClip(ih->data->cddbuffer, CD_QUERY);
@@ -185,13 +219,12 @@ static unsigned long iMatrixDrawSetBgColor(Ihandle* ih, int lin, int col, int ma
 static void iMatrixDrawFrameHorizLineCell(Ihandle* ih, int lin, int col, int x1, int x2, int y, long framecolor, char* str)
 {
   if (ih->data->checkframecolor && (ih->data->callback_mode || 
-                                    ih->data->cells[lin][col].flags & IMAT_HAS_FRAMEHORIZCOLOR ||
+                                    *iupMatrixMemGetFlags(ih, lin, col) & IMAT_HAS_FRAMEHORIZCOLOR ||
                                     ih->data->lines.flags[lin] & IMAT_HAS_FRAMEHORIZCOLOR))
   {
     char* color;
     unsigned char r,g,b;
-    sprintf(str, "FRAMEHORIZCOLOR%d:%d", lin, col);
-    color = iupAttribGet(ih, str);
+    color = iupAttribGetId2(ih, "FRAMEHORIZCOLOR", lin, col);
     if (!color)
     {
       sprintf(str, "FRAMEHORIZCOLOR%d:*", lin);
@@ -210,13 +243,12 @@ static void iMatrixDrawFrameHorizLineCell(Ihandle* ih, int lin, int col, int x1,
 static void iMatrixDrawFrameVertLineCell(Ihandle* ih, int lin, int col, int x, int y1, int y2, long framecolor, char* str)
 {
   if (ih->data->checkframecolor && (ih->data->callback_mode || 
-                                    ih->data->cells[lin][col].flags & IMAT_HAS_FRAMEVERTCOLOR ||
+                                    *iupMatrixMemGetFlags(ih, lin, col) & IMAT_HAS_FRAMEVERTCOLOR ||
                                     ih->data->columns.flags[col] & IMAT_HAS_FRAMEVERTCOLOR))
   {
     char* color;
     unsigned char r,g,b;
-    sprintf(str, "FRAMEVERTCOLOR%d:%d", lin, col);
-    color = iupAttribGet(ih, str);
+    color = iupAttribGetId2(ih, "FRAMEVERTCOLOR", lin, col);
     if (!color)
     {
       sprintf(str, "FRAMEVERTCOLOR*:%d", col);
@@ -549,6 +581,8 @@ static void iMatrixDrawTitleCorner(Ihandle* ih)
     iMatrixDrawFrameRectTitle(ih, 0, 0, 0, ih->data->columns.sizes[0], 0, ih->data->lines.sizes[0], framecolor, str);
 
     iMatrixDrawCellValue(ih, 0, ih->data->columns.sizes[0], 0, ih->data->lines.sizes[0], IMAT_T_CENTER, 0, active, 0, 0, draw_cb);
+
+    iMatrixDrawAddDamage(ih, 0, ih->data->columns.sizes[0], 0, ih->data->lines.sizes[0]);
   }
 }
 
@@ -629,7 +663,7 @@ static void iMatrixDrawFocus(Ihandle* ih)
    -> lin2 - Last line to have its title drawn */
 void iupMatrixDrawLineTitle(Ihandle* ih, int lin1, int lin2)
 {
-  int x1, y1, x2, y2, first_lin;
+  int x1, y1, x2, y2, first_lin, clip_y1;
   int lin, alignment, active;
   char str[100];
   long framecolor;
@@ -638,6 +672,12 @@ void iupMatrixDrawLineTitle(Ihandle* ih, int lin1, int lin2)
   if (!ih->data->columns.sizes[0])
     return;
 
+  if (ih->data->update_count)
+  {
+    iupMatrixDrawSetDirty(ih, lin1, 0, lin2, 0);
+    return;
+  }
+
   if (ih->data->lines.num_noscroll>1 && lin1==1 && lin2==ih->data->lines.num_noscroll-1)
   {
     first_lin = 0;
@@ -666,6 +706,7 @@ void iupMatrixDrawLineTitle(Ihandle* ih, int lin1, int lin2)
 
   iupMATRIX_CLIPAREA(ih, x1, x2, y1, ih->data->h-1);
   cdCanvasClip(ih->data->cddbuffer, CD_CLIPAREA);
+  clip_y1 = y1;
 
   /* Find the initial position of the first line */
   if (first_lin == ih->data->lines.first)
@@ -698,6 +739,8 @@ void iupMatrixDrawLineTitle(Ihandle* ih, int lin1, int lin2)
       iMatrixDrawFrameRectTitle(ih, lin, 0, x1, x2, y1, y2, framecolor, str);
 
       iMatrixDrawCellValue(ih, x1, x2, y1, y2, alignment, marked, active, lin, 0, draw_cb);
+
+      iMatrixDrawAddDamage(ih, x1, x2, y1 > clip_y1? y1: clip_y1, y2);
     }
 
     y1 = y2;
@@ -712,7 +755,7 @@ void iupMatrixDrawLineTitle(Ihandle* ih, int lin1, int lin2)
    -> col2 - Last column to have its title drawn */
 void iupMatrixDrawColumnTitle(Ihandle* ih, int col1, int col2)
 {
-  int x1, y1, x2, y2, first_col;
+  int x1, y1, x2, y2, first_col, clip_x1;
   int col, active;
   char str[100];
   long framecolor;
@@ -721,6 +764,12 @@ void iupMatrixDrawColumnTitle(Ihandle* ih, int col1, int col2)
   if (!ih->data->lines.sizes[0])
     return;
 
+  if (ih->data->update_count)
+  {
+    iupMatrixDrawSetDirty(ih, 0, col1, 0, col2);
+    return;
+  }
+
   if (ih->data->columns.num_noscroll>1 && col1==1 && col2==ih->data->columns.num_noscroll-1)
   {
     first_col = 0;
@@ -749,6 +798,7 @@ void iupMatrixDrawColumnTitle(Ihandle* ih, int col1, int col2)
 
   iupMATRIX_CLIPAREA(ih, x1, ih->data->w-1, y1, y2);
   cdCanvasClip(ih->data->cddbuffer, CD_CLIPAREA);
+  clip_x1 = x1;
 
   /* Find the initial position of the first column */
   if (first_col==ih->data->columns.first)
@@ -783,6 +833,8 @@ void iupMatrixDrawColumnTitle(Ihandle* ih, int col1, int col2)
         sort = IMAT_DROPBOX_W; /* same space is used by the sort sign */
 
       iMatrixDrawCellValue(ih, x1, x2-sort, y1, y2, IMAT_T_CENTER, marked, active, 0, col, draw_cb);
+
+      iMatrixDrawAddDamage(ih, x1 > clip_x1? x1: clip_x1, x2, y1, y2);
     }
 
     x1 = x2;
@@ -797,7 +849,7 @@ void iupMatrixDrawColumnTitle(Ihandle* ih, int col1, int col2)
    - lin2, col2 : cell coordinates that mark the right bottom corner of the area to be redrawn */
 void iupMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2)
 {
-  int x1, y1, x2, y2, old_x2, old_y1, old_y2;
+  int x1, y1, x2, y2, old_x2, old_y1, old_y2, clip_x1, clip_y1;
   int alignment, lin, col, active, first_col, first_lin;
   long framecolor, emptyarea_color = -1;
   char str[100];
@@ -805,6 +857,12 @@ void iupMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2)
   IFnii dropcheck_cb;
   IFniiiiiiC draw_cb;
 
+  if (ih->data->update_count)
+  {
+    iupMatrixDrawSetDirty(ih, lin1, col1, lin2, col2);
+    return;
+  }
+
   x2 = ih->data->w-1;
   y2 = ih->data->h-1;
 
@@ -862,6 +920,8 @@ void iupMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2)
 
   iupMATRIX_CLIPAREA(ih, x1, x2, y1, y2);
   cdCanvasClip(ih->data->cddbuffer, CD_CLIPOFF);  /* wait for background */
+  clip_x1 = x1;
+  clip_y1 = y1;
 
   /* Find the initial position of the first column */
   if (first_col==ih->data->columns.first)
@@ -885,6 +945,8 @@ void iupMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2)
   for( ; lin <= lin2; lin++)
     y2 += ih->data->lines.sizes[lin];
 
+  iMatrixDrawAddDamage(ih, x1 > clip_x1? x1: clip_x1, x2, y1 > clip_y1? y1: clip_y1, y2);
+
   if ((col2 == ih->data->columns.num-1) && (old_x2 > x2))
   {
     emptyarea_color = cdIupConvertColor(ih->data->bgcolor_parent);
@@ -893,6 +955,7 @@ void iupMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2)
     /* If it was drawn until the last column and remains space in the right of it,
        then delete this area with the the background color. */
     iupMATRIX_BOX(ih, x2, old_x2, old_y1, old_y2);
+    iMatrixDrawAddDamage(ih, x2, old_x2, old_y1, old_y2);
   }
 
   if ((lin2 == ih->data->lines.num-1) && (old_y2 > y2))
@@ -904,6 +967,7 @@ void iupMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2)
     /* If it was drawn until the last line visible and remains space below it,
        then delete this area with the the background color. */
     iupMATRIX_BOX(ih, 0, old_x2, y2, old_y2);
+    iMatrixDrawAddDamage(ih, 0, old_x2, y2, old_y2);
   }
 
   /* after the background */
@@ -965,11 +1029,18 @@ void iupMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2)
 
 void iupMatrixDraw(Ihandle* ih, int update)
 {
+  if (ih->data->update_count)
+  {
+    ih->data->need_redraw = 1;  /* wait for ENDUPDATE */
+    return;
+  }
+
   if (ih->data->need_calcsize)
     iupMatrixAuxCalcSizes(ih);
 
   iMatrixDrawMatrix(ih);
   ih->data->need_redraw = 0;
+  ih->data->dirty_count = 0;
 
   if (update)
     iupMatrixDrawUpdate(ih);
@@ -983,6 +1054,209 @@ void iupMatrixDrawUpdate(Ihandle* ih)
     iMatrixDrawFocus(ih);
 }
 
+static int iMatrixDrawDirtyMerge(ImatDirtyRect* rect, int lin1, int col1, int lin2, int col2, int max_waste)
+{
+  int area1 = (rect->lin2 - rect->lin1 + 1) * (rect->col2 - rect->col1 + 1);
+  int area2 = (lin2 - lin1 + 1) * (col2 - col1 + 1);
+  int area;
+
+  if (rect->lin1 < lin1) lin1 = rect->lin1;
+  if (rect->col1 < col1) col1 = rect->col1;
+  if (rect->lin2 > lin2) lin2 = rect->lin2;
+  if (rect->col2 > col2) col2 = rect->col2;
+
+  area = (lin2 - lin1 + 1) * (col2 - col1 + 1);
+  if (area - area1 - area2 > max_waste)
+    return 0;
+
+  rect->lin1 = lin1;
+  rect->col1 = col1;
+  rect->lin2 = lin2;
+  rect->col2 = col2;
+  return 1;
+}
+
+static int iMatrixDrawIsRangeVisible(ImatLinColData* p, int i1, int i2)
+{
+  return (i1 < p->num_noscroll) ||  /* includes the title */
+         (i1 <= p->last && i2 >= p->first);
+}
+
+void iupMatrixDrawSetDirty(Ihandle* ih, int lin1, int col1, int lin2, int col2)
+{
+  int i, best = 0, best_waste = -1;
+
+  if (!ih->data->cddbuffer || ih->data->need_redraw || ih->data->need_calcsize)
+    return;  /* everything will be drawn */
+
+  if (lin1 < 0) lin1 = 0;
+  if (col1 < 0) col1 = 0;
+  if (lin2 > ih->data->lines.num-1) lin2 = ih->data->lines.num-1;
+  if (col2 > ih->data->columns.num-1) col2 = ih->data->columns.num-1;
+  if (lin1 > lin2 || col1 > col2)
+    return;
+
+  /* a scroll will redraw everything */
+  if (!iMatrixDrawIsRangeVisible(&ih->data->lines, lin1, lin2) ||
+      !iMatrixDrawIsRangeVisible(&ih->data->columns, col1, col2))
+    return;
+
+  /* merge with a block that is not enlarged by more cells than the new block has,
+     so neighbor cells are merged in a single block */
+  for (i = 0; i < ih->data->dirty_count; i++)
+  {
+    ImatDirtyRect* rect = &ih->data->dirty[i];
+    if (iMatrixDrawDirtyMerge(rect, lin1, col1, lin2, col2, 0))
+    {
+      /* the new block can now touch another one */
+      lin1 = rect->lin1; col1 = rect->col1; lin2 = rect->lin2; col2 = rect->col2;
+      ih->data->dirty_count--;
+      *rect = ih->data->dirty[ih->data->dirty_count];
+      iupMatrixDrawSetDirty(ih, lin1, col1, lin2, col2);
+      return;
+    }
+  }
+
+  if (ih->data->dirty_count < IMAT_DIRTY_MAX)
+  {
+    ImatDirtyRect* rect = &ih->data->dirty[ih->data->dirty_count];
+    rect->lin1 = lin1;
+    rect->col1 = col1;
+    rect->lin2 = lin2;
+    rect->col2 = col2;
+    ih->data->dirty_count++;
+    return;
+  }
+
+  /* full, merge with the block that grows less */
+  for (i = 0; i < ih->data->dirty_count; i++)
+  {
+    ImatDirtyRect* rect = &ih->data->dirty[i];
+    int l1 = rect->lin1 < lin1? rect->lin1: lin1,
+        c1 = rect->col1 < col1? rect->col1: col1,
+        l2 = rect->lin2 > lin2? rect->lin2: lin2,
+        c2 = rect->col2 > col2? rect->col2: col2;
+    int waste = (l2 - l1 + 1) * (c2 - c1 + 1) - (rect->lin2 - rect->lin1 + 1) * (rect->col2 - rect->col1 + 1);
+    if (best_waste < 0 || waste < best_waste)
+    {
+      best_waste = waste;
+      best = i;
+    }
+  }
+
+  {
+    ImatDirtyRect rect = ih->data->dirty[best];
+    ih->data->dirty_count--;
+    ih->data->dirty[best] = ih->data->dirty[ih->data->dirty_count];
+    iMatrixDrawDirtyMerge(&rect, lin1, col1, lin2, col2, INT_MAX);
+    iupMatrixDrawSetDirty(ih, rect.lin1, rect.col1, rect.lin2, rect.col2);
+  }
+}
+
+/* draw a block of cells that can include non scrollable cells and titles */
+static void iMatrixDrawDirtyRect(Ihandle* ih, ImatDirtyRect* rect)
+{
+  int lin1 = rect->lin1 < 1? 1: rect->lin1, 
+      col1 = rect->col1 < 1? 1: rect->col1;
+  int lin2 = rect->lin2, col2 = rect->col2;
+  int lin_ns = ih->data->lines.num_noscroll, 
+      col_ns = ih->data->columns.num_noscroll;
+
+  if (rect->lin1 == 0 && rect->col1 == 0)
+    iMatrixDrawTitleCorner(ih);
+
+  if (rect->lin1 == 0 && col1 <= col2)
+  {
+    if (col1 < col_ns)
+      iupMatrixDrawColumnTitle(ih, 1, col_ns-1);
+    if (col2 >= col_ns)
+      iupMatrixDrawColumnTitle(ih, col1 > col_ns? col1: col_ns, col2);
+  }
+
+  if (rect->col1 == 0 && lin1 <= lin2)
+  {
+    if (lin1 < lin_ns)
+      iupMatrixDrawLineTitle(ih, 1, lin_ns-1);
+    if (lin2 >= lin_ns)
+      iupMatrixDrawLineTitle(ih, lin1 > lin_ns? lin1: lin_ns, lin2);
+  }
+
+  if (lin1 > lin2 || col1 > col2)
+    return;
+
+  /* the non scrollable cells can only be drawn all together */
+  if (lin1 < lin_ns && col1 < col_ns)
+    iupMatrixDrawCells(ih, 1, 1, lin_ns-1, col_ns-1);
+  if (lin2 >= lin_ns && col1 < col_ns)
+    iupMatrixDrawCells(ih, lin1 > lin_ns? lin1: lin_ns, 1, lin2, col_ns-1);
+  if (lin1 < lin_ns && col2 >= col_ns)
+    iupMatrixDrawCells(ih, 1, col1 > col_ns? col1: col_ns, lin_ns-1, col2);
+  if (lin2 >= lin_ns && col2 >= col_ns)
+    iupMatrixDrawCells(ih, lin1 > lin_ns? lin1: lin_ns, col1 > col_ns? col1: col_ns, lin2, col2);
+}
+
+static int iMatrixDrawIntersect(Ihandle* ih, int x1, int x2, int y1, int y2)
+{
+  return x1 <= ih->data->damage_x2 && x2 >= ih->data->damage_x1 &&
+         y1 <= ih->data->damage_y2 && y2 >= ih->data->damage_y1;
+}
+
+static int iMatrixDrawFlushDamage(Ihandle* ih)
+{
+  int focus_x1, focus_y1, focus_dx, focus_dy;
+
+  if (ih->data->damage_x1 > ih->data->damage_x2)
+    return 0;
+
+  /* the double buffer flush is affected by the clipping of the destination */
+  cdCanvasClipArea(ih->data->cdcanvas, ih->data->damage_x1, ih->data->damage_x2, 
+                   iupMATRIX_INVERTYAXIS(ih, ih->data->damage_y2), iupMATRIX_INVERTYAXIS(ih, ih->data->damage_y1));
+  cdCanvasClip(ih->data->cdcanvas, CD_CLIPAREA);
+  cdCanvasFlush(ih->data->cddbuffer);
+  cdCanvasClip(ih->data->cdcanvas, CD_CLIPOFF);
+
+  /* the focus feedback was erased */
+  if (ih->data->has_focus &&
+      iupMatrixAuxIsCellVisible(ih, ih->data->lines.focus_cell, ih->data->columns.focus_cell))
+  {
+    iupMatrixGetVisibleCellDim(ih, ih->data->lines.focus_cell, ih->data->columns.focus_cell, &focus_x1, &focus_y1, &focus_dx, &focus_dy);
+    return iMatrixDrawIntersect(ih, focus_x1, focus_x1+focus_dx-1, focus_y1, focus_y1+focus_dy-1);
+  }
+  return 0;
+}
+
+void iupMatrixDrawDirty(Ihandle* ih, int update)
+{
+  int i, draw_focus = 0;
+
+  if (ih->data->update_count)
+    return;
+
+  if (ih->data->need_redraw || ih->data->need_calcsize)
+  {
+    iupMatrixDraw(ih, update);
+    return;
+  }
+
+  if (!ih->data->dirty_count)
+    return;
+
+  iupMatrixPrepareDrawData(ih);
+
+  for (i = 0; i < ih->data->dirty_count; i++)
+  {
+    iMatrixDrawResetDamage(ih);
+    iMatrixDrawDirtyRect(ih, &ih->data->dirty[i]);
+
+    if (update && iMatrixDrawFlushDamage(ih))
+      draw_focus = 1;
+  }
+  ih->data->dirty_count = 0;
+
+  if (draw_focus)
+    iMatrixDrawFocus(ih);
+}
+
 int iupMatrixDrawSetRedrawAttrib(Ihandle* ih, const char* value)
 {
   int type;
@@ -1016,6 +1290,24 @@ int iupMatrixDrawSetRedrawAttrib(Ihandle* ih, const char* value)
     if (min > max)
       return 0;
 
+    /* in virtual mode the values changed in the application */
+    if (ih->data->cache)
+    {
+      if (type == IMAT_PROCESS_LIN)
+        iupMatrixCacheInvalidate(ih, min, max);
+      else
+        iupMatrixCacheClear(ih);
+    }
+
+    if (ih->data->update_count)
+    {
+      if (type == IMAT_PROCESS_LIN)
+        iupMatrixDrawSetDirty(ih, min, 0, max, ih->data->columns.num-1);
+      else
+        iupMatrixDrawSetDirty(ih, 0, min, ih->data->lines.num-1, max);
+      return 0;
+    }
+
     iupMatrixPrepareDrawData(ih);
 
     if (ih->data->need_calcsize)
@@ -1042,10 +1334,19 @@ int iupMatrixDrawSetRedrawAttrib(Ihandle* ih, const char* value)
   }
   else
   {
+    iupMatrixCacheClear(ih);
+
+    if (ih->data->update_count)
+    {
+      ih->data->need_redraw = 1;  /* wait for ENDUPDATE */
+      return 0;
+    }
+
     /* Force CalcSize */
     iupMatrixAuxCalcSizes(ih);
 
     iMatrixDrawMatrix(ih);
+    ih->data->dirty_count = 0;
   }
 
   ih->data->need_redraw = 0;
@@ -24,6 +24,12 @@ void iupMatrixDraw(Ihandle* ih, int update);
 /* Update the display only */
 void iupMatrixDrawUpdate(Ihandle* ih);
 
+/* Mark a block of cells to be drawn later, by iupMatrixDrawDirty */
+void iupMatrixDrawSetDirty(Ihandle* ih, int lin1, int col1, int lin2, int col2);
+
+/* Render only the dirty cells, and if update is set display only their area */
+void iupMatrixDrawDirty(Ihandle* ih, int update);
+
 int iupMatrixDrawSetRedrawAttrib(Ihandle* ih, const char* value);
 
 /* Color attenuation factor in a marked cell, 20% darker */
@@ -26,6 +26,12 @@
 #include "iupmat_edit.h"
 #include "iupmat_draw.h"
 #include "iupmat_aux.h"
+#include "iupmat_cache.h"
+#include "iupmat_mem.h"
+
+
+#define IMAT_TITLE_SAMPLE_COUNT 16   /* number of sampled blocks of lines */
+#define IMAT_TITLE_SAMPLE_LINES 64   /* number of lines in each block */
 
 
 int iupMatrixCheckCellPos(Ihandle* ih, int lin, int col)
@@ -41,35 +47,39 @@ int iupMatrixCheckCellPos(Ihandle* ih, int lin, int col)
 void iupMatrixCellSetValue(Ihandle* ih, int lin, int col, const char* value)
 {
   if (ih->data->callback_mode)
+  {
+    /* the new value must be obtained again from the application */
+    if (ih->data->cache)
+      iupMatrixCacheInvalidate(ih, lin, lin);
     return;
+  }
 
-  if (ih->data->cells[lin][col].value)
-    free(ih->data->cells[lin][col].value);
-
-  ih->data->cells[lin][col].value = iupStrDup(value);
+  iupMatrixMemSetValue(ih, lin, col, value);
 
-  ih->data->need_redraw = 1;
   if (lin==0 || col==0)
+  {
+    ih->data->need_redraw = 1;
     ih->data->need_calcsize = 1;
+  }
+  else
+    iupMatrixDrawSetDirty(ih, lin, col, lin, col);
 }
 
 char* iupMatrixCellGetValue (Ihandle* ih, int lin, int col)
 {
   if (!ih->handle)
-  {
-    char str[100];
-    sprintf(str, "%d:%d", lin, col);
-    return iupAttribGet(ih, str);
-  }
+    return iupAttribGetId2(ih, "", lin, col);
   else
   {
-    if (ih->data->callback_mode)
+    if (ih->data->cache)
+      return iupMatrixCacheGetValue(ih, lin, col);
+    else if (ih->data->callback_mode)
     {
       sIFnii value_cb = (sIFnii)IupGetCallback(ih, "VALUE_CB");
       return value_cb(ih, lin, col);
     }
     else
-      return ih->data->cells[lin][col].value;
+      return iupMatrixMemGetValue(ih, lin, col);
   }
 }
 
@@ -107,9 +117,9 @@ void iupMatrixCellSetFlag(Ihandle* ih, int lin, int col, unsigned char attr, int
         return;
 
       if (set)
-        ih->data->cells[lin][col].flags |= attr;
+        *iupMatrixMemGetFlags(ih, lin, col) |= attr;
       else
-        ih->data->cells[lin][col].flags &= ~attr;
+        *iupMatrixMemGetFlags(ih, lin, col) &= ~attr;
     }
   }
 }
@@ -171,10 +181,9 @@ static char* iMatrixGetCellAttrib(Ihandle* ih, unsigned char attr, int lin, int
   }
 
   /* 1 -  check for this cell */
-  if (ih->data->callback_mode || ih->data->cells[lin][col].flags & attr)
+  if (ih->data->callback_mode || *iupMatrixMemGetFlags(ih, lin, col) & attr)
   {
-    sprintf(attrib_id, "%s%d:%d", attrib, lin, col);
-    value = iupAttribGet(ih, attrib_id);
+    value = iupAttribGetId2(ih, attrib, lin, col);
   }
   if (!value)
   {
@@ -316,6 +325,45 @@ char* iupMatrixGetFont(Ihandle* ih, int lin, int col)
   return font;
 }
 
+static int iMatrixGetTitleMaxWidth(Ihandle* ih, int lin1, int lin2, int max_width)
+{
+  int lin, width;
+  for(lin = lin1; lin <= lin2; lin++)
+  {
+    char* title_value = iupMatrixCellGetValue(ih, lin, 0);
+    if (title_value)
+    {
+      iupdrvFontGetMultiLineStringSize(ih, title_value, &width, NULL);
+      if (width > max_width)
+        max_width = width;
+    }
+  }
+  return max_width;
+}
+
+static int iMatrixGetLineTitleWidth(Ihandle* ih)
+{
+  int num = ih->data->lines.num;
+  int i, lin, max_width;
+
+  if (!ih->data->cache || num <= IMAT_TITLE_SAMPLE_COUNT*IMAT_TITLE_SAMPLE_LINES)
+    return iMatrixGetTitleMaxWidth(ih, 0, num-1, 0);
+
+  /* in virtual mode the titles of all the lines are not obtained,
+     only the non scrollable lines, the visible lines and some blocks of lines along the matrix */
+  max_width = iMatrixGetTitleMaxWidth(ih, 0, ih->data->lines.num_noscroll-1, 0);
+  if (ih->data->lines.last >= ih->data->lines.first)
+    max_width = iMatrixGetTitleMaxWidth(ih, ih->data->lines.first, ih->data->lines.last, max_width);
+
+  for (i = 0; i < IMAT_TITLE_SAMPLE_COUNT; i++)
+  {
+    lin = (int)(((double)i*(num-IMAT_TITLE_SAMPLE_LINES))/(IMAT_TITLE_SAMPLE_COUNT-1));
+    max_width = iMatrixGetTitleMaxWidth(ih, lin, lin+IMAT_TITLE_SAMPLE_LINES-1, max_width);
+  }
+
+  return max_width;
+}
+
 int iupMatrixGetColumnWidth(Ihandle* ih, int col, int use_value)
 {
   int width = 0, pixels = 0;
@@ -342,18 +390,7 @@ int iupMatrixGetColumnWidth(Ihandle* ih, int col, int use_value)
       if (!ih->data->callback_mode || ih->data->use_title_size)
       {
         /* find the largest title */
-        int lin, max_width = 0;
-        for(lin = 0; lin < ih->data->lines.num; lin++)
-        {
-          char* title_value = iupMatrixCellGetValue(ih, lin, 0);
-          if (title_value)
-          {
-            iupdrvFontGetMultiLineStringSize(ih, title_value, &width, NULL);
-            if (width > max_width)
-              max_width = width;
-          }
-        }
-        width = max_width;
+        width = iMatrixGetLineTitleWidth(ih);
       }
     }
     else if (ih->data->use_title_size && (col>0 && col<ih->data->columns.num))
@@ -428,7 +465,7 @@ int iupMatrixGetLineHeight(Ihandle* ih, int lin, int use_value)
         height = max_height;
       }
     }
-    else if (ih->data->use_title_size && (lin>0 && lin<ih->data->lines.num))
+    else if (ih->data->use_title_size && !ih->data->cache && (lin>0 && lin<ih->data->lines.num))
     {
       char* title_value = iupMatrixCellGetValue(ih, lin, 0);
       if (title_value && title_value[0])
@@ -28,6 +28,7 @@
 #include "iupmat_mark.h"
 #include "iupmat_getset.h"
 #include "iupmat_draw.h"
+#include "iupmat_mem.h"
 
 
 static void iMatrixMarkLinSet(Ihandle* ih, int lin, int mark)
@@ -70,19 +71,18 @@ static void iMatrixMarkCellSet(Ihandle* ih, int lin, int col, int mark, IFniii m
     }
     else
     {
-      sprintf(str, "MARK%d:%d", lin, col);
       if (mark)
-        iupAttribSetStr(ih, str, "1");
+        iupAttribSetStrId2(ih, "MARK", lin, col, "1");
       else
-        iupAttribSetStr(ih, str, NULL);
+        iupAttribSetStrId2(ih, "MARK", lin, col, NULL);
     }
   }
   else
   {
     if (mark)
-      ih->data->cells[lin][col].flags |= IMAT_IS_MARKED;
+      *iupMatrixMemGetFlags(ih, lin, col) |= IMAT_IS_MARKED;
     else
-      ih->data->cells[lin][col].flags &= ~IMAT_IS_MARKED;
+      *iupMatrixMemGetFlags(ih, lin, col) &= ~IMAT_IS_MARKED;
   }
 }
 
@@ -103,14 +103,13 @@ int iupMatrixMarkCellGet(Ihandle* ih, int lin, int col, IFnii mark_cb, char* str
       {
         int mark = 0;
         char* value;
-        sprintf(str, "MARK%d:%d", lin, col);
-        value = iupAttribGet(ih, str);
+        value = iupAttribGetId2(ih, "MARK", lin, col);
         iupStrToInt(value, &mark);
         return mark;
       }
     }
     else
-      return ih->data->cells[lin][col].flags & IMAT_IS_MARKED;
+      return *iupMatrixMemGetFlags(ih, lin, col) & IMAT_IS_MARKED;
   }
   else
   {
@@ -624,23 +623,21 @@ int iupMatrixSetMarkAttrib(Ihandle* ih, int lin, int col, const char* value)
         }
         else
         {
-          char str[100];
-          sprintf(str, "MARK%d:%d", lin, col);
           if (mark)
           {
-            iupAttribSetStr(ih, str, "1");
+            iupAttribSetStrId2(ih, "MARK", lin, col, "1");
             ret = 1;
           }
           else
-            iupAttribSetStr(ih, str, NULL);
+            iupAttribSetStrId2(ih, "MARK", lin, col, NULL);
         }
       }
       else
       {
         if (mark)
-          ih->data->cells[lin][col].flags |= IMAT_IS_MARKED;
+          *iupMatrixMemGetFlags(ih, lin, col) |= IMAT_IS_MARKED;
         else
-          ih->data->cells[lin][col].flags &= ~IMAT_IS_MARKED;
+          *iupMatrixMemGetFlags(ih, lin, col) &= ~IMAT_IS_MARKED;
       }
 
       if (ih->handle)
@@ -714,7 +711,7 @@ char* iupMatrixGetMarkAttrib(Ihandle* ih, int lin, int col)
       }
       else
       {
-        if (ih->data->cells[lin][col].flags & IMAT_IS_MARKED)
+        if (*iupMatrixMemGetFlags(ih, lin, col) & IMAT_IS_MARKED)
           return "1";
         else
           return "0";
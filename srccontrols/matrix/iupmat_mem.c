@@ -25,28 +25,28 @@
 
 #include "iupmat_def.h"
 #include "iupmat_mem.h"
+#include "iupmat_cache.h"
+#include "iupmat_store.h"
 
 
 static void iMatrixGetInitialValues(Ihandle* ih)
 {
   int lin, col;
   char* value;
-  char attr[100];
 
   for (lin=0; lin<ih->data->lines.num; lin++)
   {
     for (col=0; col<ih->data->columns.num; col++)
     {
-      sprintf(attr, "%d:%d", lin, col);
-      value = iupAttribGet(ih, attr);
+      value = iupAttribGetId2(ih, "", lin, col);
       if (value)
       {
         /* get the initial value and remove it from the hash table */
 
         if (*value)
-          ih->data->cells[lin][col].value = iupStrDup(value);
+          iupMatrixMemSetValue(ih, lin, col, value);
 
-        iupAttribSetStr(ih, attr, NULL);
+        iupAttribSetStrId2(ih, "", lin, col, NULL);
       }
     }
   }
@@ -64,11 +64,16 @@ void iupMatrixMemAlloc(Ihandle* ih)
 
   if (!ih->data->callback_mode)
   {
-    int lin;
+    if (iupAttribGetBoolean(ih, "COMPACTSTORAGE"))
+      ih->data->store = iupMatrixStoreCreate(ih->data->lines.num, ih->data->columns.num);
+    else
+    {
+      int lin;
 
-    ih->data->cells = (ImatCell**)calloc(ih->data->lines.num_alloc, sizeof(ImatCell*));
-    for (lin = 0; lin < ih->data->lines.num_alloc; lin++)
-      ih->data->cells[lin] = (ImatCell*)calloc(ih->data->columns.num_alloc, sizeof(ImatCell));
+      ih->data->cells = (ImatCell**)calloc(ih->data->lines.num_alloc, sizeof(ImatCell*));
+      for (lin = 0; lin < ih->data->lines.num_alloc; lin++)
+        ih->data->cells[lin] = (ImatCell*)calloc(ih->data->columns.num_alloc, sizeof(ImatCell));
+    }
 
     iMatrixGetInitialValues(ih);
   }
@@ -102,6 +107,12 @@ void iupMatrixMemRelease(Ihandle* ih)
     ih->data->cells = NULL;
   }
 
+  if (ih->data->store)
+  {
+    iupMatrixStoreDestroy(ih->data->store);
+    ih->data->store = NULL;
+  }
+
   if (ih->data->columns.flags)
   {
     free(ih->data->columns.flags);
@@ -133,13 +144,16 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
 
   /* base is the first line where the change started */
 
+  /* in virtual mode the cached lines moved */
+  iupMatrixCacheClear(ih);
+
   /* If it doesn't have enough lines allocated, then allocate more space */
   if (num > ih->data->lines.num_alloc)  /* this also implicates that num>old_num */
   {
     int old_alloc = ih->data->lines.num_alloc;
     ih->data->lines.num_alloc = num;
 
-    if (!ih->data->callback_mode)
+    if (ih->data->cells)
     {
       ih->data->cells = (ImatCell**)realloc(ih->data->cells, ih->data->lines.num_alloc*sizeof(ImatCell*));
 
@@ -155,6 +169,14 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
   if (old_num==num)
     return;
 
+  if (ih->data->store)
+  {
+    if (num>old_num)
+      iupMatrixStoreInsertLines(ih->data->store, base, num-old_num);
+    else
+      iupMatrixStoreRemoveLines(ih->data->store, base, old_num-num);
+  }
+
   if (num>old_num) /* ADD */
   {
     diff_num = num-old_num;      /* size of the openned space */
@@ -165,7 +187,7 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
     /*   do it in reverse order to avoid overlapping */
     if (shift_num)
     {
-      if (!ih->data->callback_mode)
+      if (ih->data->cells)
         for (lin = shift_num-1; lin >= 0; lin--)   /* all columns, shift_num lines */
           memmove(ih->data->cells[lin+end], ih->data->cells[lin+base], ih->data->columns.num_alloc*sizeof(ImatCell));
       memmove(ih->data->lines.sizes+end, ih->data->lines.sizes+base, shift_num*sizeof(int));
@@ -173,7 +195,7 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
     }
 
     /* then clear the new space starting at base */
-    if (!ih->data->callback_mode)
+    if (ih->data->cells)
       for (lin = 0; lin < diff_num; lin++)        /* all columns, diff_num lines */
         memset(ih->data->cells[lin+base], 0, ih->data->columns.num_alloc*sizeof(ImatCell));
     memset(ih->data->lines.sizes+base, 0, diff_num*sizeof(int));
@@ -186,7 +208,7 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
     end = base+diff_num;
 
     /* release memory from the opened space */
-    if (!ih->data->callback_mode)
+    if (ih->data->cells)
     {
       for(lin = base; lin < end; lin++)   /* all columns, base-end lines */
       {
@@ -206,7 +228,7 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
     /* move the old data to opened space from end to base */
     if (shift_num)
     {
-      if (!ih->data->callback_mode)
+      if (ih->data->cells)
         for (lin = 0; lin < shift_num; lin++) /* all columns, shift_num lines */
           memmove(ih->data->cells[lin+base], ih->data->cells[lin+end], ih->data->columns.num_alloc*sizeof(ImatCell));
       memmove(ih->data->lines.sizes+base, ih->data->lines.sizes+end, shift_num*sizeof(int));
@@ -214,7 +236,7 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
     }
 
     /* then clear the remaining space starting at num */
-    if (!ih->data->callback_mode)
+    if (ih->data->cells)
       for (lin = 0; lin < diff_num; lin++)   /* all columns, diff_num lines */
         memset(ih->data->cells[lin+num], 0, ih->data->columns.num_alloc*sizeof(ImatCell));
     memset(ih->data->lines.sizes+num, 0, diff_num*sizeof(int));
@@ -228,6 +250,9 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
 
   /* base is the first column where the change started */
 
+  /* in virtual mode the cached values of each line changed */
+  iupMatrixCacheClear(ih);
+
   /* If it doesn't have enough columns allocated, then allocate more space */
   if (num > ih->data->columns.num_alloc)  /* this also implicates that also num>old_num */
   {
@@ -235,7 +260,7 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
 
     /* new space are allocated at the end, later we need to move the old data and clear the available space */
 
-    if (!ih->data->callback_mode)
+    if (ih->data->cells)
     {
       for(lin = 0; lin < ih->data->lines.num_alloc; lin++)
         ih->data->cells[lin] = (ImatCell*)realloc(ih->data->cells[lin], ih->data->columns.num_alloc*sizeof(ImatCell));
@@ -248,6 +273,14 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
   if (old_num==num)
     return;
 
+  if (ih->data->store)
+  {
+    if (num>old_num)
+      iupMatrixStoreInsertColumns(ih->data->store, base, num-old_num);
+    else
+      iupMatrixStoreRemoveColumns(ih->data->store, base, old_num-num);
+  }
+
   if (num>old_num) /* ADD */
   {
     /*   even if (old_num-base)>(num-old_num) memmove will correctly copy the memory */
@@ -260,7 +293,7 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     /* shift the old data, opening space for new data, from base to end */
     if (shift_num)
     {
-      if (!ih->data->callback_mode)
+      if (ih->data->cells)
         for (lin = 0; lin < ih->data->lines.num_alloc; lin++)  /* all lines, shift_num columns */
           memmove(ih->data->cells[lin]+end, ih->data->cells[lin]+base, shift_num*sizeof(ImatCell));
       memmove(ih->data->columns.sizes+end, ih->data->columns.sizes+base, shift_num*sizeof(int));
@@ -268,7 +301,7 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     }
 
     /* then clear the openned space starting at base */
-    if (!ih->data->callback_mode)
+    if (ih->data->cells)
       for (lin = 0; lin < ih->data->lines.num_alloc; lin++)   /* all lines, diff_num columns */
         memset(ih->data->cells[lin]+base, 0, diff_num*sizeof(ImatCell));
     memset(ih->data->columns.sizes+base, 0, diff_num*sizeof(int));
@@ -281,7 +314,7 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     end = base+diff_num;
 
     /* release memory from the opened space */
-    if (!ih->data->callback_mode)
+    if (ih->data->cells)
     {
       for (lin = 0; lin < ih->data->lines.num_alloc; lin++)  /* all lines, base-end columns */
       {
@@ -302,7 +335,7 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     /*   even if (num-base)>(old_num-num) memmove will correctly copy the memory */
     if (shift_num)
     {
-      if (!ih->data->callback_mode)
+      if (ih->data->cells)
         for (lin = 0; lin < ih->data->lines.num_alloc; lin++)  /* all lines, shift_num columns */
           memmove(ih->data->cells[lin]+base, ih->data->cells[lin]+end, shift_num*sizeof(ImatCell));
       memmove(ih->data->columns.sizes+base, ih->data->columns.sizes+end, shift_num*sizeof(int));
@@ -310,10 +343,66 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     }
 
     /* then clear the remaining space starting at num */
-    if (!ih->data->callback_mode)
+    if (ih->data->cells)
       for (lin = 0; lin < ih->data->lines.num_alloc; lin++)   /* all lines, diff_num columns */
         memset(ih->data->cells[lin]+num, 0, diff_num*sizeof(ImatCell));
     memset(ih->data->columns.sizes+num, 0, diff_num*sizeof(int));
     memset(ih->data->columns.flags+num, 0, diff_num*sizeof(unsigned char));
   }
 }
+
+char* iupMatrixMemGetValue(Ihandle* ih, int lin, int col)
+{
+  if (ih->data->store)
+    return iupMatrixStoreGetValue(ih->data->store, lin, col);
+  else
+    return ih->data->cells[lin][col].value;
+}
+
+void iupMatrixMemSetValue(Ihandle* ih, int lin, int col, const char* value)
+{
+  if (ih->data->store)
+    iupMatrixStoreSetValue(ih->data->store, lin, col, value);
+  else
+  {
+    ImatCell* cell = &(ih->data->cells[lin][col]);
+    char* old_value = cell->value;  /* value can be the old value */
+    cell->value = iupStrDup(value);
+    if (old_value)
+      free(old_value);
+  }
+}
+
+unsigned char* iupMatrixMemGetFlags(Ihandle* ih, int lin, int col)
+{
+  if (ih->data->store)
+    return iupMatrixStoreGetFlags(ih->data->store, lin, col);
+  else
+    return &(ih->data->cells[lin][col].flags);
+}
+
+size_t iupMatrixMemGetSize(Ihandle* ih)
+{
+  if (ih->data->store)
+    return iupMatrixStoreGetMemory(ih->data->store);
+  else if (ih->data->cells)
+  {
+    int lin, col;
+    size_t size = iupMATRIX_MEMBLOCK(ih->data->lines.num_alloc*sizeof(ImatCell*)) +
+                  ih->data->lines.num_alloc*iupMATRIX_MEMBLOCK(ih->data->columns.num_alloc*sizeof(ImatCell));
+
+    for (lin = 0; lin < ih->data->lines.num; lin++)
+    {
+      for (col = 0; col < ih->data->columns.num; col++)
+      {
+        char* value = ih->data->cells[lin][col].value;
+        if (value)
+          size += iupMATRIX_MEMBLOCK(strlen(value)+1);
+      }
+    }
+
+    return size;
+  }
+  else
+    return 0;
+}
@@ -17,6 +17,14 @@ void iupMatrixMemRelease(Ihandle* ih);
 void iupMatrixMemReAllocLines  (Ihandle* ih, int old_num, int num, int base);
 void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base);
 
+/* Access to the cells in normal mode, independent of COMPACTSTORAGE */
+char* iupMatrixMemGetValue(Ihandle* ih, int lin, int col);
+void  iupMatrixMemSetValue(Ihandle* ih, int lin, int col, const char* value);
+unsigned char* iupMatrixMemGetFlags(Ihandle* ih, int lin, int col);
+
+/* Estimated number of bytes allocated for the cells */
+size_t iupMatrixMemGetSize(Ihandle* ih);
+
 #ifdef __cplusplus
 }
 #endif
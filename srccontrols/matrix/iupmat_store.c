@@ -0,0 +1,641 @@
+/** \file
+ * \brief iupmatrix control
+ * compact storage of cells
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+/**************************************************************************/
+/*  The lines are stored in chunks of at most IMAT_STORE_CHUNK lines.     */
+/*  Inside a chunk the cells are stored by column, and each cell is an   */
+/*  offset in a pool of strings of its column plus a flags byte. Equal   */
+/*  strings in a column are stored only once. Adding or removing lines   */
+/*  moves only the lines of one chunk and the pointers to the chunks.    */
+/**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iup.h"
+#include "iupcbs.h"
+
+#include <cd.h>
+
+#include "iup_object.h"
+#include "iup_str.h"
+#include "iup_stdcontrols.h"
+
+#include "iupmat_def.h"
+#include "iupmat_store.h"
+
+
+#define IMAT_STORE_CHUNK 64              /* maximum number of lines in a chunk */
+#define IMAT_STORE_GARBAGE_MIN 4096      /* minimum size of the unused strings to rebuild a pool */
+
+typedef struct _ImatStoreChunk
+{
+  int first;              /* first line */
+  int count;              /* number of lines */
+  int* values;            /* offset of the value in the pool, 0 is NULL, [col*IMAT_STORE_CHUNK + line] */
+  unsigned char* flags;   /* same layout of values */
+} ImatStoreChunk;
+
+typedef struct _ImatStorePool
+{
+  char* data;             /* strings, each one preceded by its reference count */
+  int size, alloc;
+  int* hash;              /* offsets of the strings, 0 if empty */
+  int hash_mask, hash_count;
+  int garbage;            /* size of the strings not referenced */
+} ImatStorePool;
+
+struct _ImatStore
+{
+  ImatStoreChunk** chunks;
+  int chunk_count, chunk_alloc;
+  int num_lin;
+  int num_col, col_alloc;
+  ImatStorePool* pools;   /* one for each column */
+  int last;               /* last chunk found */
+};
+
+#define iMatrixStoreRef(_pool, _off) (*(int*)((_pool)->data + (_off) - sizeof(int)))
+
+
+/**************************************************************************/
+/*  Pool of strings                                                       */
+/**************************************************************************/
+
+static unsigned int iMatrixStoreHash(const char* str)
+{
+  unsigned int h = 2166136261u;
+  while (*str)
+  {
+    h ^= (unsigned char)*str++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static int iMatrixStoreEntrySize(const char* str)
+{
+  int len = (int)strlen(str) + 1;
+  return (int)sizeof(int) + ((len + (int)sizeof(int) - 1) & ~((int)sizeof(int) - 1));
+}
+
+static void iMatrixStorePoolHashInsert(ImatStorePool* pool, int off, unsigned int h)
+{
+  int i = h & pool->hash_mask;
+  while (pool->hash[i])
+    i = (i+1) & pool->hash_mask;
+  pool->hash[i] = off;
+  pool->hash_count++;
+}
+
+static void iMatrixStorePoolHashGrow(ImatStorePool* pool)
+{
+  int* old_hash = pool->hash;
+  int old_size = old_hash? pool->hash_mask+1: 0;
+  int size = old_size? 2*old_size: 64;
+  int i;
+
+  pool->hash = (int*)calloc(size, sizeof(int));
+  pool->hash_mask = size-1;
+  pool->hash_count = 0;
+
+  for (i = 0; i < old_size; i++)
+  {
+    if (old_hash[i])
+      iMatrixStorePoolHashInsert(pool, old_hash[i], iMatrixStoreHash(pool->data + old_hash[i]));
+  }
+
+  if (old_hash)
+    free(old_hash);
+}
+
+/* returns the offset of the string in the pool, with one more reference */
+static int iMatrixStorePoolAdd(ImatStorePool* pool, const char* str)
+{
+  unsigned int h = iMatrixStoreHash(str);
+  int off, size;
+
+  if (pool->hash)
+  {
+    int i = h & pool->hash_mask;
+    while ((off = pool->hash[i]) != 0)
+    {
+      if (strcmp(pool->data + off, str) == 0)
+      {
+        if (iMatrixStoreRef(pool, off) == 0)
+          pool->garbage -= iMatrixStoreEntrySize(str);
+        iMatrixStoreRef(pool, off)++;
+        return off;
+      }
+      i = (i+1) & pool->hash_mask;
+    }
+  }
+
+  if (!pool->hash || 2*(pool->hash_count+1) > pool->hash_mask+1)
+    iMatrixStorePoolHashGrow(pool);
+
+  size = iMatrixStoreEntrySize(str);
+  if (pool->size + size > pool->alloc)
+  {
+    int alloc = pool->alloc? 2*pool->alloc: 256;
+    while (pool->size + size > alloc)
+      alloc *= 2;
+    pool->data = (char*)realloc(pool->data, alloc);
+    pool->alloc = alloc;
+  }
+
+  off = pool->size + (int)sizeof(int);
+  memset(pool->data + pool->size, 0, size);
+  strcpy(pool->data + off, str);
+  iMatrixStoreRef(pool, off) = 1;
+  pool->size += size;
+
+  iMatrixStorePoolHashInsert(pool, off, h);
+  return off;
+}
+
+static void iMatrixStorePoolRelease(ImatStorePool* pool, int off)
+{
+  iMatrixStoreRef(pool, off)--;
+  if (iMatrixStoreRef(pool, off) == 0)
+    pool->garbage += iMatrixStoreEntrySize(pool->data + off);
+}
+
+static void iMatrixStorePoolFree(ImatStorePool* pool)
+{
+  if (pool->data) free(pool->data);
+  if (pool->hash) free(pool->hash);
+  memset(pool, 0, sizeof(ImatStorePool));
+}
+
+/* the strings that are not referenced are removed from the pool */
+static void iMatrixStorePoolRebuild(ImatStore* store, int col)
+{
+  ImatStorePool old_pool = store->pools[col];
+  ImatStorePool* pool = &(store->pools[col]);
+  int c, l;
+
+  memset(pool, 0, sizeof(ImatStorePool));
+
+  for (c = 0; c < store->chunk_count; c++)
+  {
+    int* values = store->chunks[c]->values + col*IMAT_STORE_CHUNK;
+    for (l = 0; l < store->chunks[c]->count; l++)
+    {
+      if (values[l])
+        values[l] = iMatrixStorePoolAdd(pool, old_pool.data + values[l]);
+    }
+  }
+
+  iMatrixStorePoolFree(&old_pool);
+}
+
+
+/**************************************************************************/
+/*  Chunks of lines                                                       */
+/**************************************************************************/
+
+static ImatStoreChunk* iMatrixStoreChunkCreate(ImatStore* store, int count)
+{
+  ImatStoreChunk* chunk = (ImatStoreChunk*)malloc(sizeof(ImatStoreChunk));
+  chunk->first = 0;
+  chunk->count = count;
+  chunk->values = (int*)calloc(store->col_alloc*IMAT_STORE_CHUNK, sizeof(int));
+  chunk->flags = (unsigned char*)calloc(store->col_alloc*IMAT_STORE_CHUNK, sizeof(unsigned char));
+  return chunk;
+}
+
+static void iMatrixStoreChunkDestroy(ImatStoreChunk* chunk)
+{
+  free(chunk->values);
+  free(chunk->flags);
+  free(chunk);
+}
+
+static void iMatrixStoreChunkRelease(ImatStore* store, ImatStoreChunk* chunk, int off, int count)
+{
+  int col, l;
+  for (col = 0; col < store->num_col; col++)
+  {
+    int* values = chunk->values + col*IMAT_STORE_CHUNK;
+    for (l = off; l < off+count; l++)
+    {
+      if (values[l])
+        iMatrixStorePoolRelease(&(store->pools[col]), values[l]);
+    }
+  }
+}
+
+/* copy lines between chunks, the destination lines must be free */
+static void iMatrixStoreChunkCopy(ImatStore* store, ImatStoreChunk* dst, int dst_off, ImatStoreChunk* src, int src_off, int count)
+{
+  int col;
+  for (col = 0; col < store->num_col; col++)
+  {
+    int pos = col*IMAT_STORE_CHUNK;
+    memcpy(dst->values + pos + dst_off, src->values + pos + src_off, count*sizeof(int));
+    memcpy(dst->flags + pos + dst_off, src->flags + pos + src_off, count*sizeof(unsigned char));
+  }
+}
+
+/* opens count empty lines at off, the chunk must have space for them */
+static void iMatrixStoreChunkOpen(ImatStore* store, ImatStoreChunk* chunk, int off, int count)
+{
+  int col, shift = chunk->count - off;
+  for (col = 0; col < store->num_col; col++)
+  {
+    int pos = col*IMAT_STORE_CHUNK + off;
+    memmove(chunk->values + pos + count, chunk->values + pos, shift*sizeof(int));
+    memmove(chunk->flags + pos + count, chunk->flags + pos, shift*sizeof(unsigned char));
+    memset(chunk->values + pos, 0, count*sizeof(int));
+    memset(chunk->flags + pos, 0, count*sizeof(unsigned char));
+  }
+  chunk->count += count;
+}
+
+/* removes count lines at off, their values must be already released */
+static void iMatrixStoreChunkClose(ImatStore* store, ImatStoreChunk* chunk, int off, int count)
+{
+  int col, shift = chunk->count - (off+count);
+  for (col = 0; col < store->num_col; col++)
+  {
+    int pos = col*IMAT_STORE_CHUNK;
+    memmove(chunk->values + pos + off, chunk->values + pos + off + count, shift*sizeof(int));
+    memmove(chunk->flags + pos + off, chunk->flags + pos + off + count, shift*sizeof(unsigned char));
+    memset(chunk->values + pos + chunk->count - count, 0, count*sizeof(int));
+    memset(chunk->flags + pos + chunk->count - count, 0, count*sizeof(unsigned char));
+  }
+  chunk->count -= count;
+}
+
+static void iMatrixStoreInsertChunks(ImatStore* store, int pos, int count)
+{
+  if (store->chunk_count + count > store->chunk_alloc)
+  {
+    store->chunk_alloc = 2*(store->chunk_count + count);
+    store->chunks = (ImatStoreChunk**)realloc(store->chunks, store->chunk_alloc*sizeof(ImatStoreChunk*));
+  }
+
+  memmove(store->chunks + pos + count, store->chunks + pos, (store->chunk_count - pos)*sizeof(ImatStoreChunk*));
+  store->chunk_count += count;
+}
+
+static void iMatrixStoreRemoveChunks(ImatStore* store, int pos, int count)
+{
+  memmove(store->chunks + pos, store->chunks + pos + count, (store->chunk_count - (pos + count))*sizeof(ImatStoreChunk*));
+  store->chunk_count -= count;
+}
+
+/* merge neighbor chunks that fit in one chunk, from c2 to c1 */
+static void iMatrixStoreMergeChunks(ImatStore* store, int c1, int c2)
+{
+  int c;
+
+  if (c1 < 0) c1 = 0;
+  if (c2 > store->chunk_count-2) c2 = store->chunk_count-2;
+
+  for (c = c2; c >= c1; c--)
+  {
+    ImatStoreChunk* chunk = store->chunks[c];
+    ImatStoreChunk* next = store->chunks[c+1];
+    if (chunk->count + next->count <= IMAT_STORE_CHUNK)
+    {
+      iMatrixStoreChunkCopy(store, chunk, chunk->count, next, 0, next->count);
+      chunk->count += next->count;
+      iMatrixStoreChunkDestroy(next);
+      iMatrixStoreRemoveChunks(store, c+1, 1);
+    }
+  }
+}
+
+static void iMatrixStoreUpdateFirst(ImatStore* store, int c)
+{
+  int first;
+
+  if (c < 0) c = 0;
+  if (c == 0)
+    first = 0;
+  else
+    first = store->chunks[c-1]->first + store->chunks[c-1]->count;
+
+  for (; c < store->chunk_count; c++)
+  {
+    store->chunks[c]->first = first;
+    first += store->chunks[c]->count;
+  }
+
+  store->last = 0;
+}
+
+static int iMatrixStoreFindChunk(ImatStore* store, int lin)
+{
+  int lo = 0, hi = store->chunk_count-1;
+  ImatStoreChunk* chunk;
+
+  /* usually the lines are accessed in sequence */
+  if (store->last < store->chunk_count)
+  {
+    chunk = store->chunks[store->last];
+    if (lin >= chunk->first && lin < chunk->first + chunk->count)
+      return store->last;
+  }
+
+  while (lo < hi)
+  {
+    int mid = (lo + hi + 1)/2;
+    if (store->chunks[mid]->first <= lin)
+      lo = mid;
+    else
+      hi = mid-1;
+  }
+
+  store->last = lo;
+  return lo;
+}
+
+
+/**************************************************************************/
+/*  Exported functions                                                    */
+/**************************************************************************/
+
+ImatStore* iupMatrixStoreCreate(int num_lin, int num_col)
+{
+  ImatStore* store = (ImatStore*)calloc(1, sizeof(ImatStore));
+
+  store->num_col = num_col;
+  store->col_alloc = num_col;
+  store->pools = (ImatStorePool*)calloc(store->col_alloc, sizeof(ImatStorePool));
+
+  iupMatrixStoreInsertLines(store, 0, num_lin);
+
+  return store;
+}
+
+void iupMatrixStoreDestroy(ImatStore* store)
+{
+  int c, col;
+
+  for (c = 0; c < store->chunk_count; c++)
+    iMatrixStoreChunkDestroy(store->chunks[c]);
+  if (store->chunks)
+    free(store->chunks);
+
+  for (col = 0; col < store->num_col; col++)
+    iMatrixStorePoolFree(&(store->pools[col]));
+  free(store->pools);
+
+  free(store);
+}
+
+char* iupMatrixStoreGetValue(ImatStore* store, int lin, int col)
+{
+  ImatStoreChunk* chunk = store->chunks[iMatrixStoreFindChunk(store, lin)];
+  int off = chunk->values[col*IMAT_STORE_CHUNK + lin - chunk->first];
+  if (off)
+    return iupStrGetMemoryCopy(store->pools[col].data + off);
+  else
+    return NULL;
+}
+
+void iupMatrixStoreSetValue(ImatStore* store, int lin, int col, const char* value)
+{
+  ImatStoreChunk* chunk = store->chunks[iMatrixStoreFindChunk(store, lin)];
+  ImatStorePool* pool = &(store->pools[col]);
+  int* cell_value = chunk->values + col*IMAT_STORE_CHUNK + lin - chunk->first;
+  int off = 0;
+
+  if (value)
+  {
+    /* the value can be a string of the pool, that can be reallocated */
+    if (value >= pool->data && value < pool->data + pool->size)
+    {
+      char* str = iupStrDup(value);
+      off = iMatrixStorePoolAdd(pool, str);
+      free(str);
+    }
+    else
+      off = iMatrixStorePoolAdd(pool, value);
+  }
+
+  if (*cell_value)
+    iMatrixStorePoolRelease(pool, *cell_value);
+  *cell_value = off;
+
+  if (pool->garbage > IMAT_STORE_GARBAGE_MIN && 2*pool->garbage > pool->size)
+    iMatrixStorePoolRebuild(store, col);
+}
+
+unsigned char* iupMatrixStoreGetFlags(ImatStore* store, int lin, int col)
+{
+  ImatStoreChunk* chunk = store->chunks[iMatrixStoreFindChunk(store, lin)];
+  return chunk->flags + col*IMAT_STORE_CHUNK + lin - chunk->first;
+}
+
+void iupMatrixStoreInsertLines(ImatStore* store, int base, int count)
+{
+  ImatStoreChunk* chunk = NULL;
+  int c = 0, off = 0;
+
+  if (count <= 0)
+    return;
+
+  if (store->chunk_count)
+  {
+    if (base >= store->num_lin)
+    {
+      c = store->chunk_count-1;
+      chunk = store->chunks[c];
+      off = chunk->count;
+    }
+    else
+    {
+      c = iMatrixStoreFindChunk(store, base);
+      chunk = store->chunks[c];
+      off = base - chunk->first;
+    }
+  }
+
+  if (chunk && chunk->count + count <= IMAT_STORE_CHUNK)
+    iMatrixStoreChunkOpen(store, chunk, off, count);
+  else
+  {
+    int pos, n, i;
+
+    if (!chunk || off == 0)
+      pos = c;     /* before the chunk */
+    else
+    {
+      if (off < chunk->count)
+      {
+        /* split the chunk at base */
+        ImatStoreChunk* tail = iMatrixStoreChunkCreate(store, chunk->count - off);
+        iMatrixStoreChunkCopy(store, tail, 0, chunk, off, tail->count);
+        iMatrixStoreChunkClose(store, chunk, off, tail->count);  /* values were moved, not released */
+        iMatrixStoreInsertChunks(store, c+1, 1);
+        store->chunks[c+1] = tail;
+      }
+      pos = c+1;   /* after the chunk */
+    }
+
+    n = (count + IMAT_STORE_CHUNK-1)/IMAT_STORE_CHUNK;
+    iMatrixStoreInsertChunks(store, pos, n);
+    for (i = 0; i < n; i++)
+      store->chunks[pos+i] = iMatrixStoreChunkCreate(store, i < n-1? IMAT_STORE_CHUNK: count - (n-1)*IMAT_STORE_CHUNK);
+
+    iMatrixStoreMergeChunks(store, pos-1, pos+n);
+    c = pos-1;
+  }
+
+  store->num_lin += count;
+  iMatrixStoreUpdateFirst(store, c);
+}
+
+void iupMatrixStoreRemoveLines(ImatStore* store, int base, int count)
+{
+  int c, first_c, removed = 0;
+
+  if (count <= 0)
+    return;
+
+  first_c = c = iMatrixStoreFindChunk(store, base);
+
+  while (removed < count)
+  {
+    ImatStoreChunk* chunk = store->chunks[c];
+    int off = base + removed - chunk->first;
+    int n = chunk->count - off;
+    if (n > count - removed)
+      n = count - removed;
+
+    iMatrixStoreChunkRelease(store, chunk, off, n);
+
+    if (n == chunk->count)
+    {
+      iMatrixStoreChunkDestroy(chunk);
+      store->chunks[c] = NULL;
+    }
+    else
+      iMatrixStoreChunkClose(store, chunk, off, n);
+
+    removed += n;
+    c++;
+  }
+
+  /* remove the pointers of the destroyed chunks */
+  {
+    int i, j = first_c;
+    for (i = first_c; i < c; i++)
+    {
+      if (store->chunks[i])
+        store->chunks[j++] = store->chunks[i];
+    }
+    iMatrixStoreRemoveChunks(store, j, c - j);
+  }
+
+  store->num_lin -= count;
+  iMatrixStoreMergeChunks(store, first_c-1, first_c+1);
+  iMatrixStoreUpdateFirst(store, first_c-1);
+
+  for (c = 0; c < store->num_col; c++)
+  {
+    ImatStorePool* pool = &(store->pools[c]);
+    if (pool->garbage > IMAT_STORE_GARBAGE_MIN && 2*pool->garbage > pool->size)
+      iMatrixStorePoolRebuild(store, c);
+  }
+}
+
+void iupMatrixStoreInsertColumns(ImatStore* store, int base, int count)
+{
+  int c, num = store->num_col + count;
+
+  if (count <= 0)
+    return;
+
+  if (num > store->col_alloc)
+  {
+    int old_alloc = store->col_alloc;
+    store->col_alloc = num;
+
+    for (c = 0; c < store->chunk_count; c++)
+    {
+      ImatStoreChunk* chunk = store->chunks[c];
+      chunk->values = (int*)realloc(chunk->values, store->col_alloc*IMAT_STORE_CHUNK*sizeof(int));
+      chunk->flags = (unsigned char*)realloc(chunk->flags, store->col_alloc*IMAT_STORE_CHUNK*sizeof(unsigned char));
+      memset(chunk->values + old_alloc*IMAT_STORE_CHUNK, 0, (store->col_alloc - old_alloc)*IMAT_STORE_CHUNK*sizeof(int));
+      memset(chunk->flags + old_alloc*IMAT_STORE_CHUNK, 0, (store->col_alloc - old_alloc)*IMAT_STORE_CHUNK*sizeof(unsigned char));
+    }
+
+    store->pools = (ImatStorePool*)realloc(store->pools, store->col_alloc*sizeof(ImatStorePool));
+    memset(store->pools + old_alloc, 0, (store->col_alloc - old_alloc)*sizeof(ImatStorePool));
+  }
+
+  /* shift the columns from base, the columns of a chunk are contiguous */
+  for (c = 0; c < store->chunk_count; c++)
+  {
+    ImatStoreChunk* chunk = store->chunks[c];
+    memmove(chunk->values + (base+count)*IMAT_STORE_CHUNK, chunk->values + base*IMAT_STORE_CHUNK, (store->num_col - base)*IMAT_STORE_CHUNK*sizeof(int));
+    memmove(chunk->flags + (base+count)*IMAT_STORE_CHUNK, chunk->flags + base*IMAT_STORE_CHUNK, (store->num_col - base)*IMAT_STORE_CHUNK*sizeof(unsigned char));
+    memset(chunk->values + base*IMAT_STORE_CHUNK, 0, count*IMAT_STORE_CHUNK*sizeof(int));
+    memset(chunk->flags + base*IMAT_STORE_CHUNK, 0, count*IMAT_STORE_CHUNK*sizeof(unsigned char));
+  }
+
+  memmove(store->pools + base + count, store->pools + base, (store->num_col - base)*sizeof(ImatStorePool));
+  memset(store->pools + base, 0, count*sizeof(ImatStorePool));
+
+  store->num_col = num;
+}
+
+void iupMatrixStoreRemoveColumns(ImatStore* store, int base, int count)
+{
+  int c, col, num = store->num_col - count;
+
+  if (count <= 0)
+    return;
+
+  /* the pools have only the strings of its column */
+  for (col = base; col < base+count; col++)
+    iMatrixStorePoolFree(&(store->pools[col]));
+
+  for (c = 0; c < store->chunk_count; c++)
+  {
+    ImatStoreChunk* chunk = store->chunks[c];
+    memmove(chunk->values + base*IMAT_STORE_CHUNK, chunk->values + (base+count)*IMAT_STORE_CHUNK, (num - base)*IMAT_STORE_CHUNK*sizeof(int));
+    memmove(chunk->flags + base*IMAT_STORE_CHUNK, chunk->flags + (base+count)*IMAT_STORE_CHUNK, (num - base)*IMAT_STORE_CHUNK*sizeof(unsigned char));
+    memset(chunk->values + num*IMAT_STORE_CHUNK, 0, count*IMAT_STORE_CHUNK*sizeof(int));
+    memset(chunk->flags + num*IMAT_STORE_CHUNK, 0, count*IMAT_STORE_CHUNK*sizeof(unsigned char));
+  }
+
+  memmove(store->pools + base, store->pools + base + count, (num - base)*sizeof(ImatStorePool));
+  memset(store->pools + num, 0, count*sizeof(ImatStorePool));
+
+  store->num_col = num;
+}
+
+size_t iupMatrixStoreGetMemory(ImatStore* store)
+{
+  size_t size = iupMATRIX_MEMBLOCK(sizeof(ImatStore));
+  int col;
+
+  if (store->chunks)
+    size += iupMATRIX_MEMBLOCK(store->chunk_alloc*sizeof(ImatStoreChunk*));
+  size += store->chunk_count*(iupMATRIX_MEMBLOCK(sizeof(ImatStoreChunk)) +
+                              iupMATRIX_MEMBLOCK(store->col_alloc*IMAT_STORE_CHUNK*sizeof(int)) +
+                              iupMATRIX_MEMBLOCK(store->col_alloc*IMAT_STORE_CHUNK*sizeof(unsigned char)));
+
+  size += iupMATRIX_MEMBLOCK(store->col_alloc*sizeof(ImatStorePool));
+  for (col = 0; col < store->num_col; col++)
+  {
+    ImatStorePool* pool = &(store->pools[col]);
+    if (pool->data)
+      size += iupMATRIX_MEMBLOCK(pool->alloc);
+    if (pool->hash)
+      size += iupMATRIX_MEMBLOCK((pool->hash_mask+1)*sizeof(int));
+  }
+
+  return size;
+}
@@ -0,0 +1,41 @@
+/** \file
+ * \brief iupmatrix. compact storage of cells.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#ifndef __IUPMAT_STORE_H
+#define __IUPMAT_STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Used instead of the cells array when COMPACTSTORAGE=Yes.
+   Lines are stored in chunks and the strings of each column in a pool without duplicates. */
+
+ImatStore* iupMatrixStoreCreate(int num_lin, int num_col);
+void iupMatrixStoreDestroy(ImatStore* store);
+
+/* Returns a copy in the transient string memory, the pool of the column moves when other cells are set */
+char* iupMatrixStoreGetValue(ImatStore* store, int lin, int col);
+void  iupMatrixStoreSetValue(ImatStore* store, int lin, int col, const char* value);
+unsigned char* iupMatrixStoreGetFlags(ImatStore* store, int lin, int col);
+
+void iupMatrixStoreInsertLines  (ImatStore* store, int base, int count);
+void iupMatrixStoreRemoveLines  (ImatStore* store, int base, int count);
+void iupMatrixStoreInsertColumns(ImatStore* store, int base, int count);
+void iupMatrixStoreRemoveColumns(ImatStore* store, int base, int count);
+
+/* Estimated number of bytes allocated */
+size_t iupMatrixStoreGetMemory(ImatStore* store);
+
+/* Estimated size of a memory block returned by malloc, including its header */
+#define iupMATRIX_MEMBLOCK(_size) (((size_t)(_size) + sizeof(size_t) + 15) & ~(size_t)15)
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
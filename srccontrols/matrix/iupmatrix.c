@@ -43,6 +43,7 @@
 #include "iupmat_mark.h"
 #include "iupmat_edit.h"
 #include "iupmat_draw.h"
+#include "iupmat_cache.h"
 
 
 int iupMatrixIsValid(Ihandle* ih, int check_cells)
@@ -302,6 +303,16 @@ static char* iMatrixGetCountAttrib(Ihandle* ih)
   return num;
 }
 
+static char* iMatrixGetMemoryUsageAttrib(Ihandle* ih)
+{
+  char* num;
+  if (!ih->handle || ih->data->callback_mode)
+    return NULL;
+  num = iupStrGetMemory(100);
+  sprintf(num, "%lu", (unsigned long)iupMatrixMemGetSize(ih));
+  return num;
+}
+
 static char* iMatrixGetNumLinAttrib(Ihandle* ih)
 {
   char* num = iupStrGetMemory(100);
@@ -946,7 +957,7 @@ static int iMatrixSetClearAttribAttrib(Ihandle* ih, int lin, int col, const char
       for (lin=0; lin<ih->data->lines.num; lin++)
       {
         for (col=0; col<ih->data->columns.num; col++)
-          iMatrixClearAttrib(ih, &(ih->data->cells[lin][col].flags), lin, col);
+          iMatrixClearAttrib(ih, iupMatrixMemGetFlags(ih, lin, col), lin, col);
       }
 
       /* all line attributes */
@@ -962,7 +973,7 @@ static int iMatrixSetClearAttribAttrib(Ihandle* ih, int lin, int col, const char
       for (lin=1; lin<ih->data->lines.num; lin++)
       {
         for (col=1; col<ih->data->columns.num; col++)
-          iMatrixClearAttrib(ih, &(ih->data->cells[lin][col].flags), lin, col);
+          iMatrixClearAttrib(ih, iupMatrixMemGetFlags(ih, lin, col), lin, col);
       }
     }
   }
@@ -983,7 +994,7 @@ static int iMatrixSetClearAttribAttrib(Ihandle* ih, int lin, int col, const char
         iMatrixClearAttrib(ih, &(ih->data->columns.flags[col]), IUP_INVALID_ID, col);
 
       for (lin=lin1; lin<=lin2; lin++)
-        iMatrixClearAttrib(ih, &(ih->data->cells[lin][col].flags), lin, col);
+        iMatrixClearAttrib(ih, iupMatrixMemGetFlags(ih, lin, col), lin, col);
     }
     else if (col==IUP_INVALID_ID)
     {
@@ -1000,7 +1011,7 @@ static int iMatrixSetClearAttribAttrib(Ihandle* ih, int lin, int col, const char
         iMatrixClearAttrib(ih, &(ih->data->lines.flags[lin]), lin, IUP_INVALID_ID);
 
       for (col=col1; col<=col2; col++)
-        iMatrixClearAttrib(ih, &(ih->data->cells[lin][col].flags), lin, col);
+        iMatrixClearAttrib(ih, iupMatrixMemGetFlags(ih, lin, col), lin, col);
     }
     else
     {
@@ -1029,7 +1040,7 @@ static int iMatrixSetClearAttribAttrib(Ihandle* ih, int lin, int col, const char
       for (lin=lin1; lin<=lin2; lin++)
       {
         for (col=col1; col<=col2; col++)
-          iMatrixClearAttrib(ih, &(ih->data->cells[lin][col].flags), lin, col);
+          iMatrixClearAttrib(ih, iupMatrixMemGetFlags(ih, lin, col), lin, col);
       }
     }
   }
@@ -1052,11 +1063,7 @@ static int iMatrixSetClearValueAttrib(Ihandle* ih, int lin, int col, const char*
       for (lin=0; lin<ih->data->lines.num; lin++)
       {
         for (col=0; col<ih->data->columns.num; col++)
-        {
-          if (ih->data->cells[lin][col].value)
-            free(ih->data->cells[lin][col].value);
-          ih->data->cells[lin][col].value = NULL;
-        }
+          iupMatrixMemSetValue(ih, lin, col, NULL);
       }
     }
     else if (iupStrEqualNoCase(value, "CONTENTS"))
@@ -1064,11 +1071,7 @@ static int iMatrixSetClearValueAttrib(Ihandle* ih, int lin, int col, const char*
       for (lin=1; lin<ih->data->lines.num; lin++)
       {
         for (col=1; col<ih->data->columns.num; col++)
-        {
-          if (ih->data->cells[lin][col].value)
-            free(ih->data->cells[lin][col].value);
-          ih->data->cells[lin][col].value = NULL;
-        }
+          iupMatrixMemSetValue(ih, lin, col, NULL);
       }
     }
   }
@@ -1085,11 +1088,7 @@ static int iMatrixSetClearValueAttrib(Ihandle* ih, int lin, int col, const char*
         return 0;
 
       for (lin=lin1; lin<=lin2; lin++)
-      {
-        if (ih->data->cells[lin][col].value)
-          free(ih->data->cells[lin][col].value);
-        ih->data->cells[lin][col].value = NULL;
-      }
+        iupMatrixMemSetValue(ih, lin, col, NULL);
     }
     else if (col==IUP_INVALID_ID)
     {
@@ -1102,11 +1101,7 @@ static int iMatrixSetClearValueAttrib(Ihandle* ih, int lin, int col, const char*
         return 0;
 
       for (col=col1; col<=col2; col++)
-      {
-        if (ih->data->cells[lin][col].value)
-          free(ih->data->cells[lin][col].value);
-        ih->data->cells[lin][col].value = NULL;
-      }
+        iupMatrixMemSetValue(ih, lin, col, NULL);
     }
     else
     {
@@ -1123,11 +1118,7 @@ static int iMatrixSetClearValueAttrib(Ihandle* ih, int lin, int col, const char*
       for (lin=lin1; lin<=lin2; lin++)
       {
         for (col=col1; col<=col2; col++)
-        {
-          if (ih->data->cells[lin][col].value)
-            free(ih->data->cells[lin][col].value);
-          ih->data->cells[lin][col].value = NULL;
-        }
+          iupMatrixMemSetValue(ih, lin, col, NULL);
       }
     }
   }
@@ -1138,12 +1129,38 @@ static int iMatrixSetClearValueAttrib(Ihandle* ih, int lin, int col, const char*
   return 0;
 }
 
+static int iMatrixSetBeginUpdateAttrib(Ihandle* ih, const char* value)
+{
+  ih->data->update_count++;
+  (void)value;
+  return 0;
+}
+
+static int iMatrixSetEndUpdateAttrib(Ihandle* ih, const char* value)
+{
+  if (ih->data->update_count > 0)
+    ih->data->update_count--;
+
+  /* draw and display at once all the changes since BEGINUPDATE */
+  if (ih->data->update_count == 0 && ih->data->cddbuffer)
+    iupMatrixDrawDirty(ih, 1);
+
+  (void)value;
+  return 0;
+}
+
 static int iMatrixSetFlagsAttrib(Ihandle* ih, int lin, int col, const char* value, unsigned char attr)
 {
   if (lin >= 0 || col >= 0)
   {
     iupMatrixCellSetFlag(ih, lin, col, attr, value!=NULL);
-    ih->data->need_redraw = 1;
+
+    if (lin == IUP_INVALID_ID)
+      iupMatrixDrawSetDirty(ih, 0, col, ih->data->lines.num-1, col);
+    else if (col == IUP_INVALID_ID)
+      iupMatrixDrawSetDirty(ih, lin, 0, lin, ih->data->columns.num-1);
+    else
+      iupMatrixDrawSetDirty(ih, lin, col, lin, col);
   }
   return 1;
 }
@@ -1368,6 +1385,8 @@ static int iMatrixRedraw_CB(Ihandle* ih)
       ih->data->need_redraw ||  /* if some of the attributes that do not automatically redraw were set */
       ih->data->need_calcsize)   /* if something changed the matrix size */
     iupMatrixDraw(ih, 0);
+  else
+    iupMatrixDrawDirty(ih, 0);  /* only the cells changed by attributes */
 
   iupMatrixDrawUpdate(ih);
 
@@ -1437,12 +1456,16 @@ static int iMatrixMapMethod(Ihandle* ih)
   /* this can fail if canvas size is zero */
   ih->data->cddbuffer = cdCreateCanvas(CD_DBUFFER, ih->data->cdcanvas);
 
-  if (IupGetCallback(ih, "VALUE_CB"))
+  if (IupGetCallback(ih, "VALUE_CB") || IupGetCallback(ih, "VALUEBLOCK_CB"))
   {
     ih->data->callback_mode = 1;
 
     if (!IupGetCallback(ih, "VALUE_EDIT_CB"))
       iupAttribSetStr(ih, "READONLY", "YES");
+
+    /* virtual mode, values are obtained by blocks of lines */
+    if (IupGetCallback(ih, "VALUEBLOCK_CB"))
+      iupMatrixCacheCreate(ih);
   }
 
   iupMatrixMemAlloc(ih);
@@ -1467,6 +1490,7 @@ static void iMatrixUnMapMethod(Ihandle* ih)
   }
 
   iupMatrixMemRelease(ih);
+  iupMatrixCacheDestroy(ih);
 }
 
 static int iMatrixGetNaturalWidth(Ihandle* ih, int *full_width)
@@ -1649,6 +1673,7 @@ Iclass* iupMatrixNewClass(void)
   /* --- Callback Mode --- */
   iupClassRegisterCallback(ic, "VALUE_CB", "ii=s");
   iupClassRegisterCallback(ic, "VALUE_EDIT_CB", "iis");
+  iupClassRegisterCallback(ic, "VALUEBLOCK_CB", "iiiiv");
   iupClassRegisterCallback(ic, "MARK_CB", "ii");
   iupClassRegisterCallback(ic, "MARKEDIT_CB", "iii");
 
@@ -1683,6 +1708,8 @@ Iclass* iupMatrixNewClass(void)
 
   /* IupMatrix Attributes - SIZE */
   iupClassRegisterAttribute(ic, "COUNT", iMatrixGetCountAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "MEMORYUSAGE", iMatrixGetMemoryUsageAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "COMPACTSTORAGE", NULL, NULL, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "NUMLIN", iMatrixGetNumLinAttrib, iupMatrixSetNumLinAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "NUMCOL", iMatrixGetNumColAttrib, iupMatrixSetNumColAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "NUMLIN_NOSCROLL", iMatrixGetNumLinNoScrollAttrib, iMatrixSetNumLinNoScrollAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
@@ -1723,6 +1750,8 @@ Iclass* iupMatrixNewClass(void)
   iupClassRegisterAttribute(ic, "EDIT_MODE", iMatrixGetEditModeAttrib, iMatrixSetEditModeAttrib, NULL, NULL, IUPAF_NO_SAVE|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "EDITNEXT", iMatrixGetEditNextAttrib, iMatrixSetEditNextAttrib, IUPAF_SAMEASSYSTEM, "LIN", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "REDRAW", NULL, iupMatrixDrawSetRedrawAttrib, NULL, NULL, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "BEGINUPDATE", NULL, iMatrixSetBeginUpdateAttrib, NULL, NULL, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "ENDUPDATE", NULL, iMatrixSetEndUpdateAttrib, NULL, NULL, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "CLEARVALUE", NULL, iMatrixSetClearValueAttrib, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "CLEARATTRIB", NULL, iMatrixSetClearAttribAttrib, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
 
@@ -12,6 +12,7 @@
 #include <errno.h>
 
 #include "ledc.h"
+#include "../src/iup_ledbin.h"
 
 #define alloc(type)  ((type*)malloc(sizeof(type)))
 
@@ -24,6 +25,7 @@ char *outname = 0;
 char *funcname = 0;
 int   nocode = 0;
 int   static_image = 0;
+int   binary = 0;
 
 typedef struct {
   char* name;
@@ -33,6 +35,7 @@ typedef struct {
 static Tlist* all_names;
 static Tlist* all_elems;
 static Tlist* all_images;
+static Tlist* all_decls;
 
 static Tlist* all_named;
 static Tlist* all_late;
@@ -832,7 +835,11 @@ void decl( Telem* e )
   else
   {
     if (nerrors || nocode) return;
-    if (e->elemidx == IMAGE || e->elemidx == IMAGERGB || e->elemidx == IMAGERGBA)
+    if (binary)
+    {
+      addlist( all_decls, e );  /* images and controls in the declaration order */
+    }
+    else if (e->elemidx == IMAGE || e->elemidx == IMAGERGB || e->elemidx == IMAGERGBA)
     {
       code_image( e );
       addlist( all_images, e );
@@ -886,25 +893,284 @@ Tparam** list2paramvector( Tlist* params )
     return 0;
 }
 
+/****************************************************************/
+/* Binary LED, see iup_ledbin.h */
+
+typedef struct {
+  char* data;
+  int size, max;
+} Tbuffer;
+
+static Tbuffer bin_pool;      /* zero terminated strings */
+static Tbuffer bin_strings;   /* int, offset of each string in the pool */
+static Tbuffer bin_classes;   /* int, string index of each class name */
+static Tbuffer bin_elems;     /* IledbElem */
+static Tbuffer bin_params;    /* IledbParam */
+static Tbuffer bin_attribs;   /* IledbAttrib */
+static Tbuffer bin_data;      /* int size followed by the image data, aligned to int */
+
+static int* bin_hash = 0;     /* string index+1, 0 is empty */
+static int  bin_hash_size = 0;
+
+static void bufadd( Tbuffer* b, const void* data, int size )
+{
+  if (b->size + size > b->max)
+  {
+    b->max = (b->size + size)*2 + 256;
+    b->data = (char*)realloc( b->data, b->max );
+  }
+  memcpy( b->data + b->size, data, size );
+  b->size += size;
+}
+
+static void bufaddint( Tbuffer* b, int i )
+{
+  bufadd( b, &i, sizeof(int) );
+}
+
+static void bufalign( Tbuffer* b )
+{
+  static const char zeros[sizeof(int)] = { 0 };
+  if (b->size % sizeof(int))
+    bufadd( b, zeros, sizeof(int) - b->size % sizeof(int) );
+}
+
+static unsigned int bin_hashstr( const char* str )
+{
+  unsigned int h = 0;
+  while (*str) h = h*31 + (unsigned char)*str++;
+  return h;
+}
+
+static const char* bin_string( int index )
+{
+  return bin_pool.data + ((int*)bin_strings.data)[index];
+}
+
+static void bin_hashadd( int index )
+{
+  unsigned int h = bin_hashstr( bin_string(index) ) & (bin_hash_size-1);
+  while (bin_hash[h]) h = (h+1) & (bin_hash_size-1);
+  bin_hash[h] = index+1;
+}
+
+/* returns the index of the string, each string is stored only once */
+static int bin_intern( const char* str )
+{
+  int count = bin_strings.size / sizeof(int);
+  unsigned int h;
+
+  if ((count+1)*2 > bin_hash_size)
+  {
+    int i;
+    bin_hash_size = bin_hash_size? bin_hash_size*2: 256;
+    free( bin_hash );
+    bin_hash = (int*)calloc( bin_hash_size, sizeof(int) );
+    for (i=0; i<count; i++)
+      bin_hashadd( i );
+  }
+
+  h = bin_hashstr( str ) & (bin_hash_size-1);
+  while (bin_hash[h])
+  {
+    if (!strcmp( bin_string(bin_hash[h]-1), str ))
+      return bin_hash[h]-1;
+    h = (h+1) & (bin_hash_size-1);
+  }
+
+  bufaddint( &bin_strings, bin_pool.size );
+  bufadd( &bin_pool, str, (int)strlen(str)+1 );
+  bin_hash[h] = count+1;
+  return count;
+}
+
+/* same escapes of the LED lexer in IupLoad */
+static int bin_intern_escaped( const char* str )
+{
+  int index;
+  char* ret = (char*)malloc( strlen(str)+1 );
+  char* p = ret;
+  while (*str)
+  {
+    if (*str == '\\' && str[1])
+    {
+      str++;
+      *p++ = (*str == 'n')? '\n': *str;
+      str++;
+    }
+    else
+      *p++ = *str++;
+  }
+  *p = 0;
+  index = bin_intern( ret );
+  free( ret );
+  return index;
+}
+
+static int bin_class( const char* name )
+{
+  int i, count = bin_classes.size / sizeof(int);
+  int index = bin_intern( name );
+  for (i=0; i<count; i++)
+  {
+    if (((int*)bin_classes.data)[i] == index)
+      return i;
+  }
+  bufaddint( &bin_classes, index );
+  return count;
+}
+
+static void bin_param( int type, int value )
+{
+  IledbParam p;
+  p.type = type;
+  p.value = value;
+  bufadd( &bin_params, &p, sizeof(IledbParam) );
+}
+
+/* children are written before their parent, returns the element index */
+static int bin_elem( Telem* e )
+{
+  IledbElem be;
+  int i, *children = 0;
+
+  if (e->nparams)
+  {
+    children = (int*)malloc( e->nparams*sizeof(int) );
+    for (i=0; i<e->nparams; i++)
+    {
+      if (e->params[i]->tag == ELEM_PARAM)
+        children[i] = bin_elem( e->params[i]->data.elem );
+    }
+  }
+
+  be.class_index = bin_class( e->elemname );
+  be.name = e->name? bin_intern( e->name ): -1;
+  be.first_param = bin_params.size / sizeof(IledbParam);
+
+  if (e->elemidx == IMAGE || e->elemidx == IMAGERGB || e->elemidx == IMAGERGBA)
+  {
+    int size = e->data.image.w*e->data.image.h*e->data.image.d;
+    bin_param( IUPLEDB_PARAM_NAME, bin_intern( e->params[0]->data.name ) );
+    bin_param( IUPLEDB_PARAM_NAME, bin_intern( e->params[1]->data.name ) );
+    bin_param( IUPLEDB_PARAM_DATA, bin_data.size );
+    bufaddint( &bin_data, size );
+    for (i=0; i<size; i++)
+    {
+      unsigned char c = (unsigned char)atoi( e->params[i+2]->data.name );
+      bufadd( &bin_data, &c, 1 );
+    }
+    bufalign( &bin_data );
+  }
+  else
+  {
+    for (i=0; i<e->nparams; i++)
+    {
+      switch (e->params[i]->tag)
+      {
+        case ELEM_PARAM:
+          bin_param( IUPLEDB_PARAM_ELEM, children[i] );
+          break;
+        case NAME_PARAM:
+          bin_param( IUPLEDB_PARAM_NAME, bin_intern_escaped( e->params[i]->data.name ) );
+          break;
+        case STRING_PARAM:
+          bin_param( IUPLEDB_PARAM_STRING, bin_intern_escaped( e->params[i]->data.name ) );
+          break;
+      }
+    }
+  }
+  be.param_count = bin_params.size / sizeof(IledbParam) - be.first_param;
+
+  be.first_attrib = bin_attribs.size / sizeof(IledbAttrib);
+  if (e->attrs)
+  {
+    Telemlist *p = e->attrs->first;
+    while (p)
+    {
+      IledbAttrib a;
+      a.name = bin_intern_escaped( ((Tattr*)(p->data))->name );
+      a.value = bin_intern_escaped( ((Tattr*)(p->data))->value );
+      bufadd( &bin_attribs, &a, sizeof(IledbAttrib) );
+      p = p->next;
+    }
+  }
+  be.attrib_count = bin_attribs.size / sizeof(IledbAttrib) - be.first_attrib;
+
+  if (children) free( children );
+
+  bufadd( &bin_elems, &be, sizeof(IledbElem) );
+  return bin_elems.size / sizeof(IledbElem) - 1;
+}
+
+static void bin_finish(void)
+{
+  IledbHeader h;
+  Telemlist *p;
+  int offset;
+
+  revertlist( all_decls );
+  p = all_decls->first;
+  while (p)
+  {
+    bin_elem( (Telem*)(p->data) );
+    p = p->next;
+  }
+
+  memset( &h, 0, sizeof(IledbHeader) );
+  memcpy( h.signature, IUPLEDB_SIGNATURE, 8 );
+  h.version = IUPLEDB_VERSION;
+  h.byte_order = IUPLEDB_BYTEORDER;
+
+  offset = sizeof(IledbHeader);
+  h.string_count = bin_strings.size / sizeof(int);
+  h.string_offset = offset;  offset += bin_strings.size;
+  h.class_count = bin_classes.size / sizeof(int);
+  h.class_offset = offset;   offset += bin_classes.size;
+  h.elem_count = bin_elems.size / sizeof(IledbElem);
+  h.elem_offset = offset;    offset += bin_elems.size;
+  h.param_count = bin_params.size / sizeof(IledbParam);
+  h.param_offset = offset;   offset += bin_params.size;
+  h.attrib_count = bin_attribs.size / sizeof(IledbAttrib);
+  h.attrib_offset = offset;  offset += bin_attribs.size;
+  h.data_size = bin_data.size;
+  h.data_offset = offset;    offset += bin_data.size;
+  h.pool_size = bin_pool.size;
+  h.pool_offset = offset;    offset += bin_pool.size;
+  h.size = offset;
+
+  fwrite( &h, sizeof(IledbHeader), 1, outfile );
+  fwrite( bin_strings.data, 1, bin_strings.size, outfile );
+  fwrite( bin_classes.data, 1, bin_classes.size, outfile );
+  fwrite( bin_elems.data, 1, bin_elems.size, outfile );
+  fwrite( bin_params.data, 1, bin_params.size, outfile );
+  fwrite( bin_attribs.data, 1, bin_attribs.size, outfile );
+  fwrite( bin_data.data, 1, bin_data.size, outfile );
+  fwrite( bin_pool.data, 1, bin_pool.size, outfile );
+}
+
 
 void init(void)
 {
   all_names = list();
   all_elems = list();
   all_images = list();
+  all_decls = list();
   all_named = list();
   all_late = list();
 
   if (nocode) return;
   outfile = stdout;
 
-  outfile = fopen( outname, "w" );
+  outfile = fopen( outname, binary? "wb": "w" );
   if (!outfile) 
   {
     perror( outname );
     exit(-1);
   }
 
+  if (binary) return;
+
   fprintf( outfile,
     "/*   Automatically generated by Iup 3 LED Compiler to C.   */\n"
     "\n"
@@ -924,8 +1190,23 @@ void finish(void)
   int i;
   Telemlist *p;
 
+  if (nerrors && binary && !nocode)
+  {
+    /* do not leave an incomplete binary file to be loaded by IupLoad */
+    fclose( outfile );
+    remove( outname );
+    exit(-1);
+  }
+
   if (nerrors || nocode) return;
 
+  if (binary)
+  {
+    bin_finish();
+    fclose( outfile );
+    return;
+  }
+
   for (i=1; i<nheaders; i++)
   {
     if (headerfile[i].used)
@@ -106,11 +106,12 @@ void yyerror(char *str)
 static int usage(void)
 {
   fprintf( stderr, 
-    "ledc [-v] [-c] [-f funcname] [-o file] files\n"
+    "ledc [-v] [-c] [-b] [-f funcname] [-o file] files\n"
     "  -v            print the version number\n"
     "  -c            only perform checking, do not generate code\n"
+    "  -b            generate a binary LED file, loaded with IupLoad, instead of C code\n"
     "  -f funcname   generate exported function <funcname> (default: led_load)\n"
-    "  -o file       place output in file <file> (default: led.c)\n"
+    "  -o file       place output in file <file> (default: led.c or led.ledb)\n"
   );
   return -1;
 }
@@ -155,12 +156,15 @@ int main(int argc, char *argv[])
       case 'c':
         nocode = 1;
         break;
+      case 'b':
+        binary = 1;
+        break;
       default:
         return usage();
     }
   }
 
-  if (!outname)  outname  = "led.c";
+  if (!outname)  outname  = binary? "led.ledb": "led.c";
   if (!funcname) funcname = "led_load";
 
   init();
@@ -179,6 +179,7 @@ function write_initialization(o,t)
       if i == "action" or 
          i == "action_cb" or 
          i == "edit_cb" or 
+         i == "value_cb" or 
          i == "mousemove_cb" then
         type = '"'..string.lower(o)..'"'
       end
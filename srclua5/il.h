@@ -137,6 +137,16 @@ int* iuplua_checkint_array(lua_State *L, int pos, int count);
  If count is 0, table size is used. Else table size must match count. */
 float* iuplua_checkfloat_array(lua_State *L, int pos, int count);
 
+/** Returns an array of float stored in a Lua table, in a string of packed floats or in a light userdata.
+ Only the table is copied, the string and the light userdata are used directly.
+ If count is 0, table size or string size is used. Else table size must match count, 
+ and string size must be at least count floats. For light userdata count must be given.
+ The array must be released with iuplua_freefloat_data. */
+float* iuplua_checkfloat_data(lua_State *L, int pos, int count);
+
+/** Releases an array returned by iuplua_checkfloat_data. */
+void iuplua_freefloat_data(lua_State *L, int pos, float* data);
+
 /** Returns an array of unsigned char stored in a Lua table.
  If count is 0, table size is used. Else table size must match count. */
 unsigned char* iuplua_checkuchar_array(lua_State *L, int pos, int count);
@@ -51,6 +51,29 @@ static int list_multiselect_cb(Ihandle *self, char * p0)
   return iuplua_call(L, 1);
 }
 
+static char * list_value_cb(Ihandle *self, int p0)
+{
+  lua_State *L = iuplua_call_start(self, "value_cb");
+  lua_pushinteger(L, p0);
+  return iuplua_call_rs(L, 1);
+}
+
+static char * list_image_cb(Ihandle *self, int p0)
+{
+  lua_State *L = iuplua_call_start(self, "image_cb");
+  lua_pushinteger(L, p0);
+  return iuplua_call_rs(L, 1);
+}
+
+static int list_selectrange_cb(Ihandle *self, int p0, int p1, int p2)
+{
+  lua_State *L = iuplua_call_start(self, "selectrange_cb");
+  lua_pushinteger(L, p0);
+  lua_pushinteger(L, p1);
+  lua_pushinteger(L, p2);
+  return iuplua_call(L, 3);
+}
+
 static int List(lua_State *L)
 {
   Ihandle *ih = IupList(NULL);
@@ -68,6 +91,9 @@ int iuplistlua_open(lua_State * L)
   iuplua_register_cb(L, "DBLCLICK_CB", (lua_CFunction)list_dblclick_cb, NULL);
   iuplua_register_cb(L, "EDIT_CB", (lua_CFunction)list_edit_cb, "list");
   iuplua_register_cb(L, "MULTISELECT_CB", (lua_CFunction)list_multiselect_cb, NULL);
+  iuplua_register_cb(L, "VALUE_CB", (lua_CFunction)list_value_cb, "list");
+  iuplua_register_cb(L, "IMAGE_CB", (lua_CFunction)list_image_cb, NULL);
+  iuplua_register_cb(L, "SELECTRANGE_CB", (lua_CFunction)list_selectrange_cb, NULL);
 
 #ifdef IUPLUA_USELOH
 #include "list.loh"
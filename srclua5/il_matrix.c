@@ -213,7 +213,7 @@ int iupmatrixlua_open(lua_State * L)
   iuplua_register_cb(L, "MARK_CB", (lua_CFunction)matrix_mark_cb, NULL);
   iuplua_register_cb(L, "MARKEDIT_CB", (lua_CFunction)matrix_markedit_cb, NULL);
   iuplua_register_cb(L, "BGCOLOR_CB", (lua_CFunction)matrix_bgcolor_cb, NULL);
-  iuplua_register_cb(L, "VALUE_CB", (lua_CFunction)matrix_value_cb, NULL);
+  iuplua_register_cb(L, "VALUE_CB", (lua_CFunction)matrix_value_cb, "matrix");
   iuplua_register_cb(L, "DROPSELECT_CB", (lua_CFunction)matrix_dropselect_cb, NULL);
   iuplua_register_cb(L, "DROP_CB", (lua_CFunction)matrix_drop_cb, NULL);
   iuplua_register_cb(L, "DROPCHECK_CB", (lua_CFunction)matrix_dropcheck_cb, NULL);
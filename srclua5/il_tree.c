@@ -75,6 +75,13 @@ static int tree_branchclose_cb(Ihandle *self, int p0)
   return iuplua_call(L, 1);
 }
 
+static int tree_branchpopulate_cb(Ihandle *self, int p0)
+{
+  lua_State *L = iuplua_call_start(self, "branchpopulate_cb");
+  lua_pushinteger(L, p0);
+  return iuplua_call(L, 1);
+}
+
 static int tree_executeleaf_cb(Ihandle *self, int p0)
 {
   lua_State *L = iuplua_call_start(self, "executeleaf_cb");
@@ -118,6 +125,7 @@ int iuptreelua_open(lua_State * L)
   iuplua_register_cb(L, "RIGHTCLICK_CB", (lua_CFunction)tree_rightclick_cb, NULL);
   iuplua_register_cb(L, "MULTISELECTION_CB", (lua_CFunction)tree_multiselection_cb, NULL);
   iuplua_register_cb(L, "BRANCHCLOSE_CB", (lua_CFunction)tree_branchclose_cb, NULL);
+  iuplua_register_cb(L, "BRANCHPOPULATE_CB", (lua_CFunction)tree_branchpopulate_cb, NULL);
   iuplua_register_cb(L, "EXECUTELEAF_CB", (lua_CFunction)tree_executeleaf_cb, NULL);
   iuplua_register_cb(L, "SHOWRENAME_CB", (lua_CFunction)tree_showrename_cb, NULL);
   iuplua_register_cb(L, "NODEREMOVED_CB", (lua_CFunction)tree_noderemoved_cb, NULL);
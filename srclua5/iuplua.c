@@ -248,10 +248,15 @@ void iuplua_pushihandle(lua_State *L, Ihandle *ih)
     lua_pushnil(L);
 }
 
+static void il_cache_release(lua_State *L, Ihandle* ih);
+
 static int il_destroy_cb(Ihandle* ih)
 {
   /* called from IupDestroy. */
   char* sref = IupGetAttribute(ih, "_IUPLUA_WIDGET_TABLE_REF");
+
+  il_cache_release(iuplua_getstate(ih), ih);
+
   if (sref)
   {
     lua_State *L = iuplua_getstate(ih);
@@ -344,14 +349,45 @@ float* iuplua_checkfloat_array(lua_State *L, int pos, int n)
   v = (float *) malloc (n*sizeof(float));
   for(i=1; i<=n; i++)
   {
-    lua_pushinteger(L,i);
-    lua_gettable(L,pos);
+    lua_rawgeti(L,pos,i);
     v[i-1] = (float)lua_tonumber(L, -1);
     lua_pop(L,1);
   }
   return v;
 }
 
+float* iuplua_checkfloat_data(lua_State *L, int pos, int n)
+{
+  switch (lua_type(L, pos))
+  {
+  case LUA_TSTRING:
+    {
+      /* packed floats, used without a copy */
+      size_t size;
+      const char* data = lua_tolstring(L, pos, &size);
+      if (n==0) 
+        n = (int)(size/sizeof(float));
+      else if (size < n*sizeof(float))
+        luaL_argerror(L, pos, "Invalid number of elements (size<count).");
+      if (n<=0) luaL_argerror(L, pos, "Invalid number of elements (n<=0).");
+      return (float*)data;
+    }
+  case LUA_TLIGHTUSERDATA:
+    /* buffer owned by the application, must have at least count elements */
+    if (n<=0) luaL_argerror(L, pos, "Invalid number of elements (n<=0).");
+    return (float*)lua_touserdata(L, pos);
+  default:
+    return iuplua_checkfloat_array(L, pos, n);
+  }
+}
+
+void iuplua_freefloat_data(lua_State *L, int pos, float* data)
+{
+  /* only the data from a table was copied */
+  if (lua_istable(L, pos))
+    free(data);
+}
+
 unsigned char* iuplua_checkuchar_array(lua_State *L, int pos, int n)
 {
   int i;
@@ -420,9 +456,150 @@ lua_State* iuplua_getstate(Ihandle *ih)
   return (lua_State *) IupGetAttribute(ih, "_IUPLUA_STATE_CONTEXT");
 }
 
+             /*************************************/
+             /*         callback cache            */
+
+/* When a Lua function is set as a callback of an element,
+   a reference to it is kept in the element, together with a reference to
+   an userdata of the element that is created only once.
+   So the callback can be called without iup.CallMethod,
+   that needs a new userdata for the element and a lookup in the widget table for each call.
+   Callbacks set as strings are still called using iup.CallMethod. */
+
+typedef struct _IluaCallback
+{
+  char* name;  /* in lower case, as in iuplua_call_start */
+  int ref;     /* reference to the Lua function */
+} IluaCallback;
+
+typedef struct _IluaCallbackCache
+{
+  int handle_ref;  /* reference to the userdata of the element */
+  int call_ref;    /* reference to il_call_function */
+  int count;
+  IluaCallback* callbacks;
+} IluaCallbackCache;
+
+/* il_call_function(lua_func, handle, ...)
+   Used in place of iup.CallMethod(name, handle, ...), so the stack has the same layout. */
+static int il_call_function(lua_State *L)
+{
+  lua_call(L, lua_gettop(L)-1, LUA_MULTRET);
+  return lua_gettop(L);
+}
+
+static int il_cache_find(IluaCallbackCache* cache, const char* name)
+{
+  int i;
+  for (i = 0; i < cache->count; i++)
+  {
+    if (strcmp(cache->callbacks[i].name, name) == 0)
+      return i;
+  }
+  return -1;
+}
+
+static void il_cache_remove(lua_State *L, Ihandle* ih, const char* name)
+{
+  IluaCallbackCache* cache = (IluaCallbackCache*)IupGetAttribute(ih, "_IUPLUA_CALLBACK_CACHE");
+  char lname[100];
+  int i;
+
+  if (!cache || strlen(name) >= sizeof(lname))
+    return;
+
+  iupStrLower(lname, name);
+  i = il_cache_find(cache, lname);
+  if (i == -1)
+    return;
+
+  luaL_unref(L, LUA_REGISTRYINDEX, cache->callbacks[i].ref);
+  free(cache->callbacks[i].name);
+
+  cache->count--;
+  cache->callbacks[i] = cache->callbacks[cache->count];
+}
+
+/* the element is at "pos" and the Lua function at the top of the stack */
+static void il_cache_set(lua_State *L, Ihandle* ih, int pos, const char* name)
+{
+  IluaCallbackCache* cache = (IluaCallbackCache*)IupGetAttribute(ih, "_IUPLUA_CALLBACK_CACHE");
+  char lname[100];
+  int i;
+
+  if (strlen(name) >= sizeof(lname))
+  {
+    lua_pop(L, 1);
+    return;
+  }
+
+  if (!cache)
+  {
+    cache = (IluaCallbackCache*)calloc(1, sizeof(IluaCallbackCache));
+
+    lua_pushvalue(L, pos);
+    cache->handle_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    lua_pushcfunction(L, il_call_function);
+    cache->call_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    IupSetAttribute(ih, "_IUPLUA_CALLBACK_CACHE", (char*)cache);
+    IupSetCallback(ih, "LDESTROY_CB", il_destroy_cb);
+  }
+
+  iupStrLower(lname, name);
+  i = il_cache_find(cache, lname);
+  if (i == -1)
+  {
+    i = cache->count;
+    cache->count++;
+    cache->callbacks = (IluaCallback*)realloc(cache->callbacks, cache->count*sizeof(IluaCallback));
+    cache->callbacks[i].name = iupStrDup(lname);
+  }
+  else
+    luaL_unref(L, LUA_REGISTRYINDEX, cache->callbacks[i].ref);
+
+  cache->callbacks[i].ref = luaL_ref(L, LUA_REGISTRYINDEX);  /* pops the function */
+}
+
+static void il_cache_release(lua_State *L, Ihandle* ih)
+{
+  IluaCallbackCache* cache = (IluaCallbackCache*)IupGetAttribute(ih, "_IUPLUA_CALLBACK_CACHE");
+  int i;
+
+  if (!cache)
+    return;
+
+  for (i = 0; i < cache->count; i++)
+  {
+    luaL_unref(L, LUA_REGISTRYINDEX, cache->callbacks[i].ref);
+    free(cache->callbacks[i].name);
+  }
+  if (cache->callbacks)
+    free(cache->callbacks);
+
+  luaL_unref(L, LUA_REGISTRYINDEX, cache->handle_ref);
+  luaL_unref(L, LUA_REGISTRYINDEX, cache->call_ref);
+  free(cache);
+
+  IupSetAttribute(ih, "_IUPLUA_CALLBACK_CACHE", NULL);
+}
+
 lua_State* iuplua_call_start(Ihandle *ih, const char* name)
 {
   lua_State *L = iuplua_getstate(ih);
+  IluaCallbackCache* cache = (IluaCallbackCache*)IupGetAttribute(ih, "_IUPLUA_CALLBACK_CACHE");
+  if (cache)
+  {
+    int i = il_cache_find(cache, name);
+    if (i != -1)
+    {
+      /* prepare to call il_call_function(lua_func, handle, ...) */
+      lua_rawgeti(L, LUA_REGISTRYINDEX, cache->call_ref);
+      lua_rawgeti(L, LUA_REGISTRYINDEX, cache->callbacks[i].ref);
+      lua_rawgeti(L, LUA_REGISTRYINDEX, cache->handle_ref);
+      return L;
+    }
+  }
 
   /* prepare to call iup.CallMethod(name, handle, ...) */
   lua_getglobal(L, "iup");
@@ -526,6 +703,14 @@ static int SetCallback(lua_State *L)
 
   /* lua_func, when not nil, has always the same name of a C callback in lowercase */
 
+  if (lua_isfunction(L, 4) && !iupStrBoolean(IupGetGlobal("IUPLUA_CALLMETHOD")))
+  {
+    lua_pushvalue(L, 4);
+    il_cache_set(L, ih, 1, name);
+  }
+  else
+    il_cache_remove(L, ih, name);
+
   return 0;
 }
 
@@ -536,6 +536,37 @@ static int ListDialog(lua_State *L)
   return 1;
 }
 
+/* iup.ListAppendItems(ih, items)
+   Appends all the items of a table to an IupList with a single call. */
+static int ListAppendItems(lua_State *L)
+{
+  Ihandle *ih = iuplua_checkihandle(L,1);
+  int i, n, count;
+
+  luaL_checktype(L, 2, LUA_TTABLE);
+  n = iuplua_getn(L, 2);
+  count = IupGetInt(ih, "COUNT");
+
+  for (i=1; i<=n; i++)
+  {
+    const char* item;
+    lua_rawgeti(L, 2, i);
+    item = lua_tostring(L, -1);
+    if (item)
+    {
+      if (ih->handle)
+        IupStoreAttribute(ih, "APPENDITEM", item);
+      else  /* APPENDITEM works only after map */
+        IupStoreAttributeId(ih, "", count+1, item);
+      count++;
+    }
+    lua_pop(L, 1);
+  }
+
+  lua_pushinteger(L, IupGetInt(ih, "COUNT"));
+  return 1;
+}
+
 static int GetText(lua_State *L)
 {
   char buffer[10240];
@@ -1006,6 +1037,7 @@ void iupluaapi_open(lua_State * L)
     {"Message", Message},
     {"Alarm", Alarm},  
     {"ListDialog", ListDialog},
+    {"ListAppendItems", ListAppendItems},
     {"GetText", GetText},
     {"NextField", NextField},
     {"Popup", Popup},
@@ -4,6 +4,9 @@
  * See Copyright Notice in "iup.h"
  */
 
+#include <stdio.h>
+#include <string.h>
+
 #include <lua.h>
 #include <lauxlib.h>
 
@@ -131,11 +134,120 @@ static int MatStoreAttribute(lua_State *L)
   return 0;
 }
 
+/* The format must have a single conversion for a double (e, E, f, g or G),
+   with optional flags, width and precision of up to 2 digits, and "%%" anywhere.
+   So the formatted value always fits in MatSetBlock buffer. */
+#define MATSETBLOCK_FORMAT_MAX 50
+#define MATSETBLOCK_VALUE_MAX 512
+
+static int iMatCheckFormat(const char* format)
+{
+  int count = 0, n;
+
+  if (strlen(format) > MATSETBLOCK_FORMAT_MAX)
+    return 0;
+
+  while (*format)
+  {
+    if (*format++ != '%')
+      continue;
+
+    if (*format == '%')
+    {
+      format++;
+      continue;
+    }
+
+    while (*format && strchr("-+ #0", *format))
+      format++;
+
+    for (n = 0; *format >= '0' && *format <= '9'; n++)
+      format++;
+    if (n > 2)
+      return 0;
+
+    if (*format == '.')
+    {
+      format++;
+      for (n = 0; *format >= '0' && *format <= '9'; n++)
+        format++;
+      if (n > 2)
+        return 0;
+    }
+
+    if (!*format || !strchr("eEfgG", *format))
+      return 0;
+    format++;
+    count++;
+  }
+
+  return count == 1;
+}
+
+/* iup.MatSetBlock(ih, lin, col, num_lin, num_col, data[, format])
+   Sets the values of a block of cells, line by line. 
+   data can be a table of numbers or strings, a string of packed floats or a light userdata with floats. 
+   The cells are redrawn only once. */
+static int MatSetBlock(lua_State *L)
+{
+  Ihandle *ih = iuplua_checkihandle(L,1);
+  int lin1 = luaL_checkint(L,2);
+  int col1 = luaL_checkint(L,3);
+  int num_lin = luaL_checkint(L,4);
+  int num_col = luaL_checkint(L,5);
+  const char* format = luaL_optstring(L,7,"%g");
+  int lin, col, i = 0;
+  float* data = NULL;
+  char value[MATSETBLOCK_VALUE_MAX];
+
+  if (num_lin<=0 || num_col<=0) 
+    luaL_argerror(L, 4, "Invalid block size (num_lin<=0 or num_col<=0).");
+
+  if (!iMatCheckFormat(format))
+    luaL_argerror(L, 7, "Invalid format (must have a single %e, %f or %g conversion).");
+
+  if (!lua_istable(L,6))
+    data = iuplua_checkfloat_data(L, 6, num_lin*num_col);
+  else if (iuplua_getn(L, 6) != num_lin*num_col)
+    luaL_argerror(L, 6, "Invalid number of elements (n!=num_lin*num_col).");
+
+  IupSetAttribute(ih, "BEGINUPDATE", NULL);
+
+  for (lin = lin1; lin < lin1+num_lin; lin++)
+  {
+    for (col = col1; col < col1+num_col; col++)
+    {
+      if (data)
+      {
+        sprintf(value, format, (double)data[i]);
+        IupStoreAttributeId2(ih, "", lin, col, value);
+      }
+      else
+      {
+        lua_rawgeti(L, 6, i+1);
+        if (lua_type(L, -1) == LUA_TNUMBER)
+        {
+          sprintf(value, format, (double)lua_tonumber(L, -1));
+          IupStoreAttributeId2(ih, "", lin, col, value);
+        }
+        else
+          IupStoreAttributeId2(ih, "", lin, col, lua_tostring(L, -1));
+        lua_pop(L, 1);
+      }
+      i++;
+    }
+  }
+
+  IupSetAttribute(ih, "ENDUPDATE", NULL);
+  return 0;
+}
+
 void iuplua_matrixfuncs_open (lua_State *L)
 {
   iuplua_register(L, MatGetAttribute, "MatGetAttribute");
   iuplua_register(L, MatStoreAttribute, "MatStoreAttribute");
   iuplua_register(L, MatStoreAttribute, "MatSetAttribute");
+  iuplua_register(L, MatSetBlock, "MatSetBlock");
 
   iuplua_register_cb(L, "BGCOLOR_CB", (lua_CFunction)matrix_bgcolor_cb, NULL);
   iuplua_register_cb(L, "FGCOLOR_CB", (lua_CFunction)matrix_fgcolor_cb, NULL);
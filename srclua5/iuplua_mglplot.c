@@ -85,10 +85,10 @@ static int PlotInsert1D(lua_State *L)
   char* *px;
   int count = luaL_checkint(L, 6);
   px = iuplua_checkstring_array(L, 4, count);
-  py = iuplua_checkfloat_array(L, 5, count);
+  py = iuplua_checkfloat_data(L, 5, count);
   IupMglPlotInsert1D(iuplua_checkihandle(L,1), luaL_checkint(L,2), luaL_checkint(L,3), px, py, count);
   free(px);
-  free(py);
+  iuplua_freefloat_data(L, 5, py);
   return 0;
 }
 
@@ -96,11 +96,11 @@ static int PlotInsert2D(lua_State *L)
 {
   float *px, *py;
   int count = luaL_checkint(L, 6);
-  px = iuplua_checkfloat_array(L, 4, count);
-  py = iuplua_checkfloat_array(L, 5, count);
+  px = iuplua_checkfloat_data(L, 4, count);
+  py = iuplua_checkfloat_data(L, 5, count);
   IupMglPlotInsert2D(iuplua_checkihandle(L,1), luaL_checkint(L,2), luaL_checkint(L,3), px, py, count);
-  free(px);
-  free(py);
+  iuplua_freefloat_data(L, 4, px);
+  iuplua_freefloat_data(L, 5, py);
   return 0;
 }
 
@@ -108,13 +108,13 @@ static int PlotInsert3D(lua_State *L)
 {
   float *px, *py, *pz;
   int count = luaL_checkint(L, 7);
-  px = iuplua_checkfloat_array(L, 4, count);
-  py = iuplua_checkfloat_array(L, 5, count);
-  pz = iuplua_checkfloat_array(L, 6, count);
+  px = iuplua_checkfloat_data(L, 4, count);
+  py = iuplua_checkfloat_data(L, 5, count);
+  pz = iuplua_checkfloat_data(L, 6, count);
   IupMglPlotInsert3D(iuplua_checkihandle(L,1), luaL_checkint(L,2), luaL_checkint(L,3), px, py, pz, count);
-  free(px);
-  free(py);
-  free(pz);
+  iuplua_freefloat_data(L, 4, px);
+  iuplua_freefloat_data(L, 5, py);
+  iuplua_freefloat_data(L, 6, pz);
   return 0;
 }
 
@@ -124,10 +124,10 @@ static int PlotSet1D(lua_State *L)
   char* *px;
   int count = luaL_checkint(L, 5);
   px = iuplua_checkstring_array(L, 3, count);
-  py = iuplua_checkfloat_array(L, 4, count);
+  py = iuplua_checkfloat_data(L, 4, count);
   IupMglPlotSet1D(iuplua_checkihandle(L,1), luaL_checkint(L,2), px, py, count);
   free(px);
-  free(py);
+  iuplua_freefloat_data(L, 4, py);
   return 0;
 }
 
@@ -135,11 +135,11 @@ static int PlotSet2D(lua_State *L)
 {
   float *px, *py;
   int count = luaL_checkint(L, 5);
-  px = iuplua_checkfloat_array(L, 3, count);
-  py = iuplua_checkfloat_array(L, 4, count);
+  px = iuplua_checkfloat_data(L, 3, count);
+  py = iuplua_checkfloat_data(L, 4, count);
   IupMglPlotSet2D(iuplua_checkihandle(L,1), luaL_checkint(L,2), px, py, count);
-  free(px);
-  free(py);
+  iuplua_freefloat_data(L, 3, px);
+  iuplua_freefloat_data(L, 4, py);
   return 0;
 }
 
@@ -147,13 +147,13 @@ static int PlotSet3D(lua_State *L)
 {
   float *px, *py, *pz;
   int count = luaL_checkint(L, 6);
-  px = iuplua_checkfloat_array(L, 3, count);
-  py = iuplua_checkfloat_array(L, 4, count);
-  pz = iuplua_checkfloat_array(L, 5, count);
+  px = iuplua_checkfloat_data(L, 3, count);
+  py = iuplua_checkfloat_data(L, 4, count);
+  pz = iuplua_checkfloat_data(L, 5, count);
   IupMglPlotSet3D(iuplua_checkihandle(L,1), luaL_checkint(L,2), px, py, pz, count);
-  free(px);
-  free(py);
-  free(pz);
+  iuplua_freefloat_data(L, 3, px);
+  iuplua_freefloat_data(L, 4, py);
+  iuplua_freefloat_data(L, 5, pz);
   return 0;
 }
 
@@ -180,9 +180,9 @@ static int PlotSetData(lua_State *L)
   int count_x = luaL_checkint(L,4), 
       count_y = luaL_checkint(L,5), 
       count_z = luaL_checkint(L,6);
-  float* data = iuplua_checkfloat_array(L, 3, count_x*count_y*count_z);
+  float* data = iuplua_checkfloat_data(L, 3, count_x*count_y*count_z);
   IupMglPlotSetData(iuplua_checkihandle(L,1), luaL_checkint(L,2), data, count_x, count_y, count_z);
-  free(data);
+  iuplua_freefloat_data(L, 3, data);
   return 0;
 }
 
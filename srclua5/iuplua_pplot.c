@@ -66,6 +66,13 @@ static int PlotBegin(lua_State *L)
   return 0;
 }
 
+static int PlotBeginRing(lua_State *L)
+{
+  Ihandle *ih = iuplua_checkihandle(L,1);
+  IupPPlotBeginRing(ih, luaL_checkint(L,2));
+  return 0;
+}
+
 static int PlotAdd(lua_State *L)
 {
   Ihandle *ih = iuplua_checkihandle(L,1);
@@ -106,11 +113,11 @@ static int PlotInsertPoints(lua_State *L)
 {
   float *px, *py;
   int count = luaL_checkint(L, 6);
-  px = iuplua_checkfloat_array(L, 4, count);
-  py = iuplua_checkfloat_array(L, 5, count);
+  px = iuplua_checkfloat_data(L, 4, count);
+  py = iuplua_checkfloat_data(L, 5, count);
   IupPPlotInsertPoints(iuplua_checkihandle(L,1), luaL_checkint(L,2), luaL_checkint(L,3), px, py, count);
-  free(px);
-  free(py);
+  iuplua_freefloat_data(L, 4, px);
+  iuplua_freefloat_data(L, 5, py);
   return 0;
 }
 
@@ -120,10 +127,10 @@ static int PlotInsertStrPoints(lua_State *L)
   char* *px;
   int count = luaL_checkint(L, 6);
   px = iuplua_checkstring_array(L, 4, count);
-  py = iuplua_checkfloat_array(L, 5, count);
+  py = iuplua_checkfloat_data(L, 5, count);
   IupPPlotInsertStrPoints(iuplua_checkihandle(L,1), luaL_checkint(L,2), luaL_checkint(L,3), px, py, count);
   free(px);
-  free(py);
+  iuplua_freefloat_data(L, 5, py);
   return 0;
 }
 
@@ -131,11 +138,11 @@ static int PlotAddPoints(lua_State *L)
 {
   float *px, *py;
   int count = luaL_checkint(L, 5);
-  px = iuplua_checkfloat_array(L, 3, count);
-  py = iuplua_checkfloat_array(L, 4, count);
+  px = iuplua_checkfloat_data(L, 3, count);
+  py = iuplua_checkfloat_data(L, 4, count);
   IupPPlotAddPoints(iuplua_checkihandle(L,1), luaL_checkint(L,2), px, py, count);
-  free(px);
-  free(py);
+  iuplua_freefloat_data(L, 3, px);
+  iuplua_freefloat_data(L, 4, py);
   return 0;
 }
 
@@ -145,10 +152,10 @@ static int PlotAddStrPoints(lua_State *L)
   char* *px;
   int count = luaL_checkint(L, 5);
   px = iuplua_checkstring_array(L, 3, count);
-  py = iuplua_checkfloat_array(L, 4, count);
+  py = iuplua_checkfloat_data(L, 4, count);
   IupPPlotAddStrPoints(iuplua_checkihandle(L,1), luaL_checkint(L,2), px, py, count);
   free(px);
-  free(py);
+  iuplua_freefloat_data(L, 4, py);
   return 0;
 }
 
@@ -176,6 +183,7 @@ void iuplua_pplotfuncs_open (lua_State *L)
   iuplua_register_cb(L, "POSTDRAW_CB", (lua_CFunction)pplot_postdraw_cb, NULL);
 
   iuplua_register(L, PlotBegin       ,"PPlotBegin");
+  iuplua_register(L, PlotBeginRing   ,"PPlotBeginRing");
   iuplua_register(L, PlotAdd         ,"PPlotAdd");
   iuplua_register(L, PlotAddStr      ,"PPlotAddStr");
   iuplua_register(L, PlotEnd         ,"PPlotEnd");
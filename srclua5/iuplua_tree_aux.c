@@ -4,6 +4,8 @@
  * See Copyright Notice in "iup.h"
  */
 
+#include <stdlib.h>
+
 #include <lua.h>
 #include <lauxlib.h>
 
@@ -138,6 +140,21 @@ static int TreeSetUserId(lua_State *L)
   return 0;
 }
 
+static int TreeAddNodeList(lua_State *L)
+{
+  Ihandle *ih = iuplua_checkihandle(L,1);
+  const char* kind = luaL_checkstring(L,2);
+  int id = luaL_checkint(L,3);
+  char** titles = iuplua_checkstring_array(L, 4, 0);
+  int first_id = IupTreeAddNodeList(ih, kind, id, (const char**)titles, iuplua_getn(L,4));
+  free(titles);
+  if (first_id == -1)
+    lua_pushnil(L);
+  else
+    lua_pushinteger(L, first_id);
+  return 1;
+}
+
 static int tree_multiselection_cb(Ihandle *ih, int* ids, int p1)
 {
   int i;
@@ -196,4 +213,6 @@ void iuplua_treefuncs_open (lua_State *L)
   iuplua_register(L, TreeGetId, "TreeGetTableId");
   iuplua_register(L, TreeGetUserId, "TreeGetTable");
   iuplua_register(L, TreeSetUserId, "TreeSetTableId");
+
+  iuplua_register(L, TreeAddNodeList, "TreeAddNodeList");
 }
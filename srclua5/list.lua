@@ -11,6 +11,9 @@ local ctrl = {
      edit_cb = "ns",
      dropdown_cb = "n",
      dblclick_cb = "ns",
+     value_cb = {"n", ret = "s"},
+     image_cb = {"n", ret = "s"},
+     selectrange_cb = "nnn",
    }
 } 
 
@@ -11,6 +11,7 @@ local ctrl = {
     multiunselection_cb = "nn",  -- fake definition to be replaced by treefuncs module
     branchopen_cb = "n",
     branchclose_cb = "n",
+    branchpopulate_cb = "n",
     executeleaf_cb = "n",
     noderemoved_cb = "s",  -- fake definition to be replaced by treefuncs module
     rename_cb = "ns",
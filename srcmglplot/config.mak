@@ -22,6 +22,12 @@ ifneq ($(findstring cygw, $(TEC_UNAME)), )
   LIBS = freetype-6 fontconfig
 endif
 
+ifeq ($(findstring Win, $(TEC_SYSNAME)), )
+  # multithreaded Z-buffer drawing
+  DEFINES += HAVE_PTHREAD
+  LIBS += pthread
+endif
+
 LIBS := iup iupgl $(LIBS)
 
 SRCFTGL = ftgl/FTGlyph/FTGlyph.cpp ftgl/FTFont/FTFont.cpp \
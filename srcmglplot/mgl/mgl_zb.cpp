@@ -18,6 +18,14 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 #include <stdlib.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#if !defined(MGL_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2))
+#define MGL_USE_SSE2
+#include <emmintrin.h>
+#endif
 #include "mgl/mgl_zb.h"
 #include "mgl/mgl_c.h"
 #include "mgl/mgl_f.h"
@@ -28,11 +36,82 @@
 
 //#define MGL_SIMPLE_LINE
 //-----------------------------------------------------------------------------
+mglThread::mglThread()	{	z=0;	p=0;	v=0;	id=0;	n=0;	res=0;	}
+mglThread::~mglThread()	{}
+//-----------------------------------------------------------------------------
+mreal mglStartThread(void *(*func)(void *), mreal (*fres)(mreal,mreal), int n, mreal *z, long *p, void *v)
+{
+	if(!func)	return 0;
+	register int i, nt = mglNumThr>1 ? mglNumThr:1;
+	mglThread *par = new mglThread[nt];
+	for(i=0;i<nt;i++)
+	{	par[i].z=z;	par[i].p=p;	par[i].v=v;	par[i].n=n;	par[i].id=i;	}
+#ifdef HAVE_PTHREAD
+	if(nt>1)
+	{
+		pthread_t *tmp = new pthread_t[nt];
+		for(i=0;i<nt;i++)	pthread_create(tmp+i, 0, func, par+i);
+		for(i=0;i<nt;i++)	pthread_join(tmp[i], 0);
+		delete []tmp;
+	}
+	else
+#endif
+	for(i=0;i<nt;i++)	func(par+i);
+	mreal res = par[0].res;
+	if(fres)	for(i=1;i<nt;i++)	res = fres(res, par[i].res);
+	delete []par;
+	return res;
+}
+//-----------------------------------------------------------------------------
 mglGraphZB::mglGraphZB(int w,int h) : mglGraphAB(w,h)
-{	FastNoFace = true;	C = 0;	SetSize(w,h);	}
+{
+#ifdef HAVE_PTHREAD
+	if(mglNumThr<1)
+	{
+		long nc = sysconf(_SC_NPROCESSORS_ONLN);
+		mglNumThr = nc>1 ? int(nc) : MGL_NTH_DEF;
+	}
+#endif
+	FastNoFace = true;	UseSimd = true;	C = 0;	Tile = 0;	TileNum = 0;	TileTransp = 0;
+	SetSize(w,h);
+}
 //-----------------------------------------------------------------------------
 mglGraphZB::~mglGraphZB()
-{	if(C)	{	delete []C;	delete []Z;	}	}
+{	if(C)	{	delete []C;	delete []Z;	}	tile_free();	}
+//-----------------------------------------------------------------------------
+void mglGraphZB::tile_free()
+{
+	if(!Tile)	return;
+	for(long i=0;i<TileNx*TileNy;i++)	if(Tile[i].pnt)	free(Tile[i].pnt);
+	delete []Tile;	Tile = 0;	TileNum = 0;
+}
+//-----------------------------------------------------------------------------
+void *mgl_thr_tile(void *p)
+{
+	mglThread *t=(mglThread *)p;
+	mglGraphZB *gr=(mglGraphZB *)t->v;
+	register long i,j,k;
+	int nt = mglNumThr>1 ? mglNumThr:1;
+	// rows of tiles are interleaved between threads, each tile is owned by one thread only
+	for(j=t->id;j<gr->TileNy;j+=nt)	for(i=0;i<gr->TileNx;i++)
+	{
+		mglZBTile *tl = gr->Tile+i+gr->TileNx*j;
+		for(k=0;k<tl->num;k++)	// keep the drawing order of points inside pixel
+		{
+			mglZBPoint *pt = tl->pnt+k;
+			gr->pnt_fill(pt->i0,pt->z,pt->c,pt->id,pt->face);
+		}
+		tl->num = 0;
+	}
+	return 0;
+}
+//-----------------------------------------------------------------------------
+void mglGraphZB::pnt_flush()
+{
+	if(!TileNum)	return;
+	mglStartThread(mgl_thr_tile,0,TileNy,0,0,this);
+	TileNum = 0;
+}
 //-----------------------------------------------------------------------------
 void mglGraphAB::SetDrawReg(int nx, int ny, int m)
 {
@@ -47,6 +126,7 @@ void mglGraphZB::PutDrawReg(int nx, int ny, int m, mglGraphAB *g)
 {
 	mglGraphZB *gr=dynamic_cast<mglGraphZB *>(g);
 	if(!gr)	return;
+	pnt_flush();	gr->pnt_flush();
 	int mx = m%nx, my = m/nx, x1, x2, y1, y2;
 	x1 = Width*mx/nx;		y1 = Height-Height*(my+1)/ny;
 	x2 = Width*(mx+1)/nx;	y2 = Height-Height*my/ny;
@@ -63,9 +143,9 @@ void mglGraphZB::pnt_plot(long x,long y,mreal z,unsigned char ci[4])
 {
 	long i0=x+Width*(Height-1-y);
 	if(x<nx1 || x>=nx2 || y<ny1 || y>=ny2)	return;
-	unsigned char *cc = C+32*i0, c[4];
+	unsigned char c[4];
 	memcpy(c,ci,4);
-	mreal *zz = Z+8*i0, zf = FogDist*(z/Depth-0.5-FogDz);
+	mreal zf = FogDist*(z/Depth-0.5-FogDz);
 	if(zf<0)
 	{
 		int d = int(255.f-255.f*exp(5.f*zf));
@@ -73,7 +153,38 @@ void mglGraphZB::pnt_plot(long x,long y,mreal z,unsigned char ci[4])
 		if(d==255)	return;
 		combine(c,cb);
 	}
-	if(DrawFace || !FastNoFace)
+	bool face = DrawFace || !FastNoFace;
+	if(mglNumThr<2)	// points queued before the threads were disabled are drawn first
+	{	if(TileNum)	pnt_flush();	pnt_fill(i0,z,c,ObjId,face);	return;	}
+
+	// bin the point in its tile, tiles are drawn in parallel later
+	if(TileNum && TileTransp!=TranspType)	pnt_flush();
+	TileTransp = TranspType;
+	if(!Tile)
+	{
+		TileNx = (Width+MGL_ZB_TILE-1)/MGL_ZB_TILE;
+		TileNy = (Height+MGL_ZB_TILE-1)/MGL_ZB_TILE;
+		Tile = new mglZBTile[TileNx*TileNy];
+		memset(Tile,0,TileNx*TileNy*sizeof(mglZBTile));
+	}
+	mglZBTile *tl = Tile + x/MGL_ZB_TILE + TileNx*((Height-1-y)/MGL_ZB_TILE);
+	if(tl->num==tl->max)
+	{
+		tl->max = tl->max ? 2*tl->max : 256;
+		tl->pnt = (mglZBPoint *)realloc(tl->pnt,tl->max*sizeof(mglZBPoint));
+	}
+	mglZBPoint *pt = tl->pnt + tl->num;
+	pt->i0 = i0;	pt->z = z;	pt->id = ObjId;	pt->face = face;
+	memcpy(pt->c,c,4);
+	tl->num++;	TileNum++;
+	if(TileNum>=MGL_ZB_MAXPNT)	pnt_flush();
+}
+//-----------------------------------------------------------------------------
+void mglGraphZB::pnt_fill(long i0,mreal z,unsigned char c[4],int id,bool face)
+{
+	unsigned char *cc = C+32*i0;
+	mreal *zz = Z+8*i0;
+	if(face)
 	{
 #ifdef MGL_ABUF_8
 		if(z>zz[3])
@@ -93,7 +204,7 @@ void mglGraphZB::pnt_plot(long x,long y,mreal z,unsigned char ci[4])
 				zz[2] = zz[1];	memcpy(cc+8,cc+4,4);
 				if(z>zz[0])	// shift point on slice down and paste new point
 				{
-					zz[1] = zz[0];	zz[0] = z;	OI[i0]=ObjId;
+					zz[1] = zz[0];	zz[0] = z;	OI[i0]=id;
 					memcpy(cc+4,cc,4);	memcpy(cc,c,4);
 				}
 				else	// shift point on slice down and paste new point
@@ -167,16 +278,146 @@ void mglGraphZB::pnt_plot(long x,long y,mreal z,unsigned char ci[4])
 	else
 	{
 		if(z>zz[0])	// point upper the background
-		{	zz[0]=z;	memcpy(cc,c,4);		OI[i0]=ObjId;	}
+		{	zz[0]=z;	memcpy(cc,c,4);		OI[i0]=id;	}
 	}
 }
 //-----------------------------------------------------------------------------
+void *mgl_thr_ffin(void *p)
+{
+	mglThread *t=(mglThread *)p;
+	mglGraphZB *gr=(mglGraphZB *)t->v;
+	long nt = mglNumThr>1 ? mglNumThr:1;
+	gr->finish_rows(t->n*t->id/nt, t->n*(t->id+1)/nt);
+	return 0;
+}
+//-----------------------------------------------------------------------------
 void mglGraphZB::Finish()
+{
+	pnt_flush();
+	if(mglNumThr>1)	mglStartThread(mgl_thr_ffin,0,Height,0,0,this);
+	else	finish_rows(0,Height);
+	Finished = true;
+}
+//-----------------------------------------------------------------------------
+#ifdef MGL_USE_SSE2
+/// Same as mglGraphAB::combine() for 2 pixels in 16-bit lanes
+static inline __m128i mgl_combine_sse2(__m128i c1, __m128i c2, int tt)
+{
+	const __m128i zero = _mm_setzero_si128(), v255 = _mm_set1_epi16(255);
+	const __m128i amask = _mm_set_epi16(-1,0,0,0,-1,0,0,0);	// alpha lanes
+	__m128i a1 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c1,0xFF),0xFF);
+	__m128i a2 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c2,0xFF),0xFF);
+	__m128i skip = _mm_cmpeq_epi16(a2,zero);
+	__m128i copy = _mm_or_si128(_mm_cmpeq_epi16(a1,zero), _mm_cmpeq_epi16(a2,v255));
+	__m128i col, alf, t;
+	if(tt==0)
+	{
+		__m128i b1 = _mm_sub_epi16(v255,a2);
+		col = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(c1,b1), _mm_mullo_epi16(c2,a2)),8);
+		t = _mm_mullo_epi16(a1,b1);		// t/255 = (t+1+t/256)/256 for t<=255*255
+		t = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(t,_mm_set1_epi16(1)), _mm_srli_epi16(t,8)),8);
+		alf = _mm_add_epi16(a2,t);
+	}
+	else if(tt==1)
+	{
+		__m128i t1 = _mm_sub_epi16(v255, _mm_srli_epi16(_mm_mullo_epi16(a1,_mm_sub_epi16(v255,c1)),8));
+		__m128i t2 = _mm_sub_epi16(v255, _mm_srli_epi16(_mm_mullo_epi16(a2,_mm_sub_epi16(v255,c2)),8));
+		col = _mm_srli_epi16(_mm_mullo_epi16(t1,t2),8);
+		alf = v255;
+	}
+	else
+	{	// saturated sum gives 255 after the shift, as the clamp
+		col = _mm_srli_epi16(_mm_adds_epu16(_mm_mullo_epi16(c1,a1), _mm_mullo_epi16(c2,a2)),8);
+		alf = _mm_min_epi16(_mm_add_epi16(a1,a2),v255);
+	}
+	t = _mm_or_si128(_mm_andnot_si128(amask,col), _mm_and_si128(amask,alf));
+	t = _mm_or_si128(_mm_and_si128(copy,c2), _mm_andnot_si128(copy,t));
+	return _mm_or_si128(_mm_and_si128(skip,c1), _mm_andnot_si128(skip,t));
+}
+//-----------------------------------------------------------------------------
+/// Combine 4 pixels in bytes
+static inline __m128i mgl_combine4_sse2(__m128i c1, __m128i c2, int tt)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i lo = mgl_combine_sse2(_mm_unpacklo_epi8(c1,zero), _mm_unpacklo_epi8(c2,zero), tt);
+	__m128i hi = mgl_combine_sse2(_mm_unpackhi_epi8(c1,zero), _mm_unpackhi_epi8(c2,zero), tt);
+	return _mm_packus_epi16(lo,hi);
+}
+//-----------------------------------------------------------------------------
+/// Store RGB of 4 pixels
+static inline void mgl_store_rgb_sse2(unsigned char *g, __m128i c)
+{
+	unsigned char t[16];
+	_mm_storeu_si128((__m128i *)t, c);
+	memcpy(g,t,3);	memcpy(g+3,t+4,3);	memcpy(g+6,t+8,3);	memcpy(g+9,t+12,3);
+}
+//-----------------------------------------------------------------------------
+/// Prepare final picture for 4 pixels at once, returns the first pixel that was not done
+static long mgl_finish_sse2(const unsigned char *C, unsigned char *G4, unsigned char *G, long i1, long i2, const unsigned char BDef[4], int tt, bool face)
+{
+	register long i;
+	unsigned char alf=tt!=2 ? 0:255;
+	unsigned char b0[16], b1[16];
+	for(i=0;i<4;i++)
+	{
+		memcpy(b0+4*i,BDef,3);	b0[4*i+3] = alf;
+		memcpy(b1+4*i,BDef,3);	b1[4*i+3] = 255;
+	}
+	const __m128i bg0 = _mm_loadu_si128((const __m128i *)b0);
+	const __m128i bg1 = _mm_loadu_si128((const __m128i *)b1);
+	__m128i c, r0, r1, r2, r3, t0, t1, t2, t3;
+	for(i=i1;i+4<=i2;i+=4)
+	{
+		const unsigned char *cc = C+32*i;
+		if(face)
+		{
+			c = bg0;
+#ifdef MGL_ABUF_8
+			// layers 4-7 of the 4 pixels, transposed to one register per layer
+			r0 = _mm_loadu_si128((const __m128i *)(cc+16));	r1 = _mm_loadu_si128((const __m128i *)(cc+48));
+			r2 = _mm_loadu_si128((const __m128i *)(cc+80));	r3 = _mm_loadu_si128((const __m128i *)(cc+112));
+			t0 = _mm_unpacklo_epi32(r0,r1);	t1 = _mm_unpacklo_epi32(r2,r3);
+			t2 = _mm_unpackhi_epi32(r0,r1);	t3 = _mm_unpackhi_epi32(r2,r3);
+			c = mgl_combine4_sse2(c,_mm_unpackhi_epi64(t2,t3),tt);
+			c = mgl_combine4_sse2(c,_mm_unpacklo_epi64(t2,t3),tt);
+			c = mgl_combine4_sse2(c,_mm_unpackhi_epi64(t0,t1),tt);
+			c = mgl_combine4_sse2(c,_mm_unpacklo_epi64(t0,t1),tt);
+#endif
+			// layers 0-3 of the 4 pixels, transposed to one register per layer
+			r0 = _mm_loadu_si128((const __m128i *)cc);		r1 = _mm_loadu_si128((const __m128i *)(cc+32));
+			r2 = _mm_loadu_si128((const __m128i *)(cc+64));	r3 = _mm_loadu_si128((const __m128i *)(cc+96));
+			t0 = _mm_unpacklo_epi32(r0,r1);	t1 = _mm_unpacklo_epi32(r2,r3);
+			t2 = _mm_unpackhi_epi32(r0,r1);	t3 = _mm_unpackhi_epi32(r2,r3);
+			c = mgl_combine4_sse2(c,_mm_unpackhi_epi64(t2,t3),tt);
+			c = mgl_combine4_sse2(c,_mm_unpacklo_epi64(t2,t3),tt);
+			c = mgl_combine4_sse2(c,_mm_unpackhi_epi64(t0,t1),tt);
+			c = mgl_combine4_sse2(c,_mm_unpacklo_epi64(t0,t1),tt);
+		}
+		else	// only the top layer
+		{
+			int p[4];
+			memcpy(p,cc,4);	memcpy(p+1,cc+32,4);	memcpy(p+2,cc+64,4);	memcpy(p+3,cc+96,4);
+			c = _mm_loadu_si128((const __m128i *)p);
+		}
+		_mm_storeu_si128((__m128i *)(G4+4*i), c);
+		mgl_store_rgb_sse2(G+3*i, mgl_combine4_sse2(bg1,c,tt));
+	}
+	return i;
+}
+#endif
+//-----------------------------------------------------------------------------
+void mglGraphZB::finish_rows(long j1, long j2)
 {
 	register long i,i0;
-	long n=Width*Height;
+	long n=Width*j2;
 	unsigned char c[4],alf=TranspType!=2 ? 0:255,*cc;
-	if(DrawFace || !FastNoFace)	for(i=0;i<n;i++)
+	bool face = DrawFace || !FastNoFace;
+	i = Width*j1;
+#ifdef MGL_USE_SSE2
+	if(UseSimd && TranspType>=0 && TranspType<=2)
+		i = mgl_finish_sse2(C,G4,G,i,n,BDef,TranspType,face);
+#endif
+	if(face)	for(;i<n;i++)
 	{
 		i0 = 4*i;
 		c[0]=BDef[0];	c[1]=BDef[1];	c[2]=BDef[2];	c[3]=alf;
@@ -191,13 +432,12 @@ void mglGraphZB::Finish()
 		c[0]=BDef[0];	c[1]=BDef[1];	c[2]=BDef[2];	c[3]=255;
 		combine(c,G4+i0);	memcpy(G+3*i,c,3);
 	}
-	else 	for(i=0;i<n;i++)
+	else 	for(;i<n;i++)
 	{
 		memcpy(G4+4*i,C+32*i,4);
 		c[0]=BDef[0];	c[1]=BDef[1];	c[2]=BDef[2];	c[3]=255;
 		combine(c,G4+4*i);	memcpy(G+3*i,c,3);
 	}
-	Finished = true;
 }
 //-----------------------------------------------------------------------------
 void mglGraphZB::Clf(mglColor Back)
@@ -207,6 +447,8 @@ void mglGraphZB::Clf(mglColor Back)
 	if(Back==NC)		Back = mglColor(1,1,1);
 	if(TranspType==2)	Back = mglColor(0,0,0);
 	col2int(Back,1,BDef);
+	if(Tile)	for(long k=0;k<TileNx*TileNy;k++)	Tile[k].num = 0;	// drop pending points
+	TileNum = 0;
 	register long i,n=Width*Height;
 	memset(C,0,32*n);	memset(OI,0,n*sizeof(int));
 	for(i=0;i<8*n;i++)	Z[i] = -1e20f;	// TODO Parallelization ?!?
@@ -219,6 +461,7 @@ void mglGraphZB::SetSize(int w,int h)
 {
 	if(w<=0 || h<=0)	{	SetWarn(mglWarnSize);	return;	}
 	if(C)	{	delete []C;	delete []Z;	}
+	tile_free();	// tiles are created again at first point
 	C = new unsigned char[w*h*32];		// ����� *1 ��� TranspType>0 !!!
 	Z = new mreal[w*h*8];
 	mglGraphAB::SetSize(w,h);
@@ -230,6 +473,7 @@ void mglGraphZB::WriteSlice(int n)
 	unsigned char **p;
 	char fname[32];
 	sprintf(fname,"%d.png",n);
+	pnt_flush();
 
 	p = (unsigned char **)malloc(Height * sizeof(unsigned char *));
 	for(long i=0;i<Height;i++)	p[i] = C+4*Width*i + n*4*Width*Height;
@@ -25,6 +25,24 @@
 #define _MGL_ZB_H_
 #include "mgl/mgl_ab.h"
 //-----------------------------------------------------------------------------
+#define MGL_ZB_TILE		64			///< Size of screen tiles for multithreaded drawing
+#define MGL_ZB_MAXPNT	(1L<<20)	///< Maximal number of pending points before they are drawn
+/// Point waiting to be placed in Z-buffer layers of its tile
+struct mglZBPoint
+{
+	long i0;			///< Index of pixel
+	mreal z;			///< Depth of the point
+	int id;				///< ObjId of the point
+	unsigned char c[4];	///< Color of the point (after fog)
+	bool face;			///< Point is drawn in transparency layers
+};
+/// List of points for one screen tile
+struct mglZBTile
+{
+	mglZBPoint *pnt;
+	long num, max;
+};
+//-----------------------------------------------------------------------------
 /// Class implement the creation of different mathematical plots using Z-Buffer
 class mglGraphZB : public mglGraphAB
 {
@@ -35,6 +53,7 @@ friend void *mgl_thr_quad(void *p);
 friend void *mgl_thr_quaa(void *p);
 friend void *mgl_thr_trig(void *p);
 friend void *mgl_thr_trin(void *p);
+friend void *mgl_thr_tile(void *p);
 
 public:
 	/// Initialize ZBuffer drawing and allocate the memory for image with size [Width x Height].
@@ -49,12 +68,25 @@ public:
 	void PutDrawReg(int m, int n, int k, mglGraphAB *gr);
 	// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	bool FastNoFace;	/// Use fastest (but less accurate) scheme for drawing (without faces)
+	bool UseSimd;		/// Use SIMD code (if available) for preparing the final picture
 protected:
 	mreal *Z;			///< Height for given level in Z-direction
 	unsigned char *C;	///< Picture for given level in Z-direction
+	mglZBTile *Tile;	///< Points binned by screen tiles (only for mglNumThr>1)
+	long TileNx, TileNy;	///< Number of tiles along x and y
+	long TileNum;		///< Total number of pending points in tiles
+	int TileTransp;		///< TranspType used by pending points
 
 	/// Plot point \a p with color \a c
 	void pnt_plot(long x,long y,mreal z,unsigned char c[4]);
+	/// Put point in Z-buffer layers of pixel \a i0
+	void pnt_fill(long i0,mreal z,unsigned char c[4],int id,bool face);
+	/// Put all pending points in Z-buffer, each tile by its thread
+	void pnt_flush();
+	/// Free points of tiles
+	void tile_free();
+	/// Prepare final picture for rows [j1, j2)
+	void finish_rows(long j1, long j2);
 };
 //-----------------------------------------------------------------------------
 #endif
@@ -34,6 +34,8 @@ const float kTickValueVerySmall = (float)1.0e-3;
 const float kMajorTickXInitialFac = 2.0f;
 const float kMajorTickYInitialFac = 3.0f;
 const PMargins kDefaultMargins = PMargins (40,20,5,42);
+const long kLODBlock = 8;// values in each block of PlotDataLOD levels
+const long kLODMinPointsPerPixel = 2;// use PlotDataLOD when there are more points than this per pixel
 
 const float PPlot::kRangeVerySmall = (float)1.0e-3;         // also in ZoomInteraction
 
@@ -41,6 +43,10 @@ template <class T> const T & PMax (const T &a, const T &b) {
   return b> a ? b: a;
 }
 
+template <class T> const T & PMin (const T &a, const T &b) {
+  return b< a ? b: a;
+}
+
 inline float SafeLog (float inFloat, float inBase, float inFac) {
   if (inFloat<kLogMin) {
     inFloat = kLogMin;
@@ -78,10 +84,8 @@ float PlotDataBase::GetValue (long inIndex) const {
 bool PlotDataBase::CalculateRange (float &outXMin, float &outXMax) {
   const RealData *theData = GetRealPlotData ();
   if (theData && theData->size () >0) {
-    vector<float>::const_iterator imin = min_element (theData->begin (), theData->end ());
-    vector<float>::const_iterator imax = max_element (theData->begin (), theData->end ());
-    outXMin = *imin;
-    outXMax = *imax;
+    // only the appended values are scanned
+    GetMinMax (0, theData->size () - 1, outXMin, outXMax);
     return true;
   }
   else {
@@ -96,6 +100,274 @@ bool PlotDataBase::CalculateRange (float &outXMin, float &outXMax) {
   return false;
 }
 
+void PlotDataBase::GetMinMax (long inStartIndex, long inEndIndex, float &outMin, float &outMax) const {
+  GetLOD ()->GetMinMax (*this, inStartIndex, inEndIndex, outMin, outMax);
+}
+
+const PlotDataLOD * PlotDataBase::GetLOD () const {
+  if (!mLOD) {
+    mLOD = new PlotDataLOD ();
+  }
+  mLOD->Update (*this);
+  return mLOD;
+}
+
+bool PlotDataBase::IsSorted () const {
+  if (!mLOD) {
+    mLOD = new PlotDataLOD ();
+  }
+  mLOD->UpdateSorted (*this);
+  return mLOD->IsSorted ();
+}
+
+void PlotDataLOD::Reset (long inIndex) {
+  if (inIndex < mCount) {
+    mCount = inIndex;
+  }
+  if (inIndex < mSortCount) {
+    mSortCount = inIndex;
+  }
+  if (mUnsortedIndex >= inIndex) {
+    mUnsortedIndex = -1;
+  }
+}
+
+void PlotDataLOD::UpdateSorted (const PlotDataBase &inData) {
+  long theSize = inData.GetSize ();
+  if (theSize < mSortCount) {
+    Reset (theSize);
+  }
+  if (mUnsortedIndex < 0) {
+    for (long theI = PMax (mSortCount, 1L); theI < theSize; theI++) {
+      if (inData.GetValue (theI) < inData.GetValue (theI-1)) {
+        mUnsortedIndex = theI;
+        break;
+      }
+    }
+  }
+  mSortCount = theSize;
+}
+
+void PlotDataLOD::Update (const PlotDataBase &inData) {
+  UpdateSorted (inData);
+
+  long theSize = inData.GetSize ();
+  if (theSize < mCount) {
+    Reset (theSize);
+  }
+  if (theSize == mCount) {
+    return;
+  }
+
+  // level 0 from the values, only the blocks with new values
+  long theFirst = mCount/kLODBlock;
+  long theCount = (theSize + kLODBlock - 1)/kLODBlock;
+  long theLevel = 0;
+  while (theCount > 0) {
+    if (theLevel == (long)mMinList.size ()) {
+      mMinList.push_back (RealData ());
+      mMaxList.push_back (RealData ());
+    }
+    RealData &theMin = mMinList[theLevel];
+    RealData &theMax = mMaxList[theLevel];
+    theMin.resize (theCount);
+    theMax.resize (theCount);
+
+    for (long theB = theFirst; theB < theCount; theB++) {
+      long theI = theB*kLODBlock;
+      long theLast = PMin (theI + kLODBlock, theLevel == 0? theSize: (long)mMinList[theLevel-1].size ());
+      float theBMin, theBMax;
+      if (theLevel == 0) {
+        theBMin = theBMax = inData.GetValue (theI);
+        for (theI++; theI < theLast; theI++) {
+          float theValue = inData.GetValue (theI);
+          if (theValue < theBMin) theBMin = theValue;
+          if (theValue > theBMax) theBMax = theValue;
+        }
+      }
+      else {
+        const RealData &theLMin = mMinList[theLevel-1];
+        const RealData &theLMax = mMaxList[theLevel-1];
+        theBMin = theLMin[theI];
+        theBMax = theLMax[theI];
+        for (theI++; theI < theLast; theI++) {
+          if (theLMin[theI] < theBMin) theBMin = theLMin[theI];
+          if (theLMax[theI] > theBMax) theBMax = theLMax[theI];
+        }
+      }
+      theMin[theB] = theBMin;
+      theMax[theB] = theBMax;
+    }
+
+    if (theCount == 1) {
+      break;
+    }
+    theFirst /= kLODBlock;
+    theCount = (theCount + kLODBlock - 1)/kLODBlock;
+    theLevel++;
+  }
+  mMinList.resize (theLevel+1);
+  mMaxList.resize (theLevel+1);
+
+  mCount = theSize;
+}
+
+void PlotDataLOD::GetMinMax (const PlotDataBase &inData, long inStartIndex, long inEndIndex, float &outMin, float &outMax) const {
+  long theI = inStartIndex;
+  long theEnd = inEndIndex + 1;
+  long theBlock = 1;// values in each item of the current level
+  long theLevel = -1;// the values
+
+  outMin = outMax = inData.GetValue (theI);
+  while (theI < theEnd) {
+    // go up while the block of the next level starts here and fits in the range
+    while (theLevel+1 < (long)mMinList.size () && theI % (theBlock*kLODBlock) == 0 && theI + theBlock*kLODBlock <= theEnd) {
+      theBlock *= kLODBlock;
+      theLevel++;
+    }
+    // go down while the block does not fit
+    while (theLevel >= 0 && theI + theBlock > theEnd) {
+      theBlock /= kLODBlock;
+      theLevel--;
+    }
+
+    float theMin, theMax;
+    if (theLevel < 0) {
+      theMin = theMax = inData.GetValue (theI);
+    }
+    else {
+      theMin = mMinList[theLevel][theI/theBlock];
+      theMax = mMaxList[theLevel][theI/theBlock];
+    }
+    if (theMin < outMin) outMin = theMin;
+    if (theMax > outMax) outMax = theMax;
+
+    theI += theBlock;
+  }
+}
+
+RingData::RingData (long inCapacity):
+  mCapacity (PMax (inCapacity, 1L)),
+  mStart (0),
+  mSize (0),
+  mDescentCount (0),
+  mLeaves (1)
+{
+  while (mLeaves < mCapacity) {
+    mLeaves *= 2;
+  }
+  mMinTree.resize (2*mLeaves);
+  mMaxTree.resize (2*mLeaves);
+}
+
+void RingData::Push (const float *inValues, long inCount) {
+  if (inCount <= 0) {
+    return;
+  }
+  if (inCount > mCapacity) {
+    // the first values would be replaced by the last ones
+    Clear ();
+    inValues += inCount - mCapacity;
+    inCount = mCapacity;
+  }
+
+  long theFirstSlot = Slot (mSize == mCapacity? 0: mSize);
+  for (long theI = 0; theI < inCount; theI++) {
+    float theValue = inValues[theI];
+    if (mSize == mCapacity) {
+      // the oldest value is dropped
+      if (IsDescent (1)) {
+        mDescentCount--;
+      }
+      float theLast = GetValue (mSize - 1);
+      long theSlot = mStart;
+      mStart = Slot (1);
+      SetSlot (theSlot, theValue);
+      if (mSize > 1 && theValue < theLast) {
+        mDescentCount++;
+      }
+    }
+    else {
+      SetSlot (Slot (mSize), theValue);
+      mSize++;
+      if (IsDescent (mSize - 1)) {
+        mDescentCount++;
+      }
+    }
+  }
+
+  long theLastSlot = theFirstSlot + inCount - 1;
+  if (theLastSlot < mCapacity) {
+    UpdateTree (theFirstSlot, theLastSlot);
+  }
+  else {
+    UpdateTree (theFirstSlot, mCapacity - 1);
+    UpdateTree (0, theLastSlot - mCapacity);
+  }
+}
+
+void RingData::SetValue (long inIndex, float inValue) {
+  if (IsDescent (inIndex)) mDescentCount--;
+  if (IsDescent (inIndex+1)) mDescentCount--;
+  long theSlot = Slot (inIndex);
+  SetSlot (theSlot, inValue);
+  if (IsDescent (inIndex)) mDescentCount++;
+  if (IsDescent (inIndex+1)) mDescentCount++;
+  UpdateTree (theSlot, theSlot);
+}
+
+void RingData::UpdateTree (long inFirstSlot, long inLastSlot) {
+  long theLo = (mLeaves + inFirstSlot)/2;
+  long theHi = (mLeaves + inLastSlot)/2;
+  while (theLo > 0) {
+    for (long theN = theLo; theN <= theHi; theN++) {
+      mMinTree[theN] = PMin (mMinTree[2*theN], mMinTree[2*theN+1]);
+      mMaxTree[theN] = PMax (mMaxTree[2*theN], mMaxTree[2*theN+1]);
+    }
+    theLo /= 2;
+    theHi /= 2;
+  }
+}
+
+// only the nodes inside the range are used, so the empty slots do not matter
+void RingData::GetSlotMinMax (long inFirstSlot, long inLastSlot, float &ioMin, float &ioMax) const {
+  long theLo = mLeaves + inFirstSlot;
+  long theHi = mLeaves + inLastSlot + 1;
+  for (; theLo < theHi; theLo /= 2, theHi /= 2) {
+    if (theLo & 1) {
+      if (mMinTree[theLo] < ioMin) ioMin = mMinTree[theLo];
+      if (mMaxTree[theLo] > ioMax) ioMax = mMaxTree[theLo];
+      theLo++;
+    }
+    if (theHi & 1) {
+      theHi--;
+      if (mMinTree[theHi] < ioMin) ioMin = mMinTree[theHi];
+      if (mMaxTree[theHi] > ioMax) ioMax = mMaxTree[theHi];
+    }
+  }
+}
+
+void RingData::GetMinMax (long inStartIndex, long inEndIndex, float &outMin, float &outMax) const {
+  long theFirstSlot = Slot (inStartIndex);
+  long theLastSlot = Slot (inEndIndex);
+  outMin = outMax = GetValue (inStartIndex);
+  if (theFirstSlot <= theLastSlot) {
+    GetSlotMinMax (theFirstSlot, theLastSlot, outMin, outMax);
+  }
+  else {
+    GetSlotMinMax (theFirstSlot, mCapacity - 1, outMin, outMax);
+    GetSlotMinMax (0, theLastSlot, outMin, outMax);
+  }
+}
+
+bool RingPlotData::CalculateRange (float &outMin, float &outMax) {
+  if (mRingData.GetSize () == 0) {
+    return false;
+  }
+  mRingData.GetMinMax (0, mRingData.GetSize () - 1, outMin, outMax);
+  return true;
+}
+
 DummyPlotData::DummyPlotData (long inSize) {
   for (int theI=0;theI<inSize;theI++) {
     mRealPlotData.push_back (theI);// simple ascending data
@@ -277,6 +549,7 @@ void TickInfo::MakeFormatString (float inValue, string &outFormatString) {
 
 
 PlotDataBase::~PlotDataBase (){
+  delete mLOD;
 };
 
 
@@ -610,6 +883,22 @@ bool PlotDataContainer::CalculateYRange (float inXMin, float inXMax, float &outY
   return true;
 }
 
+// first index with a value greater than inValue (or equal if inOrEqual), inData must be sorted
+static long FindFirstSorted (const PlotDataBase &inData, float inValue, bool inOrEqual) {
+    long theLo = 0, theHi = inData.GetSize ();
+    while (theLo < theHi) {
+        long theMid = (theLo + theHi)/2;
+        float theValue = inData.GetValue (theMid);
+        if (theValue < inValue || (!inOrEqual && theValue == inValue)) {
+            theLo = theMid + 1;
+        }
+        else {
+            theHi = theMid;
+        }
+    }
+    return theLo;
+}
+
 bool PlotDataContainer::CalculateYRangePlot (float inXMin, float inXMax, const PlotDataBase &inXData, const PlotDataBase &inYData, float &outYMin, float &outYMax) const {
     outYMin = 0;
     outYMax = 0;
@@ -619,6 +908,16 @@ bool PlotDataContainer::CalculateYRangePlot (float inXMin, float inXMax, const P
         return false;
     }
 
+    if (inXData.IsSorted ()) {
+        // the points inside the range are contiguous
+        long theStart = FindFirstSorted (inXData, inXMin, true);
+        long theEnd = FindFirstSorted (inXData, inXMax, false) - 1;
+        if (theStart <= theEnd) {
+            inYData.GetMinMax (theStart, theEnd, outYMin, outYMax);
+        }
+        return true;
+    }
+
     for (long theI = 0; theI < inXData.GetSize (); theI++) {
         float theX = inXData.GetValue (theI);
         float theY = inYData.GetValue (theI);
@@ -1685,6 +1984,42 @@ static void FindRange (const PlotDataBase &inData, float inMin, float inMax, lon
     assert (outStartIndex>-1);
 }
 
+// same as FindRange, but with a binary search, inData must be sorted
+static void FindRangeSorted (const PlotDataBase &inData, float inMin, float inMax, long& outStartIndex, long& outEndIndex) {
+    long theSize = inData.GetSize ();
+
+    // first value greater than inMin, then one before
+    long theLo = 0, theHi = theSize;
+    while (theLo < theHi) {
+        long theMid = (theLo + theHi)/2;
+        if (inData.GetValue (theMid) <= inMin) {
+            theLo = theMid + 1;
+        }
+        else {
+            theHi = theMid;
+        }
+    }
+    if (theLo == theSize) {
+        outStartIndex = theSize - 1;
+        outEndIndex = outStartIndex;
+        return;
+    }
+    outStartIndex = theLo > 0? theLo - 1: 0;
+
+    // first value greater or equal to inMax
+    theHi = theSize;
+    while (theLo < theHi) {
+        long theMid = (theLo + theHi)/2;
+        if (inData.GetValue (theMid) < inMax) {
+            theLo = theMid + 1;
+        }
+        else {
+            theHi = theMid;
+        }
+    }
+    outEndIndex = theLo < theSize? theLo: theSize - 1;
+}
+
 static void DrawValue(int theTraX, int theTraY, float theX, float theY, const PlotDataBase &inXData, const AxisSetup &inXAxisSetup, Painter &inPainter)
 {
   char theBuf[128];
@@ -1725,6 +2060,14 @@ bool LineDataDrawer::DrawData (const PlotDataBase &inXData, const PlotDataBase &
   long theStart = 0;
   long theEnd = inXData.GetSize () - 1;
   int theStride = 1;
+  if (mDrawLine && !mDrawPoint && !mShowValues && inXData.IsSorted ()) {
+      // large data sets are drawn with the min/max of each pixel column
+      long theVisStart, theVisEnd;
+      FindRangeSorted (inXData, inXAxisSetup.mMin, inXAxisSetup.mMax, theVisStart, theVisEnd);
+      if (mDrawFast || theVisEnd - theVisStart + 1 > kLODMinPointsPerPixel*inRect.mW) {
+          return DrawDataLOD (inXData, inYData, inPlotDataSelection, theVisStart, theVisEnd, inRect, inPainter);
+      }
+  }
   if (mDrawFast) {
       FindRange (inXData, inXAxisSetup.mMin, inXAxisSetup.mMax, theStart, theEnd);
 
@@ -1775,6 +2118,66 @@ bool LineDataDrawer::DrawData (const PlotDataBase &inXData, const PlotDataBase &
   return true;
 }
 
+// For each pixel column draws the line from the previous column to the first point,
+// a vertical line from the min to the max of the column and continues from the last point.
+// This is the same picture of the full line, but it depends only on the number of columns.
+bool LineDataDrawer::DrawDataLOD (const PlotDataBase &inXData, const PlotDataBase &inYData, const PlotDataSelection &inPlotDataSelection, long inStartIndex, long inEndIndex, const PRect &inRect, Painter &inPainter) const {
+  float thePrevX = 0;
+  float thePrevY = 0;
+  bool theFirst = true;
+
+  long theI = inStartIndex;
+  while (theI <= inEndIndex) {
+    float theTraX = mXTrafo->Transform (inXData.GetValue (theI));
+    long theColumn = (long)floor (theTraX);
+
+    // last point in the same column, the transformation is monotonic
+    long theLo = theI, theHi = inEndIndex;
+    while (theLo < theHi) {
+      long theMid = (theLo + theHi + 1)/2;
+      if ((long)floor (mXTrafo->Transform (inXData.GetValue (theMid))) == theColumn) {
+        theLo = theMid;
+      }
+      else {
+        theHi = theMid - 1;
+      }
+    }
+    long theLast = theLo;
+
+    float theTraY = mYTrafo->Transform (inYData.GetValue (theI));
+    if (!theFirst) {
+      inPainter.DrawLine (thePrevX, thePrevY, theTraX, theTraY);
+    }
+    else {
+      theFirst = false;
+    }
+
+    if (theLast > theI) {
+      float theMin, theMax;
+      inYData.GetMinMax (theI, theLast, theMin, theMax);
+      inPainter.DrawLine (theTraX, mYTrafo->Transform (theMin), theTraX, mYTrafo->Transform (theMax));
+
+      thePrevX = mXTrafo->Transform (inXData.GetValue (theLast));
+      thePrevY = mYTrafo->Transform (inYData.GetValue (theLast));
+    }
+    else {
+      thePrevX = theTraX;
+      thePrevY = theTraY;
+    }
+
+    theI = theLast + 1;
+  }
+
+  long theSelEnd = PMin (inEndIndex, (long)inPlotDataSelection.size () - 1);
+  for (theI = inStartIndex; theI <= theSelEnd; theI++) {
+    if (inPlotDataSelection.IsSelected (theI) && 
+        !DrawSelection (mXTrafo->Transform (inXData.GetValue (theI)), mYTrafo->Transform (inYData.GetValue (theI)), inRect, inPainter)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 DataDrawerBase* LineDataDrawer::Clone () const {
     return new LineDataDrawer (*this);
 }
@@ -75,10 +75,32 @@ class CalculatedDataBase {
    virtual long GetSize () const = 0;
 };
 
+class PlotDataBase;
+
+// level of detail: pyramid of min/max of blocks of values,
+// updated incrementally when values are appended
+class PlotDataLOD {
+ public:
+   PlotDataLOD (): mCount (0), mSortCount (0), mUnsortedIndex (-1) {};
+   void Update (const PlotDataBase &inData);
+   void UpdateSorted (const PlotDataBase &inData);
+   void Reset (long inIndex);// values changed from inIndex on
+   bool IsSorted () const {return mUnsortedIndex < 0;}
+   void GetMinMax (const PlotDataBase &inData, long inStartIndex, long inEndIndex, float &outMin, float &outMax) const;
+ private:
+   long mCount;// values in the pyramid
+   long mSortCount;// values checked for ascending order
+   long mUnsortedIndex;// first value smaller than the previous one
+   vector<RealData> mMinList;// level k has the min of blocks of kLODBlock^(k+1) values
+   vector<RealData> mMaxList;
+};
+
 // data
 class PlotDataBase {
  public:
-   PlotDataBase(): mIsString(false) {};
+   PlotDataBase(): mIsString(false), mLOD (0) {};
+   PlotDataBase(const PlotDataBase &inData): mIsString(inData.mIsString), mLOD (0) {};
+   PlotDataBase & operator= (const PlotDataBase &inData) {mIsString = inData.mIsString; ResetLOD (); return *this;}
    virtual ~PlotDataBase ();
    virtual const RealData * GetRealPlotData () const = 0;
    virtual const CalculatedDataBase * GetCalculatedData () const {return 0;}
@@ -86,8 +108,13 @@ class PlotDataBase {
    long GetSize () const;
    float GetValue (long inIndex) const;
    virtual bool CalculateRange (float &outMin, float &outMax);
+   virtual void GetMinMax (long inStartIndex, long inEndIndex, float &outMin, float &outMax) const;
+   const PlotDataLOD * GetLOD () const;// updated with the appended values
+   virtual bool IsSorted () const;
+   void ResetLOD (long inIndex=0) {if (mLOD) {mLOD->Reset (inIndex);}}// must be called when values are inserted, removed or changed
 protected:
    bool mIsString;
+   mutable PlotDataLOD *mLOD;
 };
  
 typedef vector<PlotDataBase *> PlotDataList;
@@ -130,6 +157,52 @@ class CalculatedPlotData: public PlotDataBase {
    CalculatedDataBase* mCalculatedData;
 };
 
+// fixed capacity circular data, when it is full a new value replaces the oldest one.
+// A tree with the min/max of the slots is updated with each value.
+class RingData: public CalculatedDataBase {
+ public:
+   RingData (long inCapacity);
+   virtual float GetValue (long inIndex) const {return mMinTree[mLeaves + Slot (inIndex)];}
+   virtual long GetSize () const {return mSize;}
+   long GetCapacity () const {return mCapacity;}
+   bool IsSorted () const {return mDescentCount == 0;}
+   void Push (float inValue) {Push (&inValue, 1);}
+   void Push (const float *inValues, long inCount);
+   void SetValue (long inIndex, float inValue);
+   void Clear () {mStart = mSize = mDescentCount = 0;}
+   void GetMinMax (long inStartIndex, long inEndIndex, float &outMin, float &outMax) const;
+ private:
+   long Slot (long inIndex) const {long theSlot = mStart + inIndex; return theSlot < mCapacity? theSlot: theSlot - mCapacity;}
+   bool IsDescent (long inIndex) const {return inIndex > 0 && inIndex < mSize && GetValue (inIndex) < GetValue (inIndex-1);}
+   void SetSlot (long inSlot, float inValue) {mMinTree[mLeaves + inSlot] = mMaxTree[mLeaves + inSlot] = inValue;}
+   void UpdateTree (long inFirstSlot, long inLastSlot);
+   void GetSlotMinMax (long inFirstSlot, long inLastSlot, float &ioMin, float &ioMax) const;
+
+   long mCapacity;
+   long mStart;// slot of the oldest value
+   long mSize;
+   long mDescentCount;// values smaller than the previous one
+   long mLeaves;// power of 2 >= mCapacity
+   RealData mMinTree;// the values are at mLeaves+slot, node n has the min of 2n and 2n+1
+   RealData mMaxTree;
+};
+
+class RingPlotData: public PlotDataBase {
+ public:
+   RingPlotData (long inCapacity): mRingData (inCapacity) {}
+   virtual const RealData * GetRealPlotData () const {return 0;}
+   virtual const CalculatedDataBase * GetCalculatedData () const {return &mRingData;}
+   virtual bool CalculateRange (float &outMin, float &outMax);
+   virtual void GetMinMax (long inStartIndex, long inEndIndex, float &outMin, float &outMax) const {mRingData.GetMinMax (inStartIndex, inEndIndex, outMin, outMax);}
+   virtual bool IsSorted () const {return mRingData.IsSorted ();}
+   long GetCapacity () const {return mRingData.GetCapacity ();}
+   void Push (float inValue) {mRingData.Push (inValue);}
+   void Push (const float *inValues, long inCount) {mRingData.Push (inValues, inCount);}
+   void SetValue (long inIndex, float inValue) {mRingData.SetValue (inIndex, inValue);}
+
+   RingData mRingData;
+};
+
 class DummyPlotData: public PlotDataBase {
  public:
    DummyPlotData (long inSize=0);
@@ -293,6 +366,8 @@ class LineDataDrawer: public DataDrawerBase {
 
   bool mDrawLine;
   bool mDrawPoint;
+ protected:
+  bool DrawDataLOD (const PlotDataBase &inXData, const PlotDataBase &inYData, const PlotDataSelection &inPlotDataSelection, long inStartIndex, long inEndIndex, const PRect &inRect, Painter &inPainter) const;
 };
 
 class DotDataDrawer: public LineDataDrawer {
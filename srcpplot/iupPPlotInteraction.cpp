@@ -563,6 +563,7 @@ void PVerticalCursorInteraction::HandleVerticalCursorKey (const PlotDataSelectio
   PlotDataIncrementer theIncremter;
   vector<PlotDataIncrementerBounds> theDummyList;
   theIncremter.Increment (theIncrementList, theSelectedData, mGlobalBounds, theDummyList);
+  theYData->ResetLOD ();
 }
 
 
@@ -671,6 +672,9 @@ template<class T> bool Erase (const vector<int> &inEraseList, vector <T> &ioVec)
 #endif
 
 void PDeleteInteraction::HandleDeleteKey (PlotDataBase *inXData, PlotDataBase *inYData, PlotDataSelection *inPlotDataSelection, int inIndex) {
+  if (dynamic_cast<RingPlotData *>(inXData)) {
+    return;// fixed size
+  }
   vector<int> theDeleteList (inPlotDataSelection->GetSelectedCount ());
   long theIndex = 0;
   for (int theI=0;theI<inYData->GetSize ();theI++) {
@@ -700,6 +704,9 @@ void PDeleteInteraction::HandleDeleteKey (PlotDataBase *inXData, PlotDataBase *i
     Erase (theDeleteList, *theYData);
     Erase (theDeleteList, *inPlotDataSelection);
   }
+
+  inXData->ResetLOD ();
+  inYData->ResetLOD ();
 }
 
 PCrosshairInteraction::PCrosshairInteraction (PPlot &inPPlot):
@@ -119,6 +119,12 @@ static int iPPlotKeyPress_CB(Ihandle* ih, int c, int press)
   return IUP_DEFAULT;
 } 
 
+/* ring datasets have a fixed size, samples can only be pushed or changed */
+static RingPlotData* iPPlotGetRing(PlotDataBase* inData)
+{
+  return dynamic_cast<RingPlotData*>(inData);
+}
+
 /* user level call: add dataset to plot */
 void IupPPlotBegin(Ihandle* ih, int strXdata)
 {
@@ -147,6 +153,29 @@ void IupPPlotBegin(Ihandle* ih, int strXdata)
   iupAttribSetStr(ih, "_IUP_PPLOT_YDATA",    (char*)inYData);
 }
 
+void IupPPlotBeginRing(Ihandle* ih, int capacity)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS || 
+      !IupClassMatch(ih, "pplot"))
+    return;
+
+  PlotDataBase* inXData = (PlotDataBase*)iupAttribGet(ih, "_IUP_PPLOT_XDATA");
+  PlotDataBase* inYData = (PlotDataBase*)iupAttribGet(ih, "_IUP_PPLOT_YDATA");
+
+  if (inXData) delete inXData;
+  if (inYData) delete inYData;
+
+  inXData = (PlotDataBase*)(new RingPlotData(capacity));
+  inYData = (PlotDataBase*)(new RingPlotData(capacity));
+
+  iupAttribSetStr(ih, "_IUP_PPLOT_XDATA",    (char*)inXData);
+  iupAttribSetStr(ih, "_IUP_PPLOT_YDATA",    (char*)inYData);
+}
+
 void IupPPlotAdd(Ihandle* ih, float x, float y)
 {
   iupASSERT(iupObjectCheck(ih));
@@ -157,12 +186,22 @@ void IupPPlotAdd(Ihandle* ih, float x, float y)
       !IupClassMatch(ih, "pplot"))
     return;
 
-  PlotData* inXData = (PlotData*)iupAttribGet(ih, "_IUP_PPLOT_XDATA");
-  PlotData* inYData = (PlotData*)iupAttribGet(ih, "_IUP_PPLOT_YDATA");
+  PlotDataBase* theXDataBase = (PlotDataBase*)iupAttribGet(ih, "_IUP_PPLOT_XDATA");
+  PlotDataBase* theYDataBase = (PlotDataBase*)iupAttribGet(ih, "_IUP_PPLOT_YDATA");
 
-  if (!inYData || !inXData || inXData->IsString())
+  if (!theYDataBase || !theXDataBase || theXDataBase->IsString())
+    return;
+
+  RingPlotData* theXRing = iPPlotGetRing(theXDataBase);
+  if (theXRing)
+  {
+    theXRing->Push(x);
+    ((RingPlotData*)theYDataBase)->Push(y);
     return;
+  }
 
+  PlotData* inXData = (PlotData*)theXDataBase;
+  PlotData* inYData = (PlotData*)theYDataBase;
   inXData->push_back(x);
   inYData->push_back(y);
 }
@@ -207,6 +246,8 @@ void IupPPlotInsertStr(Ihandle* ih, int inIndex, int inSampleIndex, const char*
 
   theXData->InsertItem(inSampleIndex, inX);
   theYData->insert(theYData->begin()+inSampleIndex, inY);
+  theXData->ResetLOD(inSampleIndex);
+  theYData->ResetLOD(inSampleIndex);
 }
 
 void IupPPlotInsert(Ihandle* ih, int inIndex, int inSampleIndex, float inX, float inY)
@@ -224,11 +265,13 @@ void IupPPlotInsert(Ihandle* ih, int inIndex, int inSampleIndex, float inX, floa
   PlotData* theXData = (PlotData*)theXDataBase;
   PlotData* theYData = (PlotData*)theYDataBase;
 
-  if (!theYData || !theXData || theXData->IsString())
+  if (!theYData || !theXData || theXData->IsString() || iPPlotGetRing(theXDataBase))
     return;
 
   theXData->insert(theXData->begin()+inSampleIndex, inX);
   theYData->insert(theYData->begin()+inSampleIndex, inY);
+  theXData->ResetLOD(inSampleIndex);
+  theYData->ResetLOD(inSampleIndex);
 }
 
 void IupPPlotAddPoints(Ihandle* ih, int inIndex, float *x, float *y, int count)
@@ -243,12 +286,19 @@ void IupPPlotAddPoints(Ihandle* ih, int inIndex, float *x, float *y, int count)
 
   PlotDataBase* theXDataBase = ih->data->plt->_plot.mPlotDataContainer.GetXData(inIndex);
   PlotDataBase* theYDataBase = ih->data->plt->_plot.mPlotDataContainer.GetYData(inIndex);
-  PlotData* inXData = (PlotData*)theXDataBase;
-  PlotData* inYData = (PlotData*)theYDataBase;
+  if (!theYDataBase || !theXDataBase || theXDataBase->IsString())
+    return;
 
-  if (!inYData || !inXData || inXData->IsString())
+  RingPlotData* theXRing = iPPlotGetRing(theXDataBase);
+  if (theXRing)
+  {
+    theXRing->Push(x, count);
+    ((RingPlotData*)theYDataBase)->Push(y, count);
     return;
+  }
 
+  PlotData* inXData = (PlotData*)theXDataBase;
+  PlotData* inYData = (PlotData*)theYDataBase;
   for (int i=0; i<count; i++)
   {
     inXData->push_back(x[i]);
@@ -304,6 +354,8 @@ void IupPPlotInsertStrPoints(Ihandle* ih, int inIndex, int inSampleIndex, const
     theXData->InsertItem(inSampleIndex+i, inX[i]);
     theYData->insert(theYData->begin()+(inSampleIndex+i), inY[i]);
   }
+  theXData->ResetLOD(inSampleIndex);
+  theYData->ResetLOD(inSampleIndex);
 }
 
 void IupPPlotInsertPoints(Ihandle* ih, int inIndex, int inSampleIndex, float *inX, float *inY, int count)
@@ -321,7 +373,7 @@ void IupPPlotInsertPoints(Ihandle* ih, int inIndex, int inSampleIndex, float *in
   PlotData* theXData = (PlotData*)theXDataBase;
   PlotData* theYData = (PlotData*)theYDataBase;
 
-  if (!theYData || !theXData || theXData->IsString())
+  if (!theYData || !theXData || theXData->IsString() || iPPlotGetRing(theXDataBase))
     return;
 
   for (int i=0; i<count; i++)
@@ -329,6 +381,8 @@ void IupPPlotInsertPoints(Ihandle* ih, int inIndex, int inSampleIndex, float *in
     theXData->insert(theXData->begin()+(inSampleIndex+i), inX[i]);
     theYData->insert(theYData->begin()+(inSampleIndex+i), inY[i]);
   }
+  theXData->ResetLOD(inSampleIndex);
+  theYData->ResetLOD(inSampleIndex);
 }
 
 int IupPPlotEnd(Ihandle* ih)
@@ -581,6 +635,11 @@ void PEditInteractionIup::HandleCursorKey (const PlotDataSelection *inPlotDataSe
         theXData->mRealPlotData[theI] = newX;
         (*theYData)[theI] = newY;
       }
+      else if (iPPlotGetRing(inXData))
+      {
+        iPPlotGetRing(inXData)->SetValue(theI, newX);
+        iPPlotGetRing(inYData)->SetValue(theI, newY);
+      }
       else
       {
         PlotData* theXData = (PlotData*)(inXData);
@@ -588,6 +647,8 @@ void PEditInteractionIup::HandleCursorKey (const PlotDataSelection *inPlotDataSe
         (*theXData)[theI] = newX;
         (*theYData)[theI] = newY;
       }
+      inXData->ResetLOD(theI);
+      inYData->ResetLOD(theI);
     }
   }
 }
@@ -695,6 +756,9 @@ static void RemoveSample(PPlot& inPPlot, int inIndex, int inSampleIndex)
   PlotDataBase* theXDataBase = inPPlot.mPlotDataContainer.GetXData(inIndex);
   PlotDataBase* theYDataBase = inPPlot.mPlotDataContainer.GetYData(inIndex);
 
+  if (iPPlotGetRing(theXDataBase))
+    return;
+
   if (theXDataBase->IsString())
   {
     StringPlotData *theXData = (StringPlotData *)theXDataBase;
@@ -710,6 +774,9 @@ static void RemoveSample(PPlot& inPPlot, int inIndex, int inSampleIndex)
     theXData->erase(theXData->begin()+inSampleIndex);
     theYData->erase(theYData->begin()+inSampleIndex);
   }
+
+  theXDataBase->ResetLOD(inSampleIndex);
+  theYDataBase->ResetLOD(inSampleIndex);
 }
 
 /* --------------------------------------------------------------------
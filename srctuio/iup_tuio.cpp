@@ -26,39 +26,81 @@
 
 using namespace TUIO;
 
-struct iTuioCursorEnvent{
+
+/* The TUIO messages are received in a separate thread (the receive thread),
+   and the callbacks must be called in the main thread.
+
+   The receive thread collects the cursor events of each TUIO frame in a pending frame,
+   when the frame is complete (refresh) it also copies the list of active cursors,
+   then publishes the frame in a ring of preallocated frames and posts a message to the element.
+   POSTMESSAGE_CB then consumes all the published frames and calls the callbacks.
+
+   The ring has a single producer (the receive thread) and a single consumer (the main thread),
+   so it needs only two counters, each one changed by only one of the threads.
+   No locks are shared between the threads and no memory is allocated per frame.
+   When the ring is full the events are kept in the pending frame
+   and published with the next frame. */
+
+#define ITUIO_MAXCURSORS 32    /* active cursors in a frame */
+#define ITUIO_MAXEVENTS 256    /* cursor events in a frame */
+#define ITUIO_RINGSIZE 16      /* frames in the ring, must be a power of 2 */
+
+#if defined(WIN32)
+#define iTuioAtomicGet(_ptr) InterlockedCompareExchange((LONG volatile*)(_ptr), 0, 0)
+#define iTuioAtomicInc(_ptr) InterlockedIncrement((LONG volatile*)(_ptr))
+#elif defined(__GNUC__)
+#define iTuioAtomicGet(_ptr) __sync_fetch_and_add((_ptr), 0)
+#define iTuioAtomicInc(_ptr) __sync_fetch_and_add((_ptr), 1)
+#else
+/* not thread safe, works only when the frames are published and consumed in the main thread */
+#define iTuioAtomicGet(_ptr) (*(_ptr))
+#define iTuioAtomicInc(_ptr) ((*(_ptr))++)
+#endif
+
+struct iTuioCursorEvent
+{
   int id;
   float x, y;
-  char state;
-
-  iTuioCursorEnvent(int _id, float _x, float _y, char _state);
+  char state;   /* 'D', 'M' or 'U' */
 };
 
-iTuioCursorEnvent::iTuioCursorEnvent(int _id, float _x, float _y, char _state)
-:id(_id), x(_x), y(_y), state(_state)
+struct iTuioFrame
 {
-}
+  int event_count;
+  iTuioCursorEvent events[ITUIO_MAXEVENTS];
+
+  int cursor_count;
+  iTuioCursorEvent cursors[ITUIO_MAXCURSORS];  /* active cursors after the events */
+  int main_id;   /* the active cursor with the smaller session id, or -1 */
+};
 
 class IupTuioListener : public TuioListener 
 {
-  int changed, locked;
+  int changed;
   TuioClient* client;
   Ihandle* ih;
-  std::list<iTuioCursorEnvent> cursor_events;
 
-  void processCursor(TuioCursor *tcur, const char* state, const char* action);
-  void initCursorInfo(int cursor_count, int* pid, int* pstate);
-  void finishCursorInfo(int cursor_count, int* px, int* py, int* pstate, int w, int h, int use_client_coord, Ihandle* ih_canvas);
-  void updateCursorInfo(int *cursor_count, int* pid, int* px, int* py, int* pstate, int id, int x, int y, int state);
-  int GetMainCursor();
+  /* owned by the receive thread */
+  iTuioFrame pending;
+  int lost_count;
 
-  static int timer_action_cb(Ihandle *timer);
+  iTuioFrame* ring;
+  volatile long write_count,  /* changed only by the receive thread */
+                read_count;   /* changed only by the main thread */
+
+  void processCursor(TuioCursor *tcur, const char* state, const char* action);
+  void removeMoveEvents();
+  void publishFrame();
+  void dispatchFrame(const iTuioFrame* frame);
 
   public:
-    int debug;
-    Ihandle* timer;
+    int debug, direct;
 
     IupTuioListener(Ihandle* _ih, TuioClient* _client);
+    ~IupTuioListener();
+
+    void resetFrames();
+    void dispatchFrames();
 
     void addTuioObject(TuioObject *tobj);
     void updateTuioObject(TuioObject *tobj);
@@ -72,12 +114,27 @@ class IupTuioListener : public TuioListener
 };
 
 IupTuioListener::IupTuioListener(Ihandle* _ih, TuioClient* _client)
-  :changed(0), locked(0), client(_client), ih(_ih), debug(0)
+  :changed(0), client(_client), ih(_ih), lost_count(0), write_count(0), read_count(0), debug(0), direct(0)
 {
-  timer = IupTimer();
-  IupSetAttribute(timer, "TIME", "50");
-  IupSetAttribute(timer, "_IUP_TUIOLISTENER", (char*)this);
-  IupSetCallback(timer, "ACTION_CB", timer_action_cb);
+  ring = new iTuioFrame[ITUIO_RINGSIZE];
+  pending.event_count = 0;
+  pending.cursor_count = 0;
+  pending.main_id = -1;
+}
+
+IupTuioListener::~IupTuioListener()
+{
+  delete[] ring;
+}
+
+void IupTuioListener::resetFrames()
+{
+  /* called only when the receive thread is not running */
+  this->changed = 0;
+  this->lost_count = 0;
+  this->pending.event_count = 0;
+  this->write_count = 0;
+  this->read_count = 0;
 }
 
 void IupTuioListener::addTuioObject(TuioObject *tobj) 
@@ -113,12 +170,41 @@ void IupTuioListener::removeTuioCursor(TuioCursor *tcur)
   IupTuioListener::processCursor(tcur, "UP", "RemoveCursor"); 
 }
 
+void IupTuioListener::removeMoveEvents()
+{
+  /* the last position of each cursor is also in the list of active cursors,
+     so when the pending frame is full the MOVE events can be discarded */
+  int i, count = 0;
+  for (i = 0; i < this->pending.event_count; i++)
+  {
+    if (this->pending.events[i].state != 'M')
+    {
+      this->pending.events[count] = this->pending.events[i];
+      count++;
+    }
+  }
+  this->pending.event_count = count;
+}
+
 void IupTuioListener::processCursor(TuioCursor *tcur, const char* state, const char* action) 
 {
-  float x = tcur->getX();
-  float y = tcur->getY();
-  int id = (int)tcur->getSessionID();
-  cursor_events.push_back(iTuioCursorEnvent(id, x, y, state[0]));
+  /* called in the receive thread */
+  iTuioCursorEvent* evt;
+
+  if (this->pending.event_count == ITUIO_MAXEVENTS)
+    removeMoveEvents();
+
+  if (this->pending.event_count == ITUIO_MAXEVENTS)
+    this->lost_count++;
+  else
+  {
+    evt = this->pending.events + this->pending.event_count;
+    evt->id = (int)tcur->getSessionID();
+    evt->x = tcur->getX();
+    evt->y = tcur->getY();
+    evt->state = state[0];
+    this->pending.event_count++;
+  }
 
   this->changed = 1;
 
@@ -126,88 +212,77 @@ void IupTuioListener::processCursor(TuioCursor *tcur, const char* state, const c
     printf("IupTuioClient-%s(id=%d sid=%d x=%d y=%d)\n", action, tcur->getCursorID(), (int)tcur->getSessionID(), (int)tcur->getX(), (int)tcur->getY());
 }
 
-void  IupTuioListener::refresh(TuioTime frameTime) 
+void IupTuioListener::publishFrame()
 {
-  if (this->changed)
-  {
-    Ihandle* ih_canvas = IupGetAttributeHandle(this->ih, "TARGETCANVAS");
-    if (!ih_canvas)
-      ih_canvas = this->ih;
-
-    this->changed = 0;
-
-    IFniiis cb = (IFniiis)IupGetCallback(ih_canvas, "TOUCH_CB");
-    IFniIIII mcb = (IFniIIII)IupGetCallback(ih_canvas, "MULTITOUCH_CB");
-    if (cb || mcb)
-    {
-      this->client->lockCursorList();
-      this->locked = 1;
-    }
+  /* called in the receive thread */
+  long write_count = iTuioAtomicGet(&this->write_count);
 
-    if (this->debug)
-      printf("IupTuioClient-RefreshChanged(time=%d)\n", (int)frameTime.getTotalMilliseconds());
-  }
-}
+  if (write_count - iTuioAtomicGet(&this->read_count) >= ITUIO_RINGSIZE)
+    return;  /* the ring is full, try again in the next frame */
 
-void IupTuioListener::initCursorInfo(int cursor_count, int* pid, int* pstate)
-{
-  std::list<TuioCursor*>& cursorList = this->client->getCursorList();
-  std::list <TuioCursor*>::iterator iter;
+  iTuioFrame* frame = this->ring + (write_count & (ITUIO_RINGSIZE-1));
   int i;
 
-  for (i = 0, iter = cursorList.begin() ; i<cursor_count; iter++, i++) 
-  {
-    TuioCursor* tcur = (*iter);
-    pid[i] = (int)tcur->getSessionID();
-    pstate[i] = 0;  /* mark to be updated later */
-  }
-}
+  frame->event_count = this->pending.event_count;
+  for (i = 0; i < this->pending.event_count; i++)
+    frame->events[i] = this->pending.events[i];
+  frame->cursor_count = this->pending.cursor_count;
+  for (i = 0; i < this->pending.cursor_count; i++)
+    frame->cursors[i] = this->pending.cursors[i];
+  frame->main_id = this->pending.main_id;
 
-int IupTuioListener::GetMainCursor()
-{
-  std::list<TuioCursor*>& cursorList = this->client->getCursorList();
-  std::list <TuioCursor*>::iterator iter;
-  std::list <TuioCursor*>::iterator end = cursorList.end();
-  int min_id = -1;
+  this->pending.event_count = 0;
+  this->changed = 0;
 
-  for (iter = cursorList.begin(); iter!=end; iter++) 
-  {
-    TuioCursor* tcur = (*iter);
-    int id = (int)tcur->getSessionID();
-    if (min_id == -1 || id < min_id)
-      min_id = id;
-  }
+  /* the frame contents are written before the counter */
+  iTuioAtomicInc(&this->write_count);
 
-  return min_id;
+  if (this->direct)
+    dispatchFrames();  /* LOCKED, already in the main thread */
+  else
+    IupPostMessage(this->ih, NULL, 0, 0, NULL);
 }
 
-void IupTuioListener::finishCursorInfo(int cursor_count, int* px, int* py, int* pstate, int w, int h, int use_client_coord, Ihandle* ih_canvas)
+void  IupTuioListener::refresh(TuioTime frameTime) 
 {
-  std::list<TuioCursor*>& cursorList = this->client->getCursorList();
-  std::list <TuioCursor*>::iterator iter;
-  std::list <TuioCursor*>::iterator end = cursorList.end();
-  int i;
-
-  for (i = 0, iter = cursorList.begin(); i<cursor_count && iter!=end; iter++, i++) 
+  /* called in the receive thread, 
+     the only thread that changes the cursor list, so it can be read without the lock */
+  if (this->changed)
   {
-    if (pstate[i] == 0) /* if still 0, then it was not updated, must fill it here */
+    std::list<TuioCursor*>& cursorList = this->client->getCursorList();
+    std::list <TuioCursor*>::iterator iter;
+    std::list <TuioCursor*>::iterator end = cursorList.end();
+    int count = 0, min_id = -1;
+
+    for (iter = cursorList.begin(); iter!=end && count<ITUIO_MAXCURSORS; iter++) 
     {
       TuioCursor* tcur = (*iter);
+      iTuioCursorEvent* cursor = this->pending.cursors + count;
+      cursor->id = (int)tcur->getSessionID();
+      cursor->x = tcur->getX();
+      cursor->y = tcur->getY();
+      cursor->state = 'M';
+      if (min_id == -1 || cursor->id < min_id)
+        min_id = cursor->id;
+      count++;
+    }
 
-      int x = tcur->getScreenX(w);
-      int y = tcur->getScreenY(h);
-
-      if (use_client_coord)
-        iupdrvScreenToClient(ih_canvas, &x, &y);
+    this->pending.cursor_count = count;
+    this->pending.main_id = min_id;
 
-      px[i] = x;
-      py[i] = y;
-      pstate[i] = 'M';  /* mark as MOVE */
+    if (this->debug)
+    {
+      printf("IupTuioClient-RefreshChanged(time=%d)\n", (int)frameTime.getTotalMilliseconds());
+      if (this->lost_count)
+        printf("IupTuioClient-LostEvents(count=%d)\n", this->lost_count);
     }
+    this->lost_count = 0;
+
+    publishFrame();
   }
 }
 
-void IupTuioListener::updateCursorInfo(int *cursor_count, int* pid, int* px, int* py, int* pstate, int id, int x, int y, int state)
+static void iTuioUpdateCursorInfo(int *cursor_count, int* pid, int* px, int* py, int* pstate, int id, int x, int y, int state)
 {
   int i;
 
@@ -222,7 +297,7 @@ void IupTuioListener::updateCursorInfo(int *cursor_count, int* pid, int* px, int
     }
   }
 
-  if (state == 'U')  /* UP - not in the cursorList, add it */
+  if (state == 'U')  /* UP - not in the cursor list, add it */
   {
     pid[i] = id;
     px[i] = x;
@@ -232,93 +307,125 @@ void IupTuioListener::updateCursorInfo(int *cursor_count, int* pid, int* px, int
   }
 }
 
-int IupTuioListener::timer_action_cb(Ihandle *timer)
+void IupTuioListener::dispatchFrame(const iTuioFrame* frame)
 {
-  IupTuioListener* listener = reinterpret_cast<IupTuioListener*>(IupGetAttribute(timer, "_IUP_TUIOLISTENER"));
-
-  if (!listener->locked)
-    return IUP_DEFAULT;
-
-  int events_count = (int)listener->cursor_events.size();
-  int cursor_count = listener->client->CursorListCount();
-  int total_count = events_count+cursor_count;
-  if (!total_count)
-  {
-    listener->locked = 0;
-    listener->client->unlockCursorList();
-    return IUP_DEFAULT;
-  }
-
+  /* called in the main thread */
+  Ihandle* ih = this->ih;
   int use_client_coord = 0;
-  Ihandle* ih_canvas = IupGetAttributeHandle(listener->ih, "TARGETCANVAS");
+  Ihandle* ih_canvas = IupGetAttributeHandle(ih, "TARGETCANVAS");
   if (ih_canvas)
     use_client_coord = 1;
   else
-    ih_canvas = listener->ih;
+    ih_canvas = ih;
 
   IFniiis cb = (IFniiis)IupGetCallback(ih_canvas, "TOUCH_CB");
   IFniIIII mcb = (IFniIIII)IupGetCallback(ih_canvas, "MULTITOUCH_CB");
+  if (!cb && !mcb)
+    return;
 
-  int w, h, x, y;
+  int w, h, x, y, i;
   iupdrvGetFullSize(&w, &h);
 
-  int *px=NULL, *py=NULL, *pid=NULL, *pstate=NULL;
+  /* UP events are added to the active cursors */
+  int px[ITUIO_MAXCURSORS+ITUIO_MAXEVENTS], py[ITUIO_MAXCURSORS+ITUIO_MAXEVENTS], 
+      pid[ITUIO_MAXCURSORS+ITUIO_MAXEVENTS], pstate[ITUIO_MAXCURSORS+ITUIO_MAXEVENTS];
+  int cursor_count = frame->cursor_count;
+
   if (mcb)
   {
-    px = new int[total_count];
-    py = new int[total_count];
-    pid = new int[total_count];
-    pstate = new int[total_count];
-
-    listener->initCursorInfo(cursor_count, pid, pstate);
+    for (i = 0; i < cursor_count; i++) 
+    {
+      pid[i] = frame->cursors[i].id;
+      pstate[i] = 0;  /* mark to be updated later */
+    }
   }
 
-  int min_id = -1;
-  if (cb)
-    min_id = listener->GetMainCursor();
-
-  for (int i = 0; i<events_count; i++) 
+  for (i = 0; i < frame->event_count; i++) 
   {
-    const iTuioCursorEnvent& evt = listener->cursor_events.front();
+    const iTuioCursorEvent* evt = frame->events + i;
 
-    const char* state = (evt.state=='D')? "DOWN": ((evt.state=='U')? "UP": "MOVE");
-    x = (int)floor(evt.x*w+0.5f);
-    y = (int)floor(evt.y*h+0.5f);
+    const char* state = (evt->state=='D')? "DOWN": ((evt->state=='U')? "UP": "MOVE");
+    x = (int)floor(evt->x*w+0.5f);
+    y = (int)floor(evt->y*h+0.5f);
 
     if (use_client_coord)
       iupdrvScreenToClient(ih_canvas, &x, &y);
 
     if (cb)
     {
-      if (min_id == evt.id)
-        state = (evt.state=='D')? "DOWN-PRIMARY": ((evt.state=='U')? "UP-PRIMARY": "MOVE-PRIMARY");
+      if (frame->main_id == evt->id)
+        state = (evt->state=='D')? "DOWN-PRIMARY": ((evt->state=='U')? "UP-PRIMARY": "MOVE-PRIMARY");
 
-      if (cb(ih_canvas, evt.id, x, y, (char*)state)==IUP_CLOSE)
+      int ret = cb(ih_canvas, evt->id, x, y, (char*)state);
+      if (ret==IUP_CLOSE)
         IupExitLoop();
+
+      /* the callback may destroy the elements */
+      if (!iupObjectCheck(ih) || !iupObjectCheck(ih_canvas))
+        return;
     }
 
     if (mcb)
-      listener->updateCursorInfo(&cursor_count, pid, px, py, pstate, evt.id, x, y, state[0]);
-
-    listener->cursor_events.pop_front();
+      iTuioUpdateCursorInfo(&cursor_count, pid, px, py, pstate, evt->id, x, y, state[0]);
   }
 
   if (mcb)
   {
-    listener->finishCursorInfo(cursor_count, px, py, pstate, w, h, use_client_coord, ih_canvas);
+    for (i = 0; i < frame->cursor_count; i++) 
+    {
+      if (pstate[i] == 0) /* if still 0, then it was not updated, must fill it here */
+      {
+        x = (int)floor(frame->cursors[i].x*w+0.5f);
+        y = (int)floor(frame->cursors[i].y*h+0.5f);
+
+        if (use_client_coord)
+          iupdrvScreenToClient(ih_canvas, &x, &y);
+
+        px[i] = x;
+        py[i] = y;
+        pstate[i] = 'M';  /* mark as MOVE */
+      }
+    }
 
     if (mcb(ih_canvas, cursor_count, pid, px, py, pstate)==IUP_CLOSE)
       IupExitLoop();
-     
-    delete[] px;
-    delete[] py;
-    delete[] pid;
-    delete[] pstate;
   }
+}
 
-  listener->locked = 0;
-  listener->client->unlockCursorList();
-  return IUP_DEFAULT;
+void IupTuioListener::dispatchFrames()
+{
+  /* called in the main thread */
+  Ihandle* ih = this->ih;
+
+  /* the counters are read again after each frame,
+     because the callbacks may process other messages or disconnect */
+  for (;;)
+  {
+    long read_count = iTuioAtomicGet(&this->read_count);
+    if (read_count == iTuioAtomicGet(&this->write_count))
+      break;
+
+    /* copy the frame, so the slot can be released before calling the callbacks,
+       because they can start a new loop that consumes the next frames */
+    iTuioFrame frame;
+    const iTuioFrame* slot = this->ring + (read_count & (ITUIO_RINGSIZE-1));
+    int i;
+
+    frame.event_count = slot->event_count;
+    for (i = 0; i < slot->event_count; i++)
+      frame.events[i] = slot->events[i];
+    frame.cursor_count = slot->cursor_count;
+    for (i = 0; i < slot->cursor_count; i++)
+      frame.cursors[i] = slot->cursors[i];
+    frame.main_id = slot->main_id;
+
+    iTuioAtomicInc(&this->read_count);
+
+    dispatchFrame(&frame);
+
+    if (!iupObjectCheck(ih))
+      return;
+  }
 }
 
 /**************************************************************************************/
@@ -332,20 +439,17 @@ struct _IcontrolData
 static int iTuioSetConnectAttrib(Ihandle* ih, const char* value)
 {
   if (ih->data->client->isConnected())
-  {
-    IupSetAttribute(ih->data->listener->timer, "RUN", "NO");
-    ih->data->client->disconnect();
-  }
+    ih->data->client->disconnect();  /* waits for the receive thread */
+
+  ih->data->listener->resetFrames();
+  ih->data->listener->direct = 0;
 
   if (iupStrEqualNoCase(value, "YES"))
-  {
     ih->data->client->connect(false);
-    IupSetAttribute(ih->data->listener->timer, "RUN", "YES");
-  }
   else if (iupStrEqualNoCase(value, "LOCKED"))
   {
+    ih->data->listener->direct = 1;
     ih->data->client->connect(true);
-    IupSetAttribute(ih->data->listener->timer, "RUN", "YES");
   }
     
   return 0;
@@ -373,6 +477,16 @@ static char* iTuioGetDebugAttrib(Ihandle *ih)
     return (char*)"No";
 }
 
+static int iTuioPostMessage_CB(Ihandle* ih, char* s, int i, double d, void* p)
+{
+  (void)s;
+  (void)i;
+  (void)d;
+  (void)p;
+  ih->data->listener->dispatchFrames();
+  return IUP_DEFAULT;
+}
+
 static int iTuioCreateMethod(Ihandle* ih, void** params)
 {
   int port = 3333;
@@ -388,12 +502,18 @@ static int iTuioCreateMethod(Ihandle* ih, void** params)
   ih->data->listener = new IupTuioListener(ih, ih->data->client);
   ih->data->client->addTuioListener(ih->data->listener);
 
+  /* the frames published by the receive thread are consumed here */
+  IupSetCallback(ih, "POSTMESSAGE_CB", (Icallback)iTuioPostMessage_CB);
+
   return IUP_NOERROR;
 }
 
 static void iTuioDestroyMethod(Ihandle* ih)
 {
-  IupDestroy(ih->data->listener->timer);
+  /* after this no more messages are posted to the element */
+  if (ih->data->client->isConnected())
+    ih->data->client->disconnect();
+
   delete ih->data->client;
   delete ih->data->listener;
 }
@@ -466,6 +466,7 @@ void TuioClient::connect(bool lk) {
 	currentTime.reset();
 	
 	locked = lk;
+	connected = true;  // before the receive thread starts, it uses the locks
 	if (!locked) {
 #ifndef WIN32
 		pthread_create(&thread , NULL, ClientThreadFunc, this);
@@ -474,24 +475,27 @@ void TuioClient::connect(bool lk) {
 		thread = CreateThread( 0, 0, ClientThreadFunc, this, 0, &threadId );
 #endif
 	} else socket->Run();
-	
-	connected = true;
-	unlockCursorList();
-	unlockObjectList();
 }
 
 void TuioClient::disconnect() {
 	
 	if (socket==NULL) return;
-	socket->Break();
 	
 	if (!locked) {
+		// wake up the receive thread and wait for it,
+		// so the listeners are not called after disconnect returns
+		socket->AsynchronousBreak();
 #ifdef WIN32
-		if( thread ) CloseHandle( thread );
+		if( thread ) {
+			WaitForSingleObject( thread, INFINITE );
+			CloseHandle( thread );
+		}
+#else
+		if (connected) pthread_join( thread, NULL );
 #endif
 		thread = 0;
 		locked = false;
-	}
+	} else socket->Break();
 	
 #ifndef WIN32	
 	pthread_mutex_destroy(&cursorMutex);
@@ -895,6 +895,9 @@ ifdef USE_IUP
     LIBS += iup$(IUP_SUFFIX)
     LDIR += $(IUP_LIB)
   endif
+  
+  # IUP uses pthread
+  LIBS += pthread
 
   IUP_INC ?= $(IUP)/include
   INCLUDES += $(IUP_INC)
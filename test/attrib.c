@@ -0,0 +1,571 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "iup.h"
+
+#include "../src/iup_table.h"
+
+/* Attribute table benchmark.
+   Compares the tables with the old chained hash table,
+   then creates many handles with a few attributes each,
+   like the elements of a large dialog. */
+
+#define ATTRIB_COUNT 50000
+
+static const char* attrib_names[] = {
+  "TITLE", "SIZE", "RASTERSIZE", "EXPAND", "FONT", "BGCOLOR", "FGCOLOR", "ACTIVE", "VISIBLE", "TIP",
+  "ALIGNMENT", "PADDING", "MARGIN", "GAP", "CURSOR", "MYDATA", "MYINDEX", "_MY_PRIVATE", "_MY_OTHER", "MYCOLOR"
+};
+
+static double attrib_time(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* The chained hash table used before the open addressing table with interned keys,
+   a copy of the old src/iup_table.c with only the functions used here,
+   renamed so both can be measured in the same program. */
+
+static const unsigned int oldtable_maxTableSizeIndex = 8;
+static const unsigned int oldtable_hashTableSize[] = { 31, 101, 401, 1601, 4001, 8009, 16001, 32003, 64007 };
+static const unsigned int oldtable_resizeLimit = 2;
+static const unsigned int oldtable_itemGrow = 5;
+
+typedef struct _OldItableContext
+{
+  unsigned int entryIndex;  /* index at the OldItable::entries array */
+  unsigned int itemIndex;   /* index at the OldItableEntry::items array */
+} OldItableContext;
+
+typedef struct _OldItableKey
+{
+  unsigned long keyIndex;  /* the secondary hash number */
+  const char   *keyStr;
+}
+OldItableKey;
+
+typedef struct _OldItableItem
+{
+  Itable_Types  itemType;
+  OldItableKey  key;
+  void*         value;
+}
+OldItableItem;
+
+typedef struct _OldItableEntry
+{
+  unsigned int    nextItemIndex;
+  unsigned int    itemsSize;
+  OldItableItem*  items;
+}
+OldItableEntry;
+
+typedef struct _OldItable
+{
+  unsigned int         entriesSize;
+  unsigned int         numberOfEntries;
+  unsigned int         tableSizeIndex;  /* index into oldtable_hashTableSize array */
+  Itable_IndexTypes    indexType;  /* type of the index: string or pointer. */
+  OldItableEntry      *entries;
+  OldItableContext     context;
+}
+OldItable;
+
+static char* oldTableStrDup(const char* str)
+{
+  size_t size = strlen(str)+1;
+  char* new_str = (char*)malloc(size);
+  memcpy(new_str, str, size);
+  return new_str;
+}
+
+static OldItable *oldTableCreateSized(Itable_IndexTypes indexType, unsigned int initialSizeIndex)
+{
+  OldItable *it = (OldItable *)malloc(sizeof(OldItable));
+
+  if (initialSizeIndex > oldtable_maxTableSizeIndex)
+    initialSizeIndex = oldtable_maxTableSizeIndex;
+
+  it->entriesSize    = oldtable_hashTableSize[initialSizeIndex];
+  it->tableSizeIndex  = initialSizeIndex;
+  it->numberOfEntries = 0;
+  it->indexType       = indexType;
+
+  it->entries = (OldItableEntry *)malloc(it->entriesSize * sizeof(OldItableEntry));
+  memset(it->entries, 0, it->entriesSize * sizeof(OldItableEntry));
+
+  it->context.entryIndex = (unsigned int)-1;
+  it->context.itemIndex = (unsigned int)-1;
+
+  return it;
+}
+
+static void iOldTableFreeItemArray(Itable_IndexTypes indexType, unsigned int nextFreeIndex, OldItableItem *items)
+{
+  unsigned int i;
+
+  if (indexType == IUPTABLE_STRINGINDEXED)
+  {
+    for (i = 0; i < nextFreeIndex; i++)
+      free((void *)(items[i].key.keyStr));
+  }
+
+  for (i = 0; i < nextFreeIndex; i++)
+  {
+    if (items[i].itemType == IUPTABLE_STRING)
+      free(items[i].value);
+  }
+
+  free(items);
+}
+
+static void oldTableDestroy(OldItable *it)
+{
+  unsigned int i;
+
+  for (i = 0; i < it->entriesSize; i++)
+  {
+    OldItableEntry *entry = &(it->entries[i]);
+    if (entry->items)
+      iOldTableFreeItemArray(it->indexType, entry->nextItemIndex, entry->items);
+  }
+
+  free(it->entries);
+  free(it);
+}
+
+static unsigned int iOldTableGetEntryIndex(OldItable *it, const char *key, unsigned long *keyIndex)
+{
+  if (it->indexType == IUPTABLE_STRINGINDEXED)
+  {
+    register unsigned int checksum = 0;
+
+    while (*key)
+    {
+      checksum *= 31;
+      checksum += *key;
+      key++;
+    }
+
+    *keyIndex = checksum;            /* this could NOT be dependent from table size */
+  }
+  else
+  {
+    /* Pointer indexed */
+    *keyIndex = (unsigned long)key;   /* this could NOT be dependent from table size */
+  }
+
+  return (unsigned int)((*keyIndex) % it->entriesSize);
+}
+
+static unsigned int iOldTableFindItem(OldItable *it, const char *key, OldItableEntry **entry, 
+                                      unsigned int *itemIndex, unsigned long *keyIndex)
+{
+  unsigned int entryIndex,
+               itemFound,
+               i;
+  OldItableItem *item;
+
+  entryIndex = iOldTableGetEntryIndex(it, key, keyIndex);
+
+  *entry = &(it->entries[entryIndex]);
+
+  item = &((*entry)->items[0]);
+  for (i = 0; i < (*entry)->nextItemIndex; i++, item++)
+  {
+    if (it->indexType == IUPTABLE_STRINGINDEXED)
+      itemFound = item->key.keyIndex == *keyIndex; 
+    else
+      itemFound = item->key.keyStr == key;
+
+    if (itemFound)
+    {
+      *itemIndex = i;
+      return 1;
+    }
+  }
+
+  /* if not found "entry", "itemIndex" and "keyIndex" will have the new insert position. */
+
+  *itemIndex = i;
+  return 0;
+}
+
+static void iOldTableUpdateArraySize(OldItableEntry *entry)
+{
+  if (entry->nextItemIndex >= entry->itemsSize)
+  {
+    /* we have to expand the item array */
+    unsigned int newSize;
+
+    newSize = entry->itemsSize + oldtable_itemGrow;
+
+    entry->items = (OldItableItem *)realloc(entry->items, newSize * sizeof(OldItableItem));
+    memset(entry->items + entry->itemsSize, 0, oldtable_itemGrow * sizeof(OldItableItem));
+
+    entry->itemsSize = newSize;
+  }
+}
+
+static void iOldTableAdd(OldItable *it, OldItableKey *key, void *value, Itable_Types itemType)
+{
+  unsigned int entryIndex;
+  unsigned long keyIndex;
+  OldItableEntry *entry;
+  OldItableItem* item;
+
+  entryIndex = iOldTableGetEntryIndex(it, key->keyStr, &keyIndex);
+
+  entry = &(it->entries[entryIndex]);
+  iOldTableUpdateArraySize(entry);
+
+  /* add a new item at the end of the item array without duplicating memory. */
+  item = &(entry->items[entry->nextItemIndex]);
+  item->itemType     = itemType;
+  item->key.keyIndex = keyIndex;
+  item->key.keyStr   = key->keyStr;
+  item->value        = value;
+
+  entry->nextItemIndex++;
+  it->numberOfEntries++;
+}
+
+static unsigned int iOldTableResize(OldItable *it)
+{
+  unsigned int   newSizeIndex,
+                 entryIndex,
+                 i;
+  OldItable     *newTable;
+  OldItableEntry *entry;
+  OldItableItem  *item;
+
+  /* check if we do not need to resize the hash table */
+  if (it->numberOfEntries == 0 ||
+     it->tableSizeIndex >= oldtable_maxTableSizeIndex ||
+     it->entriesSize / it->numberOfEntries >= oldtable_resizeLimit)
+    return 0;
+
+  /* create a new hash table and copy the contents of
+   * the current table into the new one
+   */
+  newSizeIndex = it->tableSizeIndex + 1;
+  newTable = oldTableCreateSized(it->indexType, newSizeIndex);
+
+  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
+  {
+    entry = &(it->entries[entryIndex]);
+
+    if (entry->items)
+    {
+      item = &(entry->items[0]);
+
+      for (i = 0; i < entry->nextItemIndex; i++, item++)
+        iOldTableAdd(newTable, &(item->key), item->value, item->itemType);
+
+      free(entry->items);
+      entry->items = NULL;
+    }
+  }
+
+  free(it->entries);
+
+  it->entriesSize    = newTable->entriesSize;
+  it->tableSizeIndex  = newTable->tableSizeIndex;
+  it->numberOfEntries = newTable->numberOfEntries;
+  it->entries         = newTable->entries;
+
+  free(newTable);
+
+  return 1;
+}
+
+static void oldTableSet(OldItable *it, const char *key, void *value, Itable_Types itemType)
+{
+  unsigned int  itemIndex,
+                itemFound;
+  unsigned long keyIndex;
+  OldItableEntry *entry;
+  OldItableItem  *item;
+  void         *v;
+
+  itemFound = iOldTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
+
+  if (!itemFound)
+  {
+    /* create a new item */
+
+    /* first check if the hash table has to be reorganized */
+    if (iOldTableResize(it))
+    {
+      /* We have to search for the entry again, since it may
+       * have been moved by iOldTableResize. */
+      iOldTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
+    }
+
+    iOldTableUpdateArraySize(entry);
+
+    /* add the item at the end of the item array */
+    if (itemType == IUPTABLE_STRING)
+      v = oldTableStrDup(value);
+    else
+      v = value;
+
+    item = &(entry->items[entry->nextItemIndex]);
+
+    item->itemType     = itemType;
+    item->key.keyIndex = keyIndex;
+    item->key.keyStr   = it->indexType == IUPTABLE_STRINGINDEXED? oldTableStrDup(key) : key;
+    item->value        = v;
+
+    entry->nextItemIndex++;
+    it->numberOfEntries++;
+  }
+  else
+  {
+    /* change an existing item */
+    item = &(entry->items[itemIndex]);
+
+    if (itemType == IUPTABLE_STRING && item->itemType == IUPTABLE_STRING)
+    {
+      /* this will avoid to free + alloc of a new pointer */
+      if (strcmp((char*)item->value, (char*)value) == 0)
+        return;
+    }
+
+    if (itemType == IUPTABLE_STRING)
+      v = oldTableStrDup(value);
+    else
+      v = value;
+
+    if (item->itemType == IUPTABLE_STRING)
+      free(item->value);
+
+    item->value    = v;
+    item->itemType = itemType;
+  }
+}
+
+static void *oldTableGet(OldItable *it, const char *key)
+{
+  unsigned int  itemIndex;
+  unsigned long keyIndex;
+  OldItableEntry *entry;
+
+  if (iOldTableFindItem(it, key, &entry, &itemIndex, &keyIndex))
+    return entry->items[itemIndex].value;
+
+  return 0;
+}
+
+static char *oldTableFirst(OldItable *it)
+{
+  unsigned int entryIndex;
+
+  it->context.entryIndex = (unsigned int)-1;
+  it->context.itemIndex = (unsigned int)-1;
+
+  /* find the first used entry */
+  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
+  {
+    if (it->entries[entryIndex].nextItemIndex > 0)
+    {
+      it->context.entryIndex = entryIndex;
+      it->context.itemIndex = 0;
+      return (char*)it->entries[entryIndex].items[0].key.keyStr;
+    }
+  }
+
+  return 0;
+}
+
+static char *oldTableNext(OldItable *it)
+{
+  unsigned int entryIndex;
+
+  if (it->context.entryIndex == (unsigned int)-1 || it->context.itemIndex == (unsigned int)-1)
+    return 0;
+
+  if (it->context.itemIndex + 1 < it->entries[it->context.entryIndex].nextItemIndex)
+  {
+    /* key in the current entry */
+    it->context.itemIndex++;
+    return (char*)it->entries[it->context.entryIndex].items[it->context.itemIndex].key.keyStr;
+  }
+  else
+  {
+    /* find the next used entry */
+    for (entryIndex = it->context.entryIndex+1; entryIndex < it->entriesSize; entryIndex++)
+    {
+      if (it->entries[entryIndex].nextItemIndex > 0)
+      {
+        it->context.entryIndex = entryIndex;
+        it->context.itemIndex = 0;
+        return (char*)it->entries[entryIndex].items[0].key.keyStr;
+      }
+    }
+  }
+
+  return 0;
+}
+
+/* The same operations in both tables, the attributes table of an element uses the default size */
+
+static void* attrib_new_create(void) { return iupTableCreate(IUPTABLE_STRINGINDEXED); }
+static void attrib_new_set(void* it, const char* key, const char* value) { iupTableSet((Itable*)it, key, (void*)value, IUPTABLE_STRING); }
+static void* attrib_new_get(void* it, const char* key) { return iupTableGet((Itable*)it, key); }
+static char* attrib_new_first(void* it) { return iupTableFirst((Itable*)it); }
+static char* attrib_new_next(void* it) { return iupTableNext((Itable*)it); }
+static void attrib_new_destroy(void* it) { iupTableDestroy((Itable*)it); }
+
+static void* attrib_old_create(void) { return oldTableCreateSized(IUPTABLE_STRINGINDEXED, 1); }
+static void attrib_old_set(void* it, const char* key, const char* value) { oldTableSet((OldItable*)it, key, (void*)value, IUPTABLE_STRING); }
+static void* attrib_old_get(void* it, const char* key) { return oldTableGet((OldItable*)it, key); }
+static char* attrib_old_first(void* it) { return oldTableFirst((OldItable*)it); }
+static char* attrib_old_next(void* it) { return oldTableNext((OldItable*)it); }
+static void attrib_old_destroy(void* it) { oldTableDestroy((OldItable*)it); }
+
+typedef struct _AttribTable
+{
+  void* (*create)(void);
+  void (*set)(void* it, const char* key, const char* value);
+  void* (*get)(void* it, const char* key);
+  char* (*first)(void* it);
+  char* (*next)(void* it);
+  void (*destroy)(void* it);
+} AttribTable;
+
+static const AttribTable attrib_new_table = {attrib_new_create, attrib_new_set, attrib_new_get, attrib_new_first, attrib_new_next, attrib_new_destroy};
+static const AttribTable attrib_old_table = {attrib_old_create, attrib_old_set, attrib_old_get, attrib_old_first, attrib_old_next, attrib_old_destroy};
+
+#define ATTRIB_TABLE_TIMES 4
+
+/* times are Create+Set, Get, Iterate and Destroy */
+static void attrib_table_bench(const AttribTable* table, void** tables, double* times, int *found)
+{
+  int i, j;
+  clock_t start;
+
+  start = clock();
+  for (i = 0; i < ATTRIB_COUNT; i++)
+  {
+    tables[i] = table->create();
+    for (j = 0; j < 6; j++)
+      table->set(tables[i], attrib_names[(i+j*3)%20], "value");
+  }
+  times[0] = attrib_time(start);
+
+  *found = 0;
+  start = clock();
+  for (j = 0; j < 20; j++)
+  {
+    for (i = 0; i < ATTRIB_COUNT; i++)
+    {
+      if (table->get(tables[i], attrib_names[(i+j)%20]))
+        (*found)++;
+    }
+  }
+  times[1] = attrib_time(start);
+
+  start = clock();
+  for (i = 0; i < ATTRIB_COUNT; i++)
+  {
+    char* key = table->first(tables[i]);
+    while (key)
+      key = table->next(tables[i]);
+  }
+  times[2] = attrib_time(start);
+
+  start = clock();
+  for (i = 0; i < ATTRIB_COUNT; i++)
+    table->destroy(tables[i]);
+  times[3] = attrib_time(start);
+}
+
+static void attrib_table_compare(void)
+{
+  static const char* labels[ATTRIB_TABLE_TIMES] = {"Create+Set", "Get", "Iterate", "Destroy"};
+  double old_times[ATTRIB_TABLE_TIMES], new_times[ATTRIB_TABLE_TIMES];
+  int i, old_found, new_found;
+  void** tables = (void**)malloc(ATTRIB_COUNT*sizeof(void*));
+
+  attrib_table_bench(&attrib_old_table, tables, old_times, &old_found);
+  attrib_table_bench(&attrib_new_table, tables, new_times, &new_found);
+
+  printf("Tables            old       new\n");
+  for (i = 0; i < ATTRIB_TABLE_TIMES; i++)
+    printf("  %-12s %7.3f s %7.3f s\n", labels[i], old_times[i], new_times[i]);
+  printf("  (found old=%d new=%d)\n", old_found, new_found);
+
+  free(tables);
+}
+
+void AttribTest(void)
+{
+  int i, j, found = 0, count = 0;
+  char* names[50];
+  char buffer[100];
+  clock_t start;
+  Ihandle** handles;
+
+  attrib_table_compare();
+
+  handles = (Ihandle**)malloc(ATTRIB_COUNT*sizeof(Ihandle*));
+
+  start = clock();
+  for (i = 0; i < ATTRIB_COUNT; i++)
+  {
+    handles[i] = IupUser();
+    for (j = 0; j < 6; j++)
+      IupStoreAttribute(handles[i], attrib_names[(i+j*3)%20], "value");
+  }
+  printf("Create+Set: %.3f s\n", attrib_time(start));
+
+  start = clock();
+  for (j = 0; j < 20; j++)
+  {
+    for (i = 0; i < ATTRIB_COUNT; i++)
+    {
+      if (IupGetAttribute(handles[i], attrib_names[(i+j)%20]))
+        found++;
+    }
+  }
+  printf("Get: %.3f s (found=%d)\n", attrib_time(start), found);
+
+  start = clock();
+  found = 0;
+  for (j = 0; j < 20; j++)
+  {
+    for (i = 0; i < ATTRIB_COUNT; i++)
+    {
+      if (IupGetAttributeBuffer(handles[i], "RASTERSIZE", buffer, sizeof(buffer)) > 0)
+        found++;
+    }
+  }
+  printf("GetBuffer: %.3f s (found=%d)\n", attrib_time(start), found);
+
+  start = clock();
+  for (i = 0; i < ATTRIB_COUNT; i++)
+    count += IupGetAllAttributes(handles[i], names, 50);
+  printf("GetAll: %.3f s (count=%d)\n", attrib_time(start), count);
+
+  start = clock();
+  for (i = 0; i < ATTRIB_COUNT; i++)
+    IupDestroy(handles[i]);
+  printf("Destroy: %.3f s\n", attrib_time(start));
+
+  free(handles);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  AttribTest();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
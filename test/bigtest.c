@@ -17,12 +17,14 @@ export G_SLICE=always-malloc
 
 /* Must define BIG_TEST on the Project and include in the build all test files */
 #ifdef BIG_TEST
+void AttribTest(void);
 void ButtonTest(void);
 void CanvasScrollbarTest(void);
 void CanvasTest(void);
 void CanvasCDDBufferTest(void);
 void CanvasCDSimpleTest(void);
 void DialogTest(void);
+void DrawRGBATest(void);
 void FrameTest(void);
 void TabsTest(void);
 void SysInfoTest(void);
@@ -34,6 +36,8 @@ void GLCanvasCubeTest(void);
 void HboxTest(void);
 void IdleTest(void);
 void LabelTest(void);
+void LedLoadTest(void);
+void LedThreadTest(void);
 void ListTest(void);
 void MatrixTest(void);
 void MatrixCbModeTest(void);
@@ -50,7 +54,11 @@ void CellsDegradeTest(void);
 void CellsCheckboardTest(void);
 void ValTest(void);
 void TreeTest(void);
+void TreeNodesTest(void);
 void TrayTest(void);
+#ifdef TUIO_TEST
+void TuioTest(void);
+#endif
 void ToggleTest(void);
 void TimerTest(void);
 void TextSpinTest(void);
@@ -64,6 +72,7 @@ void PPlotTest(void);
 #endif
 #ifdef MGLPLOT_TEST
 void MglPlotTest(void);
+void MglPlotZBTest(void);
 #endif
 void GetParamTest(void);
 void ClassInfo(void);
@@ -88,6 +97,7 @@ typedef struct _TestItems{
 }TestItems;
 
 static TestItems test_list[] = {
+  {"Attrib", AttribTest},
   {"Button", ButtonTest},
   {"Canvas", CanvasTest},
   {"CanvasCDSimpleTest", CanvasCDSimpleTest},
@@ -103,6 +113,7 @@ static TestItems test_list[] = {
   {"Colorbar", ColorbarTest},
   {"Dial", DialTest},
   {"Dialog", DialogTest},
+  {"DrawRGBA", DrawRGBATest},
   {"Frame", FrameTest},
 #ifdef USE_OPENGL
   {"GLCanvas", GLCanvasTest},
@@ -115,6 +126,8 @@ static TestItems test_list[] = {
   {"Hbox", HboxTest},
   {"Idle", IdleTest},
   {"Label", LabelTest},
+  {"LedLoad", LedLoadTest},
+  {"LedThread", LedThreadTest},
   {"List", ListTest},
   {"Matrix", MatrixTest},
   {"MatrixCbMode", MatrixCbModeTest},
@@ -123,6 +136,7 @@ static TestItems test_list[] = {
   {"Menu", MenuTest},
 #ifdef MGLPLOT_TEST
   {"MglPlot", MglPlotTest},
+  {"MglPlot ZBuffer", MglPlotZBTest},
 #endif
 #ifdef PPLOT_TEST
   {"PPlot", PPlotTest},
@@ -143,6 +157,10 @@ static TestItems test_list[] = {
   {"Toggle", ToggleTest},
   {"Tray", TrayTest},
   {"Tree", TreeTest},
+#ifdef TUIO_TEST
+  {"Tuio", TuioTest},
+#endif
+  {"TreeNodes", TreeNodesTest},
   {"Val", ValTest},
   {"Vbox", VboxTest},
   {"Zbox", ZboxTest},
@@ -34,6 +34,8 @@ endif
 DEFINES = BIG_TEST
 SRC += bigtest.c  
 
+SRC += attrib.c
+
 SRC += tray.c
 SRC += dialog.c
 SRC += predialogs.c
@@ -61,12 +63,19 @@ SRC += getparam.c
 SRC += getcolor.c
 SRC += class_conf.c
 SRC += tree.c
+SRC += tree_nodes.c
 SRC += zbox.c
 SRC += scanf.c
 SRC += sbox.c
 SRC += scrollbox.c
 SRC += clipboard.c
 SRC += split.c
+SRC += draw_rgba.c
+SRC += ledload.c
+SRC += led_thread.c
+ifeq ($(findstring Win, $(TEC_SYSNAME)), )
+  LIBS += pthread
+endif
 
 
 #ifneq ($(findstring Win, $(TEC_SYSNAME)), )
@@ -121,12 +130,31 @@ endif
 
 DEFINES += MGLPLOT_TEST
 SRC += mglplot.c
+SRC += mglplot_zb.cpp
+# internal MathGL headers, configured as in the iup_mglplot library, only for this file
+%/mglplot_zb.o: CXXFLAGS += -I../srcmglplot -DNO_GSL -DNO_PNG
 ifneq ($(findstring Win, $(TEC_SYSNAME)), )
   LIBS += iup_mglplot
 else
   SLIB += $(IUPLIB)/libiup_mglplot.a
 endif
 
+DEFINES += TUIO_TEST
+SRC += tuio.cpp
+# TUIO server headers, configured as in the iuptuio library, only for this file
+ifeq ($(TEC_BYTEORDER), TEC_LITTLEENDIAN)
+  TUIO_ENDIAN = -DOSC_HOST_LITTLE_ENDIAN
+else
+  TUIO_ENDIAN = -DOSC_HOST_BIG_ENDIAN
+endif
+%/tuio.o: CXXFLAGS += -I../srctuio/tuio -I../srctuio/oscpack $(TUIO_ENDIAN)
+ifneq ($(findstring Win, $(TEC_SYSNAME)), )
+  LIBS += iuptuio ws2_32 winmm
+else
+  SLIB += $(IUPLIB)/libiuptuio.a
+  LIBS += pthread
+endif
+
 USE_IM = Yes
 ifdef USE_IM
 ifneq ($(findstring Win, $(TEC_SYSNAME)), )
@@ -0,0 +1,169 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "iup.h"
+
+#include "../src/iup_draw.h"
+
+/* iupDraw RGBA canvas line test and benchmark.
+   Compares clipped lines, including lines far away from the canvas,
+   with the same lines computed point by point, then measures the drawing time. */
+
+#define DRAW_RGBA_W 64
+#define DRAW_RGBA_H 48
+#define DRAW_RGBA_LINES 100000
+#define DRAW_RGBA_DASH 4
+
+static double draw_rgba_time(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static int draw_rgba_rand(int range)
+{
+  /* rand() can be only 15 bits */
+  return (int)(((double)rand() / ((double)RAND_MAX + 1.0)) * (2.0*range)) - range;
+}
+
+/* the point at step k along the major axis has the minor offset round(k*dminor/dmajor),
+   only the steps inside the clipping area along the major axis are visited,
+   and the other points are tested against the clipping area.
+   Coordinates are kept below 2^24, so double is exact. */
+static void draw_rgba_reference(unsigned int* buffer, int cx1, int cy1, int cx2, int cy2,
+                                int x1, int y1, int x2, int y2, int dashed, unsigned int color)
+{
+  double dx = fabs((double)x2 - x1), dy = fabs((double)y2 - y1);
+  int y_major = dy > dx;
+  double dmajor = y_major? dy: dx, dminor = y_major? dx: dy, k, k0, k1;
+  int smajor = y_major? (y1 < y2? 1: -1): (x1 < x2? 1: -1);
+  int sminor = y_major? (x1 < x2? 1: -1): (y1 < y2? 1: -1);
+  double major1 = y_major? y1: x1, c1 = y_major? cy1: cx1, c2 = y_major? cy2: cx2;
+
+  k0 = smajor > 0? c1 - major1: major1 - c2;
+  k1 = smajor > 0? c2 - major1: major1 - c1;
+  if (k0 < 0) k0 = 0;
+  if (k1 > dmajor) k1 = dmajor;
+
+  for (k = k0; k <= k1; k++)
+  {
+    double off = dmajor? floor((2*k*dminor + dmajor) / (2*dmajor)): 0;
+    double x, y;
+
+    if (y_major) { x = x1 + sminor*off; y = y1 + smajor*k; }
+    else { x = x1 + smajor*k; y = y1 + sminor*off; }
+
+    if (dashed && fmod(floor(k / DRAW_RGBA_DASH), 2) != 0)
+      continue;
+
+    if (x >= cx1 && x <= cx2 && y >= cy1 && y <= cy2)
+      buffer[(int)y*DRAW_RGBA_W + (int)x] = color;
+  }
+}
+
+static int draw_rgba_compare(void)
+{
+  int i, errors = 0;
+  unsigned char* ref = (unsigned char*)malloc(DRAW_RGBA_W*DRAW_RGBA_H*4);
+  IdrawCanvas* dc = iupDrawCreateCanvasRGBA(NULL, DRAW_RGBA_W, DRAW_RGBA_H, NULL);
+  unsigned char* buffer = iupDrawGetBufferRGBA(dc);
+  unsigned char rgba[4] = {255, 0, 0, 255};
+  unsigned int color;
+
+  memcpy(&color, rgba, 4);
+  srand(1);
+
+  for (i = 0; i < DRAW_RGBA_LINES; i++)
+  {
+    /* short lines, and long lines that cross the canvas or pass far away from it */
+    int range = i%3 == 0? 100: (i%3 == 1? 10000: 2000000);
+    int x1 = DRAW_RGBA_W/2 + draw_rgba_rand(range), y1 = DRAW_RGBA_H/2 + draw_rgba_rand(range);
+    int x2 = DRAW_RGBA_W/2 + draw_rgba_rand(range), y2 = DRAW_RGBA_H/2 + draw_rgba_rand(range);
+    int dashed = i%2;
+    int cx1 = 0, cy1 = 0, cx2 = DRAW_RGBA_W-1, cy2 = DRAW_RGBA_H-1;
+
+    if (i%4 == 0) x2 = x1 + rand()%5 - 2;  /* almost vertical */
+    if (i%5 == 0) y2 = y1 + rand()%5 - 2;  /* almost horizontal */
+
+    iupDrawResetClip(dc);
+    iupDrawParentBackground(dc);
+
+    if (i%7 < 3)
+    {
+      cx1 = rand()%(DRAW_RGBA_W/2);  cx2 = cx1 + rand()%(DRAW_RGBA_W/2);
+      cy1 = rand()%(DRAW_RGBA_H/2);  cy2 = cy1 + rand()%(DRAW_RGBA_H/2);
+      iupDrawSetClipRect(dc, cx1, cy1, cx2, cy2);
+    }
+
+    /* a new dash pattern starts for each call */
+    iupDrawLine(dc, x1, y1, x2, y2, 255, 0, 0, dashed? IUP_DRAW_STROKE_DASH: IUP_DRAW_STROKE);
+
+    memset(ref, 255, DRAW_RGBA_W*DRAW_RGBA_H*4);
+    draw_rgba_reference((unsigned int*)ref, cx1, cy1, cx2, cy2, x1, y1, x2, y2, dashed, color);
+
+    if (memcmp(ref, buffer, DRAW_RGBA_W*DRAW_RGBA_H*4) != 0)
+    {
+      if (errors < 10)
+        printf("Different pixels: line=%d,%d,%d,%d dashed=%d clip=%d,%d,%d,%d\n", x1, y1, x2, y2, dashed, cx1, cy1, cx2, cy2);
+      errors++;
+    }
+  }
+
+  iupDrawKillCanvas(dc);
+  free(ref);
+  return errors;
+}
+
+static void draw_rgba_bench(void)
+{
+  int i, n;
+  IdrawCanvas* dc = iupDrawCreateCanvasRGBA(NULL, 1024, 768, NULL);
+  clock_t start;
+
+  start = clock();
+  for (n = 0; n < 100; n++)
+  {
+    for (i = 0; i < 100; i++)
+      iupDrawLine(dc, i, 0, 1023-i, 767, 0, 0, 0, IUP_DRAW_STROKE);
+  }
+  printf("10000 lines inside the canvas: %.3f s\n", draw_rgba_time(start));
+
+  start = clock();
+  for (n = 0; n < 100; n++)
+  {
+    for (i = 0; i < 100; i++)
+      iupDrawLine(dc, -1000000 + i, -750000, 1000000, 750000 - i, 0, 0, 0, n%2? IUP_DRAW_STROKE_DASH: IUP_DRAW_STROKE);
+  }
+  printf("10000 lines crossing the canvas from far away: %.3f s\n", draw_rgba_time(start));
+
+  iupDrawKillCanvas(dc);
+}
+
+void DrawRGBATest(void)
+{
+  int errors;
+
+  errors = draw_rgba_compare();
+  printf("%d lines compared, %d with different pixels\n", DRAW_RGBA_LINES, errors);
+
+  draw_rgba_bench();
+
+  if (errors)
+    IupMessage("iupDraw RGBA", "Lines with different pixels, see the console.");
+  else
+    IupMessage("iupDraw RGBA", "All lines are equal.");
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  DrawRGBATest();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
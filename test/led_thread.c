@@ -0,0 +1,185 @@
+/* Parses a LED source with IupLedParseBuffer in a worker thread,
+   while the main thread keeps setting attributes and handles with new names,
+   like a splash screen running during the parse.
+   The last description is built in the main thread with IupLedBuild. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "iup.h"
+
+#define LED_THREAD_PARSES 2000
+
+static const char* led_thread_source =
+  "led_thread_dlg = dialog[TITLE=\"LED Thread\", MARGIN=10x10, GAP=5](\n"
+  "  vbox(\n"
+  "    label(\"Parsed in a worker thread\"),\n"
+  "    hbox(toggle(\"A\", do_a), toggle(\"B\", do_b)),\n"
+  "    text[EXPAND=HORIZONTAL](do_text),\n"
+  "    frame[TITLE=List](list[DROPDOWN=YES, 1=One, 2=Two](do_list)),\n"
+  "    button[PADDING=10x2](\"Close\", do_close)))\n";
+
+static Iled* led_thread_led = NULL;
+static int led_thread_errors = 0;
+
+#ifdef WIN32
+static LONG led_thread_done = 0;
+#else
+static int led_thread_done = 0;
+static pthread_mutex_t led_thread_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void led_thread_parse(void)
+{
+  int i, size = (int)strlen(led_thread_source);
+
+  for (i = 0; i < LED_THREAD_PARSES; i++)
+  {
+    Iled* led = IupLedParseBuffer(led_thread_source, size);
+    if (IupLedGetError(led))
+      led_thread_errors++;
+
+    if (led_thread_led)
+      IupLedDestroy(led_thread_led);
+    led_thread_led = led;
+  }
+}
+
+#ifdef WIN32
+static DWORD WINAPI led_thread_func(LPVOID arg)
+{
+  (void)arg;
+  led_thread_parse();
+  InterlockedExchange(&led_thread_done, 1);
+  return 0;
+}
+
+static int led_thread_is_done(void)
+{
+  return InterlockedCompareExchange(&led_thread_done, 1, 1) == 1;
+}
+#else
+static void* led_thread_func(void* arg)
+{
+  (void)arg;
+  led_thread_parse();
+  pthread_mutex_lock(&led_thread_mutex);
+  led_thread_done = 1;
+  pthread_mutex_unlock(&led_thread_mutex);
+  return NULL;
+}
+
+static int led_thread_is_done(void)
+{
+  int done;
+  pthread_mutex_lock(&led_thread_mutex);
+  done = led_thread_done;
+  pthread_mutex_unlock(&led_thread_mutex);
+  return done;
+}
+#endif
+
+static void led_thread_clear(Ihandle* user, int first, int last)
+{
+  char name[50];
+  int i;
+
+  for (i = first; i < last; i++)
+  {
+    sprintf(name, "LED_THREAD_%d", i % 10000);
+    IupSetAttribute(user, name, NULL);
+    IupSetHandle(name, NULL);
+  }
+}
+
+static int close_cb(Ihandle* ih)
+{
+  (void)ih;
+  return IUP_CLOSE;
+}
+
+void LedThreadTest(void)
+{
+  Ihandle *user, *dlg;
+  char name[50];
+  char* error;
+  int count = 0;
+#ifdef WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+
+  led_thread_led = NULL;
+  led_thread_errors = 0;
+  led_thread_done = 0;
+
+  user = IupUser();
+
+#ifdef WIN32
+  thread = CreateThread(NULL, 0, led_thread_func, NULL, 0, NULL);
+#else
+  pthread_create(&thread, NULL, led_thread_func, NULL);
+#endif
+
+  /* new names add keys to the tables and remove them, while the worker is parsing */
+  while (!led_thread_is_done())
+  {
+    sprintf(name, "LED_THREAD_%d", count % 10000);
+    IupSetAttribute(user, name, "1");
+    IupSetHandle(name, user);
+    count++;
+
+    if (count % 100 == 0)
+      led_thread_clear(user, count - 100, count);
+  }
+
+#ifdef WIN32
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+#else
+  pthread_join(thread, NULL);
+#endif
+
+  /* IupDestroy removes only the last name of the element */
+  led_thread_clear(user, count - count % 100, count);
+  IupDestroy(user);
+
+  printf("%d parses with %d errors, %d attributes set in the main thread\n", LED_THREAD_PARSES, led_thread_errors, count);
+
+  error = IupLedBuild(led_thread_led);
+  if (error)
+  {
+    IupMessage("LED Thread", error);
+    IupLedDestroy(led_thread_led);
+    return;
+  }
+  IupLedDestroy(led_thread_led);
+  led_thread_led = NULL;
+
+  dlg = IupGetHandle("led_thread_dlg");
+  IupSetFunction("do_close", (Icallback)close_cb);
+  IupShowXY(dlg, IUP_CENTER, IUP_CENTER);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  LedThreadTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
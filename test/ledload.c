@@ -0,0 +1,79 @@
+/* Measures the startup time of dialogs loaded with IupLoad.
+   Compares a text LED file with the binary LED file generated from it by "ledc -b":
+     ledload file.led file.ledb [count]
+   Without arguments, or in the big test, the files are selected with IupGetFile.
+   The loaded elements are not destroyed, so only the load time is measured. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "iup.h"
+
+static double bench(const char* filename, int count)
+{
+  clock_t start = clock();
+  int i;
+
+  for (i = 0; i < count; i++)
+  {
+    char* error = IupLoad(filename);
+    if (error)
+    {
+      printf("%s", error);
+      return -1;
+    }
+  }
+
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void ledload(const char* text_file, const char* binary_file, int count)
+{
+  double text_time = bench(text_file, count);
+  double binary_time = bench(binary_file, count);
+
+  if (text_time >= 0 && binary_time >= 0)
+  {
+    printf("%s: %d loads in %.3f s (%.3f ms per load)\n", text_file, count, text_time, 1000*text_time/count);
+    printf("%s: %d loads in %.3f s (%.3f ms per load)\n", binary_file, count, binary_time, 1000*binary_time/count);
+  }
+}
+
+void LedLoadTest(void)
+{
+  char text_file[10240] = "*.led";
+  char binary_file[10240] = "*.ledb";
+
+  if (IupGetFile(text_file) != 0)
+    return;
+  if (IupGetFile(binary_file) != 0)
+    return;
+
+  ledload(text_file, binary_file, 100);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  int count = 100;
+
+  IupOpen(&argc, &argv);
+
+  if (argc < 3)
+  {
+    /* select the files interactively */
+    LedLoadTest();
+    IupClose();
+    return EXIT_SUCCESS;
+  }
+
+  if (argc > 3)
+    count = atoi(argv[3]);
+
+  ledload(argv[1], argv[2], count);
+
+  IupClose();
+  return EXIT_SUCCESS;
+}
+#endif
@@ -27,6 +27,19 @@ static int list_cb (Ihandle *ih, char *t, int i, int v)
   return IUP_DEFAULT;
 }
 
+static char* virtual_value_cb(Ihandle *ih, int pos)
+{
+  static char str[50];
+  sprintf(str, "Item %d", pos);
+  return str;
+}
+
+static int selectrange_cb(Ihandle *ih, int first, int last, int state)
+{
+  printf("SELECTRANGE_CB(%d-%d, %d)\n", first, last, state);
+  return IUP_DEFAULT;
+}
+
 static int dropdown_cb(Ihandle *ih, int state)
 {
   printf("DROPDOWN_CB(%d)\n", state);
@@ -297,6 +310,10 @@ void ListTest(void)
   
   //IupSetCallback(list4, "MULTISELECT_CB", (Icallback)multilist_cb);
 
+//  IupSetAttributes(list4, "VIRTUALMODE=YES, COUNT=1000000, VISIBLELINES=10");
+  IupSetCallback(list4, "VALUE_CB", (Icallback)virtual_value_cb);
+  IupSetCallback(list4, "SELECTRANGE_CB", (Icallback)selectrange_cb);
+
 //  IupSetAttribute(list1, "READONLY", "YES");
 //  IupSetAttribute(list3, "READONLY", "YES");
 //  IupSetAttribute(list1, "PADDING", "10x10");
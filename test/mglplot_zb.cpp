@@ -0,0 +1,102 @@
+/*
+ * mglGraphZB Finish Benchmark
+ * Description : Compares the time to prepare the final picture
+ *               with the scalar loop and with the SIMD code,
+ *               at 1920x1080 and 3840x2160.
+ *      Remark : depend on libs IUP, IUP_MGLPLOT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+
+#include "mgl/mgl_zb.h"
+#include "mgl/mgl_data.h"
+
+
+#ifdef MGLPLOT_TEST
+
+#define FINISH_COUNT 10
+
+static double zb_time(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static double zb_finish(mglGraphZB* gr, bool simd)
+{
+  int i;
+  clock_t start;
+  gr->UseSimd = simd;
+  start = clock();
+  for (i = 0; i < FINISH_COUNT; i++)
+    gr->Finish();
+  return zb_time(start)/FINISH_COUNT;
+}
+
+static void zb_bench(int w, int h)
+{
+  int tt;
+  mglData a(200, 200);
+  a.Modify("0.6*sin(2*pi*x)*sin(3*pi*y)+0.4*cos(3*pi*(x*y))");
+
+  for (tt = 0; tt < 3; tt++)
+  {
+    double t_scalar, t_simd;
+    unsigned char* g;
+    int same;
+    mglGraphZB* gr = new mglGraphZB(w, h);
+
+    gr->FastNoFace = false;  /* composite all transparency layers */
+    gr->SetTranspType(tt);
+    gr->Clf();
+    gr->Rotate(40, 60);
+    gr->Light(true);
+    gr->Alpha(true);
+    gr->Box();
+    gr->Surf(a);
+    gr->Surf(a, "#");
+
+    t_scalar = zb_finish(gr, false);
+    g = (unsigned char*)malloc(4*w*h);
+    memcpy(g, gr->GetRGBA(), 4*w*h);
+
+    t_simd = zb_finish(gr, true);
+    same = memcmp(g, gr->GetRGBA(), 4*w*h) == 0;
+
+    printf("%dx%d TranspType=%d: scalar %.2f ms, simd %.2f ms, %s\n", w, h, tt,
+           t_scalar*1000, t_simd*1000, same? "same picture": "DIFFERENT PICTURE");
+
+    free(g);
+    delete gr;
+  }
+}
+
+extern "C" void MglPlotZBTest(void)
+{
+  int nthr = mglNumThr;
+  mglNumThr = 1;  /* measure the kernel only */
+
+  zb_bench(1920, 1080);
+  zb_bench(3840, 2160);
+
+  mglNumThr = nthr;
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  MglPlotZBTest();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
+
+#endif
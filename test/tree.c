@@ -269,6 +269,18 @@ static int branchclose_cb(Ihandle* ih, int id)
   return IUP_DEFAULT;
 }
 
+static int branchpopulate_cb(Ihandle* ih, int id)
+{
+  printf("BRANCHPOPULATE_CB (%d)\n", id);
+
+  /* ADDxxx add always as the first child */
+  IupSetAttributeId(ih, "ADDBRANCH", id, "more");
+  IupSetAttributeId(ih, "LAZY", id+1, "Yes");
+  IupSetAttributeId(ih, "ADDLEAF", id, "sphere");
+  IupSetAttributeId(ih, "ADDLEAF", id, "cube");
+  return IUP_DEFAULT;
+}
+
 static int noderemoved_cb(Ihandle* ih, void* data)
 {
   printf("NODEREMOVED_CB(%p)\n", data);
@@ -479,6 +491,7 @@ static void init_tree_nodes(void)
   IupSetAttribute(tree, "ADDLEAF7",     "diamond");
   IupSetAttribute(tree, "INSERTLEAF6","2D");  /* new id=9 */
   IupSetAttribute(tree, "INSERTBRANCH9","3D");
+  IupSetAttribute(tree, "LAZY10", "Yes");  /* children created by BRANCHPOPULATE_CB */
 #endif
   IupSetAttribute(tree, "TOGGLEVALUE2", "ON");
   IupSetAttribute(tree, "TOGGLEVALUE6", "ON");
@@ -507,6 +520,7 @@ static void init_tree(void)
   IupSetCallback(tree, "RENAME_CB",      (Icallback) rename_cb);
   IupSetCallback(tree, "BRANCHCLOSE_CB", (Icallback) branchclose_cb);
   IupSetCallback(tree, "BRANCHOPEN_CB",  (Icallback) branchopen_cb);
+  IupSetCallback(tree, "BRANCHPOPULATE_CB", (Icallback) branchpopulate_cb);
   IupSetCallback(tree, "DRAGDROP_CB",    (Icallback) dragdrop_cb);
   IupSetCallback(tree, "RIGHTCLICK_CB",  (Icallback) rightclick_cb);
   IupSetCallback(tree, "K_ANY",          (Icallback) k_any_cb);
@@ -537,6 +551,7 @@ static void init_tree(void)
 //  IupSetAttribute(tree, "SHOWTOGGLE",   "YES");
 //  IupSetAttribute(tree, "SHOWTOGGLE",   "3STATE");
 //  IupSetAttribute(tree, "DROPEQUALDRAG", "YES");
+//  IupSetAttribute(tree, "LAZYEVICT", "YES");
 
   IupSetAttribute(tree, "ADDEXPANDED",  "YES");
 //  IupSetAttribute(tree, "HIDELINES",    "YES");
@@ -0,0 +1,103 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "iup.h"
+
+/* IupTree node cache benchmark.
+   Adds a large number of nodes and accesses them by id. */
+
+#define TREE_NODES_COUNT 1000000
+#define TREE_NODES_BRANCH 1000
+
+static double tree_nodes_time(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void tree_nodes_fill(Ihandle* tree)
+{
+  int i, b, id;
+  char** titles = (char**)malloc(TREE_NODES_BRANCH*sizeof(char*));
+  clock_t start;
+
+  for (i = 0; i < TREE_NODES_BRANCH; i++)
+  {
+    titles[i] = (char*)malloc(20);
+    sprintf(titles[i], "Leaf %d", i);
+  }
+
+  /* 1000 branches with 999 leafs each, below the root */
+  start = clock();
+  id = IupTreeAddNodeList(tree, "BRANCH", 0, (const char**)titles, 1);
+  for (b = 0; b < TREE_NODES_COUNT/TREE_NODES_BRANCH; b++)
+  {
+    IupTreeAddNodeList(tree, "LEAF", id, (const char**)titles, TREE_NODES_BRANCH-1);
+
+    if (b < TREE_NODES_COUNT/TREE_NODES_BRANCH - 1)
+    {
+      /* INSERTBRANCH after a branch adds the new branch after its children */
+      IupSetAttributeId(tree, "INSERTBRANCH", id, "Branch");
+      id = IupGetInt(tree, "LASTADDNODE");
+    }
+  }
+  printf("AddNodeList: %.3f s (count=%s)\n", tree_nodes_time(start), IupGetAttribute(tree, "COUNT"));
+
+  start = clock();
+  for (i = 0; i < 100000; i++)
+  {
+    id = 1 + rand() % (TREE_NODES_COUNT-1);
+    IupTreeSetUserId(tree, id, titles[i%TREE_NODES_BRANCH]);
+  }
+  printf("SetUserId: %.3f s\n", tree_nodes_time(start));
+
+  start = clock();
+  for (i = 0; i < 1000; i++)
+  {
+    id = 1 + rand() % (TREE_NODES_COUNT-1);
+    IupSetAttributeId(tree, "INSERTLEAF", id, "New Leaf");
+  }
+  printf("INSERTLEAF: %.3f s\n", tree_nodes_time(start));
+
+  start = clock();
+  for (i = 0; i < 1000; i++)
+  {
+    id = 1 + rand() % (TREE_NODES_COUNT-1);
+    if (IupGetIntId(tree, "CHILDCOUNT", id) == 0)
+      IupSetAttributeId(tree, "DELNODE", id, "SELECTED");
+  }
+  printf("DELNODE: %.3f s (count=%s)\n", tree_nodes_time(start), IupGetAttribute(tree, "COUNT"));
+
+  for (i = 0; i < TREE_NODES_BRANCH; i++)
+    free(titles[i]);
+  free(titles);
+}
+
+void TreeNodesTest(void)
+{
+  Ihandle *dlg, *tree;
+
+  tree = IupTree();
+  IupSetAttribute(tree, "ADDEXPANDED", "NO");
+  IupSetAttribute(tree, "RASTERSIZE", "300x400");
+
+  dlg = IupDialog(tree);
+  IupSetAttribute(dlg, "TITLE", "IupTree Nodes");
+  IupShowXY(dlg, IUP_CENTER, IUP_CENTER);
+
+  tree_nodes_fill(tree);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  TreeNodesTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,132 @@
+/* Measures the latency of the IupTuioClient touch events.
+   A TUIO server in the same process sends a cursor frame to the loopback,
+   TOUCH_CB measures the time since the frame was sent and then sends the next frame.
+   Must be linked with the iuptuio library, the TUIO server is also part of it. */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "iup.h"
+#include "iuptuio.h"
+
+#include "TuioServer.h"
+
+using namespace TUIO;
+
+#define TUIO_PORT 3333
+#define TUIO_FRAMES 1000
+
+static TuioServer* tuio_server = NULL;
+static TuioCursor* tuio_cursor = NULL;
+static int frame_count = 0, lost_count = 0;
+static double send_time, latency_sum, latency_min, latency_max;
+
+static double get_time(void)
+{
+#ifdef WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (1000.0 * count.QuadPart) / freq.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec*1000.0 + tv.tv_usec/1000.0;
+#endif
+}
+
+static void send_frame(void)
+{
+  /* alternate the position, so each frame has a MOVE */
+  float x = (frame_count%2)? 0.25f: 0.75f;
+
+  tuio_server->initFrame(TuioTime::getSessionTime());
+  if (!tuio_cursor)
+    tuio_cursor = tuio_server->addTuioCursor(x, 0.5f);
+  else
+    tuio_server->updateTuioCursor(tuio_cursor, x, 0.5f);
+
+  send_time = get_time();
+  tuio_server->commitFrame();
+}
+
+static int touch_cb(Ihandle *ih, int id, int x, int y, char* state)
+{
+  double latency = get_time() - send_time;
+  (void)ih;
+  (void)id;
+  (void)x;
+  (void)y;
+  (void)state;
+
+  if (frame_count == 0 || latency < latency_min) latency_min = latency;
+  if (frame_count == 0 || latency > latency_max) latency_max = latency;
+  latency_sum += latency;
+  frame_count++;
+
+  if (frame_count == TUIO_FRAMES)
+  {
+    printf("frames=%d lost=%d latency(ms): avg=%.3f min=%.3f max=%.3f\n",
+           frame_count, lost_count, latency_sum/frame_count, latency_min, latency_max);
+    return IUP_CLOSE;
+  }
+
+  send_frame();
+  return IUP_DEFAULT;
+}
+
+static int timer_cb(Ihandle *ih)
+{
+  static int last_count = -1;
+  (void)ih;
+
+  /* UDP may lose a frame, send it again */
+  if (last_count == frame_count)
+  {
+    lost_count++;
+    send_frame();
+  }
+  last_count = frame_count;
+  return IUP_DEFAULT;
+}
+
+extern "C" void TuioTest(void)
+{
+  Ihandle *client, *timer;
+
+  IupTuioOpen();
+
+  client = IupTuioClient(TUIO_PORT);
+  IupSetCallback(client, "TOUCH_CB", (Icallback)touch_cb);
+  IupSetAttribute(client, "CONNECT", "YES");
+
+  timer = IupTimer();
+  IupSetAttribute(timer, "TIME", "1000");
+  IupSetCallback(timer, "ACTION_CB", (Icallback)timer_cb);
+  IupSetAttribute(timer, "RUN", "YES");
+
+  tuio_server = new TuioServer("127.0.0.1", TUIO_PORT);
+  send_frame();
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  TuioTest();
+
+  IupMainLoop();
+
+  delete tuio_server;
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif